@@ -62,6 +62,7 @@ SAMPLER_ORDERING = ['independent',
 
 INTEGRATOR_ORDERING = ['direct',
                        'path',
+                       'guided_path',
                        'aov']
 
 FILM_ORDERING = ['hdrfilm']
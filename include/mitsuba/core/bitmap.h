@@ -82,11 +82,13 @@ public:
          *   <li>Loading and saving of spectral bitmaps</li>
          *   <li>Loading and saving of XYZ tristimulus bitmaps</li>
          *   <li>Loading and saving of string-valued metadata fields</li>
+         *   <li>Saving of multi-part and tiled images (see \ref
+         *   write_openexr_parts()) and loading of their channels</li>
          * </ul>
          *
          * The following is <em>not</em> supported:
          * <ul>
-         *   <li>Saving of tiled images, tile-based read access</li>
+         *   <li>Tile-based read access</li>
          *   <li>Display windows that are different than the data window</li>
          *   <li>Loading of spectrum-valued bitmaps</li>
          * </ul>
@@ -176,6 +178,65 @@ public:
         Unpremultiply
     };
 
+    /// Compression schemes supported by the OpenEXR writer
+    enum class EXRCompression : uint32_t {
+        /// No compression
+        None,
+
+        /// Run-length encoding (lossless)
+        RLE,
+
+        /// Zlib compression of single scanlines (lossless)
+        ZIPS,
+
+        /// Zlib compression of blocks of 16 scanlines (lossless)
+        ZIP,
+
+        /// Wavelet compression (lossless, the default)
+        PIZ,
+
+        /// Lossy 24-bit float compression
+        PXR24,
+
+        /// Lossy compression of 4x4 pixel blocks of \c float16 channels
+        B44,
+
+        /// Like \ref B44, but flat areas are compressed more aggressively
+        B44A,
+
+        /// Lossy DCT-based compression of blocks of 32 scanlines
+        DWAA,
+
+        /// Lossy DCT-based compression of blocks of 256 scanlines
+        DWAB
+    };
+
+    /**
+     * \brief Part of a multi-part OpenEXR file
+     *
+     * Used by \ref write_openexr_parts() to group the channels of a bitmap
+     * (e.g. the beauty pass and the AOVs of a render) into separate parts
+     * that are compressed with different settings.
+     */
+    struct EXRPart {
+        /// Name of the part (required for files with more than one part)
+        std::string name;
+
+        /**
+         * \brief Names of the channels stored in this part
+         *
+         * An empty list selects all channels that are not claimed by
+         * another part.
+         */
+        std::vector<std::string> channels;
+
+        /// Compression scheme of this part
+        EXRCompression compression = EXRCompression::PIZ;
+
+        /// Quality level of the lossy DWA compressors (higher values are more lossy)
+        float compression_level = 45.f;
+    };
+
 
     // ======================================================================
     //! @{ \name Constructors
@@ -380,6 +441,33 @@ public:
     void write_async(const fs::path &path, FileFormat format = FileFormat::Auto,
                      int quality = -1) const;
 
+    /**
+     * \brief Write the bitmap to a multi-part OpenEXR file
+     *
+     * Each entry of \c parts produces one part of the file containing the
+     * listed channels, which allows choosing a lossy compressor for the
+     * beauty pass and a lossless one for IDs or depth. Channels that are
+     * not selected by any part are not written. Parts are encoded one after
+     * the other, and the chunks of each part are compressed in parallel on
+     * the OpenEXR thread pool.
+     *
+     * \param stream
+     *    Target stream that will receive the encoded output
+     *
+     * \param parts
+     *    Description of the parts of the file
+     *
+     * \param tile_size
+     *    When nonzero, the parts are stored as tiles of the given size
+     *    instead of scanlines.
+     */
+    void write_openexr_parts(Stream *stream, const std::vector<EXRPart> &parts,
+                             uint32_t tile_size = 0) const;
+
+    /// Write the bitmap to a multi-part OpenEXR file (see \ref write_openexr_parts())
+    void write_openexr_parts(const fs::path &path, const std::vector<EXRPart> &parts,
+                             uint32_t tile_size = 0) const;
+
     /**
      * \brief Up- or down-sample this image to a different resolution
      *
@@ -643,6 +731,67 @@ public:
      Properties m_metadata;
 };
 
+/**
+ * \brief Writes a scanline-based OpenEXR file in strips of consecutive rows
+ *
+ * This is useful for images that are too large to be held in memory at
+ * once, such as very high resolution renderings that are developed while
+ * the rest of the image is still being rendered. The rows must be provided
+ * from top to bottom. Each call to \ref write() compresses the complete
+ * chunks of the strip on the OpenEXR thread pool; the remainder is buffered
+ * until the next strip arrives.
+ */
+class MTS_EXPORT_CORE EXRScanlineWriter : public Object {
+public:
+    /**
+     * \brief Create a file and write its header
+     *
+     * \param stream
+     *    Target stream that will receive the encoded output
+     *
+     * \param format
+     *    Bitmap whose pixel format, channels, width, and metadata define the
+     *    layout of the file. Its height and contents are ignored, hence the
+     *    first strip can be passed here.
+     *
+     * \param height
+     *    Total number of rows of the image
+     *
+     * \param parts
+     *    Parts of the file (see \ref Bitmap::write_openexr_parts()). Tiled
+     *    output is not supported.
+     */
+    EXRScanlineWriter(Stream *stream, const Bitmap *format, uint32_t height,
+                      const std::vector<Bitmap::EXRPart> &parts =
+                          std::vector<Bitmap::EXRPart>(1));
+
+    /// Append the rows of \c strip, which must have the layout of the file
+    void write(const Bitmap *strip);
+
+    /// Return the number of rows that have been written so far
+    uint32_t rows_written() const { return m_rows_written; }
+
+    /// Return the total number of rows of the image
+    uint32_t height() const { return m_height; }
+
+    /// Return a human-readable summary
+    std::string to_string() const override;
+
+    MTS_DECLARE_CLASS()
+protected:
+    /// Finish the file (warns when rows are missing)
+    virtual ~EXRScanlineWriter();
+
+private:
+    struct EXRScanlineWriterPrivate;
+    std::unique_ptr<EXRScanlineWriterPrivate> d;
+    ref<Stream> m_stream;
+    ref<Struct> m_struct;
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_rows_written;
+};
+
 
 /**
  * \brief Accumulate the contents of a source bitmap into a
@@ -718,5 +867,6 @@ void accumulate_2d(ConstT source,
 extern MTS_EXPORT_CORE std::ostream &operator<<(std::ostream &os, Bitmap::PixelFormat value);
 extern MTS_EXPORT_CORE std::ostream &operator<<(std::ostream &os, Bitmap::FileFormat value);
 extern MTS_EXPORT_CORE std::ostream &operator<<(std::ostream &os, Bitmap::AlphaTransform value);
+extern MTS_EXPORT_CORE std::ostream &operator<<(std::ostream &os, Bitmap::EXRCompression value);
 
 NAMESPACE_END(mitsuba)
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/mmap.h>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Alignment of the data blocks stored in a scene bundle (in bytes)
+#define MTS_BUNDLE_ALIGNMENT 4096
+
+/**
+ * \brief Single-file archive containing a fully parsed scene
+ *
+ * A scene bundle stores the object graph of a scene (the class, plugin name
+ * and \ref Properties of every object) together with the decoded bulk data of
+ * plugins that would otherwise load it from external files, such as meshes
+ * and bitmap textures. The bulk data is stored in page-aligned blocks
+ * ("blobs"), which plugins reference directly from the memory-mapped bundle
+ * instead of parsing and decoding their input files.
+ *
+ * Bundles are created using \ref xml::write_bundle() and loaded using
+ * \ref xml::load_bundle() (or \ref xml::load_file() when the filename has
+ * the <tt>.mtsb</tt> extension). Since plugins store their data in the
+ * working representation of the renderer (e.g. spectral upsampling
+ * coefficients), a bundle can only be loaded using the variant that
+ * created it.
+ *
+ * When a plugin stores data in the bundle (see \ref Object::write_bundle()),
+ * its properties will contain a pointer named <tt>"bundle"</tt> referencing
+ * this object upon loading. The plugin must keep a reference to the bundle
+ * for as long as it accesses the mapped data.
+ */
+class MTS_EXPORT_CORE SceneBundle : public Object {
+public:
+    /// Describes a single object of the scene graph
+    struct Node {
+        /// Unique identifier of the object
+        std::string id;
+        /// Name of the object's interface class (e.g. "Shape"), empty for aliases
+        std::string class_name;
+        /// Identifier of the referenced object (aliases only)
+        std::string alias;
+        /// Construction parameters (children are given as named references)
+        Properties props;
+        /// Does \c props reference bulk data stored in the bundle?
+        bool uses_blobs = false;
+    };
+
+    /// Map the specified bundle file into memory
+    SceneBundle(const fs::path &filename);
+
+    /// Return the variant that was used to create the bundle
+    const std::string &variant() const { return m_variant; }
+
+    /// Return the identifier of the root object (usually the scene)
+    const std::string &root() const { return m_root; }
+
+    /// Return the list of objects stored in the bundle
+    const std::vector<Node> &nodes() const { return m_nodes; }
+
+    /// Return the number of data blocks stored in the bundle
+    size_t blob_count() const { return m_blobs.size(); }
+
+    /// Return a pointer to the data block with the given index
+    void *blob(size_t index) const;
+
+    /// Return the size (in bytes) of the data block with the given index
+    size_t blob_size(size_t index) const;
+
+    /// Return the associated filename
+    const fs::path &filename() const { return m_mmap->filename(); }
+
+    /// Return a string representation
+    std::string to_string() const override;
+
+    MTS_DECLARE_CLASS()
+protected:
+    virtual ~SceneBundle();
+
+private:
+    ref<MemoryMappedFile> m_mmap;
+    std::string m_variant;
+    std::string m_root;
+    std::vector<Node> m_nodes;
+    std::vector<std::pair<uint64_t, uint64_t>> m_blobs;
+};
+
+/**
+ * \brief Sequentially writes a \ref SceneBundle to disk
+ *
+ * Data blocks are streamed to the file as they are added, the object graph is
+ * appended when \ref close() is called.
+ */
+class MTS_EXPORT_CORE SceneBundleWriter : public Object {
+public:
+    using Node = SceneBundle::Node;
+
+    /// Create a new bundle file for the given variant
+    SceneBundleWriter(const fs::path &filename, const std::string &variant);
+
+    /// Append a block of data to the bundle and return its index
+    uint32_t add_blob(const void *data, size_t size);
+
+    /**
+     * \brief Append an object to the scene graph
+     *
+     * Properties of type \c Object and \c AnimatedTransform are not
+     * supported. Pointer properties are assumed to reference an array of
+     * single precision values whose length is given by the \c size property
+     * of the same object (as created by the <tt>spectrum</tt> tag); their
+     * contents are stored as data blocks.
+     */
+    void add_node(const Node &node);
+
+    /// Write the scene graph and finalize the file
+    void close(const std::string &root);
+
+    /// Return the variant associated with the bundle
+    const std::string &variant() const { return m_variant; }
+
+    /// Return a string representation
+    std::string to_string() const override;
+
+    MTS_DECLARE_CLASS()
+protected:
+    virtual ~SceneBundleWriter();
+
+private:
+    ref<FileStream> m_stream;
+    std::string m_variant;
+    std::vector<std::pair<uint64_t, uint64_t>> m_blobs;
+    std::vector<Node> m_nodes;
+    bool m_closed = false;
+};
+
+NAMESPACE_END(mitsuba)
@@ -8,7 +8,7 @@ NAMESPACE_BEGIN(mitsuba)
 /** =======================================================================
  * @{ \name Data-driven warping techniques for two dimensions
  *
- * This file provides three different approaches for importance sampling 2D
+ * This file provides four different approaches for importance sampling 2D
  * functions discretized on a regular grid. All functionality is written in a
  * generic fashion and works in scalar mode, packet mode, and the just-in-time
  * compiler (in particular, the complete sampling procedure is designed to be
@@ -57,6 +57,11 @@ NAMESPACE_BEGIN(mitsuba)
  * version of \c Marginal2D may be beneficial when this method is not used as a
  * sampling scheme, but rather to generate very high-quality parameterizations.
  *
+ * Finally, \c Alias2D produces the same density as the latter two classes,
+ * but selects the bilinear patch using alias tables. Sampling and evaluation
+ * then have a constant cost irrespective of the resolution, at the price of a
+ * mapping with many discontinuities that cannot be inverted.
+ *
  * =======================================================================
  */
 
@@ -171,6 +176,12 @@ public:
         return { Point2u(col, row), (col_cdf_1 - col_cdf_0) * m_normalization, sample };
     }
 
+    /// Return the number of bytes used by the distribution's tables
+    size_t storage_bytes() const {
+        return (slices(m_data) + slices(m_marg_cdf) + slices(m_cond_cdf)) *
+               sizeof(ScalarFloat);
+    }
+
     std::string to_string() const {
         std::ostringstream oss;
         oss << "DiscreteDistribution2D" << "[" << std::endl
@@ -681,13 +692,20 @@ public:
         return warp::square_to_bilinear_pdf(v00, v10, v01, v11, pos);
     }
 
+    /// Return the number of bytes used by the hierarchy of sampling tables
+    size_t storage_bytes() const {
+        size_t size = 0;
+        for (size_t i = 0; i < m_levels.size(); ++i)
+            size += m_levels[i].size * m_slices;
+        return size * sizeof(ScalarFloat);
+    }
+
     std::string to_string() const {
         std::ostringstream oss;
         oss << "Hierarchical2D" << Dimension << "[" << std::endl
             << "  size = [" << m_levels[0].width << ", "
             << m_levels[0].size / m_levels[0].width << "]," << std::endl
             << "  levels = " << m_levels.size() << "," << std::endl;
-        size_t size = 0;
         if (Dimension > 0) {
             oss << "  param_size = [";
             for (size_t i = 0; i<Dimension; ++i) {
@@ -706,9 +724,7 @@ public:
         }
         oss << "  storage = { " << m_slices << " slice" << (m_slices > 1 ? "s" : "")
             << ", ";
-        for (size_t i = 0; i < m_levels.size(); ++i)
-            size += m_levels[i].size * m_slices;
-        oss << util::mem_string(size * sizeof(ScalarFloat)) << " }" << std::endl
+        oss << util::mem_string(storage_bytes()) << " }" << std::endl
             << "]";
         return oss.str();
     }
@@ -1035,6 +1051,58 @@ public:
         return warp::square_to_bilinear_pdf(v00, v10, v01, v11, pos);
     }
 
+    /**
+     * \brief Evaluate the densities of several distributions at position
+     * \c pos, which are parameterized by \c param if applicable.
+     *
+     * All distributions must have been constructed with the same \c size,
+     * \c param_res and \c param_values. This is more efficient than separate
+     * calls to \ref eval(), since the parameter and position interpolation
+     * weights are only computed once (e.g. for the channels of a color).
+     */
+    template <size_t N>
+    static Array<Float, N> eval(const std::array<Marginal2D, N> &distr,
+                                Point2f pos, const Float *param = nullptr,
+                                Mask active = true) {
+        MTS_MASK_ARGUMENT(active);
+        const Marginal2D &d0 = distr[0];
+
+        Float param_weight[2 * DimensionInt];
+        UInt32 slice_offset = d0.interpolate_weights(param, param_weight, active);
+
+        // Avoid issues with roundoff error
+        pos = clamp(pos, 0.f, 1.f);
+
+        // Compute linear interpolation weights
+        pos *= d0.m_inv_patch_size;
+        Point2u offset = min(Point2u(Point2i(pos)), d0.m_size - 2u);
+        pos -= Point2f(Point2i(offset));
+
+        UInt32 index = offset.x() + offset.y() * d0.m_size.x();
+
+        uint32_t size = hprod(d0.m_size);
+        if (Dimension != 0)
+            index += slice_offset * size;
+
+        Array<Float, N> result;
+        for (size_t i = 0; i < N; ++i) {
+            const ScalarFloat *data = distr[i].m_data.data();
+
+            Float v00 = d0.lookup(data, index,
+                                  size, param_weight, active),
+                  v10 = d0.lookup(data + 1, index,
+                                  size, param_weight, active),
+                  v01 = d0.lookup(data + d0.m_size.x(), index,
+                                  size, param_weight, active),
+                  v11 = d0.lookup(data + d0.m_size.x() + 1, index,
+                                  size, param_weight, active);
+
+            result[i] = warp::square_to_bilinear_pdf(v00, v10, v01, v11, pos);
+        }
+
+        return result;
+    }
+
     std::string to_string() const {
         std::ostringstream oss;
         oss << "Marginal2D" << Dimension << "[" << std::endl
@@ -1435,6 +1503,268 @@ protected:
     bool m_normalized;
 };
 
+/**
+ * \brief Implements an alias table-based sample warping scheme for 2D
+ * distributions with linear interpolation
+ *
+ * This class produces exactly the same probability density as
+ * <tt>Hierarchical2D<Float, 0></tt> and <tt>Marginal2D<Float, 0></tt>, i.e.
+ * a function on <tt>[0, 1]^2</tt> that linearly interpolates the input array.
+ *
+ * A bilinear patch is chosen using a marginal alias table over the rows of
+ * patches, followed by a conditional alias table over the patches of the
+ * chosen row. The fractional part of the uniform variates is then reused to
+ * sample a position within the patch. Both sampling and density evaluation
+ * therefore have a constant cost (a fixed number of gathers) irrespective of
+ * the resolution, while the hierarchical scheme performs
+ * <tt>log2(hmax(res))</tt> dependent lookups. The mapping is not bijective
+ * and has many discontinuities, hence no inverse is provided and it is a
+ * poor choice for structured point sets.
+ *
+ * Conditional distributions (with a dependence on additional parameters) are
+ * not supported.
+ */
+template <typename Float_>
+class Alias2D : public Distribution2D<Float_, 0> {
+public:
+    using Base = Distribution2D<Float_, 0>;
+
+    ENOKI_USING_TYPES(Base,
+        Float, UInt32, Int32, Mask, ScalarFloat, Point2i, Point2f,
+        Point2u, ScalarVector2f, ScalarVector2u, FloatStorage
+    )
+
+    ENOKI_USING_MEMBERS(Base, m_patch_size, m_inv_patch_size)
+
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    Alias2D() = default;
+
+    /**
+     * Construct an alias table-based sample warping scheme for floating
+     * point data of resolution \c size.
+     *
+     * If \c normalize is set to \c false, the implementation will not
+     * re-scale the distribution so that it integrates to \c 1. It can
+     * still be sampled (proportionally), but returned density values
+     * will reflect the unnormalized values.
+     */
+    Alias2D(const ScalarFloat *data, const ScalarVector2u &size,
+            bool normalize = true)
+        : Base(size, { }, { }), m_size(size) {
+
+        // The linear interpolant has 'size-1' patches
+        ScalarVector2u n_patches = size - 1;
+        m_max_patch_index = n_patches - 1;
+
+        // Integrate the linear interpolant over each patch
+        auto integrate_row = [&](uint32_t y, double *out) {
+            double row_sum = 0.0;
+            for (uint32_t x = 0; x < n_patches.x(); ++x) {
+                const ScalarFloat *in = data + x + y * size.x();
+                double avg = ((double) in[0] + (double) in[1] +
+                              (double) in[size.x()] + (double) in[size.x() + 1]) * .25;
+                if (out)
+                    out[x] = avg;
+                row_sum += avg;
+            }
+            return row_sum;
+        };
+
+        std::vector<double> row(n_patches.y()), patch(n_patches.x());
+        double sum = 0.0;
+        for (uint32_t y = 0; y < n_patches.y(); ++y) {
+            row[y] = integrate_row(y, nullptr);
+            sum += row[y];
+        }
+
+        if (!(sum > 0.0))
+            Throw("Alias2D: no probability mass found!");
+
+        // Copy and normalize the fine resolution interpolant
+        ScalarFloat scale = normalize ? (ScalarFloat) (hprod(n_patches) / sum) : 1.f;
+        m_data = empty<FloatStorage>(hprod(size));
+        m_data.managed();
+        for (uint32_t i = 0; i < hprod(size); ++i)
+            m_data.data()[i] = data[i] * scale;
+
+        m_marg_prob  = empty<FloatStorage>(n_patches.y());
+        m_marg_alias = empty<UInt32Storage>(n_patches.y());
+        m_cond_prob  = empty<FloatStorage>(hprod(n_patches));
+        m_cond_alias = empty<UInt32Storage>(hprod(n_patches));
+        m_marg_prob.managed();
+        m_marg_alias.managed();
+        m_cond_prob.managed();
+        m_cond_alias.managed();
+
+        build_table(row.data(), n_patches.y(), m_marg_prob.data(),
+                    m_marg_alias.data());
+
+        for (uint32_t y = 0; y < n_patches.y(); ++y) {
+            uint32_t offset = y * n_patches.x();
+            integrate_row(y, patch.data());
+            build_table(patch.data(), n_patches.x(), m_cond_prob.data() + offset,
+                        m_cond_alias.data() + offset);
+        }
+    }
+
+    /**
+     * \brief Given a uniformly distributed 2D sample, draw a sample from the
+     * distribution
+     *
+     * Returns the warped sample and associated probability density.
+     */
+    std::pair<Point2f, Float> sample(Point2f sample, Mask active = true) const {
+        MTS_MASK_ARGUMENT(active);
+
+        // Avoid issues with roundoff error
+        sample = clamp(sample, 0.f, math::OneMinusEpsilon<Float>);
+
+        // Select the row of patches, then the patch within the row
+        UInt32 row = sample_table(m_marg_prob, m_marg_alias, 0u,
+                                  m_max_patch_index.y() + 1, sample.y(), active),
+               col = sample_table(m_cond_prob, m_cond_alias,
+                                  row * (m_max_patch_index.x() + 1),
+                                  m_max_patch_index.x() + 1, sample.x(), active);
+
+        // Fetch corners of bilinear patch
+        UInt32 offset_i = col + row * m_size.x();
+
+        Float v00 = gather<Float>(m_data, offset_i, active),
+              v10 = gather<Float>(m_data, offset_i + 1, active),
+              v01 = gather<Float>(m_data, offset_i + m_size.x(), active),
+              v11 = gather<Float>(m_data, offset_i + m_size.x() + 1, active);
+
+        Float pdf;
+        std::tie(sample, pdf) =
+            warp::square_to_bilinear(v00, v10, v01, v11, sample);
+
+        return {
+            (Point2f(Point2i(Point2u(col, row))) + sample) * m_patch_size,
+            pdf
+        };
+    }
+
+    /// Evaluate the density at position \c pos
+    Float eval(Point2f pos, Mask active = true) const {
+        // Avoid issues with roundoff error
+        pos = clamp(pos, 0.f, 1.f);
+
+        // Compute linear interpolation weights
+        pos *= m_inv_patch_size;
+        Point2u offset = min(Point2u(Point2i(pos)), m_max_patch_index);
+        pos -= Point2f(Point2i(offset));
+
+        UInt32 offset_i = offset.x() + offset.y() * m_size.x();
+
+        Float v00 = gather<Float>(m_data, offset_i, active),
+              v10 = gather<Float>(m_data, offset_i + 1, active),
+              v01 = gather<Float>(m_data, offset_i + m_size.x(), active),
+              v11 = gather<Float>(m_data, offset_i + m_size.x() + 1, active);
+
+        return warp::square_to_bilinear_pdf(v00, v10, v01, v11, pos);
+    }
+
+    /// Return the number of bytes used by the interpolant and alias tables
+    size_t storage_bytes() const {
+        return (slices(m_data) + slices(m_marg_prob) + slices(m_cond_prob)) *
+                   sizeof(ScalarFloat) +
+               (slices(m_marg_alias) + slices(m_cond_alias)) * sizeof(uint32_t);
+    }
+
+    std::string to_string() const {
+        std::ostringstream oss;
+        oss << "Alias2D[" << std::endl
+            << "  size = " << m_size << "," << std::endl
+            << "  storage = " << util::mem_string(storage_bytes()) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+protected:
+    /**
+     * \brief Build an alias table for \c n nonnegative weights (Vose's method)
+     *
+     * Entry \c i is chosen with probability <tt>prob[i]</tt> when a uniform
+     * variate falls into its bucket, and redirects to <tt>alias[i]</tt>
+     * otherwise. All-zero weights produce a uniform table.
+     */
+    static void build_table(const double *weights, uint32_t n,
+                            ScalarFloat *prob, uint32_t *alias) {
+        double sum = 0.0;
+        for (uint32_t i = 0; i < n; ++i)
+            sum += weights[i];
+
+        std::vector<double> scaled(n);
+        std::vector<uint32_t> small, large;
+        for (uint32_t i = 0; i < n; ++i) {
+            scaled[i] = sum > 0.0 ? weights[i] * n / sum : 1.0;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+            prob[s] = (ScalarFloat) scaled[s];
+            alias[s] = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+
+        // Remaining entries are (up to roundoff) exactly full
+        for (uint32_t i : small) {
+            prob[i] = 1.f;
+            alias[i] = i;
+        }
+        for (uint32_t i : large) {
+            prob[i] = 1.f;
+            alias[i] = i;
+        }
+    }
+
+    /// Sample an alias table and re-uniformize the variate \c sample
+    MTS_INLINE UInt32 sample_table(const FloatStorage &prob,
+                                   const UInt32Storage &alias,
+                                   const UInt32 &offset, uint32_t n,
+                                   Float &sample, const Mask &active) const {
+        sample *= (ScalarFloat) n;
+        UInt32 index = min(UInt32(Int32(sample)), n - 1);
+        sample -= Float(Int32(index));
+
+        Float q = gather<Float>(prob, offset + index, active);
+        UInt32 a = gather<UInt32>(alias, offset + index, active);
+
+        // 'q > sample >= 0' for lanes that keep their entry, '1 - q > sample - q' otherwise
+        Mask use_alias = sample >= q;
+        sample = clamp(select(use_alias, sample - q, sample) /
+                           select(use_alias, 1.f - q, q),
+                       0.f, math::OneMinusEpsilon<Float>);
+
+        return select(use_alias, a, index);
+    }
+
+protected:
+    /// Resolution of the discretized density function
+    ScalarVector2u m_size;
+
+    /// Number of bilinear patches in the X/Y dimension - 1
+    ScalarVector2u m_max_patch_index;
+
+    /// Normalized values of the linear interpolant
+    FloatStorage m_data;
+
+    /// Marginal alias table over rows of patches
+    FloatStorage m_marg_prob;
+    UInt32Storage m_marg_alias;
+
+    /// Conditional alias tables over the patches of each row
+    FloatStorage m_cond_prob;
+    UInt32Storage m_cond_alias;
+};
+
 //! @}
 // =======================================================================
 
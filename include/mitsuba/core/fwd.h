@@ -27,6 +27,7 @@ class ArgParser;
 class Bitmap;
 class DefaultFormatter;
 class DummyStream;
+class EXRScanlineWriter;
 class FileResolver;
 class FileStream;
 class Formatter;
@@ -35,6 +36,8 @@ class MemoryStream;
 class Mutex;
 class PluginManager;
 class Properties;
+class SceneBundle;
+class SceneBundleWriter;
 class ScopedThreadEnvironment;
 class Stream;
 class StreamAppender;
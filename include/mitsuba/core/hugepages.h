@@ -0,0 +1,155 @@
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <memory>
+#include <type_traits>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Memory buffer for large read-mostly data (acceleration structures,
+ * mesh buffers, textures, volumes) that is backed by huge pages if possible
+ *
+ * Random accesses into such buffers otherwise cause many TLB misses with the
+ * default 4 KiB pages. When the large-buffer policy is enabled (see \ref
+ * set_enabled()), allocations of at least \ref HugePageSize bytes are first
+ * attempted using explicitly reserved huge pages (\c hugetlbfs). If none are
+ * available, the buffer is aligned to a huge page boundary and marked for
+ * transparent huge pages (<tt>madvise(MADV_HUGEPAGE)</tt>). Smaller buffers,
+ * and all buffers on platforms other than Linux, use regular heap memory.
+ *
+ * Besides the reference-counted buffer, which is typically used to keep
+ * the memory referenced by a <tt>DynamicBuffer</tt> alive, the static
+ * functions \ref alloc() and \ref free() expose the same policy for
+ * arrays owned by other data structures (see \ref HugePageArray).
+ */
+class MTS_EXPORT_CORE HugePageBuffer : public Object {
+public:
+    /// Size of a (transparent) huge page on the supported platforms
+    static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+    /// Type of memory backing an allocation
+    enum class Backing : uint32_t {
+        /// Regular heap memory
+        Heap,
+
+        /// Huge page aligned memory marked for transparent huge pages
+        Transparent,
+
+        /// Explicitly reserved huge pages
+        HugeTLB
+    };
+
+    /// Allocate a buffer of the given size (in bytes) according to the policy
+    HugePageBuffer(size_t size);
+
+    /// Return a pointer to the buffer contents
+    void *data() { return m_data; }
+
+    /// Return a pointer to the buffer contents (const version)
+    const void *data() const { return m_data; }
+
+    /// Return the size of the buffer in bytes
+    size_t size() const { return m_size; }
+
+    /// Return the type of memory backing the buffer
+    Backing backing() const;
+
+    /// Return a string representation
+    std::string to_string() const override;
+
+    // =============================================================
+    //! @{ \name Allocation policy
+    // =============================================================
+
+    /**
+     * \brief Is the large-buffer policy enabled?
+     *
+     * It is disabled by default and can be enabled via \ref set_enabled(),
+     * the \c --huge-pages command line flag, or by setting the
+     * \c MTS_HUGEPAGES environment variable to \c 1. The setting only
+     * affects buffers that are allocated afterwards.
+     */
+    static bool enabled();
+
+    /// Enable or disable the large-buffer policy
+    static void set_enabled(bool enabled);
+
+    /**
+     * \brief Allocate \c size bytes according to the policy
+     *
+     * The returned memory is aligned to at least 64 bytes and must be
+     * released using \ref free().
+     */
+    static void *alloc(size_t size);
+
+    /// Release memory obtained from \ref alloc()
+    static void free(void *ptr);
+
+    /// Return the type of memory backing an allocation obtained from \ref alloc()
+    static Backing backing(const void *ptr);
+
+    /**
+     * \brief Copy a large block of data into a new buffer
+     *
+     * Returns \c nullptr if the policy is disabled or the data is smaller
+     * than \ref HugePageSize, in which case the caller should keep using
+     * its regular storage.
+     */
+    static ref<HugePageBuffer> copy_large(const void *ptr, size_t size);
+
+    /// Bytes of live allocations, broken down by the type of memory backing them
+    struct Usage {
+        /// Heap memory (policy disabled or small allocations)
+        size_t heap = 0;
+
+        /// Memory marked for transparent huge pages
+        size_t transparent = 0;
+
+        /// Part of \c transparent that the kernel actually backs by huge pages
+        size_t transparent_resident = 0;
+
+        /// Explicitly reserved huge pages
+        size_t hugetlb = 0;
+    };
+
+    /**
+     * \brief Return the memory usage of all live allocations
+     *
+     * On Linux, \c transparent_resident is determined by scanning
+     * <tt>/proc/self/smaps</tt>, which is relatively expensive.
+     */
+    static Usage usage();
+
+    /// Return a human-readable summary of \ref usage()
+    static std::string usage_report();
+
+    //! @}
+    // =============================================================
+
+    MTS_DECLARE_CLASS()
+protected:
+    /// Release the buffer
+    virtual ~HugePageBuffer();
+
+private:
+    void *m_data;
+    size_t m_size;
+};
+
+/// Deleter of arrays allocated using \ref HugePageBuffer::alloc()
+template <typename T> struct HugePageDeleter {
+    void operator()(T *ptr) const { HugePageBuffer::free(ptr); }
+};
+
+/// Owning pointer to an array that follows the large-buffer policy
+template <typename T> using HugePageArray = std::unique_ptr<T[], HugePageDeleter<T>>;
+
+/// Allocate an (uninitialized) array of \c count elements according to the large-buffer policy
+template <typename T> HugePageArray<T> huge_page_array(size_t count) {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "huge_page_array(): unsupported element type!");
+    return HugePageArray<T>((T *) HugePageBuffer::alloc(count * sizeof(T)));
+}
+
+NAMESPACE_END(mitsuba)
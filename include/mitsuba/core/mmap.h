@@ -42,6 +42,16 @@ public:
     /// Return whether the mapped memory region can be modified
     bool can_write() const;
 
+    /**
+     * \brief Ask the operating system to asynchronously read a part of the
+     * file into memory
+     *
+     * This is only a hint: the function returns immediately, and accesses to
+     * pages that haven't been loaded yet simply block as usual. It does
+     * nothing on platforms without a suitable API.
+     */
+    void prefetch(size_t offset = 0, size_t size = (size_t) -1) const;
+
     /// Return a string representation
     std::string to_string() const override;
 
@@ -55,6 +65,14 @@ public:
      */
     static ref<MemoryMappedFile> create_temporary(size_t size);
 
+    /**
+     * \brief Map the specified file into memory using copy-on-write semantics
+     *
+     * The mapped region can be modified, but changes remain private to the
+     * process and are never written back to the file.
+     */
+    static ref<MemoryMappedFile> map_private(const fs::path &filename);
+
     MTS_DECLARE_CLASS()
 protected:
     /// Internal constructor
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <mitsuba/mitsuba.h>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+NAMESPACE_BEGIN(numa)
+
+/**
+ * \brief Is the NUMA mode enabled?
+ *
+ * In NUMA mode, render worker threads are pinned to the processors of a
+ * NUMA node in round-robin order, read-mostly scene data (kd-tree, mesh
+ * buffers) is interleaved across all nodes, and sampling integrators
+ * accumulate samples into one image buffer per node. The mode is disabled
+ * by default and can be enabled via \ref set_enabled(), the \c --numa
+ * command line flag, or by setting the \c MTS_NUMA environment variable
+ * to \c 1.
+ */
+extern MTS_EXPORT_CORE bool enabled();
+
+/**
+ * \brief Enable or disable the NUMA mode
+ *
+ * Worker threads are pinned when they join the task scheduler, hence this
+ * function should be called before the scheduler is initialized (or the
+ * thread count should be changed afterwards). Scene data is placed when a
+ * scene is loaded.
+ */
+extern MTS_EXPORT_CORE void set_enabled(bool enabled);
+
+/// Number of NUMA nodes of the machine (1 on systems without NUMA support)
+extern MTS_EXPORT_CORE size_t node_count();
+
+/// Logical processors that belong to the NUMA node \c node
+extern MTS_EXPORT_CORE std::vector<int> node_cpus(size_t node);
+
+/// NUMA node of the processor that currently executes the calling thread
+extern MTS_EXPORT_CORE size_t current_node();
+
+/**
+ * \brief NUMA node of the calling thread
+ *
+ * Returns the node that the thread was pinned to using \ref pin_thread(),
+ * or \ref current_node() otherwise.
+ */
+extern MTS_EXPORT_CORE size_t thread_node();
+
+/**
+ * \brief Restrict the calling thread to the processors of a NUMA node
+ *
+ * A value of <tt>-1</tt> for \c node removes a previous restriction.
+ * Returns \c false if the affinity could not be changed.
+ */
+extern MTS_EXPORT_CORE bool pin_thread(int node);
+
+/**
+ * \brief Distribute the pages of a memory region across all NUMA nodes
+ *
+ * Pages that were already touched are migrated. This is intended for large
+ * read-mostly data structures that are accessed by all threads. Only pages
+ * that lie entirely within the region are affected. Returns \c false on
+ * systems without NUMA support, if the region doesn't contain a whole page,
+ * or if the kernel rejected the request (e.g. for file-backed mappings).
+ */
+extern MTS_EXPORT_CORE bool interleave(const void *ptr, size_t size);
+
+NAMESPACE_END(numa)
+NAMESPACE_END(mitsuba)
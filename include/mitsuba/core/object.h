@@ -1,12 +1,16 @@
 #pragma once
 
 #include <atomic>
+#include <map>
 #include <stdexcept>
 #include <vector>
 #include <mitsuba/core/class.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Maps a descriptive category (e.g. "vertex data") to a size in bytes
+using MemoryUsage = std::map<std::string, size_t>;
+
 /**
  * \brief Object base class with builtin reference counting
  *
@@ -95,6 +99,35 @@ public:
      */
     virtual void parameters_changed(const std::vector<std::string> &/*keys*/ = {});
 
+    /**
+     * \brief Return the amount of memory held by this instance
+     *
+     * The result is broken down into descriptive categories (e.g. "kd-tree
+     * nodes", "vertex data") and only accounts for large allocations owned
+     * directly by this object. Referenced child objects report their own
+     * usage and are visited via \ref traverse() when computing scene-wide
+     * statistics using \ref memory_statistics().
+     *
+     * \remark The default implementation returns an empty map.
+     */
+    virtual MemoryUsage memory_usage() const;
+
+    /**
+     * \brief Store the decoded data of this instance in a scene bundle
+     *
+     * Objects that load bulk data from external files (e.g. meshes or
+     * bitmaps) can implement this function to append the decoded data to
+     * \c writer and to rewrite their construction parameters \c props, so
+     * that an equivalent object can later be created from the bundle
+     * without accessing the original files.
+     *
+     * \return \c true if \c props was rewritten to reference data stored in
+     * the bundle. The default implementation returns \c false.
+     *
+     * \sa SceneBundle
+     */
+    virtual bool write_bundle(SceneBundleWriter *writer, Properties &props) const;
+
     /**
      * \brief Return a \ref Class instance containing run-time type information
      * about this Object
@@ -286,6 +319,45 @@ protected:
                                     void *ptr) = 0;
 };
 
+/// Memory usage of a single object, as collected by \ref memory_statistics()
+struct MemoryRecord {
+    /// Path of the object within the traversed object graph
+    std::string name;
+    /// Class name of the object
+    std::string class_name;
+    /// Per-category memory usage in bytes
+    MemoryUsage usage;
+
+    /// Return the total number of bytes over all categories
+    size_t total() const {
+        size_t result = 0;
+        for (const auto &kv : usage)
+            result += kv.second;
+        return result;
+    }
+};
+
+/**
+ * \brief Recursively gather memory usage statistics of an object graph
+ *
+ * Visits \c root and all objects reachable from it via \ref
+ * Object::traverse(). Each object is visited once, even if it is referenced
+ * multiple times. Objects that report no memory usage are omitted, and the
+ * records are sorted by decreasing total size.
+ */
+extern MTS_EXPORT_CORE std::vector<MemoryRecord> memory_statistics(Object *root);
+
+/**
+ * \brief Return a human-readable table summarizing the output of \ref
+ * memory_statistics()
+ *
+ * \param max_objects
+ *     Maximum number of objects that are listed individually. The remaining
+ *     ones are combined into a single line. Set to 0 to list all objects.
+ */
+extern MTS_EXPORT_CORE std::string
+memory_report(const std::vector<MemoryRecord> &records, size_t max_objects = 20);
+
 /// Prints the canonical string representation of an object instance
 MTS_EXPORT_CORE std::ostream& operator<<(std::ostream &os, const Object *object);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mitsuba/core/object.h>
+#include <mitsuba/core/distr_1d.h>
 #include <mitsuba/core/math.h>
 #include <mitsuba/core/logger.h>
 
@@ -64,6 +65,38 @@ public:
         return gather<Float>(m_values.data(), index, active);
     }
 
+    /**
+     * \brief Importance sample the discretized filter along one dimension
+     *
+     * Generates an offset in <tt>[-radius, radius]</tt> with a density
+     * proportional to the absolute value of the filter. This is used for
+     * filter importance sampling, where each sample only contributes to the
+     * pixel it was generated for.
+     *
+     * \return
+     *    The sampled offset and the associated sample weight. The latter is
+     *    the sign of the filter at the sampled offset, since the constant
+     *    normalization factor cancels when dividing by the accumulated
+     *    weight of a pixel.
+     */
+    std::pair<Float, Float> sample(Float sample, Mask active = true) const {
+        // The filter is symmetric: use the first bit of the sample to choose a side
+        Mask negative = sample < .5f;
+        sample = select(negative, 2.f * sample, 2.f * sample - 1.f);
+
+        auto [index, sample_2] = m_distr.sample_reuse(sample, active);
+        Float x = (Float(index) + sample_2) * (1.f / m_scale_factor);
+
+        Float value;
+        if constexpr (!is_cuda_array_v<Float>)
+            value = gather<Float>(m_values.data(), index, active);
+        else
+            value = eval(x, active);
+
+        return { select(negative, -x, x),
+                 select(value < 0.f, Float(-1.f), Float(1.f)) };
+    }
+
     MTS_DECLARE_CLASS()
 protected:
     /// Create a new reconstruction filter
@@ -79,6 +112,9 @@ protected:
     ScalarFloat m_radius, m_scale_factor;
     std::vector<ScalarFloat> m_values;
     uint32_t m_border_size;
+
+    /// Distribution proportional to the absolute value of \ref m_values
+    DiscreteDistribution<Float> m_distr;
 };
 
 /**
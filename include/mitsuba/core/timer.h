@@ -3,6 +3,12 @@
 #include <mitsuba/core/util.h>
 #include <chrono>
 
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
 NAMESPACE_BEGIN(mitsuba)
 
 class Timer {
@@ -42,4 +48,25 @@ private:
     std::chrono::system_clock::time_point start;
 };
 
+/**
+ * \brief Read the processor's cycle counter
+ *
+ * Returns the time stamp counter on x86 and the virtual counter on ARM64,
+ * which are cheap enough to time individual samples. Other platforms fall
+ * back to a nanosecond clock. Values are only meaningful as differences
+ * taken on the same thread.
+ */
+inline uint64_t cycle_counter() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return (uint64_t) __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
 NAMESPACE_END(mitsuba)
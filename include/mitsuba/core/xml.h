@@ -40,6 +40,44 @@ extern MTS_EXPORT_CORE ref<Object> load_string(const std::string &string,
                                                const std::string &variant,
                                                ParameterList parameters = ParameterList());
 
+/**
+ * \brief Parse a Mitsuba scene from an XML file and store it in a scene bundle
+ *
+ * The scene is fully loaded once so that meshes and textures can store their
+ * decoded data in the bundle (see \ref SceneBundle). The bundle can then be
+ * loaded using \ref load_bundle() without parsing the XML description or
+ * decoding any of the input files.
+ *
+ * \param path
+ *     Filename of the scene XML file
+ *
+ * \param bundle_path
+ *     Filename of the bundle that should be created (usually with the
+ *     <tt>.mtsb</tt> extension)
+ *
+ * \param variant
+ *     Specifies the variant of plugins to instantiate (e.g. "scalar_rgb").
+ *     The bundle can only be loaded using the same variant.
+ *
+ * \param parameters
+ *     Optional list of parameters that can be referenced as <tt>$varname</tt>
+ *     in the scene.
+ */
+extern MTS_EXPORT_CORE void write_bundle(const fs::path &path,
+                                         const fs::path &bundle_path,
+                                         const std::string &variant,
+                                         ParameterList parameters = ParameterList());
+
+/**
+ * \brief Load a Mitsuba scene from a scene bundle created by \ref write_bundle()
+ *
+ * Meshes and textures map their data from the bundle file instead of loading
+ * it from the original input files. \ref load_file() automatically forwards
+ * to this function when given a filename with the <tt>.mtsb</tt> extension.
+ */
+extern MTS_EXPORT_CORE ref<Object> load_bundle(const fs::path &path,
+                                               const std::string &variant);
+
 
 
 NAMESPACE_BEGIN(detail)
@@ -81,6 +81,74 @@ static const char *__doc_get_shape_descr_idx =
 R"doc(Retrieve index of custom shape descriptor in the list above for a
 given shape)doc";
 
+static const char *__doc_mitsuba_Alias2D =
+R"doc(Implements an alias table-based sample warping scheme for 2D
+distributions with linear interpolation
+
+This class produces exactly the same probability density as
+<tt>Hierarchical2D<Float, 0></tt> and <tt>Marginal2D<Float, 0></tt>,
+i.e. a function on <tt>[0, 1]^2</tt> that linearly interpolates the
+input array.
+
+A bilinear patch is chosen using a marginal alias table over the rows
+of patches, followed by a conditional alias table over the patches of
+the chosen row. The fractional part of the uniform variates is then
+reused to sample a position within the patch. Both sampling and
+density evaluation therefore have a constant cost (a fixed number of
+gathers) irrespective of the resolution, while the hierarchical scheme
+performs <tt>log2(hmax(res))</tt> dependent lookups. The mapping is
+not bijective and has many discontinuities, hence no inverse is
+provided and it is a poor choice for structured point sets.
+
+Conditional distributions (with a dependence on additional parameters)
+are not supported.)doc";
+
+static const char *__doc_mitsuba_Alias2D_Alias2D = R"doc()doc";
+
+static const char *__doc_mitsuba_Alias2D_Alias2D_2 =
+R"doc(Construct an alias table-based sample warping scheme for floating
+point data of resolution ``size``.
+
+If ``normalize`` is set to ``False``, the implementation will not
+re-scale the distribution so that it integrates to ``1``. It can still
+be sampled (proportionally), but returned density values will reflect
+the unnormalized values.)doc";
+
+static const char *__doc_mitsuba_Alias2D_build_table =
+R"doc(Build an alias table for ``n`` nonnegative weights (Vose's method)
+
+Entry ``i`` is chosen with probability <tt>prob[i]</tt> when a uniform
+variate falls into its bucket, and redirects to <tt>alias[i]</tt>
+otherwise. All-zero weights produce a uniform table.)doc";
+
+static const char *__doc_mitsuba_Alias2D_eval = R"doc(Evaluate the density at position ``pos``)doc";
+
+static const char *__doc_mitsuba_Alias2D_m_cond_alias = R"doc()doc";
+
+static const char *__doc_mitsuba_Alias2D_m_cond_prob = R"doc(Conditional alias tables over the patches of each row)doc";
+
+static const char *__doc_mitsuba_Alias2D_m_data = R"doc(Normalized values of the linear interpolant)doc";
+
+static const char *__doc_mitsuba_Alias2D_m_marg_alias = R"doc()doc";
+
+static const char *__doc_mitsuba_Alias2D_m_marg_prob = R"doc(Marginal alias table over rows of patches)doc";
+
+static const char *__doc_mitsuba_Alias2D_m_max_patch_index = R"doc(Number of bilinear patches in the X/Y dimension - 1)doc";
+
+static const char *__doc_mitsuba_Alias2D_m_size = R"doc(Resolution of the discretized density function)doc";
+
+static const char *__doc_mitsuba_Alias2D_sample =
+R"doc(Given a uniformly distributed 2D sample, draw a sample from the
+distribution
+
+Returns the warped sample and associated probability density.)doc";
+
+static const char *__doc_mitsuba_Alias2D_sample_table = R"doc(Sample an alias table and re-uniformize the variate ``sample``)doc";
+
+static const char *__doc_mitsuba_Alias2D_storage_bytes = R"doc(Return the number of bytes used by the interpolant and alias tables)doc";
+
+static const char *__doc_mitsuba_Alias2D_to_string = R"doc()doc";
+
 static const char *__doc_mitsuba_AnimatedTransform =
 R"doc(Encapsulates an animated 4x4 homogeneous coordinate transformation
 
@@ -668,6 +736,47 @@ static const char *__doc_mitsuba_Bitmap_Bitmap_4 = R"doc(Copy constructor (copie
 
 static const char *__doc_mitsuba_Bitmap_Bitmap_5 = R"doc(Move constructor)doc";
 
+static const char *__doc_mitsuba_Bitmap_EXRCompression = R"doc(Compression schemes supported by the OpenEXR writer)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_B44 = R"doc(Lossy compression of 4x4 pixel blocks of ``float16`` channels)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_B44A = R"doc(Like B44, but flat areas are compressed more aggressively)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_DWAA = R"doc(Lossy DCT-based compression of blocks of 32 scanlines)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_DWAB = R"doc(Lossy DCT-based compression of blocks of 256 scanlines)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_None = R"doc(No compression)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_PIZ = R"doc(Wavelet compression (lossless, the default))doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_PXR24 = R"doc(Lossy 24-bit float compression)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_RLE = R"doc(Run-length encoding (lossless))doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_ZIP = R"doc(Zlib compression of blocks of 16 scanlines (lossless))doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRCompression_ZIPS = R"doc(Zlib compression of single scanlines (lossless))doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRPart =
+R"doc(Part of a multi-part OpenEXR file
+
+Used by write_openexr_parts() to group the channels of a bitmap (e.g.
+the beauty pass and the AOVs of a render) into separate parts that
+are compressed with different settings.)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRPart_channels =
+R"doc(Names of the channels stored in this part
+
+An empty list selects all channels that are not claimed by another
+part.)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRPart_compression = R"doc(Compression scheme of this part)doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRPart_compression_level = R"doc(Quality level of the lossy DWA compressors (higher values are more lossy))doc";
+
+static const char *__doc_mitsuba_Bitmap_EXRPart_name = R"doc(Name of the part (required for files with more than one part))doc";
+
 static const char *__doc_mitsuba_Bitmap_FileFormat = R"doc(Supported image file formats)doc";
 
 static const char *__doc_mitsuba_Bitmap_FileFormat_Auto =
@@ -705,9 +814,12 @@ supported RGB/Luminance/Alpha combinations
 
 * Loading and saving of string-valued metadata fields
 
+* Saving of multi-part and tiled images (see write_openexr_parts())
+and loading of their channels
+
 The following is *not* supported:
 
-* Saving of tiled images, tile-based read access
+* Tile-based read access
 
 * Display windows that are different than the data window
 
@@ -1095,6 +1207,28 @@ static const char *__doc_mitsuba_Bitmap_write_jpeg = R"doc(Save a file using the
 
 static const char *__doc_mitsuba_Bitmap_write_openexr = R"doc(Write a file using the OpenEXR file format)doc";
 
+static const char *__doc_mitsuba_Bitmap_write_openexr_parts =
+R"doc(Write the bitmap to a multi-part OpenEXR file
+
+Each entry of ``parts`` produces one part of the file containing the
+listed channels, which allows choosing a lossy compressor for the
+beauty pass and a lossless one for IDs or depth. Channels that are not
+selected by any part are not written. Parts are encoded one after the
+other, and the chunks of each part are compressed in parallel on the
+OpenEXR thread pool.
+
+Parameter ``stream``:
+    Target stream that will receive the encoded output
+
+Parameter ``parts``:
+    Description of the parts of the file
+
+Parameter ``tile_size``:
+    When nonzero, the parts are stored as tiles of the given size
+    instead of scanlines.)doc";
+
+static const char *__doc_mitsuba_Bitmap_write_openexr_parts_2 = R"doc(Write the bitmap to a multi-part OpenEXR file (see write_openexr_parts()))doc";
+
 static const char *__doc_mitsuba_Bitmap_write_pfm = R"doc(Save a file using the PFM file format)doc";
 
 static const char *__doc_mitsuba_Bitmap_write_png = R"doc(Save a file using the PNG file format)doc";
@@ -1908,6 +2042,58 @@ static const char *__doc_mitsuba_EOFException_gcount = R"doc()doc";
 
 static const char *__doc_mitsuba_EOFException_m_gcount = R"doc()doc";
 
+static const char *__doc_mitsuba_EXRScanlineWriter =
+R"doc(Writes a scanline-based OpenEXR file in strips of consecutive rows
+
+This is useful for images that are too large to be held in memory at
+once, such as very high resolution renderings that are developed while
+the rest of the image is still being rendered. The rows must be
+provided from top to bottom. Each call to write() compresses the
+complete chunks of the strip on the OpenEXR thread pool; the remainder
+is buffered until the next strip arrives.)doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_EXRScanlineWriter =
+R"doc(Create a file and write its header
+
+Parameter ``stream``:
+    Target stream that will receive the encoded output
+
+Parameter ``format``:
+    Bitmap whose pixel format, channels, width, and metadata define
+    the layout of the file. Its height and contents are ignored, hence
+    the first strip can be passed here.
+
+Parameter ``height``:
+    Total number of rows of the image
+
+Parameter ``parts``:
+    Parts of the file (see Bitmap::write_openexr_parts()). Tiled
+    output is not supported.)doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_EXRScanlineWriterPrivate = R"doc()doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_class = R"doc()doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_d = R"doc()doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_height = R"doc(Return the total number of rows of the image)doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_m_height = R"doc()doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_m_rows_written = R"doc()doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_m_stream = R"doc()doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_m_struct = R"doc()doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_m_width = R"doc()doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_rows_written = R"doc(Return the number of rows that have been written so far)doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_to_string = R"doc(Return a human-readable summary)doc";
+
+static const char *__doc_mitsuba_EXRScanlineWriter_write = R"doc(Append the rows of ``strip``, which must have the layout of the file)doc";
+
 static const char *__doc_mitsuba_Emitter = R"doc()doc";
 
 static const char *__doc_mitsuba_Emitter_2 = R"doc()doc";
@@ -2329,6 +2515,15 @@ safe.)doc";
 
 static const char *__doc_mitsuba_Film_reconstruction_filter = R"doc(Return the image reconstruction filter (const version))doc";
 
+static const char *__doc_mitsuba_Film_rows_finished =
+R"doc(Notify the film that all image blocks above row ``y`` (in sensor
+coordinates) have been merged using put()
+
+This promises that the blocks of all further calls to put() start at
+row ``y`` or below. A streaming film can then develop and write the
+rows that lie outside of the filter footprint of these blocks. The
+default implementation does nothing.)doc";
+
 static const char *__doc_mitsuba_Film_set_crop_window = R"doc(Set the size and offset of the crop window.)doc";
 
 static const char *__doc_mitsuba_Film_set_destination_file = R"doc(Set the target filename (with or without extension))doc";
@@ -2337,6 +2532,14 @@ static const char *__doc_mitsuba_Film_size =
 R"doc(Ignoring the crop window, return the resolution of the underlying
 sensor)doc";
 
+static const char *__doc_mitsuba_Film_streaming =
+R"doc(Does the film stream finished rows to its output file?
+
+Such films only keep the rows that can still receive samples in
+memory. Integrators should then generate image blocks in scanline
+order (see Spiral::Order) and report completed rows using
+rows_finished(). The full image is not available via bitmap().)doc";
+
 static const char *__doc_mitsuba_Film_to_string = R"doc(//! @})doc";
 
 static const char *__doc_mitsuba_FilterBoundaryCondition =
@@ -2618,6 +2821,100 @@ static const char *__doc_mitsuba_HitComputeFlags_dNSdUV = R"doc(Compute the shad
 
 static const char *__doc_mitsuba_HitComputeFlags_dPdUV = R"doc(Compute position partials wrt. UV coordinates)doc";
 
+static const char *__doc_mitsuba_HugePageBuffer =
+R"doc(Memory buffer for large read-mostly data (acceleration structures,
+mesh buffers, textures, volumes) that is backed by huge pages if
+possible
+
+Random accesses into such buffers otherwise cause many TLB misses with
+the default 4 KiB pages. When the large-buffer policy is enabled (see
+set_enabled()), allocations of at least HugePageSize bytes are first
+attempted using explicitly reserved huge pages (``hugetlbfs``). If none
+are available, the buffer is aligned to a huge page boundary and marked
+for transparent huge pages (<tt>madvise(MADV_HUGEPAGE)</tt>). Smaller
+buffers, and all buffers on platforms other than Linux, use regular
+heap memory.
+
+Besides the reference-counted buffer, which is typically used to keep
+the memory referenced by a <tt>DynamicBuffer</tt> alive, the static
+functions alloc() and free() expose the same policy for arrays owned
+by other data structures (see HugePageArray).)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_Backing = R"doc(Type of memory backing an allocation)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_Backing_Heap = R"doc(Regular heap memory)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_Backing_HugeTLB = R"doc(Explicitly reserved huge pages)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_Backing_Transparent = R"doc(Huge page aligned memory marked for transparent huge pages)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_HugePageBuffer = R"doc(Allocate a buffer of the given size (in bytes) according to the policy)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_Usage = R"doc(Bytes of live allocations, broken down by the type of memory backing them)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_Usage_heap = R"doc(Heap memory (policy disabled or small allocations))doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_Usage_hugetlb = R"doc(Explicitly reserved huge pages)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_Usage_transparent = R"doc(Memory marked for transparent huge pages)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_Usage_transparent_resident = R"doc(Part of ``transparent`` that the kernel actually backs by huge pages)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_alloc =
+R"doc(Allocate ``size`` bytes according to the policy
+
+The returned memory is aligned to at least 64 bytes and must be
+released using free().)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_backing = R"doc(Return the type of memory backing the buffer)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_backing_2 = R"doc(Return the type of memory backing an allocation obtained from alloc())doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_class = R"doc()doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_copy_large =
+R"doc(Copy a large block of data into a new buffer
+
+Returns ``nullptr`` if the policy is disabled or the data is smaller
+than HugePageSize, in which case the caller should keep using its
+regular storage.)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_data = R"doc(Return a pointer to the buffer contents)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_data_2 = R"doc(Return a pointer to the buffer contents (const version))doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_enabled =
+R"doc(Is the large-buffer policy enabled?
+
+It is disabled by default and can be enabled via set_enabled(), the
+``--huge-pages`` command line flag, or by setting the
+``MTS_HUGEPAGES`` environment variable to ``1``. The setting only
+affects buffers that are allocated afterwards.)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_free = R"doc(Release memory obtained from alloc())doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_m_data = R"doc()doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_m_size = R"doc()doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_set_enabled = R"doc(Enable or disable the large-buffer policy)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_size = R"doc(Return the size of the buffer in bytes)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_to_string = R"doc(Return a string representation)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_usage =
+R"doc(Return the memory usage of all live allocations
+
+On Linux, ``transparent_resident`` is determined by scanning
+<tt>/proc/self/smaps</tt>, which is relatively expensive.)doc";
+
+static const char *__doc_mitsuba_HugePageBuffer_usage_report = R"doc(Return a human-readable summary of usage())doc";
+
+static const char *__doc_mitsuba_HugePageDeleter = R"doc(Deleter of arrays allocated using HugePageBuffer::alloc())doc";
+
+static const char *__doc_mitsuba_HugePageDeleter_operator_call = R"doc()doc";
+
 static const char *__doc_mitsuba_IOREntry = R"doc()doc";
 
 static const char *__doc_mitsuba_IOREntry_name = R"doc()doc";
@@ -2972,6 +3269,22 @@ time. If not, the application is terminated via ``abort()``.)doc";
 
 static const char *__doc_mitsuba_Jit_static_shutdown = R"doc(Release all memory used by JIT-compiled routines)doc";
 
+static const char *__doc_mitsuba_KDBuildQuality =
+R"doc(Build quality presets of ShapeKDTree
+
+Each preset selects the number of Min-Max bins, whether primitives are
+clipped (perfect splits) and the threshold at which the builder
+switches to the O(N log N) method. Parameters that were specified
+explicitly always take precedence over the preset.)doc";
+
+static const char *__doc_mitsuba_KDBuildQuality_Auto = R"doc(Pick the preset minimizing the predicted build and ray tracing time)doc";
+
+static const char *__doc_mitsuba_KDBuildQuality_Balanced = R"doc(Default parameters of the builder)doc";
+
+static const char *__doc_mitsuba_KDBuildQuality_Fast = R"doc(Coarse binning without primitive clipping (for previews))doc";
+
+static const char *__doc_mitsuba_KDBuildQuality_High = R"doc(Finer binning and the O(N log N) builder for large subtrees)doc";
+
 static const char *__doc_mitsuba_LogLevel = R"doc(Available Log message types)doc";
 
 static const char *__doc_mitsuba_LogLevel_Debug = R"doc(< Debug message, usually turned off)doc";
@@ -3246,8 +3559,41 @@ depend on the wavelength.
 Returns:
     This method returns a pair of (Transmittance, PDF).)doc";
 
+static const char *__doc_mitsuba_Medium_eval_tr_residual_ratio =
+R"doc(Estimate the transmittance along a ray segment using residual ratio
+tracking [Novák et al. 2014]
+
+The transmittance of the control extinction (see
+get_control_extinction()) is evaluated analytically, and only the
+residual is estimated using ratio tracking. Tentative collisions are
+sampled proportionally to the residual majorant of the given channel.
+Unlike delta tracking, the estimate is not binary, and the number of
+medium lookups decreases as the control extinction becomes tighter.
+
+Parameter ``ray``:
+    Ray segment within this medium (between ``ray.mint`` and
+    ``ray.maxt``)
+
+Parameter ``sampler``:
+    Sampler used to generate the tentative collisions
+
+Parameter ``channel``:
+    The channel according to which collisions are sampled. This
+    argument is only used when rendering in RGB modes.
+
+Returns:
+    An unbiased (spectral) estimate of the transmittance)doc";
+
 static const char *__doc_mitsuba_Medium_get_combined_extinction = R"doc(Returns the medium's majorant used for delta tracking)doc";
 
+static const char *__doc_mitsuba_Medium_get_control_extinction =
+R"doc(Returns the control extinction used by residual ratio tracking, along
+with a majorant of the residual extinction |Sigma_t - control|
+
+The default implementation returns a zero control extinction and the
+combined extinction as residual majorant, which reduces residual ratio
+tracking to ratio tracking.)doc";
+
 static const char *__doc_mitsuba_Medium_get_scattering_coefficients =
 R"doc(Returns the medium coefficients Sigma_s, Sigma_n and Sigma_t evaluated
 at a given MediumInteraction mi)doc";
@@ -3352,6 +3698,20 @@ static const char *__doc_mitsuba_MemoryMappedFile_data_2 = R"doc(Return a pointe
 
 static const char *__doc_mitsuba_MemoryMappedFile_filename = R"doc(Return the associated filename)doc";
 
+static const char *__doc_mitsuba_MemoryMappedFile_map_private =
+R"doc(Map the specified file into memory using copy-on-write semantics
+
+The mapped region can be modified, but changes remain private to the
+process and are never written back to the file.)doc";
+
+static const char *__doc_mitsuba_MemoryMappedFile_prefetch =
+R"doc(Ask the operating system to asynchronously read a part of the file
+into memory
+
+This is only a hint: the function returns immediately, and accesses to
+pages that haven't been loaded yet simply block as usual. It does
+nothing on platforms without a suitable API.)doc";
+
 static const char *__doc_mitsuba_MemoryMappedFile_resize =
 R"doc(Resize the memory-mapped file
 
@@ -3362,6 +3722,16 @@ static const char *__doc_mitsuba_MemoryMappedFile_size = R"doc(Return the size o
 
 static const char *__doc_mitsuba_MemoryMappedFile_to_string = R"doc(Return a string representation)doc";
 
+static const char *__doc_mitsuba_MemoryRecord = R"doc(Memory usage of a single object, as collected by memory_statistics())doc";
+
+static const char *__doc_mitsuba_MemoryRecord_class_name = R"doc(Class name of the object)doc";
+
+static const char *__doc_mitsuba_MemoryRecord_name = R"doc(Path of the object within the traversed object graph)doc";
+
+static const char *__doc_mitsuba_MemoryRecord_total = R"doc(Return the total number of bytes over all categories)doc";
+
+static const char *__doc_mitsuba_MemoryRecord_usage = R"doc(Per-category memory usage in bytes)doc";
+
 static const char *__doc_mitsuba_MemoryStream =
 R"doc(Simple memory buffer-based stream with automatic memory management. It
 always has read & write capabilities.
@@ -3417,6 +3787,8 @@ static const char *__doc_mitsuba_MemoryStream_m_size = R"doc(Current size of the
 
 static const char *__doc_mitsuba_MemoryStream_owns_buffer = R"doc(Return whether or not the memory stream owns the underlying buffer)doc";
 
+static const char *__doc_mitsuba_MemoryStream_raw_buffer = R"doc(Return a pointer to the contents of the memory buffer)doc";
+
 static const char *__doc_mitsuba_MemoryStream_read =
 R"doc(Reads a specified amount of data from the stream. Throws an exception
 if trying to read further than the current size of the contents.)doc";
@@ -3507,8 +3879,30 @@ since it uses a mutex.)doc";
 
 static const char *__doc_mitsuba_Mesh_class = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_compact_storage =
+R"doc(Convert the vertex data into a compact quantized layout
+
+Vertex normals are octahedral-encoded into 32 bits (2x16 bit), and
+texture coordinates are stored in half precision. When ``compact_faces``
+is set and the mesh has at most 65536 vertices, face indices are
+additionally stored using 16 bits. The original single precision
+buffers are released, and the corresponding buffer accessors (e.g.
+vertex_normals_buffer()) return empty buffers afterwards.
+
+Decoding happens on the fly in the vertex accessors. The compact
+layout is only supported by the CPU variants of the renderer. Vertex
+positions always remain in single precision.)doc";
+
 static const char *__doc_mitsuba_Mesh_compute_surface_interaction = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_decode_normal = R"doc(Inverse of encode_normal())doc";
+
+static const char *__doc_mitsuba_Mesh_decode_texcoord = R"doc(Inverse of encode_texcoord())doc";
+
+static const char *__doc_mitsuba_Mesh_encode_normal = R"doc(Octahedral encoding of a unit vector into two 16 bit fixed point values)doc";
+
+static const char *__doc_mitsuba_Mesh_encode_texcoord = R"doc(Pack two texture coordinates into a pair of half precision values)doc";
+
 static const char *__doc_mitsuba_Mesh_ensure_pmf_built = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_eval_attribute = R"doc()doc";
@@ -3523,7 +3917,7 @@ static const char *__doc_mitsuba_Mesh_face_area = R"doc(Returns the surface area
 
 static const char *__doc_mitsuba_Mesh_face_count = R"doc(Return the total number of faces)doc";
 
-static const char *__doc_mitsuba_Mesh_face_data_bytes = R"doc()doc";
+static const char *__doc_mitsuba_Mesh_face_data_bytes = R"doc(Return the number of bytes used to store the data of a single face)doc";
 
 static const char *__doc_mitsuba_Mesh_face_indices = R"doc(Returns the face indices associated with triangle ``index``)doc";
 
@@ -3531,10 +3925,18 @@ static const char *__doc_mitsuba_Mesh_faces_buffer = R"doc(Return face indices b
 
 static const char *__doc_mitsuba_Mesh_faces_buffer_2 = R"doc(Const variant of faces_buffer.)doc";
 
+static const char *__doc_mitsuba_Mesh_has_compact_storage = R"doc(Does this mesh use the compact storage layout (see compact_storage())?)doc";
+
 static const char *__doc_mitsuba_Mesh_has_vertex_normals = R"doc(Does this mesh have per-vertex normals?)doc";
 
 static const char *__doc_mitsuba_Mesh_has_vertex_texcoords = R"doc(Does this mesh have per-vertex texture coordinates?)doc";
 
+static const char *__doc_mitsuba_Mesh_interleave_memory =
+R"doc(Interleave the vertex and face buffers across all NUMA nodes
+
+Called when a scene is loaded in NUMA mode (see numa::enabled()). Only
+has an effect in the CPU variants of the renderer.)doc";
+
 static const char *__doc_mitsuba_Mesh_interpolate_attribute = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_area_pmf = R"doc()doc";
@@ -3549,6 +3951,8 @@ static const char *__doc_mitsuba_Mesh_m_face_count = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_faces_buf = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_m_huge_page_storage = R"doc(Keeps the huge page buffers referenced by the buffers above alive)doc";
+
 static const char *__doc_mitsuba_Mesh_m_mesh_attributes = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_mutex = R"doc()doc";
@@ -3565,6 +3969,13 @@ static const char *__doc_mitsuba_Mesh_m_vertex_positions_buf = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_vertex_texcoords_buf = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_move_to_huge_pages =
+R"doc(Move large vertex and face buffers into memory backed by huge pages
+(see HugePageBuffer)
+
+Called when a scene is loaded while huge pages are enabled. Only has
+an effect in the CPU variants of the renderer.)doc";
+
 static const char *__doc_mitsuba_Mesh_parameters_changed = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_parameters_grad_enabled = R"doc()doc";
@@ -3606,7 +4017,7 @@ static const char *__doc_mitsuba_Mesh_traverse = R"doc(@})doc";
 
 static const char *__doc_mitsuba_Mesh_vertex_count = R"doc(Return the total number of vertices)doc";
 
-static const char *__doc_mitsuba_Mesh_vertex_data_bytes = R"doc()doc";
+static const char *__doc_mitsuba_Mesh_vertex_data_bytes = R"doc(Return the number of bytes used to store the data of a single vertex)doc";
 
 static const char *__doc_mitsuba_Mesh_vertex_normal = R"doc(Returns the normal direction of the vertex with index ``index``)doc";
 
@@ -3882,6 +4293,18 @@ static const char *__doc_mitsuba_Object_inc_ref = R"doc(Increase the object's re
 
 static const char *__doc_mitsuba_Object_m_ref_count = R"doc()doc";
 
+static const char *__doc_mitsuba_Object_memory_usage =
+R"doc(Return the amount of memory held by this instance
+
+The result is broken down into descriptive categories (e.g. "kd-tree
+nodes", "vertex data") and only accounts for large allocations owned
+directly by this object. Referenced child objects report their own
+usage and are visited via traverse() when computing scene-wide
+statistics using memory_statistics().
+
+Remark:
+    The default implementation returns an empty map.)doc";
+
 static const char *__doc_mitsuba_Object_parameters_changed =
 R"doc(Update internal state after applying changes to parameters
 
@@ -3927,6 +4350,22 @@ Remark:
 See also:
     TraversalCallback)doc";
 
+static const char *__doc_mitsuba_Object_write_bundle =
+R"doc(Store the decoded data of this instance in a scene bundle
+
+Objects that load bulk data from external files (e.g. meshes or
+bitmaps) can implement this function to append the decoded data to
+``writer`` and to rewrite their construction parameters ``props``, so
+that an equivalent object can later be created from the bundle without
+accessing the original files.
+
+Returns:
+    ``True`` if ``props`` was rewritten to reference data stored in
+    the bundle. The default implementation returns ``False``.
+
+See also:
+    SceneBundle)doc";
+
 static const char *__doc_mitsuba_PCG32Sampler =
 R"doc(Interface for sampler plugins based on the PCG32 random number
 generator)doc";
@@ -4728,6 +5167,26 @@ Remark:
     Mitsuba's ray-object intersection code may produce undefined
     results.)doc";
 
+static const char *__doc_mitsuba_RayCounters = R"doc(Aggregated values of the ray tracing counters over all threads)doc";
+
+static const char *__doc_mitsuba_RayCounters_lane_utilization =
+R"doc(Fraction of SIMD lanes that were active during packet traversal (zero
+for scalar variants))doc";
+
+static const char *__doc_mitsuba_RayCounters_nodes_per_ray = R"doc(Average number of kd-tree nodes visited per ray)doc";
+
+static const char *__doc_mitsuba_RayCounters_operator_array = R"doc()doc";
+
+static const char *__doc_mitsuba_RayCounters_primitives_per_ray = R"doc(Average number of primitive intersection tests per ray)doc";
+
+static const char *__doc_mitsuba_RayCounters_rays = R"doc(Total number of traced rays (closest-hit and shadow))doc";
+
+static const char *__doc_mitsuba_RayCounters_to_string =
+R"doc(Return a human-readable summary (``seconds`` is used to compute ray
+throughput))doc";
+
+static const char *__doc_mitsuba_RayCounters_values = R"doc()doc";
+
 static const char *__doc_mitsuba_RayDifferential =
 R"doc(Ray differential -- enhances the basic ray class with offset rays for
 two adjacent pixels on the view plane)doc";
@@ -4838,10 +5297,26 @@ static const char *__doc_mitsuba_ReconstructionFilter_m_radius = R"doc()doc";
 
 static const char *__doc_mitsuba_ReconstructionFilter_m_scale_factor = R"doc()doc";
 
+static const char *__doc_mitsuba_ReconstructionFilter_m_distr = R"doc(Distribution proportional to the absolute value of m_values)doc";
+
 static const char *__doc_mitsuba_ReconstructionFilter_m_values = R"doc()doc";
 
 static const char *__doc_mitsuba_ReconstructionFilter_radius = R"doc(Return the filter's width)doc";
 
+static const char *__doc_mitsuba_ReconstructionFilter_sample =
+R"doc(Importance sample the discretized filter along one dimension
+
+Generates an offset in ``[-radius, radius]`` with a density
+proportional to the absolute value of the filter. This is used for
+filter importance sampling, where each sample only contributes to the
+pixel it was generated for.
+
+Returns:
+    The sampled offset and the associated sample weight. The latter is
+    the sign of the filter at the sampled offset, since the constant
+    normalization factor cancels when dividing by the accumulated
+    weight of a pixel.)doc";
+
 static const char *__doc_mitsuba_Resampler =
 R"doc(Utility class for efficiently resampling discrete datasets to
 different resolutions
@@ -5062,6 +5537,14 @@ static const char *__doc_mitsuba_SamplingIntegrator_class = R"doc()doc";
 
 static const char *__doc_mitsuba_SamplingIntegrator_m_block_size = R"doc(Size of (square) image blocks to render per core.)doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_m_cost_aov =
+R"doc(Record the cost of every sample in additional AOV channels?
+
+When enabled, render() appends a ``cost.kcycles`` channel (thousands
+of cycle counter ticks) and, if the ray tracing counters were enabled
+at compile time, a ``cost.rays`` channel (number of traced rays). The
+film stores the average cost of the samples of each pixel.)doc";
+
 static const char *__doc_mitsuba_SamplingIntegrator_m_hide_emitters = R"doc(Flag for disabling direct visibility of emitters)doc";
 
 static const char *__doc_mitsuba_SamplingIntegrator_m_render_timer = R"doc(Timer used to enforce the timeout.)doc";
@@ -5216,6 +5699,45 @@ Returns:
 
 static const char *__doc_mitsuba_Scene_ray_intersect_2 = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_ray_intersect_batch =
+R"doc(Intersect a large batch of rays stored in flat arrays
+
+The rays are traced in parallel using the scalar intersection routine
+of the underlying acceleration data structure. All arrays are accessed
+in place and must remain valid for the duration of the call.
+
+Parameter ``count``:
+    Number of rays in the batch
+
+Parameter ``o``:
+    Ray origins (``3 * count`` entries, interleaved XYZ)
+
+Parameter ``d``:
+    Ray directions (``3 * count`` entries, interleaved XYZ)
+
+Parameter ``mint``:
+    Minimum ray extents (``count`` entries), or ``nullptr`` to use the
+    default ray epsilon
+
+Parameter ``maxt``:
+    Maximum ray extents (``count`` entries), or ``nullptr`` for
+    unbounded rays
+
+Parameter ``t``:
+    Output: distance to the intersection, or infinity for misses
+
+Parameter ``prim_index``:
+    Output: primitive index within the hit shape, or ``(uint32_t) -1``
+
+Parameter ``shape_index``:
+    Output: index of the hit shape in shapes(), or ``(uint32_t) -1``
+
+Parameter ``prim_uv``:
+    Output: primitive-local UV coordinates (``2 * count`` entries)
+
+Remark:
+    This function is only available in scalar variants.)doc";
+
 static const char *__doc_mitsuba_Scene_ray_intersect_cpu = R"doc(Trace a ray)doc";
 
 static const char *__doc_mitsuba_Scene_ray_intersect_gpu = R"doc()doc";
@@ -5251,6 +5773,15 @@ Parameter ``ray``:
 Returns:
     ``True`` if an intersection was found)doc";
 
+static const char *__doc_mitsuba_Scene_ray_test_batch =
+R"doc(Test a large batch of rays stored in flat arrays for occlusion
+
+The parameters have the same meaning as in ray_intersect_batch(). Entry
+``i`` of ``hit`` is set to ``True`` if ray ``i`` intersects the scene.
+
+Remark:
+    This function is only available in scalar variants.)doc";
+
 static const char *__doc_mitsuba_Scene_ray_test_cpu = R"doc(Trace a shadow ray)doc";
 
 static const char *__doc_mitsuba_Scene_ray_test_gpu = R"doc()doc";
@@ -5280,6 +5811,19 @@ Returns:
     Radiance received along the sampled ray divided by the sample
     probability.)doc";
 
+static const char *__doc_mitsuba_Scene_sample_emitter_ray =
+R"doc(Sample a ray leaving one of the emitters of the scene
+
+The emitter is chosen uniformly using ``sample1``, which is then
+rescaled and passed on to Endpoint::sample_ray() along with the
+remaining arguments. This is the starting point of light and photon
+tracing techniques.
+
+Returns:
+    The sampled ray and the emitted flux divided by the sample
+    probability (including the discrete probability of choosing the
+    emitter).)doc";
+
 static const char *__doc_mitsuba_Scene_sensors = R"doc(Return the list of sensors)doc";
 
 static const char *__doc_mitsuba_Scene_sensors_2 = R"doc(Return the list of sensors (const version))doc";
@@ -5446,6 +5990,8 @@ static const char *__doc_mitsuba_ShapeKDTree_bbox_2 = R"doc(Return the (clipped)
 
 static const char *__doc_mitsuba_ShapeKDTree_build = R"doc(Build the kd-tree)doc";
 
+static const char *__doc_mitsuba_ShapeKDTree_build_quality = R"doc(Return the build quality preset (specified via ``kd_quality``))doc";
+
 static const char *__doc_mitsuba_ShapeKDTree_class = R"doc()doc";
 
 static const char *__doc_mitsuba_ShapeKDTree_find_shape =
@@ -5465,6 +6011,14 @@ static const char *__doc_mitsuba_ShapeKDTree_m_primitive_map = R"doc()doc";
 
 static const char *__doc_mitsuba_ShapeKDTree_m_shapes = R"doc()doc";
 
+static const char *__doc_mitsuba_ShapeKDTree_predict_cost =
+R"doc(Predict the build time (in seconds) and the cost of a ray query (in
+nanoseconds) when building the current set of shapes using the given
+preset
+
+These are rough estimates based on the primitive count and the surface
+area heuristic, intended to compare presets with each other.)doc";
+
 static const char *__doc_mitsuba_ShapeKDTree_primitive_count = R"doc(Return the number of registered primitives)doc";
 
 static const char *__doc_mitsuba_ShapeKDTree_ray_intersect_naive = R"doc(Brute force intersection routine for debugging purposes)doc";
@@ -5475,6 +6029,15 @@ static const char *__doc_mitsuba_ShapeKDTree_ray_intersect_preliminary = R"doc()
 
 static const char *__doc_mitsuba_ShapeKDTree_ray_intersect_scalar = R"doc()doc";
 
+static const char *__doc_mitsuba_ShapeKDTree_set_build_quality = R"doc(Set the build quality preset (takes effect at the next build()))doc";
+
+static const char *__doc_mitsuba_ShapeKDTree_set_sample_budget =
+R"doc(Set the number of samples that will be rendered using this tree
+
+Together with the ``kd_rays_per_sample`` parameter (default: 4), this
+determines the number of queries that the KDBuildQuality::Auto preset
+weighs against the build time.)doc";
+
 static const char *__doc_mitsuba_ShapeKDTree_shape = R"doc(Return the i-th shape (const version))doc";
 
 static const char *__doc_mitsuba_ShapeKDTree_shape_2 = R"doc(Return the i-th shape)doc";
@@ -5808,6 +6371,136 @@ The default implementation throws an exception.)doc";
 
 static const char *__doc_mitsuba_Shape_traverse = R"doc()doc";
 
+static const char *__doc_mitsuba_SparseGrid =
+R"doc(Sparse, brick-based storage of a 3D grid of (multi-channel) values
+
+The grid is partitioned into bricks of 8x8x8 voxels, which are in turn
+grouped into tiles of 8x8x8 bricks. A dense root array stores one
+entry per tile, and each tile stores one entry per brick. An entry
+either references a tile (root) or brick (tile), or, when
+ConstantFlag is set, a value in a table of constants. Tiles and
+bricks whose voxels all have the same value (in particular empty ones)
+thus only occupy a single entry. The constant with index zero is
+always the zero value.
+
+Every root and tile entry furthermore stores the minimum and maximum
+value (over all channels) of its region, dilated by one voxel to cover
+the footprint of trilinear interpolation. These bounds can be used as
+local majorants and control variates by tracking methods.
+
+Voxel values follow the layout of dense grids, i.e. brick ``b`` stores
+voxel (x, y, z) of its 8x8x8 block at ``bricks[(((b * 8 + z) * 8 + y)
+* 8 + x) * channels + c]``.)doc";
+
+static const char *__doc_mitsuba_SparseGrid_BrickRes = R"doc(Resolution of a brick (in voxels))doc";
+
+static const char *__doc_mitsuba_SparseGrid_BrickSize = R"doc(Number of voxels per brick)doc";
+
+static const char *__doc_mitsuba_SparseGrid_ConstantFlag = R"doc(Marks root and tile entries that reference the table of constants)doc";
+
+static const char *__doc_mitsuba_SparseGrid_SparseGrid =
+R"doc(Create a sparse grid from dense data
+
+Parameter ``shape``:
+    Resolution of the grid
+
+Parameter ``channel_count``:
+    Number of channels per voxel
+
+Parameter ``data``:
+    Voxel values, where ``data[((z * yres + y) * xres + x) * channels +
+    c]`` stores channel ``c`` of voxel (x, y, z)
+
+Parameter ``bbox``:
+    Bounding box of the grid (only kept as metadata))doc";
+
+static const char *__doc_mitsuba_SparseGrid_SparseGrid_2 =
+R"doc(Load a sparse grid from a file
+
+Both sparse grid files (created by write()) and dense Mitsuba binary
+volume files (``.vol``, which are converted while loading) are
+supported.)doc";
+
+static const char *__doc_mitsuba_SparseGrid_SparseGrid_3 = R"doc(Load a sparse grid from a stream (see write()))doc";
+
+static const char *__doc_mitsuba_SparseGrid_TileRes = R"doc(Resolution of a tile (in bricks))doc";
+
+static const char *__doc_mitsuba_SparseGrid_TileSize = R"doc(Number of bricks per tile)doc";
+
+static const char *__doc_mitsuba_SparseGrid_bbox = R"doc(Return the bounding box stored along with the grid)doc";
+
+static const char *__doc_mitsuba_SparseGrid_bounds = R"doc(Return the (min, max) bounds of the region containing the given voxel)doc";
+
+static const char *__doc_mitsuba_SparseGrid_brick_count = R"doc(Return the number of stored bricks)doc";
+
+static const char *__doc_mitsuba_SparseGrid_bricks = R"doc(Return the voxel values of all bricks (BrickSize voxels per brick))doc";
+
+static const char *__doc_mitsuba_SparseGrid_build =
+R"doc(Build the hierarchy from dense data (m_shape and m_channel_count must
+be set))doc";
+
+static const char *__doc_mitsuba_SparseGrid_channel_count = R"doc(Return the number of channels per voxel)doc";
+
+static const char *__doc_mitsuba_SparseGrid_class = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_constants =
+R"doc(Return the table of constant values (channel_count() entries per
+constant))doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_bbox = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_bricks = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_channel_count = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_constants = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_max = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_mean = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_root = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_root_bounds = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_root_shape = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_shape = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_tile_bounds = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_m_tiles = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseGrid_max = R"doc(Return the maximum value over all voxels and channels)doc";
+
+static const char *__doc_mitsuba_SparseGrid_mean = R"doc(Return the mean value over all voxels and channels)doc";
+
+static const char *__doc_mitsuba_SparseGrid_read = R"doc(Read the contents of a sparse grid file (following the header))doc";
+
+static const char *__doc_mitsuba_SparseGrid_root = R"doc(Return the root array (one entry per tile))doc";
+
+static const char *__doc_mitsuba_SparseGrid_root_bounds = R"doc(Return interleaved (min, max) bounds of the root entries)doc";
+
+static const char *__doc_mitsuba_SparseGrid_root_shape = R"doc(Return the resolution of the root array (in tiles))doc";
+
+static const char *__doc_mitsuba_SparseGrid_shape = R"doc(Return the resolution of the grid (in voxels))doc";
+
+static const char *__doc_mitsuba_SparseGrid_size_bytes = R"doc(Return the size of the sparse representation in bytes)doc";
+
+static const char *__doc_mitsuba_SparseGrid_tile_bounds = R"doc(Return interleaved (min, max) bounds of the tile entries)doc";
+
+static const char *__doc_mitsuba_SparseGrid_tile_count = R"doc(Return the number of stored tiles)doc";
+
+static const char *__doc_mitsuba_SparseGrid_tiles = R"doc(Return the tile array (TileSize entries per tile))doc";
+
+static const char *__doc_mitsuba_SparseGrid_to_string = R"doc(Return a human-readable summary)doc";
+
+static const char *__doc_mitsuba_SparseGrid_voxel = R"doc(Look up a channel of a voxel (mainly intended for testing))doc";
+
+static const char *__doc_mitsuba_SparseGrid_write = R"doc(Write the sparse grid to a stream)doc";
+
+static const char *__doc_mitsuba_SparseGrid_write_2 = R"doc(Write the sparse grid to a file)doc";
+
 static const char *__doc_mitsuba_Spectrum =
 R"doc(//! @{ \name Data types for spectral quantities with sampled
 wavelengths)doc";
@@ -5823,6 +6516,10 @@ static const char *__doc_mitsuba_Spectrum_operator_assign_2 = R"doc()doc";
 static const char *__doc_mitsuba_Spiral =
 R"doc(Generates a spiral of blocks to be rendered.
 
+Alternatively, the blocks can be generated in scanline order (see
+Order), which completes the image in horizontal strips from top to
+bottom.
+
 Author:
     Adam Arbree Aug 25, 2005 RayTracer.java Used with permission.
     Copyright 2005 Program of Computer Graphics, Cornell University)doc";
@@ -5837,6 +6534,17 @@ static const char *__doc_mitsuba_Spiral_Direction_Right = R"doc()doc";
 
 static const char *__doc_mitsuba_Spiral_Direction_Up = R"doc()doc";
 
+static const char *__doc_mitsuba_Spiral_Order = R"doc(Order in which the blocks are generated)doc";
+
+static const char *__doc_mitsuba_Spiral_Order_Scanline =
+R"doc(Rows of blocks from top to bottom
+
+All passes of a row are generated before moving on to the next one, so
+that rows are completed as early as possible. Used by films that
+stream finished scanlines to disk.)doc";
+
+static const char *__doc_mitsuba_Spiral_Order_Spiral = R"doc(Spiral outwards from the center of the image (the default))doc";
+
 static const char *__doc_mitsuba_Spiral_Spiral =
 R"doc(Create a new spiral generator for the given size, offset into a larger
 frame, and block size)doc";
@@ -5861,6 +6569,8 @@ static const char *__doc_mitsuba_Spiral_m_mutex = R"doc(Protects the spiral's st
 
 static const char *__doc_mitsuba_Spiral_m_offset = R"doc()doc";
 
+static const char *__doc_mitsuba_Spiral_m_order = R"doc(Order in which the blocks are generated.)doc";
+
 static const char *__doc_mitsuba_Spiral_m_position = R"doc()doc";
 
 static const char *__doc_mitsuba_Spiral_m_remaining_passes = R"doc(Number of times the spiral should automatically restart.)doc";
@@ -5878,10 +6588,14 @@ R"doc(Return the offset, size and unique identifer of the next block.
 
 A size of zero indicates that the spiral traversal is done.)doc";
 
+static const char *__doc_mitsuba_Spiral_order = R"doc(Return the order in which the blocks are generated)doc";
+
 static const char *__doc_mitsuba_Spiral_reset =
 R"doc(Reset the spiral to its initial state. Does not affect the number of
 passes.)doc";
 
+static const char *__doc_mitsuba_Spiral_set_order = R"doc(Set the order in which the blocks are generated and reset the spiral)doc";
+
 static const char *__doc_mitsuba_Spiral_set_passes =
 R"doc(Sets the number of time the spiral should automatically reset. Not
 affected by a call to reset.)doc";
@@ -6617,11 +7331,15 @@ parallel construction.
 At the top of the tree, it uses min-max-binning and parallel
 reductions to create sufficient parallelism. When the number of
 elements is sufficiently small, it switches to a more accurate O(N log
-N) builder which uses normal recursion on the stack (i.e. it does not
-spawn further parallel pieces of work).)doc";
+N) builder. Nodes of the O(N log N) builder that contain many
+primitives (see parallel_exact_threshold()) sweep the three axes and
+sort their edge events in parallel, and their subtrees are built by
+new tasks. Smaller nodes use normal recursion on the stack.)doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_BuildTask_BuildTask = R"doc()doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_BuildTask_BuildTask_2 = R"doc(Create a task that builds a subtree using the O(N log N) method)doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_BuildTask_build_nlogn = R"doc(Recursively run the O(N log N builder))doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_BuildTask_execute = R"doc(Run one iteration of min-max binning and spawn recursive tasks)doc";
@@ -6636,10 +7354,16 @@ static const char *__doc_mitsuba_TShapeKDTree_BuildTask_m_ctx = R"doc(Context wi
 
 static const char *__doc_mitsuba_TShapeKDTree_BuildTask_m_depth = R"doc(Depth of the node within the tree)doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_BuildTask_m_event_prim_count = R"doc(Number of primitives referenced by m_events)doc";
+
+static const char *__doc_mitsuba_TShapeKDTree_BuildTask_m_events = R"doc(Sorted edge events of a subtree handed over by the O(N log N) builder)doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_BuildTask_m_indices = R"doc(Index list of primitives to be organized)doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_BuildTask_m_local = R"doc(Local context with thread local variables)doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_BuildTask_m_nlogn = R"doc(Continue the O(N log N) builder instead of running min-max binning?)doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_BuildTask_m_node = R"doc(Node to be initialized by this task)doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_BuildTask_m_tight_bbox = R"doc(Tighter bounding box of the contained primitives)doc";
@@ -6652,6 +7376,14 @@ static const char *__doc_mitsuba_TShapeKDTree_BuildTask_make_leaf_2 =
 R"doc(Create a leaf node using the given edge event list (called by the O(N
 log N) builder))doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_BuildTask_resume_nlogn =
+R"doc(Continue the O(N log N) builder with an edge event list handed over by
+a parent task)doc";
+
+static const char *__doc_mitsuba_TShapeKDTree_BuildTask_sweep_axis =
+R"doc(Find the best split plane along a single axis by sweeping over its
+(sorted) edge events)doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_BuildTask_transition_to_nlogn =
 R"doc(Create an initial sorted edge event list and start the O(N log N)
 builder)doc";
@@ -6904,6 +7636,16 @@ R"doc(Return the number of primitives, at which the builder will switch from
 (approximate) Min-Max binning to the accurate O(n log n) optimization
 method.)doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_expected_cost = R"doc(Recursively evaluate the cost model over a subtree)doc";
+
+static const char *__doc_mitsuba_TShapeKDTree_expected_cost_2 =
+R"doc(Return the expected cost of a query according to the cost model of the
+tree (normalized by the cost model of the root node))doc";
+
+static const char *__doc_mitsuba_TShapeKDTree_interleave_memory =
+R"doc(Traversal reads the tree from all threads: in NUMA mode, spread it
+over the memory of all nodes instead of the builders' nodes)doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_log_level = R"doc(Return the log level of kd-tree status messages)doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_m_bbox = R"doc()doc";
@@ -6930,6 +7672,8 @@ static const char *__doc_mitsuba_TShapeKDTree_m_node_count = R"doc()doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_m_nodes = R"doc()doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_m_parallel_exact_threshold = R"doc()doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_m_retract_bad_splits = R"doc()doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_m_stop_primitives = R"doc()doc";
@@ -6942,6 +7686,11 @@ static const char *__doc_mitsuba_TShapeKDTree_max_depth = R"doc(Return the maxim
 
 static const char *__doc_mitsuba_TShapeKDTree_min_max_bins = R"doc(Return the number of bins used for Min-Max binning)doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_parallel_exact_threshold =
+R"doc(Return the number of primitives, starting at which the O(n log n)
+builder sorts events in parallel and builds the subtrees of a node as
+separate tasks (0 == disabled))doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_ready = R"doc()doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_retract_bad_splits = R"doc(Return whether or not bad splits can be "retracted".)doc";
@@ -6963,6 +7712,11 @@ static const char *__doc_mitsuba_TShapeKDTree_set_max_depth = R"doc(Set the maxi
 
 static const char *__doc_mitsuba_TShapeKDTree_set_min_max_bins = R"doc(Set the number of bins used for Min-Max binning)doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_set_parallel_exact_threshold =
+R"doc(Set the number of primitives, starting at which the O(n log n) builder
+sorts events in parallel and builds the subtrees of a node as separate
+tasks (0 == disabled))doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_set_retract_bad_splits = R"doc(Specify whether or not bad splits can be "retracted".)doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_set_stop_primitives =
@@ -7599,6 +8353,17 @@ static const char *__doc_mitsuba_Volume_eval_3 =
 R"doc(Evaluate this texture as a three-channel quantity with no color
 processing (e.g. normal map).)doc";
 
+static const char *__doc_mitsuba_Volume_eval_bounds =
+R"doc(Returns a lower and an upper bound of the values of eval() and
+eval_1() in the neighborhood of the given point.
+
+Sparse volumes return bounds of the region containing the point. The
+default implementation returns the global range ``[0, max()]``.
+
+Note that no integrator or medium queries these bounds at the moment:
+the tracking methods in ``heterogeneous`` still use the global majorant
+derived from max().)doc";
+
 static const char *__doc_mitsuba_Volume_eval_gradient =
 R"doc(Evaluate the texture at the given surface interaction, and compute the
 gradients of the linear interpolant as well.)doc";
@@ -7754,6 +8519,14 @@ Parameter ``frame``:
 
 static const char *__doc_mitsuba_coordinate_system = R"doc(Complete the set {a} to an orthonormal basis {a, b, c})doc";
 
+static const char *__doc_mitsuba_cycle_counter =
+R"doc(Read the processor's cycle counter
+
+Returns the time stamp counter on x86 and the virtual counter on ARM64,
+which are cheap enough to time individual samples. Other platforms fall
+back to a nanosecond clock. Values are only meaningful as differences
+taken on the same thread.)doc";
+
 static const char *__doc_mitsuba_depolarize =
 R"doc(Return the (1,1) entry of a Mueller matrix. Identity function for all
 other-types.)doc";
@@ -8179,6 +8952,10 @@ static const char *__doc_mitsuba_hasher = R"doc()doc";
 
 static const char *__doc_mitsuba_hasher_operator_call = R"doc()doc";
 
+static const char *__doc_mitsuba_huge_page_array =
+R"doc(Allocate an (uninitialized) array of ``count`` elements according to
+the large-buffer policy)doc";
+
 static const char *__doc_mitsuba_ior_from_file = R"doc()doc";
 
 static const char *__doc_mitsuba_librender_nop =
@@ -8310,6 +9087,23 @@ static const char *__doc_mitsuba_math_ulpdiff =
 R"doc(Compare the difference in ULPs between a reference value and another
 given floating point number)doc";
 
+static const char *__doc_mitsuba_memory_report =
+R"doc(Return a human-readable table summarizing the output of
+memory_statistics()
+
+Parameter ``max_objects``:
+    Maximum number of objects that are listed individually. The
+    remaining ones are combined into a single line. Set to 0 to list
+    all objects.)doc";
+
+static const char *__doc_mitsuba_memory_statistics =
+R"doc(Recursively gather memory usage statistics of an object graph
+
+Visits ``root`` and all objects reachable from it via
+Object::traverse(). Each object is visited once, even if it is
+referenced multiple times. Objects that report no memory usage are
+omitted, and the records are sorted by decreasing total size.)doc";
+
 static const char *__doc_mitsuba_mueller_absorber =
 R"doc(Constructs the Mueller matrix of an ideal absorber
 
@@ -8700,6 +9494,53 @@ Returns:
     The (implicitly defined) reference coordinate system basis for the
     Stokes vector travelling along w.)doc";
 
+static const char *__doc_mitsuba_numa_current_node = R"doc(NUMA node of the processor that currently executes the calling thread)doc";
+
+static const char *__doc_mitsuba_numa_enabled =
+R"doc(Is the NUMA mode enabled?
+
+In NUMA mode, render worker threads are pinned to the processors of a
+NUMA node in round-robin order, read-mostly scene data (kd-tree, mesh
+buffers) is interleaved across all nodes, and sampling integrators
+accumulate samples into one image buffer per node. The mode is
+disabled by default and can be enabled via set_enabled(), the
+``--numa`` command line flag, or by setting the ``MTS_NUMA``
+environment variable to ``1``.)doc";
+
+static const char *__doc_mitsuba_numa_interleave =
+R"doc(Distribute the pages of a memory region across all NUMA nodes
+
+Pages that were already touched are migrated. This is intended for
+large read-mostly data structures that are accessed by all threads.
+Only pages that lie entirely within the region are affected. Returns
+``False`` on systems without NUMA support, if the region doesn't
+contain a whole page, or if the kernel rejected the request (e.g. for
+file-backed mappings).)doc";
+
+static const char *__doc_mitsuba_numa_node_count = R"doc(Number of NUMA nodes of the machine (1 on systems without NUMA support))doc";
+
+static const char *__doc_mitsuba_numa_node_cpus = R"doc(Logical processors that belong to the NUMA node ``node``)doc";
+
+static const char *__doc_mitsuba_numa_pin_thread =
+R"doc(Restrict the calling thread to the processors of a NUMA node
+
+A value of ``-1`` for ``node`` removes a previous restriction. Returns
+``False`` if the affinity could not be changed.)doc";
+
+static const char *__doc_mitsuba_numa_set_enabled =
+R"doc(Enable or disable the NUMA mode
+
+Worker threads are pinned when they join the task scheduler, hence
+this function should be called before the scheduler is initialized (or
+the thread count should be changed afterwards). Scene data is placed
+when a scene is loaded.)doc";
+
+static const char *__doc_mitsuba_numa_thread_node =
+R"doc(NUMA node of the calling thread
+
+Returns the node that the thread was pinned to using pin_thread(), or
+current_node() otherwise.)doc";
+
 static const char *__doc_mitsuba_operator_add = R"doc()doc";
 
 static const char *__doc_mitsuba_operator_add_2 = R"doc(Adding a vector to a point should always yield a point)doc";
@@ -8968,6 +9809,16 @@ Returns:
 
 static const char *__doc_mitsuba_radical_inverse_2 = R"doc(Van der Corput radical inverse in base 2)doc";
 
+static const char *__doc_mitsuba_ray_counters = R"doc(Sum the counters of all threads)doc";
+
+static const char *__doc_mitsuba_ray_counters_enabled = R"doc(Were the ray tracing counters enabled at compile time?)doc";
+
+static const char *__doc_mitsuba_ray_counters_reset =
+R"doc(Reset the counters of all threads to zero
+
+This function should not be called while other threads are tracing
+rays.)doc";
+
 static const char *__doc_mitsuba_ref =
 R"doc(Reference counting helper
 
@@ -9685,6 +10536,8 @@ compliant))doc";
 
 static const char *__doc_mitsuba_string_trim = R"doc(Remove leading and trailing characters)doc";
 
+static const char *__doc_mitsuba_thread_ray_count = R"doc(Number of rays (closest-hit and shadow) traced by the calling thread so far)doc";
+
 static const char *__doc_mitsuba_tuple_hasher = R"doc()doc";
 
 static const char *__doc_mitsuba_tuple_hasher_operator_call = R"doc()doc";
@@ -9916,6 +10769,14 @@ static const char *__doc_mitsuba_xml_detail_create_texture_from_spectrum =
 R"doc(Create a Texture object from a constant value or spectral values if
 available)doc";
 
+static const char *__doc_mitsuba_xml_load_bundle =
+R"doc(Load a Mitsuba scene from a scene bundle created by write_bundle()
+
+Meshes and textures map their data from the bundle file instead of
+loading it from the original input files. load_file() automatically
+forwards to this function when given a filename with the ``.mtsb``
+extension.)doc";
+
 static const char *__doc_mitsuba_xml_load_file =
 R"doc(Load a Mitsuba scene from an XML file
 
@@ -9936,6 +10797,30 @@ Parameter ``update_scene``:
 
 static const char *__doc_mitsuba_xml_load_string = R"doc(Load a Mitsuba scene from an XML string)doc";
 
+static const char *__doc_mitsuba_xml_write_bundle =
+R"doc(Parse a Mitsuba scene from an XML file and store it in a scene bundle
+
+The scene is fully loaded once so that meshes and textures can store
+their decoded data in the bundle (see SceneBundle). The bundle can
+then be loaded using load_bundle() without parsing the XML description
+or decoding any of the input files.
+
+Parameter ``path``:
+    Filename of the scene XML file
+
+Parameter ``bundle_path``:
+    Filename of the bundle that should be created (usually with the
+    ``.mtsb`` extension)
+
+Parameter ``variant``:
+    Specifies the variant of plugins to instantiate (e.g.
+    "scalar_rgb"). The bundle can only be loaded using the same
+    variant.
+
+Parameter ``parameters``:
+    Optional list of parameters that can be referenced as ``$varname``
+    in the scene.)doc";
+
 static const char *__doc_mitsuba_xyz_to_srgb = R"doc(Convert XYZ tristimulus values to ITU-R Rec. BT.709 linear RGB)doc";
 
 static const char *__doc_mitsuba_xyz_to_srgb_2 = R"doc(Convert XYZ tristimulus values to ITU-R Rec. BT.709 linear RGB)doc";
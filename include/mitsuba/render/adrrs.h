@@ -0,0 +1,317 @@
+#pragma once
+
+#include <mitsuba/core/atomic.h>
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/vector.h>
+#include <atomic>
+#include <memory>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Coarse spatial radiance cache used by the adjoint-driven Russian
+ * roulette and splitting (ADRRS) mode of the path tracing integrators
+ *
+ * The cache subdivides the bounding box of the scene into a uniform grid of
+ * cubical cells. During a training pass, integrators record how much radiance
+ * the path vertices within a cell send towards the sensor per unit of path
+ * throughput, and each cell keeps the average of these estimates. The cached
+ * values act as an approximation of the adjoint solution in the weight window
+ * of "Adjoint-Driven Russian Roulette and Splitting in Light Transport
+ * Simulation" by Vorba and Křivánek (see \ref adrrs_factor()).
+ *
+ * Recording is thread-safe, lookups are meant to happen once training is
+ * complete.
+ */
+template <typename Value> class ADRRSCache {
+public:
+    using Point3       = Point<Value, 3>;
+    using BoundingBox3 = BoundingBox<Point3>;
+
+    /**
+     * \brief Create an empty cache
+     *
+     * \param bbox
+     *     Region covered by the cache (usually the scene bounding box)
+     *
+     * \param resolution
+     *     Number of cells along the longest axis of \c bbox
+     */
+    ADRRSCache(const BoundingBox3 &bbox, uint32_t resolution) {
+        Value cell_size = hmax(bbox.extents()) / (Value) std::max(resolution, 1u);
+        if (!(cell_size > 0.f))
+            cell_size = 1.f;
+
+        m_origin = bbox.min;
+        m_inv_cell_size = 1.f / cell_size;
+        size_t cell_count = 1;
+        for (size_t i = 0; i < 3; ++i) {
+            m_res[i] = std::max(1u, (uint32_t) std::ceil(bbox.extents()[i] * m_inv_cell_size));
+            cell_count *= m_res[i];
+        }
+        m_cells.reset(new Cell[cell_count]);
+        m_cell_count = cell_count;
+    }
+
+    /// Record an estimate of the radiance sent towards the sensor at \c p
+    void record(const Point3 &p, Value value) {
+        Cell &cell = m_cells[index(p)];
+        cell.sum += value;
+        cell.count++;
+    }
+
+    /// Return the average estimate of the cell containing \c p (zero if unknown)
+    Value eval(const Point3 &p) const {
+        const Cell &cell = m_cells[index(p)];
+        uint32_t count = cell.count;
+        return count > 0 ? (Value) cell.sum / (Value) count : Value(0);
+    }
+
+    /// Return the total number of cells
+    size_t cell_count() const { return m_cell_count; }
+
+    /// Return the number of cells that received at least one estimate
+    size_t populated_cell_count() const {
+        size_t result = 0;
+        for (size_t i = 0; i < m_cell_count; ++i)
+            result += m_cells[i].count > 0 ? 1 : 0;
+        return result;
+    }
+
+private:
+    size_t index(const Point3 &p) const {
+        size_t result = 0;
+        for (int i = 2; i >= 0; --i) {
+            Value v = (p[i] - m_origin[i]) * m_inv_cell_size;
+            uint32_t k = (uint32_t) std::min(std::max(v, Value(0)), Value(m_res[i] - 1));
+            result = result * m_res[i] + k;
+        }
+        return result;
+    }
+
+    struct Cell {
+        AtomicFloat<Value> sum;
+        std::atomic<uint32_t> count { 0 };
+    };
+
+    Point3 m_origin;
+    Value m_inv_cell_size;
+    uint32_t m_res[3];
+    size_t m_cell_count;
+    std::unique_ptr<Cell[]> m_cells;
+};
+
+/**
+ * \brief Collects the vertices of a single path during the training pass of
+ * an \ref ADRRSCache
+ *
+ * Integrators register each vertex along with the current path throughput
+ * and the radiance accumulated so far. Once the path is complete, the
+ * radiance gathered after each vertex (divided by its throughput) is
+ * recorded in the cache.
+ */
+template <typename Value, typename Spectrum> class ADRRSRecorder {
+public:
+    using Point3 = Point<Value, 3>;
+
+    /// Maximum number of vertices of a path that are recorded
+    static constexpr size_t MaxVertices = 64;
+
+    void add_vertex(const Point3 &p, const Spectrum &throughput, const Spectrum &result) {
+        if (m_size < MaxVertices && any(throughput > 0.f))
+            m_vertices[m_size++] = { p, throughput, result };
+    }
+
+    void commit(ADRRSCache<Value> *cache, const Spectrum &result) const {
+        for (size_t i = 0; i < m_size; ++i) {
+            const Vertex &v = m_vertices[i];
+            Spectrum radiance = (result - v.prefix) / v.throughput;
+            Value value = hmean(select(v.throughput > 0.f, radiance, 0.f));
+            if (std::isfinite(value))
+                cache->record(v.p, std::max(value, Value(0)));
+        }
+    }
+
+private:
+    struct Vertex {
+        Point3 p;
+        Spectrum throughput, prefix;
+    };
+
+    Vertex m_vertices[MaxVertices];
+    size_t m_size = 0;
+};
+
+/**
+ * \brief Weight window of adjoint-driven Russian roulette and splitting
+ *
+ * A path is expected to contribute <tt>weight * radiance</tt> to a pixel
+ * whose value is estimated as \c pixel. The window is centered on the
+ * weight that would make this contribution match the pixel estimate: paths
+ * with a lower weight undergo Russian roulette, paths with a higher weight
+ * are split.
+ *
+ * \param weight
+ *     Throughput of the path prefix
+ *
+ * \param radiance
+ *     Cached radiance estimate at the current vertex
+ *
+ * \param pixel
+ *     Estimate of the value of the pixel being rendered
+ *
+ * \param window_size
+ *     Ratio between the upper and lower bound of the weight window
+ *
+ * \param max_split
+ *     Upper bound on the number of paths created by splitting
+ *
+ * \return
+ *     The survival probability (when less than one), the number of paths to
+ *     continue (when greater than one), or one to leave the path unchanged.
+ *     One is also returned when the estimates are not available.
+ */
+template <typename Value>
+Value adrrs_factor(Value weight, Value radiance, Value pixel, Value window_size,
+                   uint32_t max_split) {
+    if (!(radiance > 0.f) || !(pixel > 0.f) || !(weight > 0.f))
+        return 1.f;
+
+    Value center = pixel / radiance,
+          lower  = 2.f * center / (1.f + window_size),
+          upper  = lower * window_size;
+
+    if (weight < lower)
+        return weight / lower;
+    else if (weight > upper)
+        return std::min(std::ceil(weight / upper), (Value) max_split);
+    else
+        return 1.f;
+}
+
+/**
+ * \brief Settings and radiance cache of the adjoint-driven Russian roulette
+ * and splitting mode shared by the path tracing integrators
+ *
+ * Parses the \c rr_mode, \c adrrs_window, \c adrrs_max_split and
+ * \c adrrs_resolution parameters. Integrators forward their \c render()
+ * and \c pass_finished() callbacks to \ref prepare() and \ref
+ * pass_finished(), which train the cache during the first pass of the
+ * render job, and request synchronized passes when \ref enabled() returns
+ * \c true.
+ */
+template <typename Value> class ADRRS {
+public:
+    using Point3       = Point<Value, 3>;
+    using BoundingBox3 = BoundingBox<Point3>;
+    using Cache        = ADRRSCache<Value>;
+
+    /// Maximum number of pending paths created by splitting
+    static constexpr size_t MaxBranches = 64;
+
+    /**
+     * \brief Parse the Russian roulette parameters of an integrator
+     *
+     * \param scalar
+     *     Whether the integrator is instantiated in a scalar variant. The
+     *     \c adrrs mode traces split paths one after the other and is only
+     *     supported in this case.
+     */
+    ADRRS(const Properties &props, bool scalar) {
+        std::string rr_mode = props.string("rr_mode", "throughput");
+        if (rr_mode == "adrrs")
+            m_enabled = true;
+        else if (rr_mode == "throughput")
+            m_enabled = false;
+        else
+            Throw("Invalid \"rr_mode\" value \"%s\", must be \"throughput\" or \"adrrs\"!",
+                  rr_mode);
+
+        m_window = props.float_("adrrs_window", 5.f);
+        if (m_window <= 1.f)
+            Throw("\"adrrs_window\" must be greater than one!");
+        m_max_split = (uint32_t) props.size_("adrrs_max_split", 8);
+        m_resolution = (uint32_t) props.size_("adrrs_resolution", 32);
+
+        if (m_enabled && !scalar)
+            Throw("Adjoint-driven Russian roulette (rr_mode=\"adrrs\") is only "
+                  "supported in scalar variants of the renderer.");
+    }
+
+    /// Is the \c adrrs mode enabled?
+    bool enabled() const { return m_enabled; }
+
+    /// Is the radiance cache currently being trained?
+    bool training() const { return m_training; }
+
+    /// Return the radiance cache (\c nullptr unless the mode is enabled)
+    Cache *cache() const { return m_cache.get(); }
+
+    /**
+     * \brief Allocate an empty radiance cache before rendering
+     *
+     * The first pass of \c samples_per_pass samples trains the cache, which
+     * requires at least one more pass to follow.
+     */
+    void prepare(const BoundingBox3 &bbox, size_t samples_per_pass, size_t sample_count) {
+        if (!m_enabled)
+            return;
+
+        m_cache = std::unique_ptr<Cache>(new Cache(bbox, m_resolution));
+        m_training = samples_per_pass < sample_count;
+        if (!m_training)
+            Log(Warn, "Adjoint-driven Russian roulette requires \"samples_per_pass\" to be "
+                      "smaller than the sample count, using throughput-based Russian "
+                      "roulette instead.");
+    }
+
+    /// Stop training the radiance cache once the first pass is complete
+    void pass_finished(size_t pass) {
+        if (!m_training)
+            return;
+
+        m_training = false;
+        Log(Debug, "Radiance cache after pass %i: %i of %i cells populated", pass + 1,
+            m_cache->populated_cell_count(), m_cache->cell_count());
+    }
+
+    /**
+     * \brief Return the survival or splitting factor of a path vertex (see
+     * \ref adrrs_factor()), or zero when the cache has no estimate at \c p
+     * and the integrator should fall back to its default Russian roulette
+     *
+     * \param weight
+     *     Average throughput of the path prefix
+     *
+     * \param prefix
+     *     Average radiance accumulated by the path so far
+     *
+     * \param pixel
+     *     Estimate of the pixel value, initialized at the first vertex with a
+     *     cached estimate (pass a negative value to start with)
+     */
+    Value factor(const Point3 &p, Value weight, Value prefix, Value &pixel) const {
+        Value radiance = (m_cache && !m_training) ? m_cache->eval(p) : Value(0);
+        if (!(radiance > 0.f))
+            return 0.f;
+
+        if (pixel < 0.f)
+            pixel = prefix + weight * radiance;
+
+        return adrrs_factor(weight, radiance, pixel, m_window, m_max_split);
+    }
+
+    std::string to_string() const { return m_enabled ? "adrrs" : "throughput"; }
+
+private:
+    std::unique_ptr<Cache> m_cache;
+    bool m_enabled;
+    bool m_training = false;
+    Value m_window;
+    uint32_t m_max_split;
+    uint32_t m_resolution;
+};
+
+NAMESPACE_END(mitsuba)
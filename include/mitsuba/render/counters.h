@@ -0,0 +1,143 @@
+#pragma once
+
+#include <mitsuba/mitsuba.h>
+#include <enoki/array.h>
+#include <atomic>
+#include <string>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * List of events tracked by the ray tracing counters. Counting is disabled
+ * unless Mitsuba is compiled with the \c MTS_ENABLE_COUNTERS CMake option, in
+ * which case each thread increments its own set of counters. Packet variants
+ * count every active lane of a ray packet as a separate ray, node visit, or
+ * primitive test.
+ */
+enum class Counter : uint32_t {
+    RayIntersect = 0,   /* Rays traced by Scene::ray_intersect[_preliminary]() */
+    RayTest,            /* Shadow rays traced by Scene::ray_test() */
+    KDNodeVisit,        /* kd-tree nodes visited during traversal */
+    KDPrimitiveTest,    /* Ray-primitive intersection tests in kd-tree leaves */
+    PacketLanes,        /* Lanes of ray packets that visited a kd-tree node */
+    PacketActiveLanes,  /* Active lanes of ray packets that visited a kd-tree node */
+    BSDFSample,         /* BSDF::sample() calls issued by integrators */
+    EmitterSample,      /* Scene::sample_emitter_direction() calls */
+
+    CounterCount
+};
+
+constexpr const char *counter_id[int(Counter::CounterCount)] = {
+    "Closest-hit rays",
+    "Shadow rays",
+    "kd-tree node visits",
+    "Primitive tests",
+    "Packet lanes",
+    "Active packet lanes",
+    "BSDF samples",
+    "Emitter samples"
+};
+
+static_assert(std::extent_v<decltype(counter_id)> == int(Counter::CounterCount),
+              "Counters and descriptions don't have matching length!");
+
+/// Aggregated values of the ray tracing counters over all threads
+struct MTS_EXPORT_RENDER RayCounters {
+    uint64_t values[int(Counter::CounterCount)] = { };
+
+    uint64_t operator[](Counter c) const { return values[int(c)]; }
+
+    /// Total number of traced rays (closest-hit and shadow)
+    uint64_t rays() const { return (*this)[Counter::RayIntersect] + (*this)[Counter::RayTest]; }
+
+    /// Average number of kd-tree nodes visited per ray
+    double nodes_per_ray() const;
+
+    /// Average number of primitive intersection tests per ray
+    double primitives_per_ray() const;
+
+    /// Fraction of SIMD lanes that were active during packet traversal (zero for scalar variants)
+    double lane_utilization() const;
+
+    /// Return a human-readable summary (\c seconds is used to compute ray throughput)
+    std::string to_string(double seconds = 0.0) const;
+};
+
+/// Were the ray tracing counters enabled at compile time?
+extern MTS_EXPORT_RENDER bool ray_counters_enabled();
+
+/// Sum the counters of all threads
+extern MTS_EXPORT_RENDER RayCounters ray_counters();
+
+/**
+ * \brief Reset the counters of all threads to zero
+ *
+ * This function should not be called while other threads are tracing rays.
+ */
+extern MTS_EXPORT_RENDER void ray_counters_reset();
+
+#if defined(MTS_ENABLE_COUNTERS)
+/// Return the counter storage of the calling thread
+extern MTS_EXPORT_RENDER std::atomic<uint64_t> *counter_storage();
+
+MTS_INLINE void counter_add(Counter c, uint64_t value) {
+    /* Only the owning thread writes to its counters, which allows using a
+       relaxed load and store instead of an (expensive) atomic addition */
+    std::atomic<uint64_t> &target = counter_storage()[int(c)];
+    target.store(target.load(std::memory_order_relaxed) + value,
+                 std::memory_order_relaxed);
+}
+
+/// Number of rays (closest-hit and shadow) traced by the calling thread so far
+MTS_INLINE uint64_t thread_ray_count() {
+    std::atomic<uint64_t> *values = counter_storage();
+    return values[int(Counter::RayIntersect)].load(std::memory_order_relaxed) +
+           values[int(Counter::RayTest)].load(std::memory_order_relaxed);
+}
+#else
+MTS_INLINE void counter_add(Counter, uint64_t) { }
+MTS_INLINE uint64_t thread_ray_count() { return 0; }
+#endif
+
+/// Increment a counter by the number of active lanes of \c active
+template <typename Mask> MTS_INLINE void counter_add_lanes(Counter c, const Mask &active) {
+#if defined(MTS_ENABLE_COUNTERS)
+    // Horizontal reductions are costly on the GPU, these variants aren't instrumented
+    if constexpr (!enoki::is_cuda_array_v<Mask>) {
+        if constexpr (enoki::is_array_v<Mask>)
+            counter_add(c, (uint64_t) enoki::count(active));
+        else
+            counter_add(c, active ? 1 : 0);
+    }
+#else
+    ENOKI_MARK_USED(c);
+    ENOKI_MARK_USED(active);
+#endif
+}
+
+/**
+ * \brief Accumulates counter increments in local variables and commits them
+ * when going out of scope
+ *
+ * This avoids accessing the thread-local counter storage in inner loops
+ * (e.g. during kd-tree traversal).
+ */
+struct LocalCounters {
+#if defined(MTS_ENABLE_COUNTERS)
+    ~LocalCounters() {
+        for (uint32_t i = 0; i < uint32_t(Counter::CounterCount); ++i) {
+            if (m_values[i] > 0)
+                counter_add(Counter(i), m_values[i]);
+        }
+    }
+
+    MTS_INLINE void add(Counter c, uint64_t value) { m_values[int(c)] += value; }
+
+private:
+    uint64_t m_values[int(Counter::CounterCount)] = { };
+#else
+    MTS_INLINE void add(Counter, uint64_t) { }
+#endif
+};
+
+NAMESPACE_END(mitsuba)
@@ -46,6 +46,27 @@ public:
         const ScalarPoint2i  &target_offset,
         Bitmap *target) const = 0;
 
+    /**
+     * \brief Does the film stream finished rows to its output file?
+     *
+     * Such films only keep the rows that can still receive samples in
+     * memory. Integrators should then generate image blocks in scanline
+     * order (see \ref Spiral::Order) and report completed rows using \ref
+     * rows_finished(). The full image is not available via \ref bitmap().
+     */
+    virtual bool streaming() const { return false; }
+
+    /**
+     * \brief Notify the film that all image blocks above row \c y (in sensor
+     * coordinates) have been merged using \ref put()
+     *
+     * This promises that the blocks of all further calls to \ref put() start
+     * at row \c y or below. A streaming film can then develop and write the
+     * rows that lie outside of the filter footprint of these blocks. The
+     * default implementation does nothing.
+     */
+    virtual void rows_finished(int32_t y) { (void) y; }
+
     /// Return a bitmap object storing the developed contents of the film
     virtual ref<Bitmap> bitmap(bool raw = false) = 0;
 
@@ -62,6 +83,13 @@ public:
      */
     bool has_high_quality_edges() const { return m_high_quality_edges; }
 
+    /**
+     * Should camera rays be generated by importance sampling the
+     * reconstruction filter? In this case, each sample only contributes to
+     * the pixel it was generated for, and image blocks require no borders.
+     */
+    bool filter_importance_sampling() const { return m_filter_importance_sampling; }
+
     // =============================================================
     //! @{ \name Accessor functions
     // =============================================================
@@ -102,6 +130,7 @@ protected:
     ScalarVector2i m_crop_size;
     ScalarPoint2i m_crop_offset;
     bool m_high_quality_edges;
+    bool m_filter_importance_sampling;
     ref<ReconstructionFilter> m_filter;
 };
 
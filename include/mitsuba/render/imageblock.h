@@ -71,8 +71,9 @@ public:
      * \brief Store a single sample / packets of samples inside the
      * image block.
      *
-     * \note This method is only valid if a reconstruction filter was given at
-     * the construction of the block.
+     * \note When no reconstruction filter was given at the construction of
+     * the block, the sample is added to the pixel containing \c pos (e.g.
+     * when the film uses filter importance sampling).
      *
      * \param pos
      *    Denotes the sample position in fractional pixel coordinates. It is
@@ -120,8 +121,8 @@ public:
     /**
      * \brief Store a single sample inside the block.
      *
-     * \note This method is only valid if a reconstruction filter was provided
-     * when the block was constructed.
+     * \note When no reconstruction filter was provided when the block was
+     * constructed, the sample is added to the pixel containing \c pos.
      *
      * \param pos
      *    Denotes the sample position in fractional pixel coordinates. It is
@@ -194,6 +195,8 @@ public:
     //! @}
     // =============================================================
 
+    MemoryUsage memory_usage() const override;
+
     std::string to_string() const override;
 
     MTS_DECLARE_CLASS()
@@ -70,7 +70,7 @@ template <typename Float, typename Spectrum>
 class MTS_EXPORT_RENDER SamplingIntegrator : public Integrator<Float, Spectrum> {
 public:
     MTS_IMPORT_BASE(Integrator)
-    MTS_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock, Medium, Sampler)
+    MTS_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock, Medium, Sampler, ReconstructionFilter)
 
     /**
      * \brief Sample the incident radiance along a ray.
@@ -153,13 +153,53 @@ protected:
     SamplingIntegrator(const Properties &props);
     virtual ~SamplingIntegrator();
 
+    /**
+     * \brief Render the pixels of an image block
+     *
+     * Pixels are visited in Morton order relative to the parent block with
+     * identifier \c block_id, whose size is given by \ref m_block_size. When
+     * \ref render() splits a block to balance the load between threads,
+     * \c block only covers the aligned quadrant of the parent that spans the
+     * Morton indices <tt>[morton_begin, morton_end)</tt>. A value of zero
+     * for \c morton_end denotes the end of the parent block.
+     *
+     * When nonzero, \c cost_channel is the index of the first cost channel
+     * in \c aovs (see \ref m_cost_aov), which \ref render_sample() fills.
+     */
     virtual void render_block(const Scene *scene,
                               const Sensor *sensor,
                               Sampler *sampler,
                               ImageBlock *block,
                               Float *aovs,
                               size_t sample_count,
-                              size_t block_id) const;
+                              size_t block_id,
+                              uint32_t morton_begin = 0,
+                              uint32_t morton_end = 0,
+                              size_t cost_channel = 0) const;
+
+    /**
+     * \brief Indicates whether \ref render() should wait for all image blocks
+     * of a pass to finish before starting the next one.
+     *
+     * Integrators that learn from the samples of previous passes (e.g. path
+     * guiding) can override this function to return \c true, in which case
+     * \ref pass_finished() is invoked between passes. The default
+     * implementation returns \c false, which allows blocks of different
+     * passes to be processed concurrently.
+     */
+    virtual bool synchronize_passes() const;
+
+    /**
+     * \brief Callback invoked once all image blocks of a pass have been
+     * rendered. Only used when \ref synchronize_passes() returns \c true.
+     *
+     * \param pass
+     *    Index of the pass that was just completed
+     *
+     * \param pass_count
+     *    Total number of passes of the render job
+     */
+    virtual void pass_finished(size_t pass, size_t pass_count);
 
     void render_sample(const Scene *scene,
                        const Sensor *sensor,
@@ -168,6 +208,7 @@ protected:
                        Float *aovs,
                        const Vector2f &pos,
                        ScalarFloat diff_scale_factor,
+                       size_t cost_channel = 0,
                        Mask active = true) const;
 
 protected:
@@ -177,6 +218,16 @@ protected:
     /// Size of (square) image blocks to render per core.
     uint32_t m_block_size;
 
+    /**
+     * \brief Split blocks into smaller quadrants towards the end of a pass?
+     *
+     * When enabled, blocks fetched while fewer blocks than render threads
+     * remain are subdivided so that idle threads can share the work. Blocks
+     * that took much longer than average per pixel in an earlier pass are
+     * subdivided as well.
+     */
+    bool m_split_blocks;
+
     /**
      * \brief Number of samples to compute for each pass over the image blocks.
      *
@@ -197,6 +248,16 @@ protected:
 
     /// Flag for disabling direct visibility of emitters
     bool m_hide_emitters;
+
+    /**
+     * \brief Record the cost of every sample in additional AOV channels?
+     *
+     * When enabled, \ref render() appends a \c cost.kcycles channel
+     * (thousands of cycle counter ticks) and, if the ray tracing counters were enabled at compile
+     * time, a \c cost.rays channel (number of traced rays). The film stores
+     * the average cost of the samples of each pixel.
+     */
+    bool m_cost_aov;
 };
 
 /*
@@ -3,14 +3,17 @@
 #include <unordered_set>
 #include <mitsuba/core/bbox.h>
 #include <mitsuba/core/fwd.h>
+#include <mitsuba/core/hugepages.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/math.h>
+#include <mitsuba/core/numa.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/ray.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/tls.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/vector.h>
+#include <mitsuba/render/counters.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/render/shape.h>
@@ -183,6 +186,22 @@ public:
         m_exact_prim_threshold = value;
     }
 
+    /**
+     * \brief Return the number of primitives, starting at which the O(n log n)
+     * builder sorts events in parallel and builds the subtrees of a node as
+     * separate tasks (0 == disabled)
+     */
+    Size parallel_exact_threshold() const { return m_parallel_exact_threshold; }
+
+    /**
+     * \brief Set the number of primitives, starting at which the O(n log n)
+     * builder sorts events in parallel and builds the subtrees of a node as
+     * separate tasks (0 == disabled)
+     */
+    void set_parallel_exact_threshold(Size value) {
+        m_parallel_exact_threshold = value;
+    }
+
     /// Return the log level of kd-tree status messages
     LogLevel log_level() const { return m_log_level; }
 
@@ -194,6 +213,12 @@ public:
     /// Return the bounding box of the entire kd-tree
     const BoundingBox bbox() const { return m_bbox; }
 
+    /// Return the memory used by the kd-tree nodes and primitive index lists
+    MemoryUsage memory_usage() const override {
+        return { { "kd-tree nodes", m_node_count * sizeof(KDNode) },
+                 { "kd-tree indices", m_index_count * sizeof(Index) } };
+    }
+
     const Derived& derived() const { return (Derived&) *this; }
     Derived& derived() { return (Derived&) *this; }
 
@@ -950,9 +975,11 @@ protected:
      *
      * At the top of the tree, it uses min-max-binning and parallel reductions
      * to create sufficient parallelism. When the number of elements is
-     * sufficiently small, it switches to a more accurate O(N log N) builder
-     * which uses normal recursion on the stack (i.e. it does not spawn further
-     * parallel pieces of work).
+     * sufficiently small, it switches to a more accurate O(N log N) builder.
+     * Nodes of the O(N log N) builder that contain many primitives (see \ref
+     * parallel_exact_threshold()) sweep the three axes and sort their edge
+     * events in parallel, and their subtrees are built by new tasks. Smaller
+     * nodes use normal recursion on the stack.
      */
     class BuildTask : public tbb::task {
     public:
@@ -986,6 +1013,15 @@ protected:
         /// This scalar should be set to the final cost when done
         Scalar *m_cost;
 
+        /// Sorted edge events of a subtree handed over by the O(N log N) builder
+        EdgeEventVector m_events;
+
+        /// Number of primitives referenced by \c m_events
+        Size m_event_prim_count = 0;
+
+        /// Continue the O(N log N) builder instead of running min-max binning?
+        bool m_nlogn = false;
+
         BuildTask(BuildContext &ctx, const NodeIterator &node,
                   IndexVector &&indices, const BoundingBox bbox,
                   const BoundingBox &tight_bbox, Index depth, Size bad_refines,
@@ -996,6 +1032,16 @@ protected:
             Assert(m_bbox.contains(tight_bbox));
         }
 
+        /// Create a task that builds a subtree using the O(N log N) method
+        BuildTask(BuildContext &ctx, const NodeIterator &node,
+                  EdgeEventVector &&events, Size prim_count,
+                  const BoundingBox bbox, Index depth, Size bad_refines,
+                  Scalar *cost)
+            : m_ctx(ctx), m_node(node), m_bbox(bbox), m_tight_bbox(bbox),
+              m_depth(depth), m_bad_refines(bad_refines), m_cost(cost),
+              m_events(std::move(events)), m_event_prim_count(prim_count),
+              m_nlogn(true) { }
+
         /// Run one iteration of min-max binning and spawn recursive tasks
         task *execute() {
             ScopedSetThreadEnvironment env(m_ctx.env);
@@ -1004,6 +1050,11 @@ protected:
 
             m_ctx.work_units++;
 
+            if (m_nlogn) {
+                *m_cost = resume_nlogn();
+                return nullptr;
+            }
+
             /* ==================================================================== */
             /*                           Stopping criteria                          */
             /* ==================================================================== */
@@ -1132,49 +1183,17 @@ protected:
             return nullptr;
         }
 
-        /// Recursively run the O(N log N builder)
-        Scalar build_nlogn(NodeIterator node, Size prim_count,
-                           EdgeEvent *events_start, EdgeEvent *events_end,
-                           const BoundingBox &bbox, Size depth,
-                           Size bad_refines, bool left_child = true) {
-            const Derived &derived = m_ctx.derived;
-
-            /* Initialize the tree cost model */
-            CostModel model(derived.cost_model());
-            model.set_bounding_box(bbox);
-            Scalar leaf_cost = model.leaf_cost(prim_count);
-
-            /* ==================================================================== */
-            /*                           Stopping criteria                          */
-            /* ==================================================================== */
-
-            if (prim_count <= derived.stop_primitives() || depth >= derived.max_depth()) {
-                make_leaf(node, prim_count, events_start, events_end);
-                return leaf_cost;
-            }
-
-            /* ==================================================================== */
-            /*                        Split candidate search                        */
-            /* ==================================================================== */
-
-            /* First, find the optimal splitting plane according to the
-               tree construction heuristic. To do this in O(n), the search is
-               implemented as a sweep over the edge events */
-
+        /**
+         * \brief Find the best split plane along a single axis by sweeping
+         * over its (sorted) edge events
+         */
+        SplitCandidate sweep_axis(const CostModel &model, const BoundingBox &bbox,
+                                  Size prim_count, const EdgeEvent *events_start,
+                                  const EdgeEvent *events_end) const {
             /* Initially, the split plane is placed left of the scene
                and thus all geometry is on its right side */
-            Size left_count[Dimension], right_count[Dimension];
-            for (size_t i = 0; i < Dimension; ++i) {
-                left_count[i] = 0;
-                right_count[i] = prim_count;
-            }
+            Size left_count = 0, right_count = prim_count;
 
-            /* Keep track of where events for different axes start */
-            EdgeEvent* events_by_dimension[Dimension + 1] { };
-            events_by_dimension[0] = events_start;
-            events_by_dimension[Dimension] = events_end;
-
-            /* Iterate over all events and find the best split plane */
             SplitCandidate best;
             for (auto event = events_start; event != events_end; ) {
                 /* Record the current position and count the number
@@ -1183,7 +1202,7 @@ protected:
                 int axis = event->axis;
                 Scalar pos = event->pos;
 
-                while (event < events_end && event->pos == pos && event->axis == axis) {
+                while (event < events_end && event->pos == pos) {
                     switch (event->type) {
                         case EdgeEvent::Type::EdgeStart:  ++num_start;  break;
                         case EdgeEvent::Type::EdgePlanar: ++num_planar; break;
@@ -1192,23 +1211,19 @@ protected:
                     ++event;
                 }
 
-                /* Keep track of the beginning of each dimension */
-                if (event < events_end && event->axis != axis)
-                    events_by_dimension[event->axis] = event;
-
                 /* The split plane can now be moved onto 't'. Accordingly, all planar
                    and ending primitives are removed from the right side */
-                right_count[axis] -= num_planar + num_end;
+                right_count -= num_planar + num_end;
 
                 /* Check if the edge event is out of bounds -- when primitive
                    clipping is active, this should never happen! */
-                Assert(!(derived.clip_primitives() &&
+                Assert(!(m_ctx.derived.clip_primitives() &&
                          (pos < bbox.min[axis] || pos > bbox.max[axis])));
 
                 /* Calculate a score using the tree construction heuristic */
                 if (likely(pos > bbox.min[axis] && pos < bbox.max[axis])) {
-                    Size num_left = left_count[axis] + num_planar,
-                         num_right = right_count[axis];
+                    Size num_left = left_count + num_planar,
+                         num_right = right_count;
 
                     Scalar cost = model.inner_cost(
                         axis, pos, model.leaf_cost(num_left),
@@ -1226,8 +1241,8 @@ protected:
                     if (num_planar != 0) {
                         /* There are planar events here -- also consider
                            placing them on the right side */
-                        num_left = left_count[axis];
-                        num_right = right_count[axis] + num_planar;
+                        num_left = left_count;
+                        num_right = right_count + num_planar;
 
                         cost = model.inner_cost(
                             axis, pos, model.leaf_cost(num_left),
@@ -1248,14 +1263,77 @@ protected:
                     which were planar on 't', are moved to the left
                     side. Also, starting prims are now also left of
                     the split plane. */
-                left_count[axis] += num_start + num_planar;
+                left_count += num_start + num_planar;
             }
 
             /* Sanity checks. Everything should now be left of the split plane */
+            Assert(right_count == 0 && left_count == prim_count);
+
+            return best;
+        }
+
+        /// Recursively run the O(N log N builder)
+        Scalar build_nlogn(NodeIterator node, Size prim_count,
+                           EdgeEvent *events_start, EdgeEvent *events_end,
+                           const BoundingBox &bbox, Size depth,
+                           Size bad_refines, bool left_child = true) {
+            const Derived &derived = m_ctx.derived;
+
+            /* Initialize the tree cost model */
+            CostModel model(derived.cost_model());
+            model.set_bounding_box(bbox);
+            Scalar leaf_cost = model.leaf_cost(prim_count);
+
+            /* ==================================================================== */
+            /*                           Stopping criteria                          */
+            /* ==================================================================== */
+
+            if (prim_count <= derived.stop_primitives() || depth >= derived.max_depth()) {
+                make_leaf(node, prim_count, events_start, events_end);
+                return leaf_cost;
+            }
+
+            /* ==================================================================== */
+            /*                        Split candidate search                        */
+            /* ==================================================================== */
+
+            /* First, find the optimal splitting plane according to the
+               tree construction heuristic. To do this in O(n), the search is
+               implemented as a sweep over the edge events */
+
+            bool parallel = derived.parallel_exact_threshold() > 0 &&
+                            prim_count >= derived.parallel_exact_threshold();
+
+            /* Keep track of where events for different axes start */
+            EdgeEvent* events_by_dimension[Dimension + 1] { };
+            events_by_dimension[0] = events_start;
+            events_by_dimension[Dimension] = events_end;
+            for (size_t i = 1; i < Dimension; ++i)
+                events_by_dimension[i] = std::lower_bound(
+                    events_by_dimension[i - 1], events_end, (uint16_t) i,
+                    [](const EdgeEvent &e, uint16_t axis) { return e.axis < axis; });
+
+            /* Sweep over the axes (in parallel for large nodes) and keep the
+               best candidate. Ties are resolved in favor of lower axes. */
+            SplitCandidate best_by_dimension[Dimension];
+            auto sweep = [&](size_t axis) {
+                Assert(events_by_dimension[axis] != events_end &&
+                       events_by_dimension[axis]->axis == axis);
+                best_by_dimension[axis] =
+                    sweep_axis(model, bbox, prim_count, events_by_dimension[axis],
+                               events_by_dimension[axis + 1]);
+            };
+
+            if (parallel)
+                tbb::parallel_for(size_t(0), Dimension, sweep);
+            else
+                for (size_t i = 0; i < Dimension; ++i)
+                    sweep(i);
+
+            SplitCandidate best;
             for (size_t i = 0; i < Dimension; ++i) {
-                Assert(right_count[i] == 0 && left_count[i] == prim_count);
-                Assert(events_by_dimension[i] != events_end && events_by_dimension[i]->axis == i);
-                Assert((i == 0) || ((events_by_dimension[i]-1)->axis == i - 1));
+                if (best_by_dimension[i].cost < best.cost)
+                    best = best_by_dimension[i];
             }
 
             /* Allow a few bad refines in sequence before giving up */
@@ -1483,8 +1561,15 @@ protected:
                 m_ctx.pruned += pruned_left + pruned_right;
 
                 /* Sort the events due to primitives which overlap the split plane */
-                std::sort(new_left_events_start, new_left_events_end);
-                std::sort(new_right_events_start, new_right_events_end);
+                if (parallel) {
+                    tbb::parallel_invoke(
+                        [&] { tbb::parallel_sort(new_left_events_start, new_left_events_end); },
+                        [&] { tbb::parallel_sort(new_right_events_start, new_right_events_end); }
+                    );
+                } else {
+                    std::sort(new_left_events_start, new_left_events_end);
+                    std::sort(new_right_events_start, new_right_events_end);
+                }
 
                 /* Merge the left list */
                 left_events_end = std::merge(temp_left_events_start,
@@ -1523,21 +1608,51 @@ protected:
                       "to store overly large offset to left child node (%i)",
                       left_offset);
 
-            Scalar left_cost =
-                build_nlogn(children, best.left_count - pruned_left,
-                            left_events_start, left_events_end, left_bbox,
-                            depth + 1, bad_refines, true);
-
-            Scalar right_cost =
-                build_nlogn(std::next(children), best.right_count - pruned_right,
-                            right_events_start, right_events_end, right_bbox,
-                            depth + 1, bad_refines, false);
+            Scalar left_cost = 0, right_cost = 0;
 
-            /* Release the index lists not needed by the children anymore */
-            if (left_child)
-                right_alloc.release(right_events_start);
-            else
-                left_alloc.release(left_events_start);
+            if (parallel) {
+                /* Build the subtrees in separate tasks. The allocators are
+                   local to this thread, hence the events are moved into
+                   buffers that are owned by the tasks. */
+                EdgeEventVector left_events(left_events_start, left_events_end),
+                                right_events(right_events_start, right_events_end);
+
+                if (left_child)
+                    right_alloc.release(right_events_start);
+                else
+                    left_alloc.release(left_events_start);
+
+                BuildTask &left_task = *new (allocate_child()) BuildTask(
+                    m_ctx, children, std::move(left_events),
+                    best.left_count - pruned_left, left_bbox, depth + 1,
+                    bad_refines, &left_cost);
+
+                BuildTask &right_task = *new (allocate_child()) BuildTask(
+                    m_ctx, std::next(children), std::move(right_events),
+                    best.right_count - pruned_right, right_bbox, depth + 1,
+                    bad_refines, &right_cost);
+
+                set_ref_count(3);
+                spawn(left_task);
+                spawn(right_task);
+                wait_for_all();
+            } else {
+                left_cost =
+                    build_nlogn(children, best.left_count - pruned_left,
+                                left_events_start, left_events_end, left_bbox,
+                                depth + 1, bad_refines, true);
+
+                right_cost =
+                    build_nlogn(std::next(children), best.right_count - pruned_right,
+                                right_events_start, right_events_end, right_bbox,
+                                depth + 1, bad_refines, false);
+
+                /* Release the index lists not needed by the children anymore */
+                if (left_child)
+                    right_alloc.release(right_events_start);
+                else
+                    left_alloc.release(left_events_start);
+            }
 
             /* ==================================================================== */
             /*                           Final decision                             */
@@ -1611,7 +1726,11 @@ protected:
             IndexVector().swap(m_indices);
 
             /* Sort the events list and remove invalid ones from the end */
-            std::sort(events_start, events_end);
+            if (derived.parallel_exact_threshold() > 0 &&
+                prim_count >= derived.parallel_exact_threshold())
+                tbb::parallel_sort(events_start, events_end);
+            else
+                std::sort(events_start, events_end);
             while (events_start != events_end && !(events_end-1)->valid())
                 --events_end;
 
@@ -1628,6 +1747,28 @@ protected:
             return cost;
         }
 
+        /// Continue the O(N log N) builder with an edge event list handed over by a parent task
+        Scalar resume_nlogn() {
+            m_local = &((LocalBuildContext &) m_ctx.local);
+            m_local->classification_storage.resize(m_ctx.derived.primitive_count());
+            m_local->ctx = &m_ctx;
+
+            /* Move the events into the allocator of the current thread */
+            Size event_count = Size(m_events.size());
+            EdgeEvent *events_start =
+                m_local->left_alloc.template allocate<EdgeEvent>(event_count),
+                *events_end = events_start + event_count;
+            std::copy(m_events.begin(), m_events.end(), events_start);
+            EdgeEventVector().swap(m_events);
+
+            Scalar cost = build_nlogn(m_node, m_event_prim_count, events_start,
+                                      events_end, m_bbox, m_depth, m_bad_refines);
+
+            m_local->left_alloc.release(events_start);
+
+            return cost;
+        }
+
         /// Create a leaf node using the given set of indices (called by min-max binning)
         template <typename T> void make_leaf(T &&indices) {
             auto it = m_ctx.index_storage.grow_by(indices.begin(), indices.end());
@@ -1677,6 +1818,95 @@ protected:
         }
     };
 
+    /// Leaf node along with its cell and primitives (used by \ref update())
+    struct UpdateLeaf {
+        Size node;
+        BoundingBox bbox;
+        Size depth;
+        Size prior_count;
+        IndexVector prims;
+        bool rebuilt = false;
+    };
+
+    /// Collect all leaves of a subtree while removing changed primitives
+    void update_gather(const KDNode *node, const BoundingBox &bbox, Size depth,
+                       const std::vector<bool> &is_changed,
+                       std::vector<UpdateLeaf> &leaves, std::vector<Size> &leaf_id) const {
+        if (node->leaf()) {
+            UpdateLeaf leaf;
+            leaf.node = Size(node - m_nodes.get());
+            leaf.bbox = bbox;
+            leaf.depth = depth;
+            leaf.prior_count = node->primitive_count();
+            for (Size i = 0; i < leaf.prior_count; ++i) {
+                Index prim = m_indices[node->primitive_offset() + i];
+                if (!is_changed[prim])
+                    leaf.prims.push_back(prim);
+            }
+            leaf_id[leaf.node] = Size(leaves.size());
+            leaves.push_back(std::move(leaf));
+        } else {
+            Index axis = node->axis();
+            Scalar split = Scalar(node->split());
+            BoundingBox left_bbox(bbox), right_bbox(bbox);
+            left_bbox.max[axis] = split;
+            right_bbox.min[axis] = split;
+            update_gather(node->left(), left_bbox, depth + 1, is_changed, leaves, leaf_id);
+            update_gather(node->right(), right_bbox, depth + 1, is_changed, leaves, leaf_id);
+        }
+    }
+
+    /// Find the leaves overlapped by a primitive
+    void update_insert(const KDNode *node, const BoundingBox &bbox, Index prim,
+                       const BoundingBox &prim_bbox, const std::vector<Size> &leaf_id,
+                       std::vector<std::pair<Size, Index>> &result) const {
+        if (node->leaf()) {
+            if (m_clip_primitives && !derived().bbox(prim, bbox).valid())
+                return;
+            result.emplace_back(leaf_id[node - m_nodes.get()], prim);
+        } else {
+            Index axis = node->axis();
+            Scalar split = Scalar(node->split());
+            if (prim_bbox.min[axis] <= split) {
+                BoundingBox left_bbox(bbox);
+                left_bbox.max[axis] = split;
+                update_insert(node->left(), left_bbox, prim, prim_bbox, leaf_id, result);
+            }
+            if (prim_bbox.max[axis] >= split) {
+                BoundingBox right_bbox(bbox);
+                right_bbox.min[axis] = split;
+                update_insert(node->right(), right_bbox, prim, prim_bbox, leaf_id, result);
+            }
+        }
+    }
+
+    /**
+     * \brief Traversal reads the tree from all threads: in NUMA mode, spread
+     * it over the memory of all nodes instead of the builders' nodes
+     */
+    void interleave_memory() {
+        if (numa::enabled()) {
+            numa::interleave(m_nodes.get(), m_node_count * sizeof(KDNode));
+            numa::interleave(m_indices.get(), m_index_count * sizeof(Index));
+        }
+    }
+
+    /// Recursively evaluate the cost model over a subtree
+    Scalar expected_cost(const KDNode *node, const BoundingBox &bbox) const {
+        Scalar weight = CostModel::eval(bbox);
+        if (node->leaf())
+            return weight * m_cost_model.leaf_cost(node->primitive_count());
+
+        Index axis = node->axis();
+        Scalar split = Scalar(node->split());
+        BoundingBox left_bbox(bbox), right_bbox(bbox);
+        left_bbox.max[axis] = split;
+        right_bbox.min[axis] = split;
+        return weight * m_cost_model.traversal_cost() +
+               expected_cost(node->left(), left_bbox) +
+               expected_cost(node->right(), right_bbox);
+    }
+
     void compute_statistics(BuildContext &ctx, const KDNode *node,
                             const BoundingBox &bbox, Size depth) {
         if (depth > ctx.max_depth)
@@ -1733,6 +1963,9 @@ protected:
         Log(m_log_level, "   Min-max bins             : %i", m_min_max_bins);
         Log(m_log_level, "   O(n log n) method        : use for <= %i primitives",
             m_exact_prim_threshold);
+        if (m_parallel_exact_threshold > 0)
+            Log(m_log_level, "   Parallel O(n log n)      : use for >= %i primitives",
+                m_parallel_exact_threshold);
         Log(m_log_level, "   Stopping primitive count : %i", m_stop_primitives);
         Log(m_log_level, "   Perfect splits           : %s",
             m_clip_primitives ? "yes" : "no");
@@ -1785,7 +2018,7 @@ protected:
         m_node_count = Size(ctx.node_storage.size());
         m_index_count = Size(ctx.index_storage.size());
 
-        m_indices.reset(new Index[m_index_count]);
+        m_indices = huge_page_array<Index>(m_index_count);
         tbb::parallel_for(
             tbb::blocked_range<Size>(0u, m_index_count, MTS_KD_GRAIN_SIZE),
             [&](const tbb::blocked_range<Size> &range) {
@@ -1796,7 +2029,7 @@ protected:
 
         tbb::concurrent_vector<Index>().swap(ctx.index_storage);
 
-        m_nodes.reset(new KDNode[m_node_count]);
+        m_nodes = huge_page_array<KDNode>(m_node_count);
         tbb::parallel_for(
             tbb::blocked_range<Size>(0u, m_node_count, MTS_KD_GRAIN_SIZE),
             [&](const tbb::blocked_range<Size> &range) {
@@ -1806,6 +2039,8 @@ protected:
         );
         tbb::concurrent_vector<KDNode>().swap(ctx.node_storage);
 
+        interleave_memory();
+
         /* Slightly avoid the bounding box to avoid numerical issues
            involving geometry that exactly lies on the boundary */
         Vector extra = (m_bbox.extents() + 1.f) * math::Epsilon<Scalar>;
@@ -1878,11 +2113,209 @@ protected:
                 final_cost);
             Log(m_log_level, "");
         }
+
+        m_build_cost = expected_cost();
+    }
+
+    /**
+     * \brief Incrementally update the tree after some primitives have moved
+     *
+     * Instead of building a new tree from scratch, the split planes of the
+     * existing tree are retained: the specified primitives are removed from
+     * all leaves and reinserted into the leaves overlapped by their new
+     * bounding boxes. Leaves that end up with more primitives than before
+     * (and more than the stopping primitive count) are replaced by newly
+     * built subtrees. Primitives must not be added or removed.
+     *
+     * \param changed
+     *     List of <tt>[start, end)</tt> ranges of changed primitive indices
+     *
+     * \return
+     *     Expected query cost of the updated tree relative to the cost of
+     *     the tree created by the last full build (1 means no quality loss)
+     */
+    Scalar update(const std::vector<std::pair<Index, Index>> &changed) {
+        if (!ready())
+            Throw("The kd-tree must be built before it can be updated!");
+
+        Size prim_count = derived().primitive_count();
+        std::vector<bool> is_changed(prim_count, false);
+        IndexVector changed_prims;
+        for (auto [start, end] : changed) {
+            Assert(start <= end && end <= prim_count);
+            for (Index i = start; i < end; ++i) {
+                if (!is_changed[i]) {
+                    is_changed[i] = true;
+                    changed_prims.push_back(i);
+                }
+            }
+        }
+
+        /* Primitives may have moved outside of the tree's bounds. The
+           outermost cells implicitly grow along with the bounding box. */
+        BoundingBox bbox = m_bbox;
+        for (Index i : changed_prims) {
+            BoundingBox prim_bbox = derived().bbox(i);
+            if (prim_bbox.valid())
+                bbox.expand(prim_bbox);
+        }
+        if (!m_bbox.contains(bbox)) {
+            Vector extra = (bbox.extents() + 1.f) * math::Epsilon<Scalar>;
+            m_bbox.min = bbox.min - extra;
+            m_bbox.max = bbox.max + extra;
+        }
+
+        /* ==================================================================== */
+        /*        Remove changed primitives and reinsert them into leaves       */
+        /* ==================================================================== */
+
+        std::vector<UpdateLeaf> leaves;
+        std::vector<Size> leaf_id(m_node_count, (Size) -1);
+        update_gather(m_nodes.get(), m_bbox, 0, is_changed, leaves, leaf_id);
+
+        tbb::concurrent_vector<std::pair<Size, Index>> insertions;
+        tbb::parallel_for(
+            tbb::blocked_range<Size>(0u, Size(changed_prims.size()), MTS_KD_GRAIN_SIZE / 16),
+            [&](const tbb::blocked_range<Size> &range) {
+                std::vector<std::pair<Size, Index>> local;
+                for (Size i = range.begin(); i != range.end(); ++i) {
+                    Index prim = changed_prims[i];
+                    BoundingBox prim_bbox = derived().bbox(prim);
+                    if (prim_bbox.valid())
+                        update_insert(m_nodes.get(), m_bbox, prim, prim_bbox,
+                                      leaf_id, local);
+                }
+                if (!local.empty())
+                    insertions.grow_by(local.begin(), local.end());
+            }
+        );
+
+        // Sort to obtain a deterministic primitive order within the leaves
+        std::sort(insertions.begin(), insertions.end());
+        for (auto [leaf, prim] : insertions)
+            leaves[leaf].prims.push_back(prim);
+
+        /* ==================================================================== */
+        /*             Rebuild subtrees for leaves that gained geometry         */
+        /* ==================================================================== */
+
+        std::vector<Size> rebuild;
+        for (Size i = 0; i < Size(leaves.size()); ++i) {
+            const UpdateLeaf &leaf = leaves[i];
+            if (leaf.prims.size() > std::max(leaf.prior_count, m_stop_primitives) &&
+                leaf.depth < m_max_depth)
+                rebuild.push_back(i);
+        }
+
+        BuildContext ctx(derived());
+        if (!rebuild.empty()) {
+            ctx.node_storage.grow_by(rebuild.size());
+            std::vector<Scalar> costs(rebuild.size());
+
+            tbb::parallel_for(
+                tbb::blocked_range<Size>(0u, Size(rebuild.size()), 1),
+                [&](const tbb::blocked_range<Size> &range) {
+                    for (Size i = range.begin(); i != range.end(); ++i) {
+                        UpdateLeaf &leaf = leaves[rebuild[i]];
+
+                        BoundingBox tight_bbox;
+                        for (Index prim : leaf.prims)
+                            tight_bbox.expand(derived().bbox(prim, leaf.bbox));
+                        if (!tight_bbox.valid())
+                            tight_bbox = BoundingBox(leaf.bbox.min);
+
+                        BuildTask &task = *new (tbb::task::allocate_root()) BuildTask(
+                            ctx, ctx.node_storage.begin() + i, std::move(leaf.prims),
+                            leaf.bbox, tight_bbox, leaf.depth, 0, &costs[i]);
+                        tbb::task::spawn_root_and_wait(task);
+                        leaf.rebuilt = true;
+                    }
+                }
+            );
+        }
+
+        /* ==================================================================== */
+        /*      Assemble the node and index lists (new subtrees are appended)   */
+        /* ==================================================================== */
+
+        Size subtree_nodes = Size(ctx.node_storage.size()),
+             node_count    = m_node_count + subtree_nodes;
+
+        size_t index_count = 0;
+        for (const UpdateLeaf &leaf : leaves) {
+            if (!leaf.rebuilt)
+                index_count += leaf.prims.size();
+        }
+        size_t subtree_indices = index_count;
+        index_count += ctx.index_storage.size();
+
+        HugePageArray<KDNode> nodes = huge_page_array<KDNode>(node_count);
+        HugePageArray<Index> indices = huge_page_array<Index>(index_count);
+        std::copy(m_nodes.get(), m_nodes.get() + m_node_count, nodes.get());
+        std::copy(ctx.index_storage.begin(), ctx.index_storage.end(),
+                  indices.get() + subtree_indices);
+
+        bool success = true;
+        size_t offset = 0;
+        for (const UpdateLeaf &leaf : leaves) {
+            if (leaf.rebuilt)
+                continue;
+            success &= nodes[leaf.node].set_leaf_node(offset, leaf.prims.size());
+            std::copy(leaf.prims.begin(), leaf.prims.end(), indices.get() + offset);
+            offset += leaf.prims.size();
+        }
+
+        for (Size i = 0; i < subtree_nodes; ++i) {
+            KDNode node = ctx.node_storage[i];
+            if (node.leaf())
+                success &= node.set_leaf_node(subtree_indices + node.primitive_offset(),
+                                              node.primitive_count());
+            nodes[m_node_count + i] = node;
+        }
+
+        // Replace the original leaves by the roots of the new subtrees
+        for (Size i = 0; i < Size(rebuild.size()); ++i) {
+            Size target = leaves[rebuild[i]].node;
+            KDNode node = nodes[m_node_count + i];
+            if (!node.leaf())
+                success &= node.set_inner_node(node.axis(), node.split(),
+                    size_t(m_node_count + i + node.left_offset() - target));
+            nodes[target] = node;
+        }
+
+        if (!success)
+            Throw("Internal error: could not update the kd-tree -- too much geometry?");
+
+        m_nodes = std::move(nodes);
+        m_indices = std::move(indices);
+        m_node_count = node_count;
+        m_index_count = Size(index_count);
+        interleave_memory();
+
+        Scalar cost = expected_cost(),
+               ratio = m_build_cost > 0 ? cost / m_build_cost : Scalar(1);
+
+        Log(m_log_level, "kd-tree update: %i primitives changed, %i subtrees rebuilt, "
+            "expected cost %.2f (%.2f after the last full build)",
+            changed_prims.size(), rebuild.size(), cost, m_build_cost);
+
+        return ratio;
+    }
+
+    /**
+     * \brief Return the expected cost of a query according to the cost
+     * model of the tree (normalized by the cost model of the root node)
+     */
+    Scalar expected_cost() const {
+        Scalar root = CostModel::eval(m_bbox);
+        if (!ready() || !(root > 0))
+            return 0;
+        return expected_cost(m_nodes.get(), m_bbox) / root;
     }
 
 protected:
-    std::unique_ptr<KDNode[]> m_nodes;
-    std::unique_ptr<Index[]> m_indices;
+    HugePageArray<KDNode> m_nodes;
+    HugePageArray<Index> m_indices;
     Size m_node_count = 0;
     Size m_index_count = 0;
 
@@ -1893,9 +2326,11 @@ protected:
     Size m_stop_primitives = 3;
     Size m_max_bad_refines = 0;
     Size m_exact_prim_threshold = 65536;
+    Size m_parallel_exact_threshold = 8192;
     Size m_min_max_bins = 128;
     LogLevel m_log_level = Debug;
     BoundingBox m_bbox;
+    Scalar m_build_cost = 0;
 };
 
 template <typename BoundingBox, typename Index, typename CostModel, typename Derived>
@@ -2005,6 +2440,28 @@ private:
     Float m_empty_space_bonus;
 };
 
+/**
+ * \brief Build quality presets of \ref ShapeKDTree
+ *
+ * Each preset selects the number of Min-Max bins, whether primitives are
+ * clipped (perfect splits) and the threshold at which the builder switches to
+ * the O(N log N) method. Parameters that were specified explicitly always
+ * take precedence over the preset.
+ */
+enum class KDBuildQuality : uint32_t {
+    /// Pick the preset minimizing the predicted build and ray tracing time
+    Auto = 0,
+
+    /// Coarse binning without primitive clipping (for previews)
+    Fast,
+
+    /// Default parameters of the builder
+    Balanced,
+
+    /// Finer binning and the O(N log N) builder for large subtrees
+    High
+};
+
 template <typename Float, typename Spectrum>
 class MTS_EXPORT_RENDER ShapeKDTree : public TShapeKDTree<BoundingBox<Point<scalar_t<Float>, 3>>, uint32_t,
                                                           SurfaceAreaHeuristic3<scalar_t<Float>>,
@@ -2023,8 +2480,12 @@ public:
     using Base::set_exact_primitive_threshold;
     using Base::set_max_depth;
     using Base::set_min_max_bins;
+    using Base::set_parallel_exact_threshold;
     using Base::set_retract_bad_splits;
     using Base::set_stop_primitives;
+    using Base::stop_primitives;
+    using Base::cost_model;
+    using Base::expected_cost;
     using Base::bbox;
     using Base::m_bbox;
     using Base::m_nodes;
@@ -2041,6 +2502,50 @@ public:
     /// Build the kd-tree
     void build();
 
+    /**
+     * \brief Update the kd-tree after the geometry of some shapes has changed
+     *
+     * When the shapes retain their number of primitives, the changed
+     * primitives are reinserted into the existing tree and only the subtrees
+     * that gained geometry are rebuilt. This gradually degrades the quality
+     * of the tree: once its expected query cost exceeds that of the last full
+     * build by the factor given by the \c kd_rebuild_threshold parameter
+     * (default: 1.5), the tree is rebuilt from scratch.
+     *
+     * \return
+     *     Expected query cost of the resulting tree relative to a full
+     *     rebuild (1 means no quality loss)
+     */
+    ScalarFloat update(const std::vector<Shape *> &shapes);
+
+    /// Discard the tree and build it again from scratch
+    void rebuild();
+
+    /// Return the build quality preset (specified via \c kd_quality)
+    KDBuildQuality build_quality() const { return m_quality; }
+
+    /// Set the build quality preset (takes effect at the next \ref build())
+    void set_build_quality(KDBuildQuality quality) { m_quality = quality; }
+
+    /**
+     * \brief Set the number of samples that will be rendered using this tree
+     *
+     * Together with the \c kd_rays_per_sample parameter (default: 4), this
+     * determines the number of queries that the \ref KDBuildQuality::Auto
+     * preset weighs against the build time.
+     */
+    void set_sample_budget(double samples) { m_sample_budget = samples; }
+
+    /**
+     * \brief Predict the build time (in seconds) and the cost of a ray query
+     * (in nanoseconds) when building the current set of shapes using the
+     * given preset
+     *
+     * These are rough estimates based on the primitive count and the
+     * surface area heuristic, intended to compare presets with each other.
+     */
+    std::pair<double, double> predict_cost(KDBuildQuality quality) const;
+
     /// Return the number of registered shapes
     Size shape_count() const { return Size(m_shapes.size()); }
 
@@ -2092,6 +2597,9 @@ public:
         // Resulting intersection struct
         PreliminaryIntersection3f pi;
 
+        // Traversal statistics (only kept when MTS_ENABLE_COUNTERS is defined)
+        LocalCounters counters;
+
         // Intersect against the scene bounding box
         auto bbox_result = m_bbox.ray_intersect(ray);
 
@@ -2100,6 +2608,7 @@ public:
 
         const KDNode *node = m_nodes.get();
         while (mint <= maxt) {
+            counters.add(Counter::KDNodeVisit, 1);
             if (likely(!node->leaf())) { // Inner node
                 const Float split   = node->split();
                 const uint32_t axis = node->axis();
@@ -2142,6 +2651,7 @@ public:
                 for (Index i = prim_start; i < prim_end; i++) {
                     Index prim_index = m_indices[i];
 
+                    counters.add(Counter::KDPrimitiveTest, 1);
                     PreliminaryIntersection3f prim_pi =
                         intersect_prim<ShadowRay>(prim_index, ray, true);
 
@@ -2190,6 +2700,9 @@ public:
         // Resulting intersection struct
         PreliminaryIntersection3f pi;
 
+        // Traversal statistics (only kept when MTS_ENABLE_COUNTERS is defined)
+        LocalCounters counters;
+
         const KDNode *node = m_nodes.get();
 
         /* Intersect against the scene bounding box */
@@ -2203,6 +2716,11 @@ public:
                 active = active && !pi.is_valid();
 
             if (likely(any(active))) {
+                size_t active_lanes = count(active);
+                counters.add(Counter::KDNodeVisit, active_lanes);
+                counters.add(Counter::PacketActiveLanes, active_lanes);
+                counters.add(Counter::PacketLanes, array_size_v<Float>);
+
                 if (likely(!node->leaf())) { // Inner node
                     const scalar_t<Float> split = node->split();
                     const uint32_t axis = node->axis();
@@ -2266,6 +2784,7 @@ public:
                     for (Index i = prim_start; i < prim_end; i++) {
                         Index prim_index = m_indices[i];
 
+                        counters.add(Counter::KDPrimitiveTest, active_lanes);
                         PreliminaryIntersection3f prim_pi =
                             intersect_prim<ShadowRay>(prim_index, ray, active);
 
@@ -2389,9 +2908,19 @@ protected:
         }
     }
 
+protected:
+    /// Configure the builder according to a (resolved) quality preset
+    void apply_build_quality(KDBuildQuality quality);
+
 protected:
     std::vector<ref<Shape>> m_shapes;
     std::vector<Size> m_primitive_map;
+    ScalarFloat m_rebuild_threshold = 1.5f;
+    KDBuildQuality m_quality = KDBuildQuality::Balanced;
+    double m_sample_budget = 0.0;
+    ScalarFloat m_rays_per_sample = 4.f;
+    /// Builder parameters that were specified explicitly (and override the preset)
+    bool m_fixed_bins = false, m_fixed_clip = false, m_fixed_exact = false;
 };
 
 MTS_EXTERN_CLASS_RENDER(ShapeKDTree)
@@ -21,6 +21,18 @@ public:
     get_combined_extinction(const MediumInteraction3f &mi,
                             Mask active = true) const = 0;
 
+    /**
+     * \brief Returns the control extinction used by residual ratio tracking,
+     * along with a majorant of the residual extinction |Sigma_t - control|
+     *
+     * The default implementation returns a zero control extinction and the
+     * combined extinction as residual majorant, which reduces residual ratio
+     * tracking to ratio tracking.
+     */
+    virtual std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>
+    get_control_extinction(const MediumInteraction3f &mi,
+                           Mask active = true) const;
+
     /// Returns the medium coefficients Sigma_s, Sigma_n and Sigma_t evaluated
     /// at a given MediumInteraction mi
     virtual std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum,
@@ -68,6 +80,28 @@ public:
     eval_tr_and_pdf(const MediumInteraction3f &mi,
                     const SurfaceInteraction3f &si, Mask active) const;
 
+    /**
+     * \brief Estimate the transmittance along a ray segment using residual
+     * ratio tracking [Novák et al. 2014]
+     *
+     * The transmittance of the control extinction (see \ref
+     * get_control_extinction()) is evaluated analytically, and only the
+     * residual is estimated using ratio tracking. Tentative collisions are
+     * sampled proportionally to the residual majorant of the given channel.
+     * Unlike delta tracking, the estimate is not binary, and the number of
+     * medium lookups decreases as the control extinction becomes tighter.
+     *
+     * \param ray      Ray segment within this medium (between \c ray.mint
+     *                 and \c ray.maxt)
+     * \param sampler  Sampler used to generate the tentative collisions
+     * \param channel  The channel according to which collisions are sampled.
+     *                 This argument is only used when rendering in RGB modes.
+     *
+     * \return         An unbiased (spectral) estimate of the transmittance
+     */
+    UnpolarizedSpectrum eval_tr_residual_ratio(const Ray3f &ray, Sampler *sampler,
+                                               UInt32 channel, Mask active) const;
+
     /// Return the phase function of this medium
     MTS_INLINE const PhaseFunction *phase_function() const {
         return m_phase_function.get();
@@ -105,6 +139,15 @@ protected:
     std::string m_id;
 };
 
+/**
+ * \brief Parse the \c transmittance parameter of the volumetric path tracers,
+ * which selects the transmittance estimator used for shadow rays
+ *
+ * \return \c true for residual ratio tracking (\c "residual_ratio"), or
+ * \c false for ratio tracking (\c "ratio", the default)
+ */
+extern MTS_EXPORT_RENDER bool use_residual_ratio_tracking(const Properties &props);
+
 MTS_EXTERN_CLASS_RENDER(Medium)
 NAMESPACE_END(mitsuba)
 
@@ -122,6 +165,8 @@ ENOKI_CALL_SUPPORT_TEMPLATE_BEGIN(mitsuba::Medium)
     ENOKI_CALL_SUPPORT_METHOD(intersect_aabb)
     ENOKI_CALL_SUPPORT_METHOD(sample_interaction)
     ENOKI_CALL_SUPPORT_METHOD(eval_tr_and_pdf)
+    ENOKI_CALL_SUPPORT_METHOD(eval_tr_residual_ratio)
+    ENOKI_CALL_SUPPORT_METHOD(get_control_extinction)
     ENOKI_CALL_SUPPORT_METHOD(get_scattering_coefficients)
 ENOKI_CALL_SUPPORT_TEMPLATE_END(mitsuba::Medium)
 
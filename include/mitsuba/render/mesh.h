@@ -79,6 +79,19 @@ public:
     template <typename Index>
     MTS_INLINE auto face_indices(Index index, mask_t<Index> active = true) const {
         using Result = Array<replace_scalar_t<Index, uint32_t>, 3>;
+        if constexpr (!is_dynamic_v<Float>) {
+            if (unlikely(m_compact_faces)) {
+                // Two 16-bit indices are packed into each 32-bit word
+                using UInt = replace_scalar_t<Index, uint32_t>;
+                Result result;
+                for (size_t i = 0; i < 3; ++i) {
+                    UInt k = UInt(index) * 3u + (uint32_t) i,
+                         word = gather<UInt>(m_faces_short_buf, k >> 1, active);
+                    result[i] = (word >> ((k & 1u) << 4)) & 0xFFFFu;
+                }
+                return result;
+            }
+        }
         return gather<Result>(m_faces_buf, index, active);
     }
 
@@ -93,6 +106,11 @@ public:
     template <typename Index>
     MTS_INLINE auto vertex_normal(Index index, mask_t<Index> active = true) const {
         using Result = Normal<replace_scalar_t<Index, InputFloat>, 3>;
+        if constexpr (!is_dynamic_v<Float>) {
+            if (unlikely(m_compact_normals))
+                return decode_normal(gather<replace_scalar_t<Index, uint32_t>>(
+                    m_vertex_normals_oct_buf, index, active));
+        }
         return gather<Result>(m_vertex_normals_buf, index, active);
     }
 
@@ -100,6 +118,11 @@ public:
     template <typename Index>
     MTS_INLINE auto vertex_texcoord(Index index, mask_t<Index> active = true) const {
         using Result = Point<replace_scalar_t<Index, InputFloat>, 2>;
+        if constexpr (!is_dynamic_v<Float>) {
+            if (unlikely(m_compact_texcoords))
+                return decode_texcoord(gather<replace_scalar_t<Index, uint32_t>>(
+                    m_vertex_texcoords_half_buf, index, active));
+        }
         return gather<Result>(m_vertex_texcoords_buf, index, active);
     }
 
@@ -116,10 +139,19 @@ public:
     }
 
     /// Does this mesh have per-vertex normals?
-    bool has_vertex_normals() const { return slices(m_vertex_normals_buf) != 0; }
+    bool has_vertex_normals() const {
+        return m_compact_normals || slices(m_vertex_normals_buf) != 0;
+    }
 
     /// Does this mesh have per-vertex texture coordinates?
-    bool has_vertex_texcoords() const { return slices(m_vertex_texcoords_buf) != 0; }
+    bool has_vertex_texcoords() const {
+        return m_compact_texcoords || slices(m_vertex_texcoords_buf) != 0;
+    }
+
+    /// Does this mesh use the compact storage layout (see \ref compact_storage())?
+    bool has_compact_storage() const {
+        return m_compact_normals || m_compact_texcoords || m_compact_faces;
+    }
 
     /// @}
     // =========================================================================
@@ -133,6 +165,39 @@ public:
     /// Recompute the bounding box (e.g. after modifying the vertex positions)
     void recompute_bbox();
 
+    /**
+     * \brief Convert the vertex data into a compact quantized layout
+     *
+     * Vertex normals are octahedral-encoded into 32 bits (2x16 bit), and
+     * texture coordinates are stored in half precision. When \c compact_faces
+     * is set and the mesh has at most 65536 vertices, face indices are
+     * additionally stored using 16 bits. The original single precision
+     * buffers are released, and the corresponding buffer accessors (e.g.
+     * \ref vertex_normals_buffer()) return empty buffers afterwards.
+     *
+     * Decoding happens on the fly in the vertex accessors. The compact
+     * layout is only supported by the CPU variants of the renderer. Vertex
+     * positions always remain in single precision.
+     */
+    void compact_storage(bool compact_faces = false);
+
+    /**
+     * \brief Interleave the vertex and face buffers across all NUMA nodes
+     *
+     * Called when a scene is loaded in NUMA mode (see \ref numa::enabled()).
+     * Only has an effect in the CPU variants of the renderer.
+     */
+    void interleave_memory() const;
+
+    /**
+     * \brief Move large vertex and face buffers into memory backed by huge
+     * pages (see \ref HugePageBuffer)
+     *
+     * Called when a scene is loaded while huge pages are enabled. Only has an
+     * effect in the CPU variants of the renderer.
+     */
+    void move_to_huge_pages();
+
     // =============================================================
     //! @{ \name Shape interface implementation
     // =============================================================
@@ -246,9 +311,22 @@ public:
     /// Return a human-readable string representation of the shape contents.
     virtual std::string to_string() const override;
 
+    /// Return the number of bytes used to store the data of a single vertex
     size_t vertex_data_bytes() const;
+    /// Return the number of bytes used to store the data of a single face
     size_t face_data_bytes() const;
 
+    /// Return the memory used by the vertex, face and sampling data of this mesh
+    MemoryUsage memory_usage() const override;
+
+    /**
+     * \brief Store the vertex, face and attribute data in a scene bundle
+     *
+     * The construction parameters are rewritten to instantiate the
+     * \c bundlemesh plugin, which maps the data from the bundle.
+     */
+    bool write_bundle(SceneBundleWriter *writer, Properties &props) const override;
+
 protected:
     Mesh(const Properties &);
     inline Mesh() {}
@@ -277,6 +355,38 @@ protected:
             const_cast<Mesh *>(this)->build_pmf();
     }
 
+    /// Octahedral encoding of a unit vector into two 16 bit fixed point values
+    static uint32_t encode_normal(const InputNormal3f &n);
+
+    /// Inverse of \ref encode_normal()
+    template <typename UInt>
+    static MTS_INLINE auto decode_normal(const UInt &value) {
+        using Value = replace_scalar_t<UInt, InputFloat>;
+        Value x = Value(value & 0xFFFFu) * (2.f / 65535.f) - 1.f,
+              y = Value(value >> 16) * (2.f / 65535.f) - 1.f,
+              z = 1.f - abs(x) - abs(y),
+              t = max(-z, 0.f);
+        x -= select(x >= 0.f, t, -t);
+        y -= select(y >= 0.f, t, -t);
+        return normalize(Normal<Value, 3>(x, y, z));
+    }
+
+    /// Pack two texture coordinates into a pair of half precision values
+    static uint32_t encode_texcoord(const InputVector2f &uv);
+
+    /// Inverse of \ref encode_texcoord()
+    template <typename UInt>
+    static MTS_INLINE auto decode_texcoord(const UInt &value) {
+        using Value = replace_scalar_t<UInt, InputFloat>;
+        auto decode_half = [](const UInt &h) {
+            // Re-biasing the exponent by a multiplication also handles subnormals
+            Value magnitude = reinterpret_array<Value>((h & 0x7FFFu) << 13) * 0x1p112f;
+            return reinterpret_array<Value>(reinterpret_array<UInt>(magnitude) |
+                                            ((h & 0x8000u) << 16));
+        };
+        return Point<Value, 2>(decode_half(value & 0xFFFFu), decode_half(value >> 16));
+    }
+
     MTS_DECLARE_CLASS()
 
 protected:
@@ -347,6 +457,21 @@ protected:
 
     DynamicBuffer<UInt32> m_faces_buf;
 
+    /// Compact storage layout, see \ref compact_storage()
+    DynamicBuffer<UInt32> m_vertex_normals_oct_buf;
+    DynamicBuffer<UInt32> m_vertex_texcoords_half_buf;
+    DynamicBuffer<UInt32> m_faces_short_buf;
+    bool m_compact_normals = false;
+    bool m_compact_texcoords = false;
+    bool m_compact_faces = false;
+
+    /// Compact layout requested by the user (applied by the loaders)
+    bool m_compact_requested = false;
+    bool m_compact_faces_requested = false;
+
+    /// Keeps the huge page buffers referenced by the buffers above alive
+    std::vector<ref<const Object>> m_huge_page_storage;
+
     std::unordered_map<std::string, MeshAttribute> m_mesh_attributes;
 
 #if defined(MTS_ENABLE_OPTIX)
@@ -72,6 +72,62 @@ public:
      */
     Mask ray_test(const Ray3f &ray, Mask active = true) const;
 
+    /**
+     * \brief Intersect a large batch of rays stored in flat arrays
+     *
+     * The rays are traced in parallel using the scalar intersection routine
+     * of the underlying acceleration data structure. All arrays are
+     * accessed in place and must remain valid for the duration of the call.
+     *
+     * \param count
+     *    Number of rays in the batch
+     *
+     * \param o
+     *    Ray origins (<tt>3 * count</tt> entries, interleaved XYZ)
+     *
+     * \param d
+     *    Ray directions (<tt>3 * count</tt> entries, interleaved XYZ)
+     *
+     * \param mint
+     *    Minimum ray extents (\c count entries), or \c nullptr to use the
+     *    default ray epsilon
+     *
+     * \param maxt
+     *    Maximum ray extents (\c count entries), or \c nullptr for
+     *    unbounded rays
+     *
+     * \param t
+     *    Output: distance to the intersection, or infinity for misses
+     *
+     * \param prim_index
+     *    Output: primitive index within the hit shape, or <tt>(uint32_t) -1</tt>
+     *
+     * \param shape_index
+     *    Output: index of the hit shape in \ref shapes(), or <tt>(uint32_t) -1</tt>
+     *
+     * \param prim_uv
+     *    Output: primitive-local UV coordinates (<tt>2 * count</tt> entries)
+     *
+     * \remark This function is only available in scalar variants.
+     */
+    void ray_intersect_batch(size_t count, const ScalarFloat *o,
+                             const ScalarFloat *d, const ScalarFloat *mint,
+                             const ScalarFloat *maxt, ScalarFloat *t,
+                             uint32_t *prim_index, uint32_t *shape_index,
+                             ScalarFloat *prim_uv) const;
+
+    /**
+     * \brief Test a large batch of rays stored in flat arrays for occlusion
+     *
+     * The parameters have the same meaning as in \ref ray_intersect_batch().
+     * Entry \c i of \c hit is set to \c true if ray \c i intersects the scene.
+     *
+     * \remark This function is only available in scalar variants.
+     */
+    void ray_test_batch(size_t count, const ScalarFloat *o,
+                        const ScalarFloat *d, const ScalarFloat *mint,
+                        const ScalarFloat *maxt, bool *hit) const;
+
     //! @}
     // =============================================================
 
@@ -127,6 +183,24 @@ public:
                                 const DirectionSample3f &ds,
                                 Mask active = true) const;
 
+    /**
+     * \brief Sample a ray leaving one of the emitters of the scene
+     *
+     * The emitter is chosen uniformly using \c sample1, which is then
+     * rescaled and passed on to \ref Endpoint::sample_ray() along with the
+     * remaining arguments. This is the starting point of light and photon
+     * tracing techniques.
+     *
+     * \return
+     *    The sampled ray and the emitted flux divided by the sample
+     *    probability (including the discrete probability of choosing the
+     *    emitter).
+     */
+    std::pair<Ray3f, Spectrum> sample_emitter_ray(Float time, Float sample1,
+                                                  const Point2f &sample2,
+                                                  const Point2f &sample3,
+                                                  Mask active = true) const;
+
     //! @}
     // =============================================================
 
@@ -169,6 +243,9 @@ public:
     /// Update internal state following a parameter update
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override;
 
+    /// Return the memory used by the scene's acceleration data structure
+    MemoryUsage memory_usage() const override;
+
     /// Return whether any of the shape's parameters require gradient
     bool shapes_grad_enabled() const { return m_shapes_grad_enabled; };
 
@@ -185,6 +262,7 @@ protected:
     void accel_init_gpu(const Properties &props);
 
     /// Updates the ray-intersection acceleration data structure
+    void accel_parameters_changed_cpu(const std::vector<Shape *> &shapes);
     void accel_parameters_changed_gpu();
 
     /// Release the ray-intersection acceleration data structure
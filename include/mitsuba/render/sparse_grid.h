@@ -0,0 +1,181 @@
+#pragma once
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/vector.h>
+#include <functional>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Sparse, brick-based storage of a 3D grid of (multi-channel) values
+ *
+ * The grid is partitioned into bricks of 8x8x8 voxels, which are in turn
+ * grouped into tiles of 8x8x8 bricks. A dense root array stores one entry per
+ * tile, and each tile stores one entry per brick. An entry either references
+ * a tile (root) or brick (tile), or, when \ref ConstantFlag is set, a value in
+ * a table of constants. Tiles and bricks whose voxels all have the same value
+ * (in particular empty ones) thus only occupy a single entry. The constant
+ * with index zero is always the zero value.
+ *
+ * Every root and tile entry furthermore stores the minimum and maximum value
+ * (over all channels) of its region, dilated by one voxel to cover the
+ * footprint of trilinear interpolation. These bounds can be used as local
+ * majorants and control variates by tracking methods.
+ *
+ * Voxel values follow the layout of dense grids, i.e. brick \c b stores
+ * voxel (x, y, z) of its 8x8x8 block at
+ * <tt>bricks[(((b * 8 + z) * 8 + y) * 8 + x) * channels + c]</tt>.
+ */
+class MTS_EXPORT_RENDER SparseGrid : public Object {
+public:
+    using Float = float;
+    MTS_IMPORT_CORE_TYPES()
+
+    /// Resolution of a brick (in voxels)
+    static constexpr uint32_t BrickRes = 8;
+    /// Resolution of a tile (in bricks)
+    static constexpr uint32_t TileRes = 8;
+    /// Number of voxels per brick
+    static constexpr uint32_t BrickSize = BrickRes * BrickRes * BrickRes;
+    /// Number of bricks per tile
+    static constexpr uint32_t TileSize = TileRes * TileRes * TileRes;
+    /// Marks root and tile entries that reference the table of constants
+    static constexpr uint32_t ConstantFlag = 0x80000000u;
+
+    /**
+     * \brief Create a sparse grid from dense data
+     *
+     * \param shape
+     *     Resolution of the grid
+     *
+     * \param channel_count
+     *     Number of channels per voxel
+     *
+     * \param data
+     *     Voxel values, where <tt>data[((z * yres + y) * xres + x) * channels + c]</tt>
+     *     stores channel \c c of voxel (x, y, z)
+     *
+     * \param bbox
+     *     Bounding box of the grid (only kept as metadata)
+     */
+    SparseGrid(const ScalarVector3i &shape, uint32_t channel_count,
+               const float *data, const ScalarBoundingBox3f &bbox =
+               ScalarBoundingBox3f(ScalarPoint3f(0.f), ScalarPoint3f(1.f)));
+
+    /**
+     * \brief Load a sparse grid from a file
+     *
+     * Both sparse grid files (created by \ref write()) and dense Mitsuba
+     * binary volume files (<tt>.vol</tt>, which are converted while loading)
+     * are supported.
+     */
+    SparseGrid(const fs::path &filename);
+
+    /// Load a sparse grid from a stream (see \ref write())
+    SparseGrid(Stream *stream);
+
+    /// Write the sparse grid to a stream
+    void write(Stream *stream) const;
+
+    /// Write the sparse grid to a file
+    void write(const fs::path &filename) const;
+
+    /// Return the resolution of the grid (in voxels)
+    const ScalarVector3i &shape() const { return m_shape; }
+
+    /// Return the resolution of the root array (in tiles)
+    const ScalarVector3i &root_shape() const { return m_root_shape; }
+
+    /// Return the number of channels per voxel
+    uint32_t channel_count() const { return m_channel_count; }
+
+    /// Return the bounding box stored along with the grid
+    const ScalarBoundingBox3f &bbox() const { return m_bbox; }
+
+    /// Return the mean value over all voxels and channels
+    double mean() const { return m_mean; }
+
+    /// Return the maximum value over all voxels and channels
+    float max() const { return m_max; }
+
+    /// Return the root array (one entry per tile)
+    const std::vector<uint32_t> &root() const { return m_root; }
+
+    /// Return the tile array (\ref TileSize entries per tile)
+    const std::vector<uint32_t> &tiles() const { return m_tiles; }
+
+    /// Return the voxel values of all bricks (\ref BrickSize voxels per brick)
+    const std::vector<float> &bricks() const { return m_bricks; }
+
+    /// Return the table of constant values (\ref channel_count() entries per constant)
+    const std::vector<float> &constants() const { return m_constants; }
+
+    /// Return interleaved (min, max) bounds of the root entries
+    const std::vector<float> &root_bounds() const { return m_root_bounds; }
+
+    /// Return interleaved (min, max) bounds of the tile entries
+    const std::vector<float> &tile_bounds() const { return m_tile_bounds; }
+
+    /// Return the number of stored tiles
+    size_t tile_count() const { return m_tiles.size() / TileSize; }
+
+    /// Return the number of stored bricks
+    size_t brick_count() const { return m_bricks.size() / (BrickSize * m_channel_count); }
+
+    /// Look up a channel of a voxel (mainly intended for testing)
+    float voxel(const ScalarVector3i &p, uint32_t channel = 0) const;
+
+    /// Return the (min, max) bounds of the region containing the given voxel
+    std::pair<float, float> bounds(const ScalarVector3i &p) const;
+
+    /// Return the size of the sparse representation in bytes
+    size_t size_bytes() const;
+
+    /// Return a human-readable summary
+    std::string to_string() const override;
+
+    MTS_DECLARE_CLASS()
+protected:
+    virtual ~SparseGrid();
+
+    /**
+     * \brief Callback providing dense data to \ref build()
+     *
+     * Given a range <tt>[z_begin, z_end)</tt> of voxel slices, it returns a
+     * pointer to the voxel values of slice \c z_begin, which must remain
+     * valid until the next call. The slices follow in memory.
+     */
+    using SlabFunction = std::function<const float *(int32_t z_begin, int32_t z_end)>;
+
+    /**
+     * \brief Build the hierarchy from dense data (\ref m_shape and \ref
+     * m_channel_count must be set)
+     *
+     * The grid is processed in slabs that are one tile deep, so only the
+     * slices of one slab (plus a one-voxel border) are accessed at a time.
+     */
+    void build(const SlabFunction &slab);
+
+    /// Read the contents of a sparse grid file (following the header)
+    void read(Stream *stream);
+
+protected:
+    ScalarVector3i m_shape;
+    ScalarVector3i m_root_shape;
+    uint32_t m_channel_count;
+    ScalarBoundingBox3f m_bbox;
+    double m_mean;
+    float m_max;
+
+    std::vector<uint32_t> m_root;
+    std::vector<uint32_t> m_tiles;
+    std::vector<float> m_bricks;
+    std::vector<float> m_constants;
+    std::vector<float> m_root_bounds;
+    std::vector<float> m_tile_bounds;
+};
+
+NAMESPACE_END(mitsuba)
@@ -15,6 +15,9 @@ NAMESPACE_BEGIN(mitsuba)
 /**
  * \brief Generates a spiral of blocks to be rendered.
  *
+ * Alternatively, the blocks can be generated in scanline order (see \ref
+ * Order), which completes the image in horizontal strips from top to bottom.
+ *
  * \author Adam Arbree
  * Aug 25, 2005
  * RayTracer.java
@@ -27,6 +30,21 @@ public:
     using Float = float;
     MTS_IMPORT_CORE_TYPES()
 
+    /// Order in which the blocks are generated
+    enum class Order {
+        /// Spiral outwards from the center of the image (the default)
+        Spiral,
+
+        /**
+         * \brief Rows of blocks from top to bottom
+         *
+         * All passes of a row are generated before moving on to the next
+         * one, so that rows are completed as early as possible. Used by
+         * films that stream finished scanlines to disk.
+         */
+        Scanline
+    };
+
     /// Create a new spiral generator for the given size, offset into a larger frame, and block size
     Spiral(Vector2i size, Vector2i offset, size_t block_size, size_t passes = 1);
 
@@ -43,6 +61,15 @@ public:
     /// Reset the spiral to its initial state. Does not affect the number of passes.
     void reset();
 
+    /// Return the order in which the blocks are generated
+    Order order() const { return m_order; }
+
+    /// Set the order in which the blocks are generated and reset the spiral
+    void set_order(Order order) {
+        m_order = order;
+        reset();
+    }
+
     /**
      * Sets the number of time the spiral should automatically reset.
      * Not affected by a call to \ref reset.
@@ -84,6 +111,9 @@ protected:
     /// Number of times the spiral should automatically restart.
     size_t m_remaining_passes;
 
+    /// Order in which the blocks are generated.
+    Order m_order;
+
     /// Protects the spiral's state (thread safety).
     tbb::spin_mutex m_mutex;
 };
@@ -34,6 +34,19 @@ MTS_INLINE value_t<Array3f> srgb_model_mean(const Array3f &coeff) {
     return hmean(result);
 }
 
+/**
+ * \brief Replace the infinite coefficients that \ref srgb_model_fetch()
+ * returns for black and white by finite values
+ *
+ * The resulting spectra differ from the exact ones by less than 3e-5, but the
+ * coefficients can then be interpolated (e.g. by textures that filter in
+ * coefficient space rather than evaluating the model at every texel).
+ */
+template <typename Array3f> MTS_INLINE Array3f srgb_model_finite(Array3f coeff) {
+    coeff.z() = clamp(coeff.z(), -100.f, 100.f);
+    return coeff;
+}
+
 /**
  * Look up the model coefficients for a sRGB color value
  * @param  c An sRGB color value where all components are in [0, 1].
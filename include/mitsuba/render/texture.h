@@ -234,6 +234,20 @@ public:
     /// Returns the maximum value of the texture over all dimensions.
     virtual ScalarFloat max() const;
 
+    /**
+     * \brief Returns a lower and an upper bound of the values of \ref eval()
+     * and \ref eval_1() in the neighborhood of the given point.
+     *
+     * Sparse volumes return bounds of the region containing the point. The
+     * default implementation returns the global range <tt>[0, max()]</tt>.
+     *
+     * Note that no integrator or medium queries these bounds at the moment:
+     * the tracking methods in \c heterogeneous still use the global majorant
+     * derived from \ref max().
+     */
+    virtual std::pair<Float, Float> eval_bounds(const Interaction3f &it,
+                                                Mask active = true) const;
+
     /// Returns the bounding box of the 3d texture
     ScalarBoundingBox3f bbox() const { return m_bbox; }
 
@@ -1,5 +1,6 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/tensor.h>
 #include <mitsuba/core/distr_2d.h>
 #include <mitsuba/core/warp.h>
@@ -23,6 +24,10 @@ public:
     using Warp2D2 = Marginal2D<Float, 2, true>;
     using Warp2D3 = Marginal2D<Float, 3, true>;
 
+    /// Number of color channels of the precomputed tables used in RGB/monochrome modes
+    static constexpr size_t Channels =
+        is_spectral_v<Spectrum> ? 1 : array_size_v<UnpolarizedSpectrum>;
+
     Measured(const Properties &props) : Base(props) {
         if constexpr (is_polarized_v<Spectrum>)
             Throw("The measured BSDF model requires that rendering takes place in spectral mode!");
@@ -133,18 +138,57 @@ public:
                (const ScalarFloat *) theta_i.data }}
         );
 
-        // Construct spectral interpolant
-        m_spectra = Warp2D3(
-            (ScalarFloat *) spectra.data,
-            ScalarVector2u(spectra.shape[4], spectra.shape[3]),
-            {{ (uint32_t) phi_i.shape[0],
-               (uint32_t) theta_i.shape[0],
-               (uint32_t) wavelengths.shape[0] }},
-            {{ (const ScalarFloat *) phi_i.data,
-               (const ScalarFloat *) theta_i.data,
-               (const ScalarFloat *) wavelengths.data }},
-            false, false
-        );
+        if constexpr (is_spectral_v<Spectrum>) {
+            // Construct spectral interpolant
+            m_spectra = Warp2D3(
+                (ScalarFloat *) spectra.data,
+                ScalarVector2u(spectra.shape[4], spectra.shape[3]),
+                {{ (uint32_t) phi_i.shape[0],
+                   (uint32_t) theta_i.shape[0],
+                   (uint32_t) wavelengths.shape[0] }},
+                {{ (const ScalarFloat *) phi_i.data,
+                   (const ScalarFloat *) theta_i.data,
+                   (const ScalarFloat *) wavelengths.data }},
+                false, false
+            );
+        } else {
+            /* Reduce the spectra to the color channels of the renderer
+               once, rather than interpolating them per channel and wavelength
+               during rendering (which does not work in RGB mode anyway) */
+            size_t n_wavelengths = wavelengths.shape[0],
+                   n_slices      = phi_i.shape[0] * theta_i.shape[0],
+                   n_pixels      = spectra.shape[3] * spectra.shape[4];
+            std::vector<ScalarColor3f> weights =
+                color_weights((const ScalarFloat *) wavelengths.data, n_wavelengths);
+
+            const ScalarFloat *in = (const ScalarFloat *) spectra.data;
+            std::unique_ptr<ScalarFloat[]> out(new ScalarFloat[n_slices * n_pixels * Channels]);
+
+            for (size_t slice = 0; slice < n_slices; ++slice) {
+                for (size_t i = 0; i < n_pixels; ++i) {
+                    ScalarColor3f rgb(0.f);
+                    for (size_t k = 0; k < n_wavelengths; ++k)
+                        rgb += in[(slice * n_wavelengths + k) * n_pixels + i] * weights[k];
+                    rgb = max(rgb, 0.f);
+
+                    for (size_t ch = 0; ch < Channels; ++ch) {
+                        ScalarFloat value = Channels == 3 ? rgb[ch] : mitsuba::luminance(rgb);
+                        out[(ch * n_slices + slice) * n_pixels + i] = value;
+                    }
+                }
+            }
+
+            for (size_t ch = 0; ch < Channels; ++ch)
+                m_colors[ch] = Warp2D2(
+                    out.get() + ch * n_slices * n_pixels,
+                    ScalarVector2u(spectra.shape[4], spectra.shape[3]),
+                    {{ (uint32_t) phi_i.shape[0],
+                       (uint32_t) theta_i.shape[0] }},
+                    {{ (const ScalarFloat *) phi_i.data,
+                       (const ScalarFloat *) theta_i.data }},
+                    false, false
+                );
+        }
 
         std::string description_str(
             (const char *) description.data,
@@ -251,11 +295,7 @@ public:
         bs.sampled_type      = +BSDFFlags::GlossyReflection;
         bs.sampled_component = 0;
 
-        UnpolarizedSpectrum spec;
-        for (size_t i = 0; i < array_size_v<UnpolarizedSpectrum>; ++i) {
-            Float params_spec[3] = { phi_i, theta_i, si.wavelengths[i] };
-            spec[i] = m_spectra.eval(sample, params_spec, active);
-        }
+        UnpolarizedSpectrum spec = eval_spectrum(sample, phi_i, theta_i, si, active);
 
         if (m_jacobian)
             spec *= m_ndf.eval(u_m, params, active) /
@@ -309,11 +349,7 @@ public:
         Float params[2] = { phi_i, theta_i };
         auto [sample, unused] = m_vndf.invert(u_m, params, active);
 
-        UnpolarizedSpectrum spec;
-        for (size_t i = 0; i < array_size_v<UnpolarizedSpectrum>; ++i) {
-            Float params_spec[3] = { phi_i, theta_i, si.wavelengths[i] };
-            spec[i] = m_spectra.eval(sample, params_spec, active);
-        }
+        UnpolarizedSpectrum spec = eval_spectrum(sample, phi_i, theta_i, si, active);
 
         if (m_jacobian)
             spec *= m_ndf.eval(u_m, params, active) /
@@ -387,14 +423,70 @@ public:
             << "  ndf = " << string::indent(m_ndf.to_string()) << "," << std::endl
             << "  sigma = " << string::indent(m_sigma.to_string()) << "," << std::endl
             << "  vndf = " << string::indent(m_vndf.to_string()) << "," << std::endl
-            << "  luminance = " << string::indent(m_luminance.to_string()) << "," << std::endl
-            << "  spectra = " << string::indent(m_spectra.to_string()) << std::endl
-            << "]";
+            << "  luminance = " << string::indent(m_luminance.to_string()) << "," << std::endl;
+        if constexpr (is_spectral_v<Spectrum>)
+            oss << "  spectra = " << string::indent(m_spectra.to_string()) << std::endl;
+        else
+            oss << "  colors = " << string::indent(m_colors[0].to_string()) << std::endl;
+        oss << "]";
         return oss.str();
     }
 
     MTS_DECLARE_CLASS()
 private:
+    /// Interpolate the reflectance spectrum at the given VNDF sample position
+    MTS_INLINE UnpolarizedSpectrum eval_spectrum(const Vector2f &sample, Float phi_i,
+                                                 Float theta_i,
+                                                 const SurfaceInteraction3f &si,
+                                                 Mask active) const {
+        if constexpr (is_spectral_v<Spectrum>) {
+            UnpolarizedSpectrum spec;
+            for (size_t i = 0; i < array_size_v<UnpolarizedSpectrum>; ++i) {
+                Float params_spec[3] = { phi_i, theta_i, si.wavelengths[i] };
+                spec[i] = m_spectra.eval(sample, params_spec, active);
+            }
+            return spec;
+        } else {
+            ENOKI_MARK_USED(si);
+            Float params[2] = { phi_i, theta_i };
+            return UnpolarizedSpectrum(Warp2D2::eval(m_colors, sample, params, active));
+        }
+    }
+
+    /**
+     * Compute the linear sRGB color of each spectral sample of the material
+     * (assuming linear interpolation between samples). The result is
+     * normalized so that a constant unit spectrum maps to white.
+     */
+    static std::vector<ScalarColor3f> color_weights(const ScalarFloat *wavelengths,
+                                                    size_t n) {
+        std::vector<ScalarColor3f> weights(n, ScalarColor3f(0.f));
+        ScalarColor3f white(0.f);
+
+        // Integrate the CIE matching functions at 1nm intervals
+        for (ScalarFloat lambda = MTS_CIE_MIN; lambda <= MTS_CIE_MAX; lambda += 1.f) {
+            ScalarColor3f xyz = cie1931_xyz(lambda);
+
+            size_t k = (size_t) (std::lower_bound(wavelengths, wavelengths + n, lambda) -
+                                 wavelengths);
+            if (k == 0 || k == n) {
+                // Clamp the spectrum outside of the measured range
+                weights[k == 0 ? 0 : n - 1] += xyz;
+            } else {
+                ScalarFloat t = (lambda - wavelengths[k - 1]) /
+                                (wavelengths[k] - wavelengths[k - 1]);
+                weights[k - 1] += (1.f - t) * xyz;
+                weights[k] += t * xyz;
+            }
+            white += xyz;
+        }
+
+        ScalarColor3f white_rgb = xyz_to_srgb(white);
+        for (ScalarColor3f &w : weights)
+            w = xyz_to_srgb(w) / white_rgb;
+        return weights;
+    }
+
     template <typename Value> Value u2theta(Value u) const {
         return sqr(u) * (math::Pi<Float> / 2.f);
     }
@@ -418,6 +510,7 @@ private:
     Warp2D2 m_vndf;
     Warp2D2 m_luminance;
     Warp2D3 m_spectra;
+    std::array<Warp2D2, Channels> m_colors;
     bool m_isotropic;
     bool m_jacobian;
     int m_reduction;
@@ -0,0 +1,132 @@
+import struct
+
+import numpy as np
+import pytest
+
+import mitsuba
+
+
+def write_tensor_file(filename, fields):
+    """Write a set of NumPy arrays in the tensor file format of the measured BSDF"""
+    dtypes = { np.dtype(np.uint8): 1, np.dtype(np.float32): 10 }
+
+    header_size = 12 + 2 + 4 + sum(2 + len(name) + 2 + 1 + 8 + 8 * value.ndim
+                                   for name, value in fields.items())
+    header = b'tensor_file\0' + struct.pack('<BBI', 1, 0, len(fields))
+    data, offset = b'', header_size
+    for name, value in fields.items():
+        offset = (offset + 7) // 8 * 8
+        padding = offset - header_size - len(data)
+        data += b'\0' * padding + value.tobytes()
+        header += struct.pack('<H', len(name)) + name.encode()
+        header += struct.pack('<HBQ', value.ndim, dtypes[value.dtype], offset)
+        header += struct.pack('<%iQ' % value.ndim, *value.shape)
+        offset += value.nbytes
+
+    with open(filename, 'wb') as f:
+        f.write(header + data)
+
+
+def make_material(filename, spectrum):
+    """Isotropic material whose spectra vary across the table, following the
+    given relative spectral distribution (as a function of the wavelength)"""
+    res, n_wavelengths = 8, 48
+    theta_i = np.linspace(0, np.pi / 2, 3, dtype=np.float32)
+    phi_i = np.array([-np.pi, np.pi], dtype=np.float32)
+    wavelengths = np.linspace(360, 830, n_wavelengths, dtype=np.float32)
+
+    x = np.linspace(0, 1, res)
+    magnitude = (0.2 + 0.6 * x[None, :]) * (1.0 - 0.3 * x[:, None])
+    spectra = magnitude[None, None, None, :, :] * \
+        spectrum(wavelengths)[None, None, :, None, None]
+    spectra = np.broadcast_to(spectra, (2, 3, n_wavelengths, res, res))
+
+    ones = np.ones((2, 3, res, res), dtype=np.float32)
+    write_tensor_file(filename, {
+        'description': np.frombuffer(b'test material', dtype=np.uint8),
+        'theta_i': theta_i,
+        'phi_i': phi_i,
+        'wavelengths': wavelengths,
+        'ndf': np.ones((res, res), dtype=np.float32),
+        'sigma': np.ones((res, res), dtype=np.float32),
+        'vndf': ones,
+        'luminance': ones,
+        'spectra': np.ascontiguousarray(spectra, dtype=np.float32),
+        'jacobian': np.array([0], dtype=np.uint8)
+    })
+
+
+def directions():
+    """Pairs of incident and outgoing directions in the upper hemisphere"""
+    rng = np.random.RandomState(0)
+    result = []
+    for i in range(8):
+        v = rng.normal(size=(2, 3))
+        v[:, 2] = np.abs(v[:, 2]) + 0.1
+        v /= np.linalg.norm(v, axis=1)[:, None]
+        result.append(v)
+    return result
+
+
+def load_bsdf(filename):
+    from mitsuba.core.xml import load_string
+    return load_string("""<bsdf version="2.0.0" type="measured">
+            <string name="filename" value="%s"/>
+        </bsdf>""" % filename)
+
+
+def eval_spectral_reference(filename):
+    """Evaluate the material in the spectral variant and convert the result to
+    white-balanced linear sRGB by integration against the CIE 1931 curves"""
+    try:
+        mitsuba.set_variant('scalar_spectral')
+    except Exception:
+        pytest.skip('Mitsuba variant "scalar_spectral" is not enabled!')
+
+    from mitsuba.core import cie1931_xyz, xyz_to_srgb
+    from mitsuba.render import BSDFContext, SurfaceInteraction3f
+
+    bsdf = load_bsdf(filename)
+    lambdas = np.arange(360.0, 831.0, 1.0)
+    cmf = np.array([cie1931_xyz(l) for l in lambdas])
+    white = np.array(xyz_to_srgb(np.sum(cmf, axis=0)))
+
+    result = []
+    for wi, wo in directions():
+        si = SurfaceInteraction3f()
+        si.wi = wi
+        values = []
+        for l in lambdas:
+            si.wavelengths = [l] * 4
+            values.append(bsdf.eval(BSDFContext(), si, wo)[0])
+        xyz = np.sum(np.array(values)[:, None] * cmf, axis=0)
+        result.append(np.array(xyz_to_srgb(xyz)) / white)
+    return np.array(result)
+
+
+@pytest.mark.parametrize('spectrum', ['flat', 'ramp'])
+def test01_rgb_matches_spectral(variant_scalar_rgb, tmpdir, spectrum):
+    filename = str(tmpdir.join('material.bsdf'))
+    make_material(filename, {
+        'flat': lambda l: np.ones_like(l),
+        'ramp': lambda l: 0.25 + 0.75 * (l - 360) / 470
+    }[spectrum])
+
+    reference = eval_spectral_reference(filename)
+    mitsuba.set_variant('scalar_rgb')
+    from mitsuba.render import BSDFContext, SurfaceInteraction3f
+
+    bsdf = load_bsdf(filename)
+    result = []
+    for wi, wo in directions():
+        si = SurfaceInteraction3f()
+        si.wi = wi
+        result.append(np.array(bsdf.eval(BSDFContext(), si, wo)))
+    result = np.array(result)
+
+    assert np.all(reference > 0)
+    assert np.allclose(result, reference, rtol=2e-3, atol=1e-5)
+
+    if spectrum == 'flat':
+        # White balance: a constant spectrum maps to gray
+        assert np.allclose(result, result[:, :1], rtol=1e-4)
@@ -31,6 +31,14 @@ Environment emitter (:monosp:`envmap`)
    - |transform|
    - Specifies an optional emitter-to-world transformation.  (Default: none, i.e. emitter space = world space)
 
+ * - warp
+   - |string|
+   - Sample warping scheme used for importance sampling the map. ``hierarchical`` traverses a MIP
+     hierarchy of the image, which costs ``log2(resolution)`` dependent lookups per sample.
+     ``alias`` uses a marginal alias table over rows and one alias table per row, which makes both
+     sampling and density queries constant-time. Both produce the same sampling density.
+     (Default: ``hierarchical``)
+
 This plugin provides a HDRI (high dynamic range imaging) environment map,
 which is a type of light source that is well-suited for representing "natural"
 illumination.
@@ -65,6 +73,7 @@ public:
     MTS_IMPORT_TYPES(Scene, Shape, Texture)
 
     using Warp = Hierarchical2D<Float, 0>;
+    using AliasWarp = Alias2D<Float>;
 
     EnvironmentMapEmitter(const Properties &props) : Base(props) {
         /* Until `set_scene` is called, we have no information
@@ -119,8 +128,14 @@ public:
         m_resolution = bitmap->size();
         m_data = DynamicBuffer<Float>::copy(bitmap->data(), hprod(m_resolution) * 4);
 
+        std::string warp = props.string("warp", "hierarchical");
+        if (warp == "alias")
+            m_alias = true;
+        else if (warp != "hierarchical")
+            Throw("Invalid warp \"%s\", must be one of: \"hierarchical\", or \"alias\"!", warp);
+
         m_scale = props.float_("scale", 1.f);
-        m_warp = Warp(luminance.get(), m_resolution);
+        build_warp(luminance.get());
         m_d65 = Texture::D65(1.f);
         m_flags = EmitterFlags::Infinite | EmitterFlags::SpatiallyVarying;
     }
@@ -157,7 +172,8 @@ public:
     sample_direction(const Interaction3f &it, const Point2f &sample, Mask active) const override {
         MTS_MASKED_FUNCTION(ProfilerPhase::EndpointSampleDirection, active);
 
-        auto [uv, pdf] = m_warp.sample(sample);
+        auto [uv, pdf] = m_alias ? m_alias_warp.sample(sample, active)
+                                 : m_warp.sample(sample, nullptr, active);
 
         Float theta = uv.y() * math::Pi<Float>,
               phi = uv.x() * (2.f * math::Pi<Float>);
@@ -204,7 +220,8 @@ public:
 
         Float inv_sin_theta =
             safe_rsqrt(max(sqr(d.x()) + sqr(d.z()), sqr(math::Epsilon<Float>)));
-        return m_warp.eval(uv) * inv_sin_theta * (1.f / (2.f * sqr(math::Pi<Float>)));
+        Float pdf = m_alias ? m_alias_warp.eval(uv, active) : m_warp.eval(uv, nullptr, active);
+        return pdf * inv_sin_theta * (1.f / (2.f * sqr(math::Pi<Float>)));
     }
 
     ScalarBoundingBox3f bbox() const override {
@@ -251,21 +268,36 @@ public:
                 }
             }
 
-            m_warp = Warp(luminance.get(), m_resolution);
+            build_warp(luminance.get());
         }
     }
 
+    MemoryUsage memory_usage() const override {
+        return { { "environment maps", slices(m_data) * sizeof(ScalarFloat) },
+                 { "sampling tables", m_alias ? m_alias_warp.storage_bytes()
+                                              : m_warp.storage_bytes() } };
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "EnvironmentMapEmitter[" << std::endl
             << "  filename = \"" << m_filename << "\"," << std::endl
             << "  resolution = \"" << m_resolution << "\"," << std::endl
+            << "  warp = " << (m_alias ? "alias" : "hierarchical") << "," << std::endl
             << "  bsphere = " << string::indent(m_bsphere) << std::endl
             << "]";
         return oss.str();
     }
 
 protected:
+    /// Build the sampling tables of the selected warp from luminance values
+    void build_warp(const ScalarFloat *luminance) {
+        if (m_alias)
+            m_alias_warp = AliasWarp(luminance, m_resolution);
+        else
+            m_warp = Warp(luminance, m_resolution);
+    }
+
     UnpolarizedSpectrum eval_spectrum(Point2f uv, const Wavelength &wavelengths, Mask active) const {
         uv *= Vector2f(m_resolution - 1u);
 
@@ -325,6 +357,8 @@ protected:
     DynamicBuffer<Float> m_data;
     ScalarVector2u m_resolution;
     Warp m_warp;
+    AliasWarp m_alias_warp;
+    bool m_alias = false;
     ref<Texture> m_d65;
     ScalarFloat m_scale;
 };
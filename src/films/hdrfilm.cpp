@@ -3,10 +3,17 @@
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
+#include <mitsuba/core/thread.h>
 #include <mitsuba/render/film.h>
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/render/imageblock.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -47,6 +54,50 @@ High dynamic range film (:monosp:`hdrfilm`)
    - If set to |true|, regions slightly outside of the film plane will also be sampled. This may
      improve the image quality at the edges, especially when using very large reconstruction
      filters. In general, this is not needed though. (Default: |false|, i.e. disabled)
+ * - filter_importance_sampling
+   - |bool|
+   - If set to |true|, camera rays are generated by importance sampling the reconstruction
+     filter, and each sample only contributes to the pixel it was generated for (with a weight
+     given by the sign of the filter). This avoids splatting samples into neighboring pixels,
+     which is costly for wide filters and images with many channels, at the cost of slightly
+     higher variance. (Default: |false|)
+ * - compression
+   - |string|
+   - Compression scheme of OpenEXR output. The options are :monosp:`none`, :monosp:`rle`,
+     :monosp:`zips`, :monosp:`zip`, :monosp:`piz`, :monosp:`pxr24`, :monosp:`b44`,
+     :monosp:`b44a`, :monosp:`dwaa`, and :monosp:`dwab`. The last five are lossy.
+     (Default: :monosp:`piz`)
+ * - aov_compression
+   - |string|
+   - Compression scheme of the AOV parts when :monosp:`multipart` is enabled, e.g.
+     :monosp:`zips` to store IDs or depth losslessly while the beauty pass uses a lossy scheme.
+     (Default: same as :monosp:`compression`)
+ * - compression_level
+   - |float|
+   - Quality level of the lossy :monosp:`dwaa` and :monosp:`dwab` compressors, with higher
+     values corresponding to smaller files of lower quality. (Default: 45)
+ * - multipart
+   - |bool|
+   - If set to |true| and the image has AOVs, write a multi-part OpenEXR file with the beauty pass
+     (:monosp:`R`, :monosp:`G`, :monosp:`B`, :monosp:`A`) in one part and one part per AOV
+     group, i.e. per channel name prefix such as :monosp:`albedo` in :monosp:`albedo.R`.
+     (Default: |false|)
+ * - tile_size
+   - |int|
+   - When set to a positive value, OpenEXR output is stored as tiles of the given size instead of
+     scanlines. (Default: 0, i.e. scanlines)
+ * - streaming
+   - |bool|
+   - If set to |true|, the film only keeps the rows of the image that can still receive samples
+     in memory and streams finished scanlines to the OpenEXR file while rendering (see below).
+     Not supported in GPU variants. (Default: |false|)
+ * - snapshot_interval
+   - |float|
+   - When set to a positive value, a background thread periodically develops the current state
+     of the film and writes it to a file named :monosp:`<filename>_snapshot` (with the proper
+     extension) every :monosp:`snapshot_interval` seconds while rendering. Render threads only
+     hold a lock while the film storage is copied. Not supported in GPU variants.
+     (Default: 0, i.e. disabled)
  * - (Nested plugin)
    - :paramtype:`rfilter`
    - Reconstruction filter that should be used by the film. (Default: :monosp:`gaussian`, a windowed
@@ -65,7 +116,30 @@ most purposes.
 
 For OpenEXR files, Mitsuba 2 also supports fully general multi-channel output; refer to
 the :ref:`aov <integrator-aov>` or :ref:`stokes <integrator-stokes>` plugins for
-details on how this works.
+details on how this works. Setting the :monosp:`cost_aov` parameter of a sampling-based
+integrator (e.g. :monosp:`path`) to |true| adds a :monosp:`cost.kcycles` channel with the
+average time spent per sample of each pixel (in thousands of CPU cycles) and, in builds with
+ray tracing counters, a :monosp:`cost.rays` channel with the average number of rays per sample.
+These channels make it easy to spot the expensive materials or volumes of a shot.
+
+Writing many channels at high resolutions with the default lossless :monosp:`piz` compressor
+can take seconds and produce very large files. Setting :monosp:`multipart` to |true| stores
+each AOV group in a separate part of the OpenEXR file, so that the beauty pass can use a lossy
+compressor (e.g. :monosp:`dwaa`) while IDs and depth remain lossless (e.g. with
+:monosp:`aov_compression` set to :monosp:`zips`). The chunks of each part are compressed in
+parallel on the OpenEXR thread pool.
+
+For very large resolutions, holding the whole image with all of its channels in memory (and a
+developed copy of it) may not be feasible. With :monosp:`streaming` enabled, the integrator renders
+the image in horizontal strips of blocks from top to bottom, completing all passes of a strip
+before moving on. As soon as the samples of later strips can no longer reach a row, taking the
+footprint of the reconstruction filter into account, the row is developed and appended to the
+OpenEXR file. Peak film memory is thus bounded by the strips that are currently being rendered plus
+the filter border. In this mode, the output is always written as scanlines, snapshots are
+disabled, and the developed image is not available in memory. Integrators that learn from
+previous passes (e.g. :monosp:`path` with :monosp:`rr_mode` set to :monosp:`adrrs`) render
+each pass over the whole image, so the rows are only written during the final pass and
+memory is not reduced.
 
 The plugin can also write RLE-compressed files in the Radiance RGBE format pioneered by Greg Ward
 (set :monosp:`file_format=rgbe`), as well as the Portable Float Map format
@@ -91,10 +165,52 @@ The following XML snippet discribes a film that writes a full-HD RGBA OpenEXR fi
 
  */
 
+/// Background thread that periodically invokes a callback until it is stopped
+class SnapshotThread : public Thread {
+public:
+    SnapshotThread(float interval, const std::function<void()> &callback)
+        : Thread("snapshot"), m_interval(interval), m_callback(callback) { }
+
+    /// Signal the thread to exit and wait for it to finish
+    void stop() {
+        /* Critical section */ {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        join();
+    }
+
+protected:
+    void run() override {
+        auto interval = std::chrono::duration<float>(m_interval);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_cv.wait_for(lock, interval, [&]() { return m_stop; })) {
+            lock.unlock();
+            try {
+                m_callback();
+            } catch (const std::exception &e) {
+                Log(Warn, "Could not write film snapshot: %s", e.what());
+            }
+            lock.lock();
+        }
+    }
+
+    virtual ~SnapshotThread() { }
+
+private:
+    float m_interval;
+    std::function<void()> m_callback;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+};
+
 template <typename Float, typename Spectrum>
 class HDRFilm final : public Film<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(Film, m_size, m_crop_size, m_crop_offset, m_high_quality_edges, m_filter)
+    MTS_IMPORT_BASE(Film, m_size, m_crop_size, m_crop_offset, m_high_quality_edges,
+                    m_filter_importance_sampling, m_filter)
     MTS_IMPORT_TYPES(ImageBlock)
 
     HDRFilm(const Properties &props) : Base(props) {
@@ -106,6 +222,30 @@ public:
             props.string("component_format", "float16"));
 
         m_dest_file = props.string("filename", "");
+        m_compression = exr_compression(props.string("compression", "piz"));
+        m_aov_compression = props.has_property("aov_compression")
+                                ? exr_compression(props.string("aov_compression"))
+                                : m_compression;
+        m_compression_level = props.float_("compression_level", 45.f);
+        m_multipart = props.bool_("multipart", false);
+
+        int tile_size = props.int_("tile_size", 0);
+        if (tile_size < 0)
+            Throw("The \"tile_size\" parameter must be nonnegative, found %i.", tile_size);
+        m_tile_size = (uint32_t) tile_size;
+        m_snapshot_interval = props.float_("snapshot_interval", 0.f);
+        m_streaming = props.bool_("streaming", false);
+
+        if constexpr (is_cuda_array_v<Float>) {
+            if (m_snapshot_interval > 0.f) {
+                Log(Warn, "Film snapshots are not supported in GPU variants, ignoring.");
+                m_snapshot_interval = 0.f;
+            }
+            if (m_streaming) {
+                Log(Warn, "Streaming output is not supported in GPU variants, ignoring.");
+                m_streaming = false;
+            }
+        }
 
         if (file_format == "openexr" || file_format == "exr")
             m_file_format = Bitmap::FileFormat::OpenEXR;
@@ -180,6 +320,19 @@ public:
             }
         }
 
+        if (m_streaming) {
+            if (m_file_format != Bitmap::FileFormat::OpenEXR)
+                Throw("Streaming output is only supported for OpenEXR files.");
+            if (m_tile_size > 0) {
+                Log(Warn, "Streaming output is written as scanlines, ignoring \"tile_size\".");
+                m_tile_size = 0;
+            }
+            if (m_snapshot_interval > 0.f) {
+                Log(Warn, "Film snapshots are not supported with streaming output, ignoring.");
+                m_snapshot_interval = 0.f;
+            }
+        }
+
         props.mark_queried("banner"); // no banner in Mitsuba 2
     }
 
@@ -198,16 +351,48 @@ public:
                 Throw("Film::prepare(): duplicate channel name \"%s\"", channels[i]);
         }
 
-        m_storage = new ImageBlock(m_crop_size, channels.size());
+        stop_snapshots();
+
+        /* In streaming mode, the storage is a window of rows starting at the
+           first row that has not been written yet. It grows as needed when
+           blocks are merged and slides down as rows are written. */
+        m_stream_writer = nullptr;
+        m_storage = new ImageBlock(
+            m_streaming ? ScalarVector2i(m_crop_size.x(), 1) : m_crop_size,
+            channels.size());
         m_storage->set_offset(m_crop_offset);
         m_storage->clear();
         m_channels = channels;
+        m_put_count = m_snapshot_put_count = 0;
+
+        if (m_snapshot_interval > 0.f && !m_dest_file.empty()) {
+            m_snapshot_thread = new SnapshotThread(m_snapshot_interval,
+                                                   [this]() { write_snapshot(); });
+            m_snapshot_thread->start();
+        }
     }
 
     void put(const ImageBlock *block) override {
         Assert(m_storage != nullptr);
         std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_streaming)
+            grow_window(block->offset().y() + block->size().y() + block->border_size());
         m_storage->put(block);
+        m_put_count++;
+    }
+
+    bool streaming() const override { return m_streaming; }
+
+    void rows_finished(int32_t y) override {
+        if (!m_streaming)
+            return;
+
+        // Blocks starting at row 'y' still splat into the rows above it
+        int32_t crop_end = m_crop_offset.y() + m_crop_size.y();
+        if (y < crop_end && !m_filter_importance_sampling)
+            y -= m_filter->border_size();
+
+        write_rows(std::min(y, crop_end));
     }
 
     bool develop(const ScalarPoint2i  &source_offset,
@@ -249,15 +434,287 @@ public:
     }
 
     ref<Bitmap> bitmap(bool raw = false) override {
+        if (m_streaming)
+            Throw("HDRFilm::bitmap(): not available in streaming mode, the rows "
+                  "of the image are written to disk while rendering.");
+
         if constexpr (is_cuda_array_v<Float>) {
             cuda_eval();
             cuda_sync();
         }
 
+        return to_bitmap(m_storage, raw);
+    }
+
+    void develop() override {
+        if (m_dest_file.empty())
+            Throw("Destination file not specified, cannot develop.");
+
+        // The final image supersedes any further snapshots
+        stop_snapshots();
+
+        fs::path filename = output_filename(m_dest_file);
+        Log(Info, "\U00002714  Developing \"%s\" ..", filename.string());
+
+        if (m_streaming) {
+            // Write the remaining rows and finish the file
+            Assert(m_storage != nullptr);
+            write_rows(m_crop_offset.y() + m_crop_size.y());
+            m_stream_writer = nullptr;
+            return;
+        }
+
+        write_bitmap(bitmap(), filename);
+    }
+
+    bool destination_exists(const fs::path &base_name) const override {
+        return fs::exists(output_filename(base_name));
+    }
+
+    MemoryUsage memory_usage() const override {
+        if (!m_storage)
+            return { };
+        return { { m_streaming ? "film storage (streaming window)" : "film storage",
+                   slices(m_storage->data()) * sizeof(ScalarFloat) } };
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "HDRFilm[" << std::endl
+            << "  size = " << m_size        << "," << std::endl
+            << "  crop_size = " << m_crop_size   << "," << std::endl
+            << "  crop_offset = " << m_crop_offset << "," << std::endl
+            << "  high_quality_edges = " << m_high_quality_edges << "," << std::endl
+            << "  filter = " << m_filter << "," << std::endl
+            << "  file_format = " << m_file_format << "," << std::endl
+            << "  pixel_format = " << m_pixel_format << "," << std::endl
+            << "  component_format = " << m_component_format << "," << std::endl
+            << "  compression = " << m_compression << "," << std::endl
+            << "  aov_compression = " << m_aov_compression << "," << std::endl
+            << "  multipart = " << m_multipart << "," << std::endl
+            << "  tile_size = " << m_tile_size << "," << std::endl
+            << "  streaming = " << m_streaming << "," << std::endl
+            << "  dest_file = \"" << m_dest_file << "\"" << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    ~HDRFilm() {
+        stop_snapshots();
+    }
+
+    /// Replace the extension of \c base_name by the one of the output file format
+    fs::path output_filename(const fs::path &base_name) const {
+        std::string proper_extension;
+        if (m_file_format == Bitmap::FileFormat::OpenEXR)
+            proper_extension = ".exr";
+        else if (m_file_format == Bitmap::FileFormat::RGBE)
+            proper_extension = ".rgbe";
+        else
+            proper_extension = ".pfm";
+
+        fs::path filename = base_name;
+
+        std::string extension = string::to_lower(filename.extension().string());
+        if (extension != proper_extension)
+            filename.replace_extension(proper_extension);
+
+        return filename;
+    }
+
+    /// Parse the name of an OpenEXR compression scheme
+    static Bitmap::EXRCompression exr_compression(const std::string &name_) {
+        using EXRCompression = Bitmap::EXRCompression;
+        std::string name = string::to_lower(name_);
+        for (EXRCompression c : { EXRCompression::None, EXRCompression::RLE,
+                                  EXRCompression::ZIPS, EXRCompression::ZIP,
+                                  EXRCompression::PIZ, EXRCompression::PXR24,
+                                  EXRCompression::B44, EXRCompression::B44A,
+                                  EXRCompression::DWAA, EXRCompression::DWAB }) {
+            std::ostringstream oss;
+            oss << c;
+            if (oss.str() == name)
+                return c;
+        }
+        Throw("Unsupported OpenEXR compression scheme \"%s\"! The options are "
+              "\"none\", \"rle\", \"zips\", \"zip\", \"piz\", \"pxr24\", "
+              "\"b44\", \"b44a\", \"dwaa\", and \"dwab\".", name_);
+    }
+
+    /**
+     * \brief Split the channels of a developed bitmap into OpenEXR parts
+     *
+     * Unless multi-part output is requested, a single part holds all
+     * channels. Otherwise, the beauty pass and each AOV group (channels
+     * sharing the prefix before the last '.') get their own part.
+     */
+    std::vector<Bitmap::EXRPart> exr_parts(const Bitmap *bitmap) const {
+        std::vector<Bitmap::EXRPart> parts;
+        parts.push_back({ "", { }, m_compression, m_compression_level });
+
+        if (!m_multipart || bitmap->pixel_format() != Bitmap::PixelFormat::MultiChannel)
+            return parts;
+
+        parts[0].name = "rgba";
+        for (const Struct::Field &field : *bitmap->struct_()) {
+            const std::string &name = field.name;
+            if (name == "R" || name == "G" || name == "B" || name == "A") {
+                parts[0].channels.push_back(name);
+                continue;
+            }
+
+            size_t pos = name.rfind('.');
+            std::string group = pos != std::string::npos ? name.substr(0, pos) : name;
+
+            // Part names must be unique, rename AOV groups that clash with the beauty part
+            if (group == parts[0].name)
+                group += "_aov";
+
+            auto it = std::find_if(parts.begin() + 1, parts.end(),
+                                   [&](const Bitmap::EXRPart &p) { return p.name == group; });
+            if (it == parts.end()) {
+                parts.push_back({ group, { }, m_aov_compression, m_compression_level });
+                it = parts.end() - 1;
+            }
+            it->channels.push_back(name);
+        }
+
+        return parts;
+    }
+
+    /// Write a developed bitmap using the output file format and compression settings
+    void write_bitmap(const Bitmap *bitmap, const fs::path &filename) const {
+        if (m_file_format == Bitmap::FileFormat::OpenEXR)
+            bitmap->write_openexr_parts(filename, exr_parts(bitmap), m_tile_size);
+        else
+            bitmap->write(filename, m_file_format);
+    }
+
+    /**
+     * \brief Develop a copy of the current film contents and write it to disk
+     *
+     * Invoked periodically by the snapshot thread, which also performs the
+     * file I/O. The film is only locked while its storage is copied, so that
+     * render threads are not blocked by the conversion and file I/O.
+     */
+    void write_snapshot() {
+        if (m_put_count == m_snapshot_put_count)
+            return; // Nothing changed since the last snapshot
+
+        // Allocate outside of the critical section (the storage only changes in prepare())
+        ref<ImageBlock> copy = new ImageBlock(m_storage->size(), m_storage->channel_count());
+        copy->set_offset(m_storage->offset());
+        Assert(slices(copy->data()) == slices(m_storage->data()));
+
+        /* Critical section: copy-on-snapshot */ {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_snapshot_put_count = m_put_count;
+            std::memcpy(copy->data().data(), m_storage->data().data(),
+                        slices(m_storage->data()) * sizeof(ScalarFloat));
+        }
+
+        // Insert a suffix before the extension, e.g. "out.exr" -> "out_snapshot.exr"
+        fs::path filename = output_filename(m_dest_file);
+        std::string name = filename.string();
+        name.insert(name.size() - filename.extension().string().size(), "_snapshot");
+        filename = name;
+
+        Log(Debug, "Writing film snapshot \"%s\" ..", filename.string());
+        write_bitmap(to_bitmap(copy, false), filename);
+    }
+
+    /**
+     * \brief Make sure that the streaming window extends up to row \c end
+     * (exclusive). Must be called with \c m_mutex held.
+     */
+    void grow_window(int32_t end) {
+        ScalarPoint2i offset = m_storage->offset();
+        int32_t max_height = m_crop_offset.y() + m_crop_size.y() - offset.y(),
+                height     = std::min(end - offset.y(), max_height);
+        if (height <= m_storage->size().y())
+            return;
+
+        // Grow geometrically to amortize the cost of reallocating the window
+        height = std::min(std::max(height, 2 * m_storage->size().y()), max_height);
+
+        ref<ImageBlock> window = new ImageBlock(ScalarVector2i(m_crop_size.x(), height),
+                                                m_storage->channel_count());
+        window->set_offset(offset);
+        window->clear();
+        std::memcpy(window->data().data(), m_storage->data().data(),
+                    slices(m_storage->data()) * sizeof(ScalarFloat));
+        m_storage = window;
+    }
+
+    /**
+     * \brief Develop the rows of the streaming window above row \c y and
+     * append them to the output file
+     *
+     * Render threads only wait while the rows are moved out of the window.
+     * The conversion and compression happen outside of that critical section
+     * but are serialized, so that rows reach the file in order.
+     */
+    void write_rows(int32_t y) {
+        std::lock_guard<std::mutex> write_lock(m_write_mutex);
+        ref<ImageBlock> strip;
+
+        /* Critical section: move the rows out of the window */ {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ScalarPoint2i offset = m_storage->offset();
+            int32_t count = y - offset.y();
+            if (count <= 0)
+                return;
+
+            // Rows beyond the window never received any samples and remain zero
+            strip = new ImageBlock(ScalarVector2i(m_crop_size.x(), count),
+                                   m_storage->channel_count());
+            strip->set_offset(offset);
+            strip->clear();
+
+            size_t row_size = (size_t) m_crop_size.x() * m_storage->channel_count(),
+                   window_rows = (size_t) m_storage->size().y(),
+                   moved = std::min((size_t) count, window_rows);
+
+            ScalarFloat *data = m_storage->data().data();
+            std::memcpy(strip->data().data(), data, moved * row_size * sizeof(ScalarFloat));
+            std::memmove(data, data + moved * row_size,
+                         (window_rows - moved) * row_size * sizeof(ScalarFloat));
+            std::memset(data + (window_rows - moved) * row_size, 0,
+                        moved * row_size * sizeof(ScalarFloat));
+            m_storage->set_offset(ScalarPoint2i(offset.x(), y));
+        }
+
+        ref<Bitmap> bitmap = to_bitmap(strip, false);
+
+        if (!m_stream_writer) {
+            if (m_dest_file.empty())
+                Throw("Destination file not specified, cannot stream the film.");
+            fs::path filename = output_filename(m_dest_file);
+            Log(Info, "Streaming rows to \"%s\" ..", filename.string());
+            ref<FileStream> stream = new FileStream(filename, FileStream::ETruncReadWrite);
+            m_stream_writer = new EXRScanlineWriter(stream, bitmap, (uint32_t) m_crop_size.y(),
+                                                    exr_parts(bitmap));
+        }
+
+        m_stream_writer->write(bitmap);
+    }
+
+    /// Terminate the snapshot thread (if running)
+    void stop_snapshots() {
+        if (m_snapshot_thread) {
+            m_snapshot_thread->stop();
+            m_snapshot_thread = nullptr;
+        }
+    }
+
+    /// Convert the contents of an image block into a bitmap in the output format
+    ref<Bitmap> to_bitmap(ImageBlock *block, bool raw) const {
         ref<Bitmap> source = new Bitmap(m_channels.size() != 5 ? Bitmap::PixelFormat::MultiChannel
                                                                : Bitmap::PixelFormat::XYZAW,
-                          struct_type_v<ScalarFloat>, m_storage->size(), m_storage->channel_count(),
-                          (uint8_t *) m_storage->data().managed().data());
+                          struct_type_v<ScalarFloat>, block->size(), block->channel_count(),
+                          (uint8_t *) block->data().managed().data());
 
         if (raw)
             return source;
@@ -266,8 +723,8 @@ public:
 
         ref<Bitmap> target = new Bitmap(
             has_aovs ? Bitmap::PixelFormat::MultiChannel : m_pixel_format,
-            m_component_format, m_storage->size(),
-            has_aovs ? (m_storage->channel_count() - 1) : 0);
+            m_component_format, block->size(),
+            has_aovs ? (block->channel_count() - 1) : 0);
 
         if (has_aovs) {
             for (size_t i = 0, j = 0; i < m_channels.size(); ++i, ++j) {
@@ -319,73 +776,30 @@ public:
         source->convert(target);
 
         return target;
-     };
-
-    void develop() override {
-        if (m_dest_file.empty())
-            Throw("Destination file not specified, cannot develop.");
-
-        fs::path filename = m_dest_file;
-        std::string proper_extension;
-        if (m_file_format == Bitmap::FileFormat::OpenEXR)
-            proper_extension = ".exr";
-        else if (m_file_format == Bitmap::FileFormat::RGBE)
-            proper_extension = ".rgbe";
-        else
-            proper_extension = ".pfm";
-
-        std::string extension = string::to_lower(filename.extension().string());
-        if (extension != proper_extension)
-            filename.replace_extension(proper_extension);
-
-        Log(Info, "\U00002714  Developing \"%s\" ..", filename.string());
-
-        bitmap()->write(filename, m_file_format);
     }
 
-    bool destination_exists(const fs::path &base_name) const override {
-        std::string proper_extension;
-        if (m_file_format == Bitmap::FileFormat::OpenEXR)
-            proper_extension = ".exr";
-        else if (m_file_format == Bitmap::FileFormat::RGBE)
-            proper_extension = ".rgbe";
-        else
-            proper_extension = ".pfm";
-
-        fs::path filename = base_name;
-
-        std::string extension = string::to_lower(filename.extension().string());
-        if (extension != proper_extension)
-            filename.replace_extension(proper_extension);
-
-        return fs::exists(filename);
-    }
-
-    std::string to_string() const override {
-        std::ostringstream oss;
-        oss << "HDRFilm[" << std::endl
-            << "  size = " << m_size        << "," << std::endl
-            << "  crop_size = " << m_crop_size   << "," << std::endl
-            << "  crop_offset = " << m_crop_offset << "," << std::endl
-            << "  high_quality_edges = " << m_high_quality_edges << "," << std::endl
-            << "  filter = " << m_filter << "," << std::endl
-            << "  file_format = " << m_file_format << "," << std::endl
-            << "  pixel_format = " << m_pixel_format << "," << std::endl
-            << "  component_format = " << m_component_format << "," << std::endl
-            << "  dest_file = \"" << m_dest_file << "\"" << std::endl
-            << "]";
-        return oss.str();
-    }
-
-    MTS_DECLARE_CLASS()
-protected:
     Bitmap::FileFormat m_file_format;
     Bitmap::PixelFormat m_pixel_format;
     Struct::Type m_component_format;
+    Bitmap::EXRCompression m_compression;
+    Bitmap::EXRCompression m_aov_compression;
+    float m_compression_level;
+    bool m_multipart;
+    uint32_t m_tile_size;
     fs::path m_dest_file;
     ref<ImageBlock> m_storage;
     std::mutex m_mutex;
+
+    bool m_streaming;
+    ref<EXRScanlineWriter> m_stream_writer;
+    std::mutex m_write_mutex;
+
     std::vector<std::string> m_channels;
+
+    float m_snapshot_interval;
+    ref<SnapshotThread> m_snapshot_thread;
+    std::atomic<size_t> m_put_count { 0 };
+    size_t m_snapshot_put_count = 0;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(HDRFilm, Film)
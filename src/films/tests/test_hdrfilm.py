@@ -30,6 +30,19 @@ def test01_construct(variant_scalar_rgb):
         load_string("""<film version="2.0.0" type="hdrfilm">
             <string name="pixel_format" value="brga"/>
         </film>""")
+    with pytest.raises(RuntimeError):
+        load_string("""<film version="2.0.0" type="hdrfilm">
+            <string name="compression" value="jpeg"/>
+        </film>""")
+
+    film = load_string("""<film version="2.0.0" type="hdrfilm">
+            <string name="compression" value="DWAA"/>
+            <string name="aov_compression" value="zips"/>
+            <boolean name="multipart" value="true"/>
+            <integer name="tile_size" value="64"/>
+        </film>""")
+    assert "compression = dwaa" in str(film)
+    assert "aov_compression = zips" in str(film)
 
 
 def test02_crops(variant_scalar_rgb):
@@ -142,3 +155,138 @@ def test03_develop(variant_scalar_rgb, file_format, tmpdir):
             assert ek.allclose(img[:, :, :3], contents[:, :, :3], atol=1e-5)
         # Alpha channel was ignored, alpha and weights should default to 1.0.
         assert ek.allclose(img[:, :, 3:5], 1.0, atol=1e-6)
+
+
+def test04_snapshots(variant_scalar_rgb, tmpdir):
+    from mitsuba.core.xml import load_string
+    from mitsuba.core import Bitmap, Struct
+    from mitsuba.render import ImageBlock
+    import numpy as np
+    import time
+
+    film = load_string("""<film version="2.0.0" type="hdrfilm">
+            <integer name="width" value="8"/>
+            <integer name="height" value="4"/>
+            <string name="component_format" value="float32"/>
+            <float name="snapshot_interval" value="0.05"/>
+            <rfilter type="box"/>
+        </film>""")
+
+    filename = str(tmpdir.join('test_image.exr'))
+    snapshot = str(tmpdir.join('test_image_snapshot.exr'))
+    film.set_destination_file(filename)
+    film.prepare(['X', 'Y', 'Z', 'A', 'W'])
+
+    block = ImageBlock(film.size(), 5, film.reconstruction_filter())
+    block.clear()
+    for x in range(film.size()[1]):
+        for y in range(film.size()[0]):
+            block.put([y + 0.5, x + 0.5], [0.5, 0.25, 0.125, 1.0, 1.0])
+    film.put(block)
+
+    # Snapshots are written by a background thread, wait until it has started one
+    for i in range(100):
+        if os.path.exists(snapshot):
+            break
+        time.sleep(0.05)
+
+    # develop() joins the snapshot thread, hence any pending write has completed
+    film.develop()
+
+    assert os.path.exists(filename)
+    assert os.path.exists(snapshot)
+    img = np.array(Bitmap(snapshot).convert(Bitmap.PixelFormat.XYZAW,
+                                            Struct.Type.Float32, srgb_gamma=False))
+    ref = np.array(Bitmap(filename).convert(Bitmap.PixelFormat.XYZAW,
+                                            Struct.Type.Float32, srgb_gamma=False))
+    assert np.allclose(img, ref, atol=1e-5)
+
+
+def test05_streaming(variant_scalar_rgb, tmpdir):
+    from mitsuba.core.xml import load_string
+    from mitsuba.core import Bitmap, Struct
+    from mitsuba.render import ImageBlock
+    import numpy as np
+
+    """Develop the same image blocks with and without streaming output and
+    check that the results match."""
+    np.random.seed(1234)
+    xml = """<film version="2.0.0" type="hdrfilm">
+            <integer name="width" value="41"/>
+            <integer name="height" value="37"/>
+            <string name="component_format" value="float32"/>
+            <boolean name="streaming" value="{}"/>
+            <rfilter type="gaussian"/>
+        </film>"""
+    films = [load_string(xml.format('false')), load_string(xml.format('true'))]
+    assert not films[0].streaming() and films[1].streaming()
+
+    filenames = [str(tmpdir.join('regular.exr')), str(tmpdir.join('streaming.exr'))]
+    for film, filename in zip(films, filenames):
+        film.set_destination_file(filename)
+        film.prepare(['X', 'Y', 'Z', 'A', 'W'])
+
+    size, h = films[0].size(), 8
+    for y0 in range(0, size[1], h):
+        for x0 in range(0, size[0], 16):
+            block_size = [min(16, size[0] - x0), min(h, size[1] - y0)]
+            block = ImageBlock(block_size, 5, films[0].reconstruction_filter())
+            block.set_offset([x0, y0])
+            block.clear()
+            for y in range(block_size[1]):
+                for x in range(block_size[0]):
+                    pos = np.array([x0 + x, y0 + y]) + np.random.uniform(size=2)
+                    value = np.random.uniform(size=5)
+                    value[4] = 1.0
+                    block.put(pos, value)
+            for film in films:
+                film.put(block)
+        films[1].rows_finished(min(y0 + h, size[1]))
+
+    with pytest.raises(RuntimeError):
+        films[1].bitmap()
+
+    for film in films:
+        film.develop()
+
+    images = [np.array(Bitmap(f).convert(Bitmap.PixelFormat.XYZAW, Struct.Type.Float32,
+                                         srgb_gamma=False)) for f in filenames]
+    assert np.allclose(images[0], images[1], atol=1e-6)
+
+
+def test06_multipart_rgba_group(variant_scalar_rgb, tmpdir):
+    from mitsuba.core.xml import load_string
+    from mitsuba.core import Bitmap
+    from mitsuba.render import ImageBlock
+    import numpy as np
+
+    # An AOV group named 'rgba' gets its own part instead of being merged
+    # into the beauty part
+    film = load_string("""<film version="2.0.0" type="hdrfilm">
+            <integer name="width" value="8"/>
+            <integer name="height" value="6"/>
+            <string name="component_format" value="float32"/>
+            <boolean name="multipart" value="true"/>
+            <rfilter type="box"/>
+        </film>""")
+    film.prepare(['X', 'Y', 'Z', 'A', 'W', 'rgba.x', 'rgba.y'])
+
+    contents = np.random.RandomState(0).uniform(size=(6, 8, 7))
+    contents[:, :, 4] = 1.0
+    block = ImageBlock(film.size(), 7, film.reconstruction_filter())
+    block.clear()
+    for y in range(6):
+        for x in range(8):
+            block.put([x + 0.5, y + 0.5], contents[y, x, :])
+    film.put(block)
+
+    filename = str(tmpdir.join('multipart.exr'))
+    film.set_destination_file(filename)
+    film.develop()
+
+    bitmap = Bitmap(filename)
+    names = [f.name for f in bitmap.struct_()]
+    assert sorted(names) == sorted(['R', 'G', 'B', 'A', 'rgba.x', 'rgba.y'])
+    img = np.array(bitmap, copy=False)
+    for i, name in enumerate(['rgba.x', 'rgba.y']):
+        assert np.allclose(img[:, :, names.index(name)], contents[:, :, 5 + i], atol=1e-6)
@@ -1,6 +1,7 @@
 #include <enoki/stl.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/counters.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/core/properties.h>
 
@@ -162,6 +163,7 @@ public:
         // ------------------------ BSDF sampling -------------------------
 
         for (size_t i = 0; i < m_bsdf_samples; ++i) {
+            counter_add_lanes(Counter::BSDFSample, active);
             auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active),
                                                sampler->next_2d(active), active);
             bsdf_val = si.to_world_mueller(bsdf_val, -bs.wo, si.wi);
@@ -0,0 +1,674 @@
+#include <atomic>
+#include <enoki/stl.h>
+#include <mitsuba/core/atomic.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/counters.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/records.h>
+#include <tbb/parallel_for.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-guided_path:
+
+Guided path tracer (:monosp:`guided_path`)
+-------------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1 corresponds to
+     :math:`\infty`). A value of 1 will only render directly visible light sources. 2 will lead
+     to single-bounce (direct-only) illumination, and so on. (Default: -1)
+ * - rr_depth
+   - |int|
+   - Specifies the minimum path depth, after which the implementation will start to use the
+     *russian roulette* path termination criterion. (Default: 5)
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: no, i.e. |false|)
+ * - bsdf_sampling_fraction
+   - |float|
+   - Probability of sampling a direction from the BSDF instead of the learned
+     incident radiance distribution. (Default: 0.5)
+ * - spatial_threshold
+   - |int|
+   - Number of recorded samples (scaled by the square root of ``samples_per_pass``)
+     after which a spatial cell is split in two. (Default: 12000)
+ * - directional_threshold
+   - |float|
+   - Fraction of the energy of a directional distribution above which a quadtree
+     node is subdivided. (Default: 0.01)
+ * - max_directional_depth
+   - |int|
+   - Maximum depth of the directional quadtrees. (Default: 20)
+
+This plugin implements the *practical path guiding* technique by Müller et al.
+It is a unidirectional path tracer that learns the incident radiance field of the
+scene while rendering and uses it to importance sample the directions of
+indirect bounces. The radiance estimate is stored in a *spatial-directional tree*
+(SD-tree): a binary tree that adaptively subdivides the bounding box of the scene,
+whose leaves each hold a quadtree over the sphere of directions.
+
+Learning takes place over the passes of the render job, whose size is specified
+using the ``samples_per_pass`` parameter of the integrator. During a pass, all
+render threads record their radiance estimates into the same SD-tree using atomic
+floating point updates. Once the pass is complete, the tree is refined based on the
+recorded statistics and becomes the sampling distribution of the next pass. The
+guided distribution is combined with BSDF sampling using the one-sample MIS model
+controlled by ``bsdf_sampling_fraction``. All passes contribute to the final image.
+
+.. code-block:: xml
+
+    <integrator type="guided_path">
+        <integer name="samples_per_pass" value="16"/>
+    </integrator>
+
+.. note:: This integrator requires a scalar variant of the renderer, does not handle
+   participating media, and needs at least two passes to have any effect.
+
+ */
+
+/// Quadtree node of a directional distribution, with one child per quadrant
+template <typename Value> struct DTreeNode {
+    AtomicFloat<Value> sum[4];
+    uint32_t child[4] = { 0, 0, 0, 0 }; // 0 marks a leaf (the root is never a child)
+
+    DTreeNode() { }
+    DTreeNode(const DTreeNode &n) { *this = n; }
+    DTreeNode &operator=(const DTreeNode &n) {
+        for (int i = 0; i < 4; ++i) {
+            sum[i] = (Value) n.sum[i];
+            child[i] = n.child[i];
+        }
+        return *this;
+    }
+
+    Value total() const { return sum[0] + sum[1] + sum[2] + sum[3]; }
+
+    /// Return the quadrant containing \c p and remap \c p to its local coordinates
+    static int quadrant(Point<Value, 2> &p) {
+        int x = p.x() >= .5f ? 1 : 0, y = p.y() >= .5f ? 1 : 0;
+        p = p * 2.f - Point<Value, 2>(Value(x), Value(y));
+        return x + 2 * y;
+    }
+};
+
+/**
+ * \brief Directional quadtree storing the incident radiance over the unit
+ * square, which is mapped to the sphere using the cylindrical mapping of
+ * \ref warp::square_to_uniform_sphere().
+ */
+template <typename Value> class DTree {
+public:
+    using Node = DTreeNode<Value>;
+    using Point2 = Point<Value, 2>;
+
+    DTree() : m_nodes(1) { }
+
+    Value total() const { return m_nodes[0].total(); }
+
+    /// Splat an irradiance estimate into every node along the path to \c p
+    void record(Point2 p, Value value) {
+        uint32_t index = 0;
+        while (true) {
+            Node &node = m_nodes[index];
+            int i = Node::quadrant(p);
+            node.sum[i] += value;
+            if (node.child[i] == 0)
+                break;
+            index = node.child[i];
+        }
+    }
+
+    /// Sample a point on the unit square proportional to the stored energy
+    Point2 sample(Point2 u) const {
+        Point2 origin(0.f);
+        Value scale = 1.f;
+        uint32_t index = 0;
+
+        while (true) {
+            const Node &node = m_nodes[index];
+            Value s[4] = { node.sum[0], node.sum[1], node.sum[2], node.sum[3] };
+            Value total = s[0] + s[1] + s[2] + s[3];
+
+            // Choose the column first, then the row within the column
+            Value left = s[0] + s[2];
+            int x = 0, y = 0;
+            Value p_left = left / total;
+            if (u.x() < p_left) {
+                u.x() /= p_left;
+            } else {
+                x = 1;
+                u.x() = (u.x() - p_left) / (1.f - p_left);
+            }
+
+            Value p_top = s[x] / (s[x] + s[x + 2]);
+            if (u.y() < p_top) {
+                u.y() /= p_top;
+            } else {
+                y = 1;
+                u.y() = (u.y() - p_top) / (1.f - p_top);
+            }
+            u = min(u, math::OneMinusEpsilon<Value>);
+
+            int i = x + 2 * y;
+            scale *= .5f;
+            origin += Point2(Value(x), Value(y)) * scale;
+
+            if (node.child[i] == 0)
+                break;
+            index = node.child[i];
+        }
+
+        return origin + u * scale;
+    }
+
+    /// Density of \ref sample() with respect to the unit square
+    Value pdf(Point2 p) const {
+        Value result = 1.f;
+        uint32_t index = 0;
+        while (true) {
+            const Node &node = m_nodes[index];
+            Value total = node.total();
+            int i = Node::quadrant(p);
+            if (!(total > 0.f))
+                return 0.f;
+            result *= 4.f * node.sum[i] / total;
+            if (node.child[i] == 0)
+                break;
+            index = node.child[i];
+        }
+        return result;
+    }
+
+    /**
+     * \brief Rebuild the tree topology from the recorded energy and reset
+     * all statistics.
+     *
+     * Quadrants carrying more than \c threshold of the total energy are
+     * subdivided (up to \c max_depth levels), all others are collapsed.
+     */
+    void refine(Value threshold, uint32_t max_depth) {
+        Value total = this->total();
+
+        if (total > 0.f) {
+            struct Item {
+                uint32_t new_index, old_index;
+                bool has_old;
+                Value fraction;
+                uint32_t depth;
+            };
+
+            std::vector<Node> nodes(1);
+            std::vector<Item> stack = { { 0, 0, true, 1.f, 1 } };
+
+            while (!stack.empty()) {
+                Item item = stack.back();
+                stack.pop_back();
+
+                for (int i = 0; i < 4; ++i) {
+                    Value fraction = item.fraction * .25f;
+                    uint32_t old_child = 0;
+                    if (item.has_old) {
+                        const Node &old = m_nodes[item.old_index];
+                        fraction = old.sum[i] / total;
+                        old_child = old.child[i];
+                    }
+
+                    if (item.depth < max_depth && fraction > threshold) {
+                        uint32_t index = (uint32_t) nodes.size();
+                        nodes.emplace_back();
+                        nodes[item.new_index].child[i] = index;
+                        stack.push_back({ index, old_child, old_child != 0,
+                                          fraction, item.depth + 1 });
+                    }
+                }
+            }
+
+            m_nodes = std::move(nodes);
+        }
+
+        for (Node &node : m_nodes)
+            for (int i = 0; i < 4; ++i)
+                node.sum[i] = 0.f;
+    }
+
+    size_t node_count() const { return m_nodes.size(); }
+
+private:
+    std::vector<Node> m_nodes;
+};
+
+/// Pair of directional trees attached to a leaf of the spatial tree
+template <typename Value> struct DTreeWrapper {
+    /// Receives the radiance estimates of the current pass
+    DTree<Value> building;
+    /// Read-only distribution learned during the previous pass
+    DTree<Value> sampling;
+    /// Number of estimates recorded during the current pass
+    std::atomic<uint32_t> sample_count { 0 };
+
+    DTreeWrapper() { }
+    DTreeWrapper(const DTreeWrapper &w)
+        : building(w.building), sampling(w.sampling),
+          sample_count(w.sample_count.load()) { }
+};
+
+/// Binary tree adaptively subdividing the scene bounding box
+template <typename Value> class STree {
+public:
+    using Point3 = Point<Value, 3>;
+    using BoundingBox3 = BoundingBox<Point3>;
+    using Wrapper = DTreeWrapper<Value>;
+
+    STree(const BoundingBox3 &bbox) {
+        // Use a cubical domain so that axis-aligned splits produce well-shaped cells
+        Value extent = hmax(bbox.extents()) * (1.f + math::RayEpsilon<Value> * 16.f);
+        Point3 center = bbox.center();
+        m_bbox = BoundingBox3(center - .5f * extent, center + .5f * extent);
+        m_nodes.push_back({ { 0, 0 }, 0, 0 });
+        m_wrappers.emplace_back(new Wrapper());
+    }
+
+    /// Look up the directional distribution associated with position \c p
+    Wrapper *lookup(const Point3 &p_) const {
+        Point3 p = clamp((p_ - m_bbox.min) / m_bbox.extents(), 0.f,
+                         math::OneMinusEpsilon<Value>);
+        uint32_t index = 0;
+        while (true) {
+            const Node &node = m_nodes[index];
+            if (node.is_leaf())
+                return m_wrappers[node.wrapper].get();
+            Value &v = p[node.axis];
+            int side = v >= .5f ? 1 : 0;
+            v = v * 2.f - side;
+            index = node.child[side];
+        }
+    }
+
+    /**
+     * \brief Split all cells that recorded more than \c threshold samples,
+     * then turn the statistics of the pass into new sampling distributions.
+     */
+    void refine(uint32_t threshold, Value directional_threshold, uint32_t max_depth) {
+        // Spatial refinement: recursively split cells along alternating axes
+        std::vector<uint32_t> stack = { 0 };
+        while (!stack.empty()) {
+            uint32_t index = stack.back();
+            stack.pop_back();
+
+            if (!m_nodes[index].is_leaf()) {
+                stack.push_back(m_nodes[index].child[0]);
+                stack.push_back(m_nodes[index].child[1]);
+                continue;
+            }
+
+            Wrapper *wrapper = m_wrappers[m_nodes[index].wrapper].get();
+            uint32_t count = wrapper->sample_count;
+            if (count <= threshold)
+                continue;
+
+            // Each half inherits the distributions and half of the samples
+            wrapper->sample_count = count / 2;
+            uint32_t other_wrapper = (uint32_t) m_wrappers.size();
+            m_wrappers.emplace_back(new Wrapper(*wrapper));
+
+            uint8_t child_axis = (uint8_t) ((m_nodes[index].axis + 1) % 3);
+            uint32_t first = (uint32_t) m_nodes.size();
+            m_nodes.push_back({ { 0, 0 }, child_axis, m_nodes[index].wrapper });
+            m_nodes.push_back({ { 0, 0 }, child_axis, other_wrapper });
+            m_nodes[index].child[0] = first;
+            m_nodes[index].child[1] = first + 1;
+
+            stack.push_back(first);
+            stack.push_back(first + 1);
+        }
+
+        // Directional refinement of all leaves
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, m_wrappers.size(), 16),
+            [&](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    Wrapper *wrapper = m_wrappers[i].get();
+                    wrapper->sampling = wrapper->building;
+                    wrapper->building.refine(directional_threshold, max_depth);
+                    wrapper->sample_count = 0;
+                }
+            }
+        );
+    }
+
+    size_t leaf_count() const { return m_wrappers.size(); }
+
+    size_t directional_node_count() const {
+        size_t result = 0;
+        for (auto &w : m_wrappers)
+            result += w->sampling.node_count();
+        return result;
+    }
+
+private:
+    struct Node {
+        /// Children of interior nodes, zero for leaves
+        uint32_t child[2];
+        /// Axis along which the cell is (or will be) split
+        uint8_t axis;
+        /// Index of the directional distribution of leaves
+        uint32_t wrapper;
+
+        bool is_leaf() const { return child[0] == 0; }
+    };
+
+    BoundingBox3 m_bbox;
+    std::vector<Node> m_nodes;
+    std::vector<std::unique_ptr<Wrapper>> m_wrappers;
+};
+
+template <typename Float, typename Spectrum>
+class GuidedPathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_samples_per_pass)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, Medium, Emitter, EmitterPtr, BSDF, BSDFPtr)
+
+    using SDTree = STree<ScalarFloat>;
+    using Wrapper = DTreeWrapper<ScalarFloat>;
+
+    /// Maximum number of path vertices whose radiance estimate is recorded
+    static constexpr size_t MaxVertices = 64;
+
+    GuidedPathIntegrator(const Properties &props) : Base(props) {
+        m_bsdf_sampling_fraction = props.float_("bsdf_sampling_fraction", .5f);
+        if (m_bsdf_sampling_fraction <= 0.f || m_bsdf_sampling_fraction > 1.f)
+            Throw("\"bsdf_sampling_fraction\" must be in the range (0, 1]!");
+
+        m_spatial_threshold = (uint32_t) props.size_("spatial_threshold", 12000);
+        m_directional_threshold = props.float_("directional_threshold", .01f);
+        m_max_directional_depth = (uint32_t) props.size_("max_directional_depth", 20);
+        m_training = false;
+
+        if constexpr (is_array_v<Float>)
+            Throw("The guided path tracer is only supported in scalar variants "
+                  "of the renderer.");
+    }
+
+    bool render(Scene *scene, Sensor *sensor) override {
+        m_sdtree = std::unique_ptr<SDTree>(new SDTree(scene->bbox()));
+
+        size_t total_spp = sensor->sampler()->sample_count();
+        m_training = m_samples_per_pass != (uint32_t) -1 &&
+                     m_samples_per_pass < total_spp;
+        if (!m_training)
+            Log(Warn, "Path guiding requires \"samples_per_pass\" to be smaller than "
+                      "the sample count, rendering without guiding.");
+
+        return Base::render(scene, sensor);
+    }
+
+    bool synchronize_passes() const override { return true; }
+
+    void pass_finished(size_t pass, size_t pass_count) override {
+        if (!m_training)
+            return;
+
+        Timer timer;
+        uint32_t threshold = (uint32_t) (m_spatial_threshold *
+                                         std::sqrt((ScalarFloat) m_samples_per_pass));
+        m_sdtree->refine(threshold, m_directional_threshold, m_max_directional_depth);
+
+        // The final pass only uses the learned distribution
+        m_training = pass + 2 < pass_count;
+
+        Log(Debug, "Refined SD-tree after pass %i: %i spatial leaves, %i directional nodes (took %s)",
+            pass + 1, m_sdtree->leaf_count(), m_sdtree->directional_node_count(),
+            util::time_string(timer.value()));
+    }
+
+    std::pair<Spectrum, Mask> sample(const Scene *scene,
+                                     Sampler *sampler,
+                                     const RayDifferential3f &ray_,
+                                     const Medium * /* medium */,
+                                     Float * /* aovs */,
+                                     Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
+
+        if constexpr (is_array_v<Float>) {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sampler);
+            ENOKI_MARK_USED(ray_);
+            Throw("GuidedPathIntegrator::sample(): not supported in vectorized variants.");
+        } else {
+            /// Per-vertex bookkeeping used to compute incident radiance estimates
+            struct Vertex {
+                Wrapper *wrapper;
+                Point2f p;
+                UnpolarizedSpectrum throughput, radiance;
+                Float pdf;
+            };
+
+            Vertex vertices[MaxVertices];
+            size_t n_vertices = 0;
+
+            auto add_radiance = [&](const UnpolarizedSpectrum &value) {
+                for (size_t i = 0; i < n_vertices; ++i)
+                    vertices[i].radiance += value;
+            };
+
+            RayDifferential3f ray = ray_;
+
+            // Tracks radiance scaling due to index of refraction changes
+            Float eta(1.f);
+
+            // MIS weight for intersected emitters (set by prev. iteration)
+            Float emission_weight(1.f);
+
+            Spectrum throughput(1.f), result(0.f);
+
+            // ---------------------- First intersection ----------------------
+
+            SurfaceInteraction3f si = scene->ray_intersect(ray, active);
+            Mask valid_ray = si.is_valid();
+            EmitterPtr emitter = si.emitter(scene);
+
+            for (int depth = 1;; ++depth) {
+
+                // ---------------- Intersection with emitters ----------------
+
+                if (emitter) {
+                    Spectrum contrib = emission_weight * throughput * emitter->eval(si, active);
+                    result += contrib;
+                    add_radiance(depolarize(contrib));
+                }
+
+                active &= si.is_valid();
+
+                // Russian roulette (see the 'path' plugin)
+                if (depth > m_rr_depth) {
+                    Float q = min(hmax(depolarize(throughput)) * sqr(eta), .95f);
+                    active &= sampler->next_1d(active) < q;
+                    throughput *= rcp(q);
+                }
+
+                if ((uint32_t) depth >= (uint32_t) m_max_depth || !active)
+                    break;
+
+                BSDFContext ctx;
+                BSDFPtr bsdf = si.bsdf(ray);
+
+                /* Only guide at vertices with a smooth BSDF component, and
+                   only once a distribution has been learned for this region */
+                bool smooth = has_flag(bsdf->flags(), BSDFFlags::Smooth);
+                Wrapper *wrapper = smooth ? m_sdtree->lookup(si.p) : nullptr;
+                const DTree<ScalarFloat> *dtree =
+                    (wrapper && wrapper->sampling.total() > 0.f) ? &wrapper->sampling : nullptr;
+                Float bsdf_fraction = dtree ? m_bsdf_sampling_fraction : 1.f;
+
+                // Density of the guided one-sample MIS mixture
+                auto mixture_pdf = [&](const Vector3f &wo, Float bsdf_pdf) {
+                    if (!dtree)
+                        return bsdf_pdf;
+                    Float guide_pdf = dtree->pdf(warp::uniform_sphere_to_square(wo)) *
+                                      math::InvFourPi<Float>;
+                    return bsdf_fraction * bsdf_pdf + (1.f - bsdf_fraction) * guide_pdf;
+                };
+
+                // --------------------- Emitter sampling ---------------------
+
+                if (smooth) {
+                    auto [ds, emitter_val] = scene->sample_emitter_direction(
+                        si, sampler->next_2d(active), true, active);
+
+                    if (ds.pdf != 0.f) {
+                        // Query the BSDF for that emitter-sampled direction
+                        Vector3f wo = si.to_local(ds.d);
+                        Spectrum bsdf_val = bsdf->eval(ctx, si, wo, active);
+                        bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
+
+                        // Determine density of sampling that same direction
+                        Float bsdf_pdf = mixture_pdf(ds.d, bsdf->pdf(ctx, si, wo, active));
+
+                        Float mis = ds.delta ? 1.f : mis_weight(ds.pdf, bsdf_pdf);
+                        Spectrum contrib = mis * throughput * bsdf_val * emitter_val;
+                        result += contrib;
+                        add_radiance(depolarize(contrib));
+
+                        /* The emitter sample is an unbiased estimate of the
+                           direct irradiance arriving from direction 'ds.d' */
+                        if (m_training && wrapper && !ds.delta) {
+                            wrapper->building.record(
+                                warp::uniform_sphere_to_square(ds.d),
+                                hmean(depolarize(emitter_val)));
+                            wrapper->sample_count++;
+                        }
+                    }
+                }
+
+                // ------------------ BSDF or guided sampling -----------------
+
+                Float sample_1 = sampler->next_1d(active);
+                Point2f sample_2 = sampler->next_2d(active);
+
+                Vector3f wo_world;
+                Spectrum bsdf_weight;
+                Float wo_pdf;
+                bool delta;
+
+                if (sample_1 < bsdf_fraction) {
+                    // Reuse the remaining randomness of the lobe selection
+                    counter_add_lanes(Counter::BSDFSample, active);
+                    auto [bs, bsdf_val] =
+                        bsdf->sample(ctx, si, sample_1 / bsdf_fraction, sample_2, active);
+                    bsdf_val = si.to_world_mueller(bsdf_val, -bs.wo, si.wi);
+                    wo_world = si.to_world(bs.wo);
+                    delta = has_flag(bs.sampled_type, BSDFFlags::Delta);
+                    eta *= bs.eta;
+
+                    if (delta || !dtree) {
+                        wo_pdf = bs.pdf * bsdf_fraction;
+                        bsdf_weight = bsdf_val / bsdf_fraction;
+                    } else {
+                        // Convert the BSDF weight back into a BSDF value
+                        wo_pdf = mixture_pdf(wo_world, bs.pdf);
+                        bsdf_weight = bsdf_val * (bs.pdf / wo_pdf);
+                    }
+                } else {
+                    wo_world = warp::square_to_uniform_sphere(dtree->sample(sample_2));
+                    Vector3f wo = si.to_local(wo_world);
+                    Spectrum bsdf_val = bsdf->eval(ctx, si, wo, active);
+                    bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
+                    delta = false;
+
+                    wo_pdf = mixture_pdf(wo_world, bsdf->pdf(ctx, si, wo, active));
+                    bsdf_weight = wo_pdf > 0.f ? bsdf_val / wo_pdf : Spectrum(0.f);
+                }
+
+                throughput = throughput * bsdf_weight;
+                active &= any(neq(depolarize(throughput), 0.f)) && wo_pdf > 0.f;
+                if (!active)
+                    break;
+
+                if (m_training && wrapper && !delta && n_vertices < MaxVertices)
+                    vertices[n_vertices++] = { wrapper, warp::uniform_sphere_to_square(wo_world),
+                                               depolarize(throughput),
+                                               UnpolarizedSpectrum(0.f), wo_pdf };
+
+                // Intersect the sampled ray against the scene geometry
+                ray = si.spawn_ray(wo_world);
+                SurfaceInteraction3f si_next = scene->ray_intersect(ray, active);
+
+                /* Determine probability of having sampled that same
+                   direction using emitter sampling. */
+                emitter = si_next.emitter(scene, active);
+                DirectionSample3f ds(si_next, si);
+                ds.object = emitter;
+
+                if (emitter) {
+                    Float emitter_pdf = !delta ? scene->pdf_emitter_direction(si, ds) : 0.f;
+                    emission_weight = mis_weight(wo_pdf, emitter_pdf);
+                }
+
+                si = std::move(si_next);
+            }
+
+            /* Record the incident radiance estimates of all vertices. The
+               radiance arriving at a vertex along the sampled direction is
+               the contribution of the path suffix divided by its throughput. */
+            for (size_t i = 0; i < n_vertices; ++i) {
+                const Vertex &v = vertices[i];
+                Float throughput_mean = hmean(v.throughput);
+                if (!(throughput_mean > 0.f))
+                    continue;
+                UnpolarizedSpectrum incident = v.radiance / v.throughput;
+                Float value = hmean(select(v.throughput > 0.f, incident, 0.f)) / v.pdf;
+                if (std::isfinite(value)) {
+                    v.wrapper->building.record(v.p, value);
+                    v.wrapper->sample_count++;
+                }
+            }
+
+            return { result, valid_ray };
+        }
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        return tfm::format("GuidedPathIntegrator[\n"
+            "  max_depth = %i,\n"
+            "  rr_depth = %i,\n"
+            "  bsdf_sampling_fraction = %f,\n"
+            "  spatial_threshold = %i,\n"
+            "  directional_threshold = %f\n"
+            "]", m_max_depth, m_rr_depth, m_bsdf_sampling_fraction,
+            m_spatial_threshold, m_directional_threshold);
+    }
+
+    Float mis_weight(Float pdf_a, Float pdf_b) const {
+        pdf_a *= pdf_a;
+        pdf_b *= pdf_b;
+        return select(pdf_a > 0.f, pdf_a / (pdf_a + pdf_b), 0.f);
+    }
+
+    MTS_DECLARE_CLASS()
+private:
+    std::unique_ptr<SDTree> m_sdtree;
+    ScalarFloat m_bsdf_sampling_fraction;
+    uint32_t m_spatial_threshold;
+    ScalarFloat m_directional_threshold;
+    uint32_t m_max_directional_depth;
+    bool m_training;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(GuidedPathIntegrator, MonteCarloIntegrator)
+MTS_EXPORT_PLUGIN(GuidedPathIntegrator, "Guided path tracer integrator");
+NAMESPACE_END(mitsuba)
@@ -2,7 +2,9 @@
 #include <enoki/stl.h>
 #include <mitsuba/core/ray.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/render/adrrs.h>
 #include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/counters.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
@@ -30,6 +32,23 @@ Path tracer (:monosp:`path`)
  * - hide_emitters
    - |bool|
    - Hide directly visible emitters. (Default: no, i.e. |false|)
+ * - rr_mode
+   - |string|
+   - Path termination strategy: ``throughput`` (Russian roulette based on the path
+     throughput) or ``adrrs`` (adjoint-driven Russian roulette and splitting, see below).
+     (Default: ``throughput``)
+ * - adrrs_window
+   - |float|
+   - Ratio between the upper and lower bound of the weight window used by the
+     ``adrrs`` mode. (Default: 5)
+ * - adrrs_max_split
+   - |int|
+   - Maximum number of paths created when splitting at a single vertex in the
+     ``adrrs`` mode. (Default: 8)
+ * - adrrs_resolution
+   - |int|
+   - Resolution of the radiance cache of the ``adrrs`` mode along the longest
+     axis of the scene bounding box. (Default: 32)
 
 This integrator implements a basic path tracer and is a **good default choice**
 when there is no strong reason to prefer another method.
@@ -63,6 +82,38 @@ sampling to combine BSDF and emitter samples. The main difference in comparison
 to the former plugin is that it considers light paths of arbitrary length to compute
 both direct and indirect illumination.
 
+.. _sec-path-adrrs:
+
+Adjoint-driven Russian roulette and splitting
+*********************************************
+
+The default Russian roulette only looks at the throughput of a path, and thus
+spends as much effort on paths that will barely contribute to a pixel as on
+paths that carry most of its energy. When ``rr_mode`` is set to ``adrrs``, the
+integrator instead implements the *adjoint-driven Russian roulette and
+splitting* technique by Vorba and Křivánek: at every vertex, the expected
+contribution of the path (its throughput times the radiance leaving the vertex)
+is compared to an estimate of the pixel value. Paths expected to contribute
+much less than the pixel value are terminated with a correspondingly higher
+probability, while paths expected to contribute much more are split into
+several independent continuations.
+
+The radiance leaving each vertex is looked up in a coarse grid over the scene
+bounding box, which is filled during the first pass of the render job (whose
+size is specified using the ``samples_per_pass`` parameter). The first pass
+uses the default Russian roulette and contributes to the final image as well.
+
+.. code-block:: xml
+
+    <integrator type="path">
+        <string name="rr_mode" value="adrrs"/>
+        <integer name="samples_per_pass" value="4"/>
+    </integrator>
+
+The ``volpath`` plugin accepts the same parameters.
+
+.. note:: The ``adrrs`` mode requires a scalar variant of the renderer.
+
 .. _sec-path-strictnormals:
 
 .. Commented out for now
@@ -92,10 +143,22 @@ both direct and indirect illumination.
 template <typename Float, typename Spectrum>
 class PathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
 public:
-    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth)
-    MTS_IMPORT_TYPES(Scene, Sampler, Medium, Emitter, EmitterPtr, BSDF, BSDFPtr)
+    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_samples_per_pass)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, Medium, Emitter, EmitterPtr, BSDF, BSDFPtr)
+
+    PathIntegrator(const Properties &props)
+        : Base(props), m_adrrs(props, !is_array_v<Float>) { }
 
-    PathIntegrator(const Properties &props) : Base(props) { }
+    bool render(Scene *scene, Sensor *sensor) override {
+        m_adrrs.prepare(scene->bbox(), m_samples_per_pass, sensor->sampler()->sample_count());
+        return Base::render(scene, sensor);
+    }
+
+    bool synchronize_passes() const override { return m_adrrs.enabled(); }
+
+    void pass_finished(size_t pass, size_t /* pass_count */) override {
+        m_adrrs.pass_finished(pass);
+    }
 
     std::pair<Spectrum, Mask> sample(const Scene *scene,
                                      Sampler *sampler,
@@ -105,6 +168,9 @@ public:
                                      Mask active) const override {
         MTS_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
 
+        if (m_adrrs.enabled())
+            return sample_adrrs(scene, sampler, ray_, active);
+
         RayDifferential3f ray = ray_;
 
         // Tracks radiance scaling due to index of refraction changes
@@ -174,6 +240,7 @@ public:
             // ----------------------- BSDF sampling ----------------------
 
             // Sample BSDF * cos(theta)
+            counter_add_lanes(Counter::BSDFSample, active);
             auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active),
                                                sampler->next_2d(active), active);
             bsdf_val = si.to_world_mueller(bsdf_val, -bs.wo, si.wi);
@@ -210,14 +277,193 @@ public:
         return { result, valid_ray };
     }
 
+    /**
+     * Variant of \ref sample() using adjoint-driven Russian roulette and
+     * splitting. Paths created by splitting are traced one after the other
+     * using a stack of pending path states.
+     */
+    std::pair<Spectrum, Mask> sample_adrrs(const Scene *scene,
+                                           Sampler *sampler,
+                                           const RayDifferential3f &ray_,
+                                           Mask active) const {
+        if constexpr (is_array_v<Float>) {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sampler);
+            ENOKI_MARK_USED(ray_);
+            ENOKI_MARK_USED(active);
+            Throw("PathIntegrator::sample_adrrs(): not supported in vectorized variants.");
+        } else {
+            /// State of a path that was split, resumed after its sibling terminates
+            struct Branch {
+                RayDifferential3f ray;
+                SurfaceInteraction3f si;
+                Spectrum throughput;
+                Float eta;
+                int depth;
+            };
+
+            std::vector<Branch> branches;
+            ADRRSRecorder<Float, UnpolarizedSpectrum> recorder;
+
+            // Estimate of the pixel value, computed at the first radiance cache hit
+            Float pixel = -1.f;
+
+            RayDifferential3f ray = ray_;
+
+            // Tracks radiance scaling due to index of refraction changes
+            Float eta(1.f);
+
+            // MIS weight for intersected emitters (set by prev. iteration)
+            Float emission_weight(1.f);
+
+            Spectrum throughput(1.f), result(0.f);
+
+            // ---------------------- First intersection ----------------------
+
+            SurfaceInteraction3f si = scene->ray_intersect(ray, active);
+            Mask valid_ray = si.is_valid();
+            EmitterPtr emitter = si.emitter(scene);
+            bool resumed = false;
+            int depth = 1;
+
+            while (true) {
+
+                // ---------------- Intersection with emitters ----------------
+
+                if (emitter)
+                    result += emission_weight * throughput * emitter->eval(si, active);
+
+                active &= si.is_valid();
+
+                /* Russian roulette and splitting (skipped by resumed paths, for
+                   which the decision was already made at this vertex). Falls back
+                   to the throughput-based criterion where the radiance cache
+                   provides no estimate (and while it is being trained). */
+                if (active && !resumed) {
+                    Float factor = m_adrrs.factor(si.p, hmean(depolarize(throughput)),
+                                                  hmean(depolarize(result)), pixel);
+
+                    if (factor > 0.f) {
+                        if (factor < 1.f) {
+                            active = sampler->next_1d(active) < factor;
+                            throughput /= factor;
+                        } else if (factor > 1.f) {
+                            size_t count = std::min((size_t) factor,
+                                                    ADRRS<ScalarFloat>::MaxBranches + 1 -
+                                                        branches.size());
+                            throughput /= (Float) count;
+                            for (size_t i = 1; i < count; ++i)
+                                branches.push_back({ ray, si, throughput, eta, depth });
+                        }
+                    } else if (depth > m_rr_depth) {
+                        Float q = min(hmax(depolarize(throughput)) * sqr(eta), .95f);
+                        active &= sampler->next_1d(active) < q;
+                        throughput *= rcp(q);
+                    }
+                }
+                resumed = false;
+
+                if ((uint32_t) depth >= (uint32_t) m_max_depth)
+                    active = false;
+
+                if (active) {
+                    if (m_adrrs.training())
+                        recorder.add_vertex(si.p, depolarize(throughput), depolarize(result));
+
+                    // --------------------- Emitter sampling ---------------------
+
+                    BSDFContext ctx;
+                    BSDFPtr bsdf = si.bsdf(ray);
+
+                    if (has_flag(bsdf->flags(), BSDFFlags::Smooth)) {
+                        auto [ds, emitter_val] = scene->sample_emitter_direction(
+                            si, sampler->next_2d(active), true, active);
+
+                        if (ds.pdf != 0.f) {
+                            // Query the BSDF for that emitter-sampled direction
+                            Vector3f wo = si.to_local(ds.d);
+                            Spectrum bsdf_val = bsdf->eval(ctx, si, wo, active);
+                            bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
+
+                            // Determine density of sampling that same direction using BSDF sampling
+                            Float bsdf_pdf = bsdf->pdf(ctx, si, wo, active);
+
+                            Float mis = ds.delta ? 1.f : mis_weight(ds.pdf, bsdf_pdf);
+                            result += mis * throughput * bsdf_val * emitter_val;
+                        }
+                    }
+
+                    // ----------------------- BSDF sampling ----------------------
+
+                    // Sample BSDF * cos(theta)
+                    counter_add_lanes(Counter::BSDFSample, active);
+                    auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active),
+                                                       sampler->next_2d(active), active);
+                    bsdf_val = si.to_world_mueller(bsdf_val, -bs.wo, si.wi);
+
+                    throughput = throughput * bsdf_val;
+                    active &= any(neq(depolarize(throughput), 0.f));
+
+                    if (active) {
+                        eta *= bs.eta;
+
+                        // Intersect the BSDF ray against the scene geometry
+                        ray = si.spawn_ray(si.to_world(bs.wo));
+                        SurfaceInteraction3f si_bsdf = scene->ray_intersect(ray, active);
+
+                        /* Determine probability of having sampled that same
+                           direction using emitter sampling. */
+                        emitter = si_bsdf.emitter(scene, active);
+                        DirectionSample3f ds(si_bsdf, si);
+                        ds.object = emitter;
+
+                        if (emitter) {
+                            Float emitter_pdf = !has_flag(bs.sampled_type, BSDFFlags::Delta)
+                                                    ? scene->pdf_emitter_direction(si, ds)
+                                                    : 0.f;
+                            emission_weight = mis_weight(bs.pdf, emitter_pdf);
+                        }
+
+                        si = std::move(si_bsdf);
+                        ++depth;
+                        continue;
+                    }
+                }
+
+                // The path terminated: continue with the most recently split path
+                if (branches.empty())
+                    break;
+
+                const Branch &branch = branches.back();
+                ray        = branch.ray;
+                si         = branch.si;
+                throughput = branch.throughput;
+                eta        = branch.eta;
+                depth      = branch.depth;
+                branches.pop_back();
+
+                // Emission at the split vertex was already accounted for
+                emitter = nullptr;
+                active  = true;
+                resumed = true;
+            }
+
+            if (m_adrrs.training())
+                recorder.commit(m_adrrs.cache(), depolarize(result));
+
+            return { result, valid_ray };
+        }
+    }
+
     //! @}
     // =============================================================
 
     std::string to_string() const override {
         return tfm::format("PathIntegrator[\n"
             "  max_depth = %i,\n"
-            "  rr_depth = %i\n"
-            "]", m_max_depth, m_rr_depth);
+            "  rr_depth = %i,\n"
+            "  rr_mode = %s\n"
+            "]", m_max_depth, m_rr_depth, m_adrrs.to_string());
     }
 
     Float mis_weight(Float pdf_a, Float pdf_b) const {
@@ -227,6 +473,8 @@ public:
     }
 
     MTS_DECLARE_CLASS()
+private:
+    ADRRS<ScalarFloat> m_adrrs;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(PathIntegrator, MonteCarloIntegrator)
@@ -0,0 +1,602 @@
+#include <atomic>
+#include <enoki/stl.h>
+#include <mitsuba/core/atomic.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/progress.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/counters.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-sppm:
+
+Stochastic progressive photon mapping (:monosp:`sppm`)
+------------------------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1 corresponds to
+     :math:`\infty`). A value of 1 will only render directly visible light sources. 2 will lead
+     to single-bounce (direct-only) illumination, and so on. (Default: -1)
+ * - rr_depth
+   - |int|
+   - Specifies the minimum depth of photon paths, after which the implementation will start
+     to use the *russian roulette* path termination criterion. (Default: 5)
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: no, i.e. |false|)
+ * - photon_count
+   - |int|
+   - Number of photons traced per iteration. (Default: 250000)
+ * - initial_radius
+   - |float|
+   - Initial gather radius in world space units. A value of zero selects 1/500 of the
+     longest side of the scene bounding box. (Default: 0)
+ * - alpha
+   - |float|
+   - Radius reduction parameter, which controls how quickly the gather radius shrinks
+     (in the range (0, 1), smaller values shrink faster). (Default: 0.7)
+
+This plugin implements *stochastic progressive photon mapping* (SPPM) by Hachisuka and
+Jensen. It renders caustics and other light paths through specular interfaces, e.g.
+the pattern at the bottom of a pool or the dispersion of a gemstone, which are all but
+impossible to sample from the sensor side with a path tracer.
+
+The integrator performs a number of iterations, which is given by the sample count of
+the sensor's sampler. Every iteration traces one camera path per pixel through specular
+interactions until it finds a *visible point* on a surface with a non-delta BSDF, where
+direct illumination is computed using emitter sampling. The visible points are then
+inserted into a spatial hash grid, and a set of photons is traced from the emitters
+(see ``Scene::sample_emitter_ray()``). Each photon that lands within the gather radius of
+a visible point contributes to its flux estimate. Finally, the gather radius of each pixel
+shrinks according to the number of photons it received, which makes the estimate
+consistent as the number of iterations grows.
+
+Both the camera and photon passes run in parallel. The hash grid is rebuilt every
+iteration and filled concurrently using atomic compare-and-swap operations.
+
+.. code-block:: xml
+
+    <integrator type="sppm">
+        <integer name="photon_count" value="1000000"/>
+    </integrator>
+
+.. note:: This integrator requires a scalar RGB or monochromatic variant of the renderer,
+   does not handle participating media, and ignores the reconstruction filter of the film
+   (each camera path only contributes to its own pixel).
+
+ */
+
+template <typename Float, typename Spectrum>
+class SPPMIntegrator final : public SamplingIntegrator<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(SamplingIntegrator, m_stop, m_render_timer, m_hide_emitters, should_stop)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, Film, ImageBlock, Emitter, EmitterPtr, BSDF,
+                     BSDFPtr)
+
+    /// Per-pixel state of the progressive estimate and its current visible point
+    struct Pixel {
+        // Progressive estimate
+        ScalarFloat radius = 0.f, n = 0.f, alpha = 0.f;
+        UnpolarizedSpectrum direct = 0.f, tau = 0.f;
+
+        // Visible point of the current iteration
+        SurfaceInteraction3f si;
+        UnpolarizedSpectrum throughput = 0.f;
+        const BSDF *bsdf = nullptr;
+        int depth = 0;
+
+        // Photon statistics of the current iteration
+        AtomicFloat<ScalarFloat> phi[array_size_v<UnpolarizedSpectrum>];
+        std::atomic<uint32_t> m { 0 };
+    };
+
+    /// Entry of the linked list of visible points overlapping a grid cell
+    struct GridNode {
+        uint32_t pixel, next;
+    };
+
+    static constexpr uint32_t InvalidNode = (uint32_t) -1;
+
+    /// Each visible point overlaps at most 2x2x2 cells, whose size is twice the largest radius
+    static constexpr size_t MaxNodesPerPixel = 8;
+
+    /// SPPM requires scalar variants that store colors (rather than spectral samples)
+    static constexpr bool Supported =
+        !is_array_v<Float> && !is_spectral_v<Spectrum> && !is_polarized_v<Spectrum>;
+
+    SPPMIntegrator(const Properties &props) : Base(props) {
+        m_max_depth = props.int_("max_depth", -1);
+        if (m_max_depth < 0 && m_max_depth != -1)
+            Throw("\"max_depth\" must be set to -1 (infinite) or a value >= 0");
+        m_rr_depth = props.int_("rr_depth", 5);
+        if (m_rr_depth <= 0)
+            Throw("\"rr_depth\" must be set to a value greater than zero!");
+
+        m_photon_count = props.size_("photon_count", 250000);
+        if (m_photon_count == 0)
+            Throw("\"photon_count\" must be greater than zero!");
+        m_initial_radius = props.float_("initial_radius", 0.f);
+        if (m_initial_radius < 0.f)
+            Throw("\"initial_radius\" must be non-negative!");
+        m_alpha = props.float_("alpha", .7f);
+        if (m_alpha <= 0.f || m_alpha >= 1.f)
+            Throw("\"alpha\" must be in the range (0, 1)!");
+
+        if constexpr (!Supported)
+            Throw("The SPPM integrator is only supported in scalar RGB and monochromatic "
+                  "variants of the renderer.");
+    }
+
+    bool render(Scene *scene, Sensor *sensor) override {
+        if constexpr (!Supported) {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sensor);
+            return false;
+        } else {
+            ScopedPhase sp(ProfilerPhase::Render);
+            m_stop = false;
+
+            ref<Film> film = sensor->film();
+            ScalarVector2i film_size = film->crop_size();
+            size_t pixel_count = (size_t) hprod(film_size),
+                   iterations  = sensor->sampler()->sample_count();
+
+            film->prepare({ "X", "Y", "Z", "A", "W" });
+
+            ScalarFloat radius = m_initial_radius;
+            if (radius == 0.f)
+                radius = hmax(scene->bbox().extents()) / 500.f;
+
+            std::unique_ptr<Pixel[]> pixels(new Pixel[pixel_count]);
+            for (size_t i = 0; i < pixel_count; ++i)
+                pixels[i].radius = radius;
+
+            std::unique_ptr<GridNode[]> nodes(new GridNode[MaxNodesPerPixel * pixel_count]);
+            std::unique_ptr<std::atomic<uint32_t>[]> cells(new std::atomic<uint32_t>[pixel_count]);
+
+            Log(Info, "Starting render job (%ix%i, %i iteration%s, %i photons per iteration, "
+                "%i thread%s)", film_size.x(), film_size.y(), iterations,
+                iterations == 1 ? "" : "s", m_photon_count, __global_thread_count,
+                __global_thread_count == 1 ? "" : "s");
+
+            ray_counters_reset();
+            m_render_timer.reset();
+
+            ThreadEnvironment env;
+            ref<ProgressReporter> progress = new ProgressReporter("Rendering");
+            size_t iteration = 0;
+
+            for (; iteration < iterations && !should_stop(); ++iteration) {
+                // 1. Trace camera paths to the visible points of this iteration
+                tbb::parallel_for(
+                    tbb::blocked_range<size_t>(0, pixel_count, 256),
+                    [&](const tbb::blocked_range<size_t> &range) {
+                        ScopedSetThreadEnvironment set_env(env);
+                        ref<Sampler> sampler = sensor->sampler()->clone();
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            sampler->seed(iteration * pixel_count + i);
+                            trace_camera_path(scene, sensor, sampler, film, pixels[i],
+                                              ScalarPoint2u((uint32_t) (i % film_size.x()),
+                                                            (uint32_t) (i / film_size.x())));
+                        }
+                    }
+                );
+
+                if (should_stop())
+                    break;
+
+                // 2. Insert the visible points into the spatial hash grid
+                Grid grid = build_grid(pixels.get(), pixel_count, nodes.get(), cells.get());
+
+                // 3. Trace photons and splat them onto nearby visible points
+                size_t seed_offset = iterations * pixel_count + iteration * m_photon_count;
+                tbb::parallel_for(
+                    tbb::blocked_range<size_t>(0, m_photon_count, 1024),
+                    [&](const tbb::blocked_range<size_t> &range) {
+                        ScopedSetThreadEnvironment set_env(env);
+                        ref<Sampler> sampler = sensor->sampler()->clone();
+                        for (size_t i = range.begin(); i != range.end() && !should_stop(); ++i) {
+                            sampler->seed(seed_offset + i);
+                            trace_photon(scene, sensor, sampler, pixels.get(), grid,
+                                         nodes.get(), cells.get());
+                        }
+                    }
+                );
+
+                // Discard the photons of an interrupted iteration
+                if (should_stop())
+                    break;
+
+                // 4. Progressive radius reduction and flux update [Hachisuka and Jensen 2009]
+                tbb::parallel_for(
+                    tbb::blocked_range<size_t>(0, pixel_count, 1024),
+                    [&](const tbb::blocked_range<size_t> &range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            Pixel &pixel = pixels[i];
+                            uint32_t m = pixel.m.load(std::memory_order_relaxed);
+                            if (m > 0) {
+                                ScalarFloat n_new = pixel.n + m_alpha * m,
+                                            radius_new =
+                                                pixel.radius * std::sqrt(n_new / (pixel.n + m));
+
+                                UnpolarizedSpectrum phi;
+                                for (size_t k = 0; k < array_size_v<UnpolarizedSpectrum>; ++k)
+                                    phi[k] = pixel.phi[k];
+
+                                pixel.tau = (pixel.tau + pixel.throughput * phi) *
+                                            sqr(radius_new / pixel.radius);
+                                pixel.n = n_new;
+                                pixel.radius = radius_new;
+                            }
+
+                            for (size_t k = 0; k < array_size_v<UnpolarizedSpectrum>; ++k)
+                                pixel.phi[k] = 0.f;
+                            pixel.m.store(0, std::memory_order_relaxed);
+                        }
+                    }
+                );
+
+                progress->update((iteration + 1) / (ScalarFloat) iterations);
+            }
+
+            // Develop the estimate of the completed iterations
+            if (iteration > 0) {
+                ref<ImageBlock> block = new ImageBlock(film_size, 5, nullptr);
+                block->set_offset(film->crop_offset());
+                block->clear();
+
+                ScalarFloat inv_iterations = 1.f / (ScalarFloat) iteration,
+                            inv_photons    = inv_iterations / (ScalarFloat) m_photon_count;
+
+                for (size_t i = 0; i < pixel_count; ++i) {
+                    const Pixel &pixel = pixels[i];
+                    UnpolarizedSpectrum value =
+                        pixel.direct * inv_iterations +
+                        pixel.tau * (inv_photons / (math::Pi<ScalarFloat> * sqr(pixel.radius)));
+
+                    Color3f xyz;
+                    if constexpr (is_monochromatic_v<Spectrum>)
+                        xyz = value.x();
+                    else
+                        xyz = srgb_to_xyz(value);
+
+                    Float values[5] = { xyz.x(), xyz.y(), xyz.z(),
+                                        pixel.alpha * inv_iterations, 1.f };
+                    ScalarPoint2f pos(ScalarFloat(i % film_size.x()) + .5f,
+                                      ScalarFloat(i / film_size.x()) + .5f);
+                    block->put(pos + ScalarVector2f(block->offset()), values);
+                }
+
+                film->put(block);
+            }
+
+            if (!m_stop) {
+                size_t render_time = m_render_timer.value();
+                Log(Info, "Rendering finished. (took %s)", util::time_string(render_time, true));
+                if (ray_counters_enabled())
+                    Log(Info, "%s", ray_counters().to_string(render_time / 1000.0));
+            }
+
+            return !m_stop;
+        }
+    }
+
+    std::string to_string() const override {
+        return tfm::format("SPPMIntegrator[\n"
+                           "  max_depth = %i,\n"
+                           "  rr_depth = %i,\n"
+                           "  photon_count = %i,\n"
+                           "  initial_radius = %f,\n"
+                           "  alpha = %f\n"
+                           "]",
+                           m_max_depth, m_rr_depth, m_photon_count, m_initial_radius,
+                           m_alpha);
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    /// Uniform grid over the visible points, whose cells are hashed into a table
+    struct Grid {
+        ScalarBoundingBox3f bbox;
+        ScalarVector3i res;
+        ScalarFloat inv_cell_size;
+        size_t table_size;
+
+        /// Cell containing \c p, which must lie within \c bbox
+        ScalarVector3i cell(const ScalarPoint3f &p) const {
+            return clamp(ScalarVector3i((p - bbox.min) * inv_cell_size), 0, res - 1);
+        }
+
+        size_t hash(const ScalarVector3i &index) const {
+            return (size_t) (((uint32_t) index.x() * 73856093u) ^
+                             ((uint32_t) index.y() * 19349663u) ^
+                             ((uint32_t) index.z() * 83492791u)) % table_size;
+        }
+    };
+
+    /**
+     * Trace a path from the sensor through specular interactions until it
+     * reaches a surface with a smooth BSDF, which becomes the pixel's visible
+     * point. Emission found along the way and direct illumination at the
+     * visible point are accumulated into the pixel's direct estimate.
+     */
+    void trace_camera_path(const Scene *scene, const Sensor *sensor, Sampler *sampler,
+                           const Film *film, Pixel &pixel, const ScalarPoint2u &pos) const {
+        if constexpr (!Supported) {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sensor);
+            ENOKI_MARK_USED(sampler);
+            ENOKI_MARK_USED(film);
+            ENOKI_MARK_USED(pixel);
+            ENOKI_MARK_USED(pos);
+            Throw("SPPMIntegrator::trace_camera_path(): not supported in this variant.");
+        } else {
+        pixel.bsdf = nullptr;
+
+        Point2f position_sample = Point2f(pos) + sampler->next_2d();
+        Point2f aperture_sample(.5f);
+        if (sensor->needs_aperture_sample())
+            aperture_sample = sampler->next_2d();
+
+        Float time = sensor->shutter_open();
+        if (sensor->shutter_open_time() > 0.f)
+            time += sampler->next_1d() * sensor->shutter_open_time();
+
+        Float wavelength_sample = sampler->next_1d();
+        auto [ray, ray_weight] = sensor->sample_ray_differential(
+            time, wavelength_sample, position_sample / ScalarVector2f(film->crop_size()),
+            aperture_sample);
+        ray.scale_differential(rsqrt((ScalarFloat) sampler->sample_count()));
+
+        UnpolarizedSpectrum throughput = depolarize(ray_weight), direct(0.f);
+
+        SurfaceInteraction3f si = scene->ray_intersect(ray);
+        if (si.is_valid())
+            pixel.alpha += 1.f;
+
+        for (int depth = 1;; ++depth) {
+            // Emission is only found by the camera path along specular chains
+            EmitterPtr emitter = si.emitter(scene);
+            if (emitter && !(m_hide_emitters && depth == 1))
+                direct += throughput * depolarize(emitter->eval(si));
+
+            if (!si.is_valid() || (uint32_t) depth >= (uint32_t) m_max_depth)
+                break;
+
+            BSDFContext ctx;
+            BSDFPtr bsdf = si.bsdf(ray);
+
+            if (has_flag(bsdf->flags(), BSDFFlags::Smooth)) {
+                // Direct illumination by emitter sampling, photons handle the rest
+                auto [ds, emitter_val] = scene->sample_emitter_direction(si, sampler->next_2d(), true);
+                if (ds.pdf != 0.f) {
+                    Vector3f wo = si.to_local(ds.d);
+                    direct += throughput * depolarize(bsdf->eval(ctx, si, wo) * emitter_val);
+                }
+
+                pixel.si         = si;
+                pixel.throughput = throughput;
+                pixel.bsdf       = bsdf;
+                pixel.depth      = depth;
+                break;
+            }
+
+            // Continue through specular interactions
+            auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(), sampler->next_2d());
+            throughput *= depolarize(bsdf_val);
+            if (all(eq(throughput, 0.f)))
+                break;
+
+            ray = si.spawn_ray(si.to_world(bs.wo));
+            si = scene->ray_intersect(ray);
+        }
+
+        pixel.direct += direct;
+        }
+    }
+
+    /// Insert the visible points into the (cleared) hash grid
+    Grid build_grid(Pixel *pixels, size_t pixel_count, GridNode *nodes,
+                    std::atomic<uint32_t> *cells) const {
+        if constexpr (!Supported) {
+            ENOKI_MARK_USED(pixels);
+            ENOKI_MARK_USED(pixel_count);
+            ENOKI_MARK_USED(nodes);
+            ENOKI_MARK_USED(cells);
+            Throw("SPPMIntegrator::build_grid(): not supported in this variant.");
+        } else {
+            using Bounds = std::pair<ScalarBoundingBox3f, ScalarFloat>;
+            Bounds bounds = tbb::parallel_reduce(
+                tbb::blocked_range<size_t>(0, pixel_count, 4096),
+                Bounds(ScalarBoundingBox3f(), 0.f),
+                [&](const tbb::blocked_range<size_t> &range, Bounds b) {
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        const Pixel &pixel = pixels[i];
+                        if (!pixel.bsdf)
+                            continue;
+                        b.first.expand(pixel.si.p - pixel.radius);
+                        b.first.expand(pixel.si.p + pixel.radius);
+                        b.second = std::max(b.second, pixel.radius);
+                    }
+                    return b;
+                },
+                [](Bounds b1, const Bounds &b2) {
+                    b1.first.expand(b2.first);
+                    return Bounds(b1.first, std::max(b1.second, b2.second));
+                }
+            );
+
+            Grid grid;
+            grid.bbox = bounds.first;
+            grid.table_size = pixel_count;
+            grid.inv_cell_size = 1.f / (2.f * std::max(bounds.second, math::Epsilon<ScalarFloat>));
+            grid.res = ScalarVector3i(0);
+            if (grid.bbox.valid())
+                grid.res = max(min(ScalarVector3i(ceil(grid.bbox.extents() * grid.inv_cell_size)),
+                                   1 << 20), 1);
+
+            for (size_t i = 0; i < pixel_count; ++i)
+                cells[i].store(InvalidNode, std::memory_order_relaxed);
+
+            if (!grid.bbox.valid())
+                return grid;
+
+            size_t node_capacity = MaxNodesPerPixel * pixel_count;
+            std::atomic<uint32_t> node_count { 0 };
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(0, pixel_count, 1024),
+                [&](const tbb::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        const Pixel &pixel = pixels[i];
+                        if (!pixel.bsdf)
+                            continue;
+
+                        /* Rounding can make the footprint straddle a third cell along
+                           an axis, which it then only touches at its boundary */
+                        ScalarVector3i lo = grid.cell(pixel.si.p - pixel.radius),
+                                       hi = min(grid.cell(pixel.si.p + pixel.radius), lo + 1);
+
+                        for (int z = lo.z(); z <= hi.z(); ++z) {
+                            for (int y = lo.y(); y <= hi.y(); ++y) {
+                                for (int x = lo.x(); x <= hi.x(); ++x) {
+                                    // Lock-free insertion at the head of the cell's list
+                                    uint32_t index = node_count.fetch_add(1, std::memory_order_relaxed);
+                                    if (index >= node_capacity)
+                                        continue;
+                                    std::atomic<uint32_t> &head = cells[grid.hash(ScalarVector3i(x, y, z))];
+                                    GridNode &node = nodes[index];
+                                    node.pixel = (uint32_t) i;
+                                    node.next = head.load(std::memory_order_relaxed);
+                                    while (!head.compare_exchange_weak(node.next, index,
+                                                                       std::memory_order_release,
+                                                                       std::memory_order_relaxed))
+                                        ;
+                                }
+                            }
+                        }
+                    }
+                }
+            );
+
+            return grid;
+        }
+    }
+
+    /// Trace a photon from the emitters and record it at every visible point in range
+    void trace_photon(const Scene *scene, const Sensor *sensor, Sampler *sampler, Pixel *pixels,
+                      const Grid &grid, const GridNode *nodes,
+                      const std::atomic<uint32_t> *cells) const {
+        if constexpr (!Supported) {
+            ENOKI_MARK_USED(scene);
+            ENOKI_MARK_USED(sensor);
+            ENOKI_MARK_USED(sampler);
+            ENOKI_MARK_USED(pixels);
+            ENOKI_MARK_USED(grid);
+            ENOKI_MARK_USED(nodes);
+            ENOKI_MARK_USED(cells);
+            Throw("SPPMIntegrator::trace_photon(): not supported in this variant.");
+        } else {
+            Float time = sensor->shutter_open();
+            if (sensor->shutter_open_time() > 0.f)
+                time += sampler->next_1d() * sensor->shutter_open_time();
+
+            Float emitter_sample = sampler->next_1d();
+            Point2f position_sample = sampler->next_2d(),
+                    direction_sample = sampler->next_2d();
+            auto [ray, weight] = scene->sample_emitter_ray(time, emitter_sample, position_sample,
+                                                            direction_sample);
+            UnpolarizedSpectrum throughput = depolarize(weight);
+            if (all(eq(throughput, 0.f)))
+                return;
+
+            BSDFContext ctx(TransportMode::Importance), ctx_vp;
+
+            for (int depth = 1;; ++depth) {
+                SurfaceInteraction3f si = scene->ray_intersect(ray);
+                if (!si.is_valid())
+                    break;
+
+                // Direct illumination is handled by the camera pass
+                if (depth > 1 && grid.bbox.contains(si.p)) {
+                    size_t cell = grid.hash(grid.cell(si.p));
+                    for (uint32_t node = cells[cell].load(std::memory_order_acquire);
+                         node != InvalidNode; node = nodes[node].next) {
+                        Pixel &pixel = pixels[nodes[node].pixel];
+                        if (squared_norm(pixel.si.p - si.p) > sqr(pixel.radius) ||
+                            (m_max_depth != -1 && pixel.depth + depth > m_max_depth))
+                            continue;
+
+                        pixel.m.fetch_add(1, std::memory_order_relaxed);
+
+                        /* eval() includes the cosine of the photon's direction, but
+                           the density estimate divides flux by area, not projected
+                           area: remove it again (grazing photons carry no flux) */
+                        Vector3f wi = pixel.si.to_local(-ray.d);
+                        Float cos_theta = abs(Frame3f::cos_theta(wi));
+                        if (cos_theta < math::Epsilon<Float>)
+                            continue;
+
+                        UnpolarizedSpectrum phi =
+                            throughput * depolarize(pixel.bsdf->eval(ctx_vp, pixel.si, wi)) /
+                            cos_theta;
+                        for (size_t k = 0; k < array_size_v<UnpolarizedSpectrum>; ++k)
+                            pixel.phi[k] += phi[k];
+                    }
+                }
+
+                if ((uint32_t) depth + 1 >= (uint32_t) m_max_depth)
+                    break;
+
+                BSDFPtr bsdf = si.bsdf(ray);
+                auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(), sampler->next_2d());
+                UnpolarizedSpectrum throughput_new = throughput * depolarize(bsdf_val);
+
+                // Russian roulette based on the change of the photon's throughput
+                if (depth > m_rr_depth) {
+                    Float q = min(hmax(throughput_new) / hmax(throughput), .95f);
+                    if (!(sampler->next_1d() < q))
+                        break;
+                    throughput_new /= q;
+                }
+
+                throughput = throughput_new;
+                if (all(eq(throughput, 0.f)))
+                    break;
+
+                ray = si.spawn_ray(si.to_world(bs.wo));
+            }
+        }
+    }
+
+private:
+    int m_max_depth;
+    int m_rr_depth;
+    size_t m_photon_count;
+    ScalarFloat m_initial_radius;
+    ScalarFloat m_alpha;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(SPPMIntegrator, SamplingIntegrator)
+MTS_EXPORT_PLUGIN(SPPMIntegrator, "Stochastic progressive photon mapping integrator")
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,91 @@
+import numpy as np
+import pytest
+
+import mitsuba
+
+
+def make_scene(integrator, medium=False):
+    from mitsuba.core.xml import load_string
+
+    # A closed room lit by a small spherical emitter, which requires several
+    # bounces to be rendered accurately
+    return load_string("""<scene version="2.0.0">
+        %s
+        <sensor type="perspective">
+            <transform name="to_world">
+                <lookat origin="0, -2.5, 0.5" target="0, 0, -0.5" up="0, 0, 1"/>
+            </transform>
+            <film type="hdrfilm">
+                <integer name="width" value="16"/>
+                <integer name="height" value="16"/>
+            </film>
+            <sampler type="independent">
+                <integer name="sample_count" value="64"/>
+            </sampler>
+        </sensor>
+        <shape type="sphere">
+            <float name="radius" value="3"/>
+            <boolean name="flip_normals" value="true"/>
+            <bsdf type="diffuse">
+                <rgb name="reflectance" value="0.6, 0.6, 0.6"/>
+            </bsdf>
+        </shape>
+        <shape type="sphere">
+            <point name="center" x="0" y="0" z="-1"/>
+            <float name="radius" value="0.8"/>
+            <bsdf type="diffuse"/>
+        </shape>
+        <shape type="sphere">
+            <point name="center" x="0" y="0" z="2"/>
+            <float name="radius" value="0.3"/>
+            <emitter type="area">
+                <spectrum name="radiance" value="10"/>
+            </emitter>
+        </shape>
+        %s
+    </scene>""" % (integrator, """<shape type="sphere">
+            <point name="center" x="1" y="0" z="0"/>
+            <float name="radius" value="0.5"/>
+            <bsdf type="null"/>
+            <medium name="interior" type="homogeneous">
+                <float name="sigma_t" value="2"/>
+                <rgb name="albedo" value="0.8, 0.8, 0.8"/>
+            </medium>
+        </shape>""" if medium else ""))
+
+
+def render_mean(int_name, rr_mode, medium):
+    scene = make_scene("""<integrator type="%s">
+            <string name="rr_mode" value="%s"/>
+            <integer name="rr_depth" value="2"/>
+            <integer name="samples_per_pass" value="8"/>
+        </integrator>""" % (int_name, rr_mode), medium)
+
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+
+    image = np.array(sensor.film().bitmap(raw=False), copy=False)
+    assert np.all(np.isfinite(image))
+    return np.mean(image[..., :3])
+
+
+def test01_invalid_parameters(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+
+    for int_name in ['path', 'volpath']:
+        for param in ['<string name="rr_mode" value="splitting"/>',
+                      '<float name="adrrs_window" value="0.5"/>']:
+            with pytest.raises(Exception):
+                load_string("""<integrator version="2.0.0" type="%s">
+                        %s
+                    </integrator>""" % (int_name, param))
+
+
+@pytest.mark.parametrize('int_name, medium', [('path', False), ('volpath', False),
+                                              ('volpath', True)])
+def test02_unbiased(variant_scalar_rgb, int_name, medium):
+    # Splitting and Russian roulette must not change the expected image
+    reference = render_mean(int_name, 'throughput', medium)
+    result = render_mean(int_name, 'adrrs', medium)
+    assert reference > 0
+    assert np.isclose(result, reference, rtol=0.05)
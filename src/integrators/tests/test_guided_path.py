@@ -0,0 +1,109 @@
+import numpy as np
+import pytest
+
+import mitsuba
+
+
+def make_scene(integrator, spp):
+    from mitsuba.core.xml import load_string
+
+    # A closed room lit by a small spherical emitter, where most of the light
+    # arrives indirectly and guiding has something to learn
+    return load_string("""<scene version="2.0.0">
+        %s
+        <sensor type="perspective">
+            <transform name="to_world">
+                <lookat origin="0, -2.5, 0.5" target="0, 0, -0.5" up="0, 0, 1"/>
+            </transform>
+            <film type="hdrfilm">
+                <integer name="width" value="16"/>
+                <integer name="height" value="16"/>
+            </film>
+            <sampler type="independent">
+                <integer name="sample_count" value="%i"/>
+            </sampler>
+        </sensor>
+        <shape type="sphere">
+            <float name="radius" value="3"/>
+            <boolean name="flip_normals" value="true"/>
+            <bsdf type="diffuse">
+                <rgb name="reflectance" value="0.6, 0.6, 0.6"/>
+            </bsdf>
+        </shape>
+        <shape type="sphere">
+            <point name="center" x="0" y="0" z="-1"/>
+            <float name="radius" value="0.8"/>
+            <bsdf type="roughconductor">
+                <float name="alpha" value="0.3"/>
+            </bsdf>
+        </shape>
+        <shape type="sphere">
+            <point name="center" x="0" y="0" z="2"/>
+            <float name="radius" value="0.3"/>
+            <emitter type="area">
+                <spectrum name="radiance" value="10"/>
+            </emitter>
+        </shape>
+    </scene>""" % (integrator, spp))
+
+
+def render_mean(scene):
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+
+    image = np.array(sensor.film().bitmap(raw=False), copy=False)
+    assert np.all(np.isfinite(image))
+    return np.mean(image[..., :3])
+
+
+def test01_invalid_parameters(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+
+    for value in [0, -0.5, 1.5]:
+        with pytest.raises(Exception):
+            load_string("""<integrator version="2.0.0" type="guided_path">
+                    <float name="bsdf_sampling_fraction" value="%f"/>
+                </integrator>""" % value)
+
+
+@pytest.mark.parametrize('bsdf_sampling_fraction', [0.5, 0.1])
+def test02_matches_path(variant_scalar_rgb, bsdf_sampling_fraction):
+    # Several synchronized passes, each sampling from the distribution learned
+    # so far, must converge to the same image as the path tracer
+    reference = render_mean(make_scene('<integrator type="path"/>', 256))
+    result = render_mean(make_scene("""<integrator type="guided_path">
+            <integer name="samples_per_pass" value="16"/>
+            <float name="bsdf_sampling_fraction" value="%f"/>
+            <integer name="spatial_threshold" value="200"/>
+        </integrator>""" % bsdf_sampling_fraction, 128))
+
+    assert reference > 0
+    assert np.isclose(result, reference, rtol=0.05)
+
+
+def test03_pass_finished(variant_scalar_rgb):
+    from mitsuba.core import Color3f
+    from mitsuba.core.xml import load_string
+    from mitsuba.render import SamplingIntegrator, register_integrator
+
+    passes = []
+
+    class PassIntegrator(SamplingIntegrator):
+        def sample(self, scene, sampler, ray, medium, active):
+            return Color3f(1.0), True, []
+
+        def synchronize_passes(self):
+            return True
+
+        def pass_finished(self, pass_, pass_count):
+            passes.append((pass_, pass_count))
+
+    register_integrator('test_pass_integrator', lambda props: PassIntegrator(props))
+
+    scene = make_scene("""<integrator type="test_pass_integrator">
+            <integer name="samples_per_pass" value="2"/>
+        </integrator>""", 8)
+    assert render_mean(scene) > 0
+
+    # Invoked exactly once after each pass, in order
+    assert passes == [(i, 4) for i in range(4)]
@@ -0,0 +1,121 @@
+import numpy as np
+import pytest
+
+import mitsuba
+
+
+def make_scene(integrator):
+    from mitsuba.core.xml import load_string
+
+    return load_string("""<scene version="2.0.0">
+        %s
+        <sensor type="perspective">
+            <transform name="to_world">
+                <lookat origin="0, 0, 3" target="0, 0, 0" up="0, 1, 0"/>
+            </transform>
+            <film type="hdrfilm">
+                <integer name="width" value="8"/>
+                <integer name="height" value="8"/>
+            </film>
+            <sampler type="independent">
+                <integer name="sample_count" value="4"/>
+            </sampler>
+        </sensor>
+        <emitter type="point">
+            <point name="position" x="0" y="0" z="1"/>
+        </emitter>
+        <shape type="rectangle">
+            <transform name="to_world">
+                <scale value="4"/>
+            </transform>
+            <bsdf type="diffuse"/>
+        </shape>
+        <shape type="sphere">
+            <point name="center" x="0" y="0" z="0.5"/>
+            <float name="radius" value="0.2"/>
+            <bsdf type="roughconductor"/>
+        </shape>
+    </scene>""" % integrator)
+
+
+def test01_sample_emitter_ray(variant_scalar_rgb):
+    scene = make_scene('')
+
+    ray, weight = scene.sample_emitter_ray(0, 0.5, [0.5, 0.5], [0.3, 0.7])
+    assert np.allclose(ray.o, [0, 0, 1])
+    assert np.isclose(np.linalg.norm(ray.d), 1)
+    assert np.all(np.array(weight) > 0)
+
+
+def test02_invalid_parameters(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+
+    for name, value in [('alpha', 0), ('alpha', 1), ('initial_radius', -1)]:
+        with pytest.raises(Exception):
+            load_string("""<integrator version="2.0.0" type="sppm">
+                    <float name="%s" value="%f"/>
+                </integrator>""" % (name, value))
+
+
+def test03_render(variant_scalar_rgb):
+    scene = make_scene("""<integrator type="sppm">
+            <integer name="photon_count" value="20000"/>
+            <float name="initial_radius" value="0.1"/>
+        </integrator>""")
+
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+
+    image = np.array(sensor.film().bitmap(raw=False), copy=False)
+    assert np.all(np.isfinite(image))
+    assert np.all(image[..., :3] >= 0) and np.mean(image[..., :3]) > 0
+
+
+def test04_matches_path(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+
+    # Diffuse room lit by a point light, where most of the light is indirect
+    # and thus gathered from photons
+    scene_str = """<scene version="2.0.0">
+        %s
+        <sensor type="perspective">
+            <transform name="to_world">
+                <lookat origin="0, -1.5, 0" target="0, 0, 0" up="0, 0, 1"/>
+            </transform>
+            <film type="hdrfilm">
+                <integer name="width" value="16"/>
+                <integer name="height" value="16"/>
+            </film>
+            <sampler type="independent">
+                <integer name="sample_count" value="%i"/>
+            </sampler>
+        </sensor>
+        <emitter type="point">
+            <point name="position" x="0" y="0" z="1"/>
+            <spectrum name="intensity" value="10"/>
+        </emitter>
+        <shape type="sphere">
+            <float name="radius" value="2"/>
+            <boolean name="flip_normals" value="true"/>
+            <bsdf type="diffuse">
+                <rgb name="reflectance" value="0.7, 0.5, 0.3"/>
+            </bsdf>
+        </shape>
+    </scene>"""
+
+    def render_mean(integrator, spp):
+        scene = load_string(scene_str % (integrator, spp))
+        sensor = scene.sensors()[0]
+        assert scene.integrator().render(scene, sensor)
+        image = np.array(sensor.film().bitmap(raw=False), copy=False)
+        assert np.all(np.isfinite(image))
+        return np.mean(image[..., :3], axis=(0, 1))
+
+    reference = render_mean('<integrator type="path"/>', 256)
+    result = render_mean("""<integrator type="sppm">
+            <integer name="photon_count" value="50000"/>
+            <float name="initial_radius" value="0.2"/>
+        </integrator>""", 32)
+
+    assert np.all(reference > 0)
+    assert np.allclose(result, reference, rtol=0.05)
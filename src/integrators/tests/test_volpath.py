@@ -0,0 +1,74 @@
+import numpy as np
+import pytest
+
+import mitsuba
+
+from mitsuba.python.test.util import tmpfile
+
+
+def make_scene(integrator, transmittance, filename):
+    from mitsuba.core.xml import load_string
+
+    # A sphere filled with a heterogeneous medium in front of an environment
+    # emitter, whose shadow rays cross regions of varying density
+    return load_string("""<scene version="2.0.0">
+        <integrator type="%s">
+            <integer name="max_depth" value="8"/>
+            <string name="transmittance" value="%s"/>
+        </integrator>
+        <sensor type="perspective">
+            <transform name="to_world">
+                <lookat origin="0, -4, 1" target="0, 0, 0" up="0, 0, 1"/>
+            </transform>
+            <film type="hdrfilm">
+                <integer name="width" value="16"/>
+                <integer name="height" value="16"/>
+            </film>
+            <sampler type="independent">
+                <integer name="sample_count" value="128"/>
+            </sampler>
+        </sensor>
+        <emitter type="constant">
+            <spectrum name="radiance" value="1"/>
+        </emitter>
+        <shape type="sphere">
+            <bsdf type="null"/>
+            <medium type="heterogeneous" name="interior">
+                <volume type="gridvolume" name="sigma_t">
+                    <string name="filename" value="%s"/>
+                    <transform name="to_world">
+                        <translate x="-0.5" y="-0.5" z="-0.5"/>
+                        <scale value="2"/>
+                    </transform>
+                </volume>
+                <rgb name="albedo" value="0.8, 0.6, 0.4"/>
+                <float name="scale" value="2"/>
+                <float name="control_fraction" value="0.5"/>
+            </medium>
+        </shape>
+    </scene>""" % (integrator, transmittance, filename))
+
+
+def render(scene):
+    sensor = scene.sensors()[0]
+    assert scene.integrator().render(scene, sensor)
+
+    image = np.array(sensor.film().bitmap(raw=False), copy=False)
+    assert np.all(np.isfinite(image))
+    return image[..., :3]
+
+
+@pytest.mark.parametrize('integrator', ['volpath', 'volpathmis'])
+def test01_residual_ratio_matches_ratio(variant_scalar_rgb, tmpfile, integrator):
+    from mitsuba.python.volume import write_dense_volume
+
+    rng = np.random.RandomState(0)
+    write_dense_volume(tmpfile, rng.uniform(0.1, 1.5, size=(8, 8, 8)))
+
+    ratio = render(make_scene(integrator, 'ratio', tmpfile))
+    residual = render(make_scene(integrator, 'residual_ratio', tmpfile))
+
+    # Both estimators are unbiased: the images only differ by noise
+    assert np.mean(ratio) > 0
+    assert np.allclose(np.mean(ratio, axis=(0, 1)), np.mean(residual, axis=(0, 1)),
+                       rtol=0.03)
@@ -2,7 +2,9 @@
 #include <enoki/stl.h>
 #include <mitsuba/core/ray.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/render/adrrs.h>
 #include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/counters.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
@@ -16,11 +18,37 @@ template <typename Float, typename Spectrum>
 class VolumetricPathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
 
 public:
-    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters)
-    MTS_IMPORT_TYPES(Scene, Sampler, Emitter, EmitterPtr, BSDF, BSDFPtr,
+    MTS_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters,
+                    m_samples_per_pass)
+    MTS_IMPORT_TYPES(Scene, Sensor, Sampler, Emitter, EmitterPtr, BSDF, BSDFPtr,
                      Medium, MediumPtr, PhaseFunctionContext)
 
-    VolumetricPathIntegrator(const Properties &props) : Base(props) {
+    /// State of a path that was split at a scattering vertex, resumed after its sibling terminates
+    struct Branch {
+        Ray3f ray;
+        SurfaceInteraction3f si;
+        MediumInteraction3f mi;
+        MediumPtr medium;
+        Spectrum throughput;
+        Float eta;
+        UInt32 depth;
+        Mask specular_chain;
+        bool medium_vertex;
+    };
+
+    VolumetricPathIntegrator(const Properties &props)
+        : Base(props), m_adrrs(props, !is_array_v<Float>),
+          m_residual_ratio(use_residual_ratio_tracking(props)) { }
+
+    bool render(Scene *scene, Sensor *sensor) override {
+        m_adrrs.prepare(scene->bbox(), m_samples_per_pass, sensor->sampler()->sample_count());
+        return Base::render(scene, sensor);
+    }
+
+    bool synchronize_passes() const override { return m_adrrs.enabled(); }
+
+    void pass_finished(size_t pass, size_t /* pass_count */) override {
+        m_adrrs.pass_finished(pass);
     }
 
     MTS_INLINE
@@ -69,6 +97,51 @@ public:
         SurfaceInteraction3f si = zero<SurfaceInteraction3f>();
         si.t = math::Infinity<Float>;
         Mask needs_intersection = true;
+
+        // Bookkeeping of the adjoint-driven Russian roulette (scalar variants only)
+        std::vector<Branch> branches;
+        ADRRSRecorder<ScalarFloat, UnpolarizedSpectrum> recorder;
+        Float pixel = -1.f;
+        bool resumed = false, resumed_medium = false, adrrs_decided = false;
+
+        /* Adjoint-driven Russian roulette and splitting (see the 'path'
+           plugin) at a scattering vertex, before the next direction is
+           sampled. Split paths resume at the same vertex and sample their
+           own direction. Returns whether the path survives. */
+        auto adrrs_vertex = [&](const Point3f &p, bool medium_vertex) -> bool {
+            if constexpr (!is_array_v<Float>) {
+                if (m_adrrs.training()) {
+                    recorder.add_vertex(p, depolarize(throughput), depolarize(result));
+                    return true;
+                }
+
+                Float factor = m_adrrs.factor(p, hmean(depolarize(throughput)),
+                                              hmean(depolarize(result)), pixel);
+                if (!(factor > 0.f))
+                    return true;
+
+                // Replaces the throughput-based Russian roulette of this vertex
+                adrrs_decided = true;
+                if (factor < 1.f) {
+                    if (sampler->next_1d() >= factor)
+                        return false;
+                    throughput /= factor;
+                } else if (factor > 1.f) {
+                    size_t count = std::min((size_t) factor,
+                                            ADRRS<ScalarFloat>::MaxBranches + 1 -
+                                                branches.size());
+                    throughput /= (Float) count;
+                    for (size_t i = 1; i < count; ++i)
+                        branches.push_back({ ray, si, mi, medium, throughput, eta, depth,
+                                             specular_chain, medium_vertex });
+                }
+            } else {
+                ENOKI_MARK_USED(p);
+                ENOKI_MARK_USED(medium_vertex);
+            }
+            return true;
+        };
+
         for (int bounce = 0;; ++bounce) {
             // ----------------- Handle termination of paths ------------------
 
@@ -79,12 +152,43 @@ public:
             active &= any(neq(depolarize(throughput), 0.f));
             Float q = min(hmax(depolarize(throughput)) * sqr(eta), .95f);
             Mask perform_rr = (depth > (uint32_t) m_rr_depth);
+
+            // Skip vertices where adjoint-driven Russian roulette already decided
+            if constexpr (!is_array_v<Float>) {
+                perform_rr &= !resumed && !adrrs_decided;
+                if (!resumed)
+                    adrrs_decided = false;
+            }
+
             active &= sampler->next_1d(active) < q || !perform_rr;
             masked(throughput, perform_rr) *= rcp(detach(q));
 
             Mask exceeded_max_depth = depth >= (uint32_t) m_max_depth;
-            if (none(active) || all(exceeded_max_depth))
+            if (none(active) || all(exceeded_max_depth)) {
+                // The path terminated: continue with the most recently split path
+                if constexpr (!is_array_v<Float>) {
+                    if (!branches.empty()) {
+                        const Branch &branch = branches.back();
+                        ray                = branch.ray;
+                        si                 = branch.si;
+                        mi                 = branch.mi;
+                        medium             = branch.medium;
+                        throughput         = branch.throughput;
+                        eta                = branch.eta;
+                        depth              = branch.depth;
+                        specular_chain     = branch.specular_chain;
+                        resumed_medium     = branch.medium_vertex;
+                        needs_intersection = false;
+                        branches.pop_back();
+
+                        active        = true;
+                        resumed       = true;
+                        adrrs_decided = true;
+                        continue;
+                    }
+                }
                 break;
+            }
 
             // ----------------------- Sampling the RTE -----------------------
             Mask active_medium  = active && neq(medium, nullptr);
@@ -101,7 +205,7 @@ public:
                 not_spectral = !is_spectral && active_medium;
             }
 
-            if (any_or<true>(active_medium)) {
+            if (any_or<true>(active_medium) && !resumed) {
                 mi = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
                 masked(ray.maxt, active_medium && medium->is_homogeneous() && mi.is_valid()) = mi.t;
                 Mask intersect = needs_intersection && active_medium;
@@ -133,6 +237,15 @@ public:
                 masked(depth, act_medium_scatter) += 1;
             }
 
+            if constexpr (!is_array_v<Float>) {
+                if (resumed) {
+                    // A split path continues at the scattering vertex where it was split
+                    active_medium = act_medium_scatter = resumed_medium;
+                    active_surface = !resumed_medium;
+                    is_spectral = not_spectral = false;
+                }
+            }
+
             // Dont estimate lighting if we exceeded number of bounces
             active &= depth < (uint32_t) m_max_depth;
             act_medium_scatter &= active;
@@ -149,7 +262,15 @@ public:
                         mi.sigma_s * index_spectrum(mi.combined_extinction, channel) / index_spectrum(mi.sigma_t, channel);
                 if (any_or<true>(not_spectral))
                     masked(throughput, not_spectral && act_medium_scatter) *= mi.sigma_s / mi.sigma_t;
+            }
+
+            if constexpr (!is_array_v<Float>) {
+                if (m_adrrs.enabled() && act_medium_scatter && !resumed &&
+                    !adrrs_vertex(mi.p, true))
+                    act_medium_scatter = active_medium = false;
+            }
 
+            if (any_or<true>(act_medium_scatter)) {
                 PhaseFunctionContext phase_ctx(sampler);
                 auto phase = mi.medium->phase_function();
 
@@ -181,7 +302,7 @@ public:
             if (any_or<true>(intersect))
                 masked(si, intersect) = scene->ray_intersect(ray, intersect);
 
-            if (any_or<true>(active_surface)) {
+            if (any_or<true>(active_surface) && !resumed) {
                 // ---------------- Intersection with emitters ----------------
                 EmitterPtr emitter = si.emitter(scene);
                 Mask use_emitter_contribution =
@@ -191,6 +312,18 @@ public:
                         throughput * emitter->eval(si, use_emitter_contribution);
             }
             active_surface &= si.is_valid();
+
+            if constexpr (!is_array_v<Float>) {
+                if (m_adrrs.enabled() && active_surface && !resumed) {
+                    // Only split where the BSDF actually scatters light
+                    BSDFPtr bsdf = si.bsdf(ray);
+                    if ((has_flag(bsdf->flags(), BSDFFlags::Smooth) ||
+                         has_flag(bsdf->flags(), BSDFFlags::Delta)) &&
+                        !adrrs_vertex(si.p, false))
+                        active_surface = false;
+                }
+            }
+
             if (any_or<true>(active_surface)) {
                 // --------------------- Emitter sampling ---------------------
                 BSDFContext ctx;
@@ -212,6 +345,7 @@ public:
                 }
 
                 // ----------------------- BSDF sampling ----------------------
+                counter_add_lanes(Counter::BSDFSample, active_surface);
                 auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active_surface),
                                                    sampler->next_2d(active_surface), active_surface);
                 bsdf_val = si.to_world_mueller(bsdf_val, -bs.wo, si.wi);
@@ -252,7 +386,14 @@ public:
                 masked(si, intersect2) = si_new;
             }
             active &= (active_surface | active_medium);
+            resumed = false;
         }
+
+        if constexpr (!is_array_v<Float>) {
+            if (m_adrrs.training())
+                recorder.commit(m_adrrs.cache(), depolarize(result));
+        }
+
         return { result, valid_ray };
     }
 
@@ -290,7 +431,22 @@ public:
             Mask active_medium  = active && neq(medium, nullptr);
             Mask active_surface = active && !active_medium;
 
-            if (any_or<true>(active_medium)) {
+            if (m_residual_ratio && any_or<true>(active_medium)) {
+                /* Estimate the transmittance up to the next surface in one
+                   go, then continue as if the ray had left the medium */
+                Mask intersect = needs_intersection && active_medium;
+                if (any_or<true>(intersect))
+                    masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                needs_intersection &= !active_medium;
+
+                Ray3f segment = ray;
+                segment.maxt  = min(si.t, remaining_dist);
+                masked(transmittance, active_medium) *=
+                    medium->eval_tr_residual_ratio(segment, sampler, channel, active_medium);
+
+                escaped_medium = active_medium;
+                active_medium  = false;
+            } else if (any_or<true>(active_medium)) {
                 auto mi = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
                 masked(ray.maxt, active_medium && medium->is_homogeneous() && mi.is_valid()) = min(mi.t, remaining_dist);
                 Mask intersect = needs_intersection && active_medium;
@@ -387,7 +543,21 @@ public:
             Mask active_medium  = active && neq(medium, nullptr);
             Mask active_surface = active && !active_medium;
             SurfaceInteraction3f si_medium;
-            if (any_or<true>(active_medium)) {
+            if (m_residual_ratio && any_or<true>(active_medium)) {
+                // See sample_emitter()
+                Mask intersect = needs_intersection && active_medium;
+                if (any_or<true>(intersect))
+                    masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                needs_intersection &= !active_medium;
+
+                Ray3f segment = ray;
+                segment.maxt  = min(si.t, ray.maxt);
+                masked(transmittance, active_medium) *=
+                    medium->eval_tr_residual_ratio(segment, sampler, channel, active_medium);
+
+                escaped_medium = active_medium;
+                active_medium  = false;
+            } else if (any_or<true>(active_medium)) {
                 auto mi = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
                 masked(ray.maxt, active_medium && medium->is_homogeneous() && mi.is_valid()) = mi.t;
                 Mask intersect = needs_intersection && active_medium;
@@ -471,9 +641,12 @@ public:
     std::string to_string() const override {
         return tfm::format("VolumetricSimplePathIntegrator[\n"
                            "  max_depth = %i,\n"
-                           "  rr_depth = %i\n"
+                           "  rr_depth = %i,\n"
+                           "  rr_mode = %s,\n"
+                           "  transmittance = %s\n"
                            "]",
-                           m_max_depth, m_rr_depth);
+                           m_max_depth, m_rr_depth, m_adrrs.to_string(),
+                           m_residual_ratio ? "residual_ratio" : "ratio");
     }
 
     Float mis_weight(Float pdf_a, Float pdf_b) const {
@@ -483,6 +656,9 @@ public:
     };
 
     MTS_DECLARE_CLASS()
+private:
+    ADRRS<ScalarFloat> m_adrrs;
+    bool m_residual_ratio;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(VolumetricPathIntegrator, MonteCarloIntegrator);
@@ -3,6 +3,7 @@
 #include <mitsuba/core/ray.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/counters.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
@@ -37,6 +38,9 @@ public:
     VolumetricMisPathIntegrator(const Properties &props) : Base(props) {
         m_use_spectral_mis = props.bool_("use_spectral_mis", true);
         m_props = props;
+
+        // Only used in the implementation class
+        props.mark_queried("transmittance");
     }
 
     template <bool SpectralMis>
@@ -69,7 +73,8 @@ public:
         std::conditional_t<SpectralMis, Matrix<Float, array_size_v<UnpolarizedSpectrum>>,
                            UnpolarizedSpectrum>;
 
-    VolpathMisIntegratorImpl(const Properties &props) : Base(props) {}
+    VolpathMisIntegratorImpl(const Properties &props)
+        : Base(props), m_residual_ratio(use_residual_ratio_tracking(props)) { }
 
     MTS_INLINE
     Float index_spectrum(const UnpolarizedSpectrum &spec, const UInt32 &idx) const {
@@ -295,6 +300,7 @@ public:
                 }
 
                 // ----------------------- BSDF sampling ----------------------
+                counter_add_lanes(Counter::BSDFSample, active_surface);
                 auto [bs, bsdf_weight] = bsdf->sample(ctx, si, sampler->next_1d(active_surface),
                                                    sampler->next_2d(active_surface), active_surface);
                 Mask invalid_bsdf_sample = active_surface && eq(bs.pdf, 0.f);
@@ -361,7 +367,27 @@ public:
             Mask active_medium  = active && neq(medium, nullptr);
             Mask active_surface = active && !active_medium;
 
-            if (any_or<true>(active_medium)) {
+            if (m_residual_ratio && any_or<true>(active_medium)) {
+                /* Estimate the transmittance up to the next surface in one
+                   go, then continue as if the ray had left the medium */
+                Mask intersect = needs_intersection && active_medium;
+                if (any_or<true>(intersect))
+                    masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                needs_intersection &= !active_medium;
+
+                Ray3f segment = ray;
+                segment.maxt  = min(si.t, remaining_dist);
+                UnpolarizedSpectrum tr =
+                    medium->eval_tr_residual_ratio(segment, sampler, channel, active_medium);
+
+                /* Like the null collisions of ratio tracking, the estimate
+                   scales the unidirectional strategy's PDF relative to NEE */
+                update_weights(p_over_f_nee, 1.f, tr, channel, active_medium);
+                update_weights(p_over_f_uni, tr, tr, channel, active_medium);
+
+                escaped_medium = active_medium;
+                active_medium  = false;
+            } else if (any_or<true>(active_medium)) {
                 auto mi = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
                 masked(ray.maxt, active_medium && medium->is_homogeneous() && mi.is_valid()) = min(mi.t, remaining_dist);
                 Mask intersect = needs_intersection && active_medium;
@@ -501,12 +527,16 @@ public:
     std::string to_string() const override {
         return tfm::format("VolumetricMisPathIntegrator[\n"
                            "  max_depth = %i,\n"
-                           "  rr_depth = %i\n"
+                           "  rr_depth = %i,\n"
+                           "  transmittance = %s\n"
                            "]",
-                           m_max_depth, m_rr_depth);
+                           m_max_depth, m_rr_depth,
+                           m_residual_ratio ? "residual_ratio" : "ratio");
     }
 
     MTS_DECLARE_CLASS()
+private:
+    bool m_residual_ratio;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(VolumetricMisPathIntegrator, MonteCarloIntegrator);
@@ -7,6 +7,7 @@
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/fstream.h>
 #include <tbb/tbb.h>
+#include <map>
 #include <unordered_map>
 
 /* libpng */
@@ -36,6 +37,13 @@ extern "C" {
 #include <ImfStandardAttributes.h>
 #include <ImfRgbaYca.h>
 #include <ImfOutputFile.h>
+#include <ImfMultiPartInputFile.h>
+#include <ImfMultiPartOutputFile.h>
+#include <ImfInputPart.h>
+#include <ImfOutputPart.h>
+#include <ImfTiledOutputPart.h>
+#include <ImfTileDescription.h>
+#include <ImfPartType.h>
 #include <ImfChannelList.h>
 #include <ImfStringAttribute.h>
 #include <ImfIntAttribute.h>
@@ -916,17 +924,61 @@ private:
     ref<Stream> m_stream;
 };
 
+/// Map a compression scheme onto the corresponding OpenEXR constant
+static Imf::Compression exr_compression(Bitmap::EXRCompression compression) {
+    switch (compression) {
+        case Bitmap::EXRCompression::None:  return Imf::NO_COMPRESSION;
+        case Bitmap::EXRCompression::RLE:   return Imf::RLE_COMPRESSION;
+        case Bitmap::EXRCompression::ZIPS:  return Imf::ZIPS_COMPRESSION;
+        case Bitmap::EXRCompression::ZIP:   return Imf::ZIP_COMPRESSION;
+        case Bitmap::EXRCompression::PIZ:   return Imf::PIZ_COMPRESSION;
+        case Bitmap::EXRCompression::PXR24: return Imf::PXR24_COMPRESSION;
+        case Bitmap::EXRCompression::B44:   return Imf::B44_COMPRESSION;
+        case Bitmap::EXRCompression::B44A:  return Imf::B44A_COMPRESSION;
+        case Bitmap::EXRCompression::DWAA:  return Imf::DWAA_COMPRESSION;
+        case Bitmap::EXRCompression::DWAB:  return Imf::DWAB_COMPRESSION;
+        default: Throw("Unknown OpenEXR compression scheme!");
+    }
+}
+
 void Bitmap::read_openexr(Stream *stream) {
     if (Imf::globalThreadCount() == 0)
         Imf::setGlobalThreadCount(std::min(8, util::core_count()));
 
     EXRIStream istr(stream);
-    Imf::InputFile file(istr);
+    Imf::MultiPartInputFile file(istr, Imf::globalThreadCount());
 
-    const Imf::Header &header = file.header();
-    const Imf::ChannelList &channels = header.channels();
+    // Metadata, chromaticities, etc. are taken from the first part
+    const Imf::Header &header = file.header(0);
+    Imath::Box2i data_window = header.dataWindow();
+
+    // Gather the channels of all parts (e.g. one part per AOV group)
+    struct EXRChannel {
+        int part;
+        std::string name;
+        Imf::Channel channel;
+    };
+    std::map<std::string, EXRChannel> channels;
+
+    for (int i = 0; i < file.parts(); ++i) {
+        const Imf::Header &part_header = file.header(i);
+        if (part_header.hasType() && Imf::isDeepData(part_header.type()))
+            Throw("read_openexr(): deep images are not supported!");
+        if (part_header.dataWindow() != data_window)
+            Throw("read_openexr(): all parts must have the same data window!");
+
+        const Imf::ChannelList &part_channels = part_header.channels();
+        for (auto it = part_channels.begin(); it != part_channels.end(); ++it) {
+            std::string name(it.name());
+            // Disambiguate channels with the same name in different parts
+            if (channels.find(name) != channels.end() && part_header.hasName())
+                name = part_header.name() + "." + name;
+            if (!channels.emplace(name, EXRChannel{ i, it.name(), it.channel() }).second)
+                Throw("read_openexr(): duplicate channel \"%s\"!", name);
+        }
+    }
 
-    if (channels.begin() == channels.end())
+    if (channels.empty())
         Throw("read_openexr(): Image does not contain any channels!");
 
     // Load metadata if present
@@ -935,6 +987,11 @@ void Bitmap::read_openexr(Stream *stream) {
         const Imf::Attribute *attr = &it.attribute();
         std::string type_name = attr->typeName();
 
+        // Skip the attributes that describe the structure of multi-part files
+        if (file.parts() > 1 &&
+            (name == "name" || name == "type" || name == "chunkCount"))
+            continue;
+
         if (type_name == "string") {
             auto v = static_cast<const Imf::StringAttribute *>(attr);
             m_metadata.set_string(name, v->value());
@@ -966,7 +1023,7 @@ void Bitmap::read_openexr(Stream *stream) {
     m_premultiplied_alpha = true;
     m_pixel_format = PixelFormat::MultiChannel;
     m_struct = new Struct();
-    Imf::PixelType pixel_type = channels.begin().channel().type;
+    Imf::PixelType pixel_type = channels.begin()->second.channel.type;
 
     switch (pixel_type) {
         case Imf::HALF:  m_component_format = Struct::Type::Float16; break;
@@ -1012,8 +1069,7 @@ void Bitmap::read_openexr(Stream *stream) {
 
     bool found[NumClasses] = { false };
     std::vector<std::string> channels_sorted;
-    for (auto it = channels.begin(); it != channels.end(); ++it) {
-        std::string name(it.name());
+    for (auto const &[name, channel] : channels) {
         found[channel_class(name)] = true;
         channels_sorted.push_back(name);
     }
@@ -1068,8 +1124,8 @@ void Bitmap::read_openexr(Stream *stream) {
 
     // Check if there is a chromaticity header entry
     Imf::Chromaticities file_chroma;
-    if (Imf::hasChromaticities(file.header()))
-        file_chroma = Imf::chromaticities(file.header());
+    if (Imf::hasChromaticities(header))
+        file_chroma = Imf::chromaticities(header);
 
     auto chroma_eq = [](const Imf::Chromaticities &a,
                         const Imf::Chromaticities &b) {
@@ -1086,7 +1142,6 @@ void Bitmap::read_openexr(Stream *stream) {
         return name;
     };
 
-    Imath::Box2i data_window = file.header().dataWindow();
     m_size = Vector2u(data_window.max.x - data_window.min.x + 1,
                       data_window.max.y - data_window.min.y + 1);
 
@@ -1106,9 +1161,10 @@ void Bitmap::read_openexr(Stream *stream) {
         (data_window.min.x + data_window.min.y * m_size.x()) * pixel_stride;
 
     // Tell OpenEXR where the image data should be put
-    Imf::FrameBuffer framebuffer;
+    std::vector<Imf::FrameBuffer> framebuffers(file.parts());
     for (auto const &field: *m_struct) {
-        const Imf::Channel &channel = channels[field.name];
+        const EXRChannel &exr_channel = channels.find(field.name)->second;
+        const Imf::Channel &channel = exr_channel.channel;
         Vector2i sampling(channel.xSampling, channel.ySampling);
         Imf::Slice slice;
 
@@ -1133,16 +1189,20 @@ void Bitmap::read_openexr(Stream *stream) {
             resample_buffers.emplace_back(field.name, std::move(bitmap));
         }
 
-        framebuffer.insert(field.name, slice);
+        framebuffers[exr_channel.part].insert(exr_channel.name, slice);
     }
 
     auto fs = dynamic_cast<FileStream *>(stream);
-    Log(Debug, "Loading OpenEXR file \"%s\" (%ix%i, %s, %s) ..",
+    Log(Debug, "Loading OpenEXR file \"%s\" (%ix%i, %s, %s, %i part%s) ..",
         fs ? fs->path().string() : "<stream>", m_size.x(), m_size.y(),
-        m_pixel_format, m_component_format);
+        m_pixel_format, m_component_format, file.parts(),
+        file.parts() > 1 ? "s" : "");
 
-    file.setFrameBuffer(framebuffer);
-    file.readPixels(data_window.min.y, data_window.max.y);
+    for (int i = 0; i < file.parts(); ++i) {
+        Imf::InputPart part(file, i);
+        part.setFrameBuffer(framebuffers[i]);
+        part.readPixels(data_window.min.y, data_window.max.y);
+    }
 
     for (auto &buf: resample_buffers) {
         Log(Debug, "Upsampling layer \"%s\" from %ix%i to %ix%i pixels",
@@ -1211,7 +1271,7 @@ void Bitmap::read_openexr(Stream *stream) {
         }
     }
 
-    if (Imf::hasChromaticities(file.header()) &&
+    if (Imf::hasChromaticities(header) &&
         (m_pixel_format == PixelFormat::RGB || m_pixel_format == PixelFormat::RGBA)) {
 
         Imf::Chromaticities itu_rec_b_709;
@@ -1279,108 +1339,328 @@ void Bitmap::read_openexr(Stream *stream) {
 }
 
 void Bitmap::write_openexr(Stream *stream, int quality) const {
-    if (Imf::globalThreadCount() == 0)
-        Imf::setGlobalThreadCount(std::min(8, util::core_count()));
+    EXRPart part;
+    if (quality > 0) {
+        part.compression = EXRCompression::DWAB;
+        part.compression_level = float(quality);
+    }
+    write_openexr_parts(stream, { part });
+}
 
-    PixelFormat pixel_format = m_pixel_format;
+void Bitmap::write_openexr_parts(const fs::path &path, const std::vector<EXRPart> &parts,
+                                 uint32_t tile_size) const {
+    ref<FileStream> fs = new FileStream(path, FileStream::ETruncReadWrite);
+    write_openexr_parts(fs, parts, tile_size);
+}
 
-    Properties metadata(m_metadata);
+/**
+ * \brief Assign the channels of a bitmap to the parts of an OpenEXR file
+ *
+ * Returns the index of the part of each field, or -1 for channels that are
+ * not written.
+ */
+static std::vector<int> exr_assign_parts(const Struct *struct_,
+                                         const std::vector<Bitmap::EXRPart> &parts) {
+    if (parts.empty())
+        Throw("write_openexr_parts(): at least one part must be specified!");
+
+    std::unordered_map<std::string, size_t> field_index;
+    for (size_t i = 0; i < struct_->field_count(); ++i)
+        field_index[struct_->operator[](i).name] = i;
+
+    std::vector<int> field_part(struct_->field_count(), -1);
+    int catch_all = -1;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (parts[i].channels.empty()) {
+            if (catch_all != -1)
+                Throw("write_openexr_parts(): only one part may have an empty "
+                      "channel list!");
+            catch_all = (int) i;
+            continue;
+        }
+        for (const std::string &name : parts[i].channels) {
+            auto it = field_index.find(name);
+            if (it == field_index.end())
+                Throw("write_openexr_parts(): unknown channel \"%s\"!", name);
+            size_t index = it->second;
+            if (field_part[index] != -1)
+                Throw("write_openexr_parts(): channel \"%s\" is assigned to "
+                      "multiple parts!", name);
+            field_part[index] = (int) i;
+        }
+    }
+    if (catch_all != -1) {
+        for (int &part : field_part) {
+            if (part == -1)
+                part = catch_all;
+        }
+    }
+    return field_part;
+}
+
+/// Map a bitmap component format onto the corresponding OpenEXR pixel type
+static Imf::PixelType exr_pixel_type(Struct::Type type) {
+    switch (type) {
+        case Struct::Type::Float32: return Imf::FLOAT;
+        case Struct::Type::Float16: return Imf::HALF;
+        case Struct::Type::UInt32: return Imf::UINT;
+        default: Throw("Unexpected field type!");
+    }
+}
+
+/**
+ * \brief Create the headers of the parts of an OpenEXR file storing the
+ * channels of \c bitmap at the given resolution
+ */
+static std::vector<Imf::Header> exr_headers(const Bitmap *bitmap, const Bitmap::Vector2u &size,
+                                            const std::vector<Bitmap::EXRPart> &parts,
+                                            const std::vector<int> &field_part,
+                                            uint32_t tile_size) {
+    using PixelFormat = Bitmap::PixelFormat;
+    using EXRCompression = Bitmap::EXRCompression;
+    using Float = Bitmap::Float;
+    using Vector3f = Bitmap::Vector3f;
+    using Matrix4f = Bitmap::Matrix4f;
+
+    PixelFormat pixel_format = bitmap->pixel_format();
+
+    Properties metadata(bitmap->metadata());
     if (!metadata.has_property("generatedBy"))
         metadata.set_string("generatedBy", "Mitsuba version " MTS_VERSION);
 
     std::vector<std::string> keys = metadata.property_names();
 
-    Imf::Header header(
-        (int) m_size.x(),  // width
-        (int) m_size.y(),  // height,
-        1.f,               // pixelAspectRatio
-        Imath::V2f(0, 0),  // screenWindowCenter,
-        1.f,               // screenWindowWidth
-        Imf::INCREASING_Y, // lineOrder
-        quality <= 0 ? Imf::PIZ_COMPRESSION : Imf::DWAB_COMPRESSION // compression
-    );
+    std::vector<Imf::Header> headers;
+    headers.reserve(parts.size());
 
-    if (quality > 0)
-        Imf::addDwaCompressionLevel(header, float(quality));
+    for (size_t i = 0; i < parts.size(); ++i) {
+        const Bitmap::EXRPart &part = parts[i];
 
-    for (auto it = keys.begin(); it != keys.end(); ++it) {
-        using Type = Properties::Type;
+        headers.emplace_back(
+            (int) size.x(),    // width
+            (int) size.y(),    // height,
+            1.f,               // pixelAspectRatio
+            Imath::V2f(0, 0),  // screenWindowCenter,
+            1.f,               // screenWindowWidth
+            Imf::INCREASING_Y, // lineOrder
+            exr_compression(part.compression) // compression
+        );
+        Imf::Header &header = headers.back();
+
+        if (part.compression == EXRCompression::DWAA ||
+            part.compression == EXRCompression::DWAB)
+            Imf::addDwaCompressionLevel(header, part.compression_level);
+
+        if (!part.name.empty() || parts.size() > 1) {
+            std::string name = part.name.empty() ? tfm::format("part%i", i) : part.name;
+            for (size_t j = 0; j < i; ++j) {
+                if (headers[j].name() == name)
+                    Throw("write_openexr_parts(): duplicate part name \"%s\"!", name);
+            }
+            header.setName(name);
+        }
 
-        Type type = metadata.type(*it);
-        if (*it == "pixelAspectRatio" || *it == "screenWindowWidth" ||
-            *it == "screenWindowCenter")
+        if (tile_size > 0) {
+            header.setTileDescription(
+                Imf::TileDescription(tile_size, tile_size, Imf::ONE_LEVEL));
+            header.setType(Imf::TILEDIMAGE);
+        } else {
+            header.setType(Imf::SCANLINEIMAGE);
+        }
+
+        // Chromaticities are shared between the parts of a file
+        if (pixel_format == PixelFormat::XYZ || pixel_format == PixelFormat::XYZA) {
+            Imf::addChromaticities(header, Imf::Chromaticities(
+                Imath::V2f(1.f, 0.f),
+                Imath::V2f(0.f, 1.f),
+                Imath::V2f(0.f, 0.f),
+                Imath::V2f(1.f / 3.f, 1.f / 3.f)));
+        }
+
+        // Metadata is only stored once (in the first part)
+        if (i > 0)
             continue;
 
-        switch (type) {
-            case Type::String:
-                header.insert(it->c_str(), Imf::StringAttribute(metadata.string(*it)));
-                break;
-            case Type::Long:
-                header.insert(it->c_str(), Imf::IntAttribute(metadata.int_(*it)));
-                break;
-            case Type::Float:
-                if constexpr (is_double_v<Float>)
-                    header.insert(it->c_str(), Imf::DoubleAttribute((double)metadata.float_(*it)));
-                else
-                    header.insert(it->c_str(), Imf::FloatAttribute(metadata.float_(*it)));
-                break;
-            case Type::Array3f: {
-                    Vector3f val = metadata.array3f(*it);
-                    header.insert(it->c_str(), Imf::V3fAttribute(
-                        Imath::V3f((float) val.x(), (float) val.y(), (float) val.z())));
-                }
-                break;
-            case Type::Transform: {
-                    Matrix4f val = metadata.transform(*it).matrix;
-                    header.insert(it->c_str(), Imf::M44fAttribute(Imath::M44f(
-                        (float) val(0, 0), (float) val(0, 1),
-                        (float) val(0, 2), (float) val(0, 3),
-                        (float) val(1, 0), (float) val(1, 1),
-                        (float) val(1, 2), (float) val(1, 3),
-                        (float) val(2, 0), (float) val(2, 1),
-                        (float) val(2, 2), (float) val(2, 3),
-                        (float) val(3, 0), (float) val(3, 1),
-                        (float) val(3, 2), (float) val(3, 3))));
-                }
-                break;
-            default:
-                header.insert(it->c_str(), Imf::StringAttribute(metadata.as_string(*it)));
-                break;
+        for (auto it = keys.begin(); it != keys.end(); ++it) {
+            using Type = Properties::Type;
+
+            Type type = metadata.type(*it);
+            if (*it == "pixelAspectRatio" || *it == "screenWindowWidth" ||
+                *it == "screenWindowCenter" || *it == "type" || *it == "chunkCount" ||
+                (*it == "name" && header.hasName()))
+                continue;
+
+            switch (type) {
+                case Type::String:
+                    header.insert(it->c_str(), Imf::StringAttribute(metadata.string(*it)));
+                    break;
+                case Type::Long:
+                    header.insert(it->c_str(), Imf::IntAttribute(metadata.int_(*it)));
+                    break;
+                case Type::Float:
+                    if constexpr (is_double_v<Float>)
+                        header.insert(it->c_str(), Imf::DoubleAttribute((double)metadata.float_(*it)));
+                    else
+                        header.insert(it->c_str(), Imf::FloatAttribute(metadata.float_(*it)));
+                    break;
+                case Type::Array3f: {
+                        Vector3f val = metadata.array3f(*it);
+                        header.insert(it->c_str(), Imf::V3fAttribute(
+                            Imath::V3f((float) val.x(), (float) val.y(), (float) val.z())));
+                    }
+                    break;
+                case Type::Transform: {
+                        Matrix4f val = metadata.transform(*it).matrix;
+                        header.insert(it->c_str(), Imf::M44fAttribute(Imath::M44f(
+                            (float) val(0, 0), (float) val(0, 1),
+                            (float) val(0, 2), (float) val(0, 3),
+                            (float) val(1, 0), (float) val(1, 1),
+                            (float) val(1, 2), (float) val(1, 3),
+                            (float) val(2, 0), (float) val(2, 1),
+                            (float) val(2, 2), (float) val(2, 3),
+                            (float) val(3, 0), (float) val(3, 1),
+                            (float) val(3, 2), (float) val(3, 3))));
+                    }
+                    break;
+                default:
+                    header.insert(it->c_str(), Imf::StringAttribute(metadata.as_string(*it)));
+                    break;
+            }
         }
     }
 
-    if (pixel_format == PixelFormat::XYZ || pixel_format == PixelFormat::XYZA) {
-        Imf::addChromaticities(header, Imf::Chromaticities(
-            Imath::V2f(1.f, 0.f),
-            Imath::V2f(0.f, 1.f),
-            Imath::V2f(0.f, 0.f),
-            Imath::V2f(1.f / 3.f, 1.f / 3.f)));
+    const Struct *struct_ = bitmap->struct_();
+    for (size_t i = 0; i < struct_->field_count(); ++i) {
+        const Struct::Field &field = struct_->operator[](i);
+        if (field_part[i] != -1)
+            headers[field_part[i]].channels().insert(
+                field.name, Imf::Channel(exr_pixel_type(field.type)));
     }
 
-    size_t pixel_stride = m_struct->size(),
-           row_stride = pixel_stride * m_size.x();
+    for (const Imf::Header &header : headers) {
+        if (header.channels().begin() == header.channels().end())
+            Throw("write_openexr_parts(): part \"%s\" does not contain any channels!",
+                  header.hasName() ? header.name() : std::string("<unnamed>"));
+    }
 
-    Imf::ChannelList &channels = header.channels();
-    Imf::FrameBuffer framebuffer;
-    const uint8_t *ptr = uint8_data();
-    for (auto field : *m_struct) {
-        Imf::PixelType comp_type;
-        switch (field.type) {
-            case Struct::Type::Float32: comp_type = Imf::FLOAT; break;
-            case Struct::Type::Float16: comp_type = Imf::HALF; break;
-            case Struct::Type::UInt32: comp_type = Imf::UINT; break;
-            default: Throw("Unexpected field type!");
-        }
+    return headers;
+}
 
-        Imf::Slice slice(comp_type, (char *) (ptr + field.offset), pixel_stride, row_stride);
-        channels.insert(field.name, Imf::Channel(comp_type));
-        framebuffer.insert(field.name, slice);
+/**
+ * \brief Create frame buffers that reference the channels of \c bitmap
+ *
+ * The first row of the bitmap corresponds to row \c y_offset of the file.
+ */
+static std::vector<Imf::FrameBuffer> exr_framebuffers(const Bitmap *bitmap, size_t part_count,
+                                                      const std::vector<int> &field_part,
+                                                      uint32_t y_offset) {
+    const Struct *struct_ = bitmap->struct_();
+    size_t pixel_stride = struct_->size(),
+           row_stride = pixel_stride * bitmap->width();
+
+    std::vector<Imf::FrameBuffer> framebuffers(part_count);
+    const uint8_t *ptr = bitmap->uint8_data() - y_offset * row_stride;
+    for (size_t i = 0; i < struct_->field_count(); ++i) {
+        const Struct::Field &field = struct_->operator[](i);
+        if (field_part[i] == -1)
+            continue;
+
+        Imf::Slice slice(exr_pixel_type(field.type), (char *) (ptr + field.offset),
+                         pixel_stride, row_stride);
+        framebuffers[field_part[i]].insert(field.name, slice);
     }
+    return framebuffers;
+}
+
+void Bitmap::write_openexr_parts(Stream *stream, const std::vector<EXRPart> &parts,
+                                 uint32_t tile_size) const {
+    if (Imf::globalThreadCount() == 0)
+        Imf::setGlobalThreadCount(std::min(8, util::core_count()));
+
+    std::vector<int> field_part = exr_assign_parts(m_struct.get(), parts);
+    std::vector<Imf::Header> headers =
+        exr_headers(this, m_size, parts, field_part, tile_size);
+    std::vector<Imf::FrameBuffer> framebuffers =
+        exr_framebuffers(this, parts.size(), field_part, 0);
 
     EXROStream ostr(stream);
-    Imf::OutputFile file(ostr, header);
-    file.setFrameBuffer(framebuffer);
-    file.writePixels((int) m_size.y());
+    Imf::MultiPartOutputFile file(ostr, headers.data(), (int) headers.size(),
+                                  false, Imf::globalThreadCount());
+
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (tile_size > 0) {
+            Imf::TiledOutputPart part(file, (int) i);
+            part.setFrameBuffer(framebuffers[i]);
+            part.writeTiles(0, part.numXTiles() - 1, 0, part.numYTiles() - 1);
+        } else {
+            Imf::OutputPart part(file, (int) i);
+            part.setFrameBuffer(framebuffers[i]);
+            part.writePixels((int) m_size.y());
+        }
+    }
+}
+
+struct EXRScanlineWriter::EXRScanlineWriterPrivate {
+    EXROStream ostr;
+    std::vector<Bitmap::EXRPart> parts;
+    std::vector<int> field_part;
+    std::unique_ptr<Imf::MultiPartOutputFile> file;
+
+    EXRScanlineWriterPrivate(Stream *stream) : ostr(stream) { }
+};
+
+EXRScanlineWriter::EXRScanlineWriter(Stream *stream, const Bitmap *format, uint32_t height,
+                                     const std::vector<Bitmap::EXRPart> &parts)
+    : d(new EXRScanlineWriterPrivate(stream)), m_stream(stream),
+      m_struct(new Struct(*format->struct_())), m_width(format->width()),
+      m_height(height), m_rows_written(0) {
+    if (Imf::globalThreadCount() == 0)
+        Imf::setGlobalThreadCount(std::min(8, util::core_count()));
+
+    d->parts = parts;
+    d->field_part = exr_assign_parts(m_struct.get(), parts);
+    std::vector<Imf::Header> headers =
+        exr_headers(format, Bitmap::Vector2u(m_width, m_height), parts, d->field_part, 0);
+
+    d->file.reset(new Imf::MultiPartOutputFile(d->ostr, headers.data(), (int) headers.size(),
+                                               false, Imf::globalThreadCount()));
+}
+
+EXRScanlineWriter::~EXRScanlineWriter() {
+    if (m_rows_written != m_height)
+        Log(Warn, "EXRScanlineWriter: closing the file after %i of %i rows, "
+            "the remaining rows are missing!", m_rows_written, m_height);
+}
+
+void EXRScanlineWriter::write(const Bitmap *strip) {
+    if (strip->width() != m_width || *strip->struct_() != *m_struct)
+        Throw("EXRScanlineWriter::write(): the strip does not match the layout "
+              "of the file!");
+    if (m_rows_written + strip->height() > m_height)
+        Throw("EXRScanlineWriter::write(): attempted to write %i rows, but only "
+              "%i remain!", strip->height(), m_height - m_rows_written);
+
+    std::vector<Imf::FrameBuffer> framebuffers =
+        exr_framebuffers(strip, d->parts.size(), d->field_part, m_rows_written);
+
+    // The parts are stored as separate chunks, so they may be written in turn
+    for (size_t i = 0; i < d->parts.size(); ++i) {
+        Imf::OutputPart part(*d->file, (int) i);
+        part.setFrameBuffer(framebuffers[i]);
+        part.writePixels((int) strip->height());
+    }
+
+    m_rows_written += (uint32_t) strip->height();
+}
+
+std::string EXRScanlineWriter::to_string() const {
+    std::ostringstream oss;
+    oss << "EXRScanlineWriter[" << std::endl
+        << "  size = [" << m_width << ", " << m_height << "]," << std::endl
+        << "  parts = " << d->parts.size() << "," << std::endl
+        << "  rows_written = " << m_rows_written << std::endl
+        << "]";
+    return oss.str();
 }
 
 // -----------------------------------------------------------------------------
@@ -2479,6 +2759,23 @@ std::ostream &operator<<(std::ostream &os, Bitmap::AlphaTransform value) {
     return os;
 }
 
+std::ostream &operator<<(std::ostream &os, Bitmap::EXRCompression value) {
+    switch (value) {
+        case Bitmap::EXRCompression::None:  os << "none";  break;
+        case Bitmap::EXRCompression::RLE:   os << "rle";   break;
+        case Bitmap::EXRCompression::ZIPS:  os << "zips";  break;
+        case Bitmap::EXRCompression::ZIP:   os << "zip";   break;
+        case Bitmap::EXRCompression::PIZ:   os << "piz";   break;
+        case Bitmap::EXRCompression::PXR24: os << "pxr24"; break;
+        case Bitmap::EXRCompression::B44:   os << "b44";   break;
+        case Bitmap::EXRCompression::B44A:  os << "b44a";  break;
+        case Bitmap::EXRCompression::DWAA:  os << "dwaa";  break;
+        case Bitmap::EXRCompression::DWAB:  os << "dwab";  break;
+        default: Throw("Unknown OpenEXR compression scheme!");
+    }
+    return os;
+}
+
 void Bitmap::static_initialization() {
     // No-op
 }
@@ -2488,5 +2785,6 @@ void Bitmap::static_shutdown() {
 }
 
 MTS_IMPLEMENT_CLASS(Bitmap, Object)
+MTS_IMPLEMENT_CLASS(EXRScanlineWriter, Object)
 
 NAMESPACE_END(mitsuba)
@@ -0,0 +1,370 @@
+#include <mitsuba/core/bundle.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/mstream.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/* Bundle file layout (native byte order):
+
+   - Header: magic string, version, offset and size of the directory.
+     The header is padded to MTS_BUNDLE_ALIGNMENT bytes.
+   - Data blocks, each starting at a multiple of MTS_BUNDLE_ALIGNMENT.
+   - Directory: variant, root object, data block table, and the list of
+     objects with their serialized properties. */
+
+static const char bundle_magic[8] = { 'M', 'T', 'S', 'B', 'N', 'D', 'L', '\0' };
+static const uint32_t bundle_version = 1;
+
+struct BundleHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t directory_offset;
+    uint64_t directory_size;
+};
+
+static void write_properties(Stream *stream, const Properties &props,
+                             SceneBundleWriter *writer) {
+    std::vector<std::string> names = props.property_names();
+    stream->write(props.plugin_name());
+    stream->write(props.id());
+    stream->write((uint32_t) names.size());
+
+    for (const std::string &name : names) {
+        Properties::Type type = props.type(name);
+        stream->write(name);
+        stream->write((uint8_t) type);
+
+        switch (type) {
+            case Properties::Type::Bool:
+                stream->write((uint8_t) props.bool_(name));
+                break;
+
+            case Properties::Type::Long:
+                stream->write(props.long_(name));
+                break;
+
+            case Properties::Type::Float:
+                stream->write(props.float_(name));
+                break;
+
+            case Properties::Type::Array3f:
+                stream->write_array(props.array3f(name).data(), 3);
+                break;
+
+            case Properties::Type::Color:
+                stream->write_array(props.color(name).data(), 3);
+                break;
+
+            case Properties::Type::String:
+                stream->write(props.string(name));
+                break;
+
+            case Properties::Type::NamedReference:
+                stream->write((const std::string &) props.named_reference(name));
+                break;
+
+            case Properties::Type::Transform: {
+                    const Properties::Transform4f &trafo = props.transform(name);
+                    for (size_t i = 0; i < 4; ++i)
+                        for (size_t j = 0; j < 4; ++j)
+                            stream->write(trafo.matrix(i, j));
+                }
+                break;
+
+            case Properties::Type::Pointer: {
+                    if (!props.has_property("size"))
+                        Throw("SceneBundleWriter: cannot serialize pointer \"%s\" of "
+                              "\"%s\" (unknown array size)!", name, props.id());
+                    size_t size = (size_t) props.long_("size") * sizeof(Properties::Float);
+                    stream->write(writer->add_blob(props.pointer(name), size));
+                }
+                break;
+
+            default:
+                Throw("SceneBundleWriter: property \"%s\" of \"%s\" has a type "
+                      "that cannot be stored in a scene bundle!", name, props.id());
+        }
+    }
+}
+
+static Properties read_properties(Stream *stream, const SceneBundle *bundle) {
+    std::string plugin_name, id;
+    uint32_t count;
+    stream->read(plugin_name);
+    stream->read(id);
+    stream->read(count);
+
+    Properties props(plugin_name);
+    props.set_id(id);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        uint8_t type;
+        stream->read(name);
+        stream->read(type);
+
+        switch ((Properties::Type) type) {
+            case Properties::Type::Bool: {
+                    uint8_t value;
+                    stream->read(value);
+                    props.set_bool(name, value != 0);
+                }
+                break;
+
+            case Properties::Type::Long: {
+                    int64_t value;
+                    stream->read(value);
+                    props.set_long(name, value);
+                }
+                break;
+
+            case Properties::Type::Float: {
+                    Properties::Float value;
+                    stream->read(value);
+                    props.set_float(name, value);
+                }
+                break;
+
+            case Properties::Type::Array3f: {
+                    Properties::Array3f value;
+                    stream->read_array(value.data(), 3);
+                    props.set_array3f(name, value);
+                }
+                break;
+
+            case Properties::Type::Color: {
+                    Properties::Color3f value;
+                    stream->read_array(value.data(), 3);
+                    props.set_color(name, value);
+                }
+                break;
+
+            case Properties::Type::String: {
+                    std::string value;
+                    stream->read(value);
+                    props.set_string(name, value);
+                }
+                break;
+
+            case Properties::Type::NamedReference: {
+                    std::string value;
+                    stream->read(value);
+                    props.set_named_reference(name, value);
+                }
+                break;
+
+            case Properties::Type::Transform: {
+                    Properties::Transform4f::Matrix matrix;
+                    for (size_t k = 0; k < 4; ++k)
+                        for (size_t j = 0; j < 4; ++j)
+                            stream->read(matrix(k, j));
+                    props.set_transform(name, Properties::Transform4f(matrix));
+                }
+                break;
+
+            case Properties::Type::Pointer: {
+                    uint32_t index;
+                    stream->read(index);
+                    props.set_pointer(name, bundle->blob(index));
+                }
+                break;
+
+            default:
+                Throw("SceneBundle: encountered an invalid property type (%i)!", (int) type);
+        }
+    }
+
+    return props;
+}
+
+// =============================================================
+//! SceneBundle
+// =============================================================
+
+SceneBundle::SceneBundle(const fs::path &filename) {
+    /* Mapped data may be modified by plugins (e.g. when recomputing vertex
+       normals), which must not affect the file on disk */
+    m_mmap = MemoryMappedFile::map_private(filename);
+
+    const uint8_t *data = (const uint8_t *) m_mmap->data();
+    BundleHeader header;
+    if (m_mmap->size() < sizeof(BundleHeader))
+        Throw("\"%s\": not a scene bundle (file too small)!", filename.string());
+    memcpy(&header, data, sizeof(BundleHeader));
+
+    if (memcmp(header.magic, bundle_magic, sizeof(bundle_magic)) != 0)
+        Throw("\"%s\": not a scene bundle (invalid header)!", filename.string());
+    if (header.version != bundle_version)
+        Throw("\"%s\": unsupported scene bundle version %i (expected %i)!",
+              filename.string(), header.version, bundle_version);
+    if (header.directory_offset + header.directory_size > m_mmap->size())
+        Throw("\"%s\": scene bundle is truncated!", filename.string());
+
+    ref<MemoryStream> stream = new MemoryStream(
+        (uint8_t *) m_mmap->data() + header.directory_offset,
+        header.directory_size);
+
+    stream->read(m_variant);
+    stream->read(m_root);
+
+    uint64_t blob_count;
+    stream->read(blob_count);
+    m_blobs.resize(blob_count);
+    for (auto &[offset, size] : m_blobs) {
+        stream->read(offset);
+        stream->read(size);
+        if (offset + size > m_mmap->size())
+            Throw("\"%s\": scene bundle is truncated!", filename.string());
+    }
+
+    uint64_t node_count;
+    stream->read(node_count);
+    m_nodes.resize(node_count);
+    for (Node &node : m_nodes) {
+        uint8_t uses_blobs;
+        stream->read(node.id);
+        stream->read(node.class_name);
+        stream->read(node.alias);
+        stream->read(uses_blobs);
+        node.uses_blobs = uses_blobs != 0;
+        node.props = read_properties(stream, this);
+    }
+
+    Log(Debug, "Mapped scene bundle \"%s\" (%i objects, %i data blocks, %s)",
+        filename.filename().string(), m_nodes.size(), m_blobs.size(),
+        util::mem_string(m_mmap->size()));
+}
+
+SceneBundle::~SceneBundle() { }
+
+void *SceneBundle::blob(size_t index) const {
+    if (index >= m_blobs.size())
+        Throw("SceneBundle: data block index %i is out of bounds!", index);
+    return (uint8_t *) m_mmap->data() + m_blobs[index].first;
+}
+
+size_t SceneBundle::blob_size(size_t index) const {
+    if (index >= m_blobs.size())
+        Throw("SceneBundle: data block index %i is out of bounds!", index);
+    return (size_t) m_blobs[index].second;
+}
+
+std::string SceneBundle::to_string() const {
+    std::ostringstream oss;
+    oss << "SceneBundle[" << std::endl
+        << "  filename = \"" << filename().string() << "\"," << std::endl
+        << "  variant = \"" << m_variant << "\"," << std::endl
+        << "  root = \"" << m_root << "\"," << std::endl
+        << "  nodes = " << m_nodes.size() << "," << std::endl
+        << "  blobs = " << m_blobs.size() << "," << std::endl
+        << "  size = " << util::mem_string(m_mmap->size()) << std::endl
+        << "]";
+    return oss.str();
+}
+
+// =============================================================
+//! SceneBundleWriter
+// =============================================================
+
+/// Pad the stream with zeros up to the next multiple of MTS_BUNDLE_ALIGNMENT
+static void bundle_pad(Stream *stream) {
+    static const uint8_t zeros[MTS_BUNDLE_ALIGNMENT] = { };
+    size_t remainder = stream->tell() % MTS_BUNDLE_ALIGNMENT;
+    if (remainder != 0)
+        stream->write(zeros, MTS_BUNDLE_ALIGNMENT - remainder);
+}
+
+SceneBundleWriter::SceneBundleWriter(const fs::path &filename, const std::string &variant)
+    : m_variant(variant) {
+    m_stream = new FileStream(filename, FileStream::ETruncReadWrite);
+
+    // Reserve space for the header, which is written by close()
+    BundleHeader header { };
+    m_stream->write(&header, sizeof(BundleHeader));
+    bundle_pad(m_stream);
+}
+
+SceneBundleWriter::~SceneBundleWriter() {
+    if (!m_closed)
+        Log(Warn, "SceneBundleWriter: \"%s\" was never closed and is incomplete!",
+            m_stream->path().string());
+}
+
+uint32_t SceneBundleWriter::add_blob(const void *data, size_t size) {
+    if (m_closed)
+        Throw("SceneBundleWriter::add_blob(): the bundle was already closed!");
+
+    uint64_t offset = (uint64_t) m_stream->tell();
+    m_stream->write(data, size);
+    bundle_pad(m_stream);
+    m_blobs.emplace_back(offset, (uint64_t) size);
+    return (uint32_t) (m_blobs.size() - 1);
+}
+
+void SceneBundleWriter::add_node(const Node &node) {
+    if (m_closed)
+        Throw("SceneBundleWriter::add_node(): the bundle was already closed!");
+    m_nodes.push_back(node);
+}
+
+void SceneBundleWriter::close(const std::string &root) {
+    if (m_closed)
+        Throw("SceneBundleWriter::close(): the bundle was already closed!");
+
+    /* Properties are serialized into a separate stream since
+       pointer properties append further data blocks */
+    ref<MemoryStream> nodes = new MemoryStream();
+    nodes->write((uint64_t) m_nodes.size());
+    for (const Node &node : m_nodes) {
+        nodes->write(node.id);
+        nodes->write(node.class_name);
+        nodes->write(node.alias);
+        nodes->write((uint8_t) node.uses_blobs);
+        write_properties(nodes, node.props, this);
+    }
+
+    ref<MemoryStream> directory = new MemoryStream();
+    directory->write(m_variant);
+    directory->write(root);
+    directory->write((uint64_t) m_blobs.size());
+    for (const auto &[offset, size] : m_blobs) {
+        directory->write(offset);
+        directory->write(size);
+    }
+    directory->write(nodes->raw_buffer(), nodes->size());
+
+    BundleHeader header { };
+    memcpy(header.magic, bundle_magic, sizeof(bundle_magic));
+    header.version = bundle_version;
+    header.directory_offset = (uint64_t) m_stream->tell();
+    header.directory_size = (uint64_t) directory->size();
+
+    m_stream->write(directory->raw_buffer(), directory->size());
+    m_stream->seek(0);
+    m_stream->write(&header, sizeof(BundleHeader));
+    m_stream->close();
+    m_closed = true;
+
+    Log(Info, "Wrote scene bundle \"%s\" (%i objects, %i data blocks, %s)",
+        m_stream->path().filename().string(), m_nodes.size(), m_blobs.size(),
+        util::mem_string(header.directory_offset + header.directory_size));
+}
+
+std::string SceneBundleWriter::to_string() const {
+    std::ostringstream oss;
+    oss << "SceneBundleWriter[" << std::endl
+        << "  filename = \"" << m_stream->path().string() << "\"," << std::endl
+        << "  variant = \"" << m_variant << "\"," << std::endl
+        << "  nodes = " << m_nodes.size() << "," << std::endl
+        << "  blobs = " << m_blobs.size() << "," << std::endl
+        << "  closed = " << m_closed << std::endl
+        << "]";
+    return oss.str();
+}
+
+MTS_IMPLEMENT_CLASS(SceneBundle, Object)
+MTS_IMPLEMENT_CLASS(SceneBundleWriter, Object)
+NAMESPACE_END(mitsuba)
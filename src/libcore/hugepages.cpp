@@ -0,0 +1,269 @@
+#include <mitsuba/core/hugepages.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/util.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#if defined(__LINUX__)
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Alignment of heap allocations (cache line size)
+static constexpr size_t HeapAlignment = 64;
+
+/// -1: not yet initialized from the environment, 0: disabled, 1: enabled
+static std::atomic<int> huge_page_mode { -1 };
+
+namespace {
+    struct Allocation {
+        void *base;           // Start of the underlying mapping
+        size_t map_size;      // Size of the underlying mapping
+        size_t size;          // Requested size
+        HugePageBuffer::Backing backing;
+    };
+
+    /// Live allocations, indexed by the pointer returned to the caller
+    struct AllocationTable {
+        std::mutex mutex;
+        std::map<uintptr_t, Allocation> entries;
+    };
+
+    AllocationTable &allocation_table() {
+        static AllocationTable table;
+        return table;
+    }
+
+#if defined(__LINUX__)
+    size_t round_up(size_t size, size_t alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    /// Try to allocate explicitly reserved huge pages (returns \c nullptr on failure)
+    void *map_hugetlb(size_t map_size) {
+#  if defined(MAP_HUGETLB)
+        void *ptr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+#  else
+        (void) map_size;
+        return nullptr;
+#  endif
+    }
+
+    /// Allocate a huge page aligned region and mark it for transparent huge pages
+    void *map_transparent(size_t map_size) {
+        // Over-allocate, then trim the region to a huge page boundary
+        size_t padded_size = map_size + HugePageBuffer::HugePageSize;
+        void *ptr = mmap(nullptr, padded_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            return nullptr;
+
+        uintptr_t start = (uintptr_t) ptr,
+                  aligned = round_up(start, HugePageBuffer::HugePageSize),
+                  end = start + padded_size;
+
+        if (aligned > start)
+            munmap(ptr, aligned - start);
+        if (end > aligned + map_size)
+            munmap((void *) (aligned + map_size), end - (aligned + map_size));
+
+#  if defined(MADV_HUGEPAGE)
+        if (madvise((void *) aligned, map_size, MADV_HUGEPAGE) != 0)
+            Log(Debug, "HugePageBuffer: madvise(MADV_HUGEPAGE) failed: %s",
+                strerror(errno));
+#  endif
+        return (void *) aligned;
+    }
+#endif
+} // namespace
+
+bool HugePageBuffer::enabled() {
+    int mode = huge_page_mode.load(std::memory_order_relaxed);
+    if (unlikely(mode == -1)) {
+        const char *env = std::getenv("MTS_HUGEPAGES");
+        mode = (env && std::string(env) == "1") ? 1 : 0;
+        huge_page_mode.store(mode, std::memory_order_relaxed);
+    }
+    return mode == 1;
+}
+
+void HugePageBuffer::set_enabled(bool enabled) {
+    huge_page_mode.store(enabled ? 1 : 0, std::memory_order_relaxed);
+}
+
+void *HugePageBuffer::alloc(size_t size) {
+    Allocation alloc { nullptr, 0, size, Backing::Heap };
+
+#if defined(__LINUX__)
+    if (enabled() && size >= HugePageSize) {
+        size_t map_size = round_up(size, HugePageSize);
+        if (void *ptr = map_hugetlb(map_size); ptr) {
+            alloc = { ptr, map_size, size, Backing::HugeTLB };
+        } else if (void *ptr2 = map_transparent(map_size); ptr2) {
+            alloc = { ptr2, map_size, size, Backing::Transparent };
+        } else {
+            Log(Warn, "HugePageBuffer: could not map %s of memory, "
+                "falling back to the heap.", util::mem_string(size));
+        }
+    }
+#endif
+
+    if (!alloc.base) {
+        alloc.base = ::operator new(std::max(size, (size_t) 1),
+                                    std::align_val_t(HeapAlignment));
+        alloc.map_size = size;
+    }
+
+    AllocationTable &table = allocation_table();
+    std::lock_guard<std::mutex> guard(table.mutex);
+    table.entries[(uintptr_t) alloc.base] = alloc;
+    return alloc.base;
+}
+
+void HugePageBuffer::free(void *ptr) {
+    if (!ptr)
+        return;
+
+    Allocation alloc;
+    {
+        AllocationTable &table = allocation_table();
+        std::lock_guard<std::mutex> guard(table.mutex);
+        auto it = table.entries.find((uintptr_t) ptr);
+        if (it == table.entries.end())
+            Throw("HugePageBuffer::free(): unknown pointer %p!", ptr);
+        alloc = it->second;
+        table.entries.erase(it);
+    }
+
+    if (alloc.backing == Backing::Heap) {
+        ::operator delete(alloc.base, std::align_val_t(HeapAlignment));
+    } else {
+#if defined(__LINUX__)
+        if (munmap(alloc.base, alloc.map_size) != 0)
+            Log(Warn, "HugePageBuffer::free(): munmap() failed: %s", strerror(errno));
+#endif
+    }
+}
+
+HugePageBuffer::Backing HugePageBuffer::backing(const void *ptr) {
+    AllocationTable &table = allocation_table();
+    std::lock_guard<std::mutex> guard(table.mutex);
+    auto it = table.entries.find((uintptr_t) ptr);
+    if (it == table.entries.end())
+        Throw("HugePageBuffer::backing(): unknown pointer %p!", ptr);
+    return it->second.backing;
+}
+
+ref<HugePageBuffer> HugePageBuffer::copy_large(const void *ptr, size_t size) {
+    if (!enabled() || size < HugePageSize)
+        return nullptr;
+    ref<HugePageBuffer> buffer = new HugePageBuffer(size);
+    std::memcpy(buffer->data(), ptr, size);
+    return buffer;
+}
+
+HugePageBuffer::Usage HugePageBuffer::usage() {
+    Usage result;
+    std::vector<std::pair<uintptr_t, uintptr_t>> transparent;
+
+    {
+        AllocationTable &table = allocation_table();
+        std::lock_guard<std::mutex> guard(table.mutex);
+        for (const auto &[key, alloc] : table.entries) {
+            switch (alloc.backing) {
+                case Backing::Heap: result.heap += alloc.size; break;
+                case Backing::HugeTLB: result.hugetlb += alloc.size; break;
+                case Backing::Transparent:
+                    result.transparent += alloc.size;
+                    transparent.emplace_back(key, key + alloc.map_size);
+                    break;
+            }
+        }
+    }
+
+#if defined(__LINUX__)
+    if (transparent.empty())
+        return result;
+
+    /* The kernel decides whether to back a region by huge pages. Find the
+       mappings that overlap the allocations and sum up their share of the
+       'AnonHugePages' entries (adjacent mappings may have been merged) */
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    size_t overlap = 0;
+    while (std::getline(smaps, line)) {
+        unsigned long long start, end;
+        if (std::sscanf(line.c_str(), "%llx-%llx ", &start, &end) == 2 &&
+            line.find(':') > line.find(' ')) {
+            overlap = 0;
+            for (const auto &[a_start, a_end] : transparent) {
+                uintptr_t lo = std::max((uintptr_t) start, a_start),
+                          hi = std::min((uintptr_t) end, a_end);
+                if (hi > lo)
+                    overlap += hi - lo;
+            }
+        } else if (overlap > 0 && string::starts_with(line, "AnonHugePages:")) {
+            size_t kb = 0;
+            std::sscanf(line.c_str() + 14, "%zu", &kb);
+            result.transparent_resident += std::min(kb * 1024, overlap);
+            overlap = 0;
+        }
+    }
+    result.transparent_resident = std::min(result.transparent_resident, result.transparent);
+#endif
+
+    return result;
+}
+
+std::string HugePageBuffer::usage_report() {
+    Usage u = usage();
+    return tfm::format("%s in explicit huge pages, %s in transparent huge pages "
+                       "(%s resident), %s on the heap",
+                       util::mem_string(u.hugetlb), util::mem_string(u.transparent),
+                       util::mem_string(u.transparent_resident), util::mem_string(u.heap));
+}
+
+HugePageBuffer::HugePageBuffer(size_t size)
+    : m_data(alloc(size)), m_size(size) { }
+
+HugePageBuffer::~HugePageBuffer() {
+    free(m_data);
+}
+
+HugePageBuffer::Backing HugePageBuffer::backing() const {
+    return backing(m_data);
+}
+
+std::string HugePageBuffer::to_string() const {
+    const char *backing_str = "heap";
+    switch (backing()) {
+        case Backing::Transparent: backing_str = "transparent"; break;
+        case Backing::HugeTLB: backing_str = "hugetlb"; break;
+        default: break;
+    }
+
+    std::ostringstream oss;
+    oss << "HugePageBuffer[" << std::endl
+        << "  size = " << util::mem_string(m_size) << "," << std::endl
+        << "  backing = " << backing_str << std::endl
+        << "]";
+    return oss.str();
+}
+
+MTS_IMPLEMENT_CLASS(HugePageBuffer, Object)
+NAMESPACE_END(mitsuba)
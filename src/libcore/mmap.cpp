@@ -1,5 +1,6 @@
 #include <mitsuba/core/mmap.h>
 #include <mitsuba/core/util.h>
+#include <algorithm>
 
 #if defined(__LINUX__) || defined(__OSX__)
 # include <sys/mman.h>
@@ -20,10 +21,12 @@ struct MemoryMappedFile::MemoryMappedFilePrivate {
     size_t size;
     void *data;
     bool can_write;
+    bool copy_on_write;
     bool temp;
 
     MemoryMappedFilePrivate(const fs::path &f = "", size_t s = 0)
-        : filename(f), size(s), data(nullptr), can_write(false), temp(false) { }
+        : filename(f), size(s), data(nullptr), can_write(false),
+          copy_on_write(false), temp(false) { }
 
     void create() {
         #if defined(__LINUX__) || defined(__OSX__)
@@ -138,11 +141,13 @@ struct MemoryMappedFile::MemoryMappedFilePrivate {
         size = (size_t) fs::file_size(filename);
 
         #if defined(__LINUX__) || defined(__OSX__)
-            int fd = open(filename.string().c_str(), can_write ? O_RDWR : O_RDONLY);
+            bool write_back = can_write && !copy_on_write;
+            int fd = open(filename.string().c_str(), write_back ? O_RDWR : O_RDONLY);
             if (fd == -1)
                 Throw("Could not open \"%s\"!", filename.string());
 
-            data = mmap(nullptr, size, PROT_READ | (can_write ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+            data = mmap(nullptr, size, PROT_READ | (can_write ? PROT_WRITE : 0),
+                        copy_on_write ? MAP_PRIVATE : MAP_SHARED, fd, 0);
             if (data == MAP_FAILED) {
                 data = nullptr;
                 Throw("Could not map \"%s\" to memory!", filename.string());
@@ -151,7 +156,8 @@ struct MemoryMappedFile::MemoryMappedFilePrivate {
             if (close(fd) != 0)
                 Throw("close(): unable to close file!");
         #elif defined(__WINDOWS__)
-            file = CreateFileW(filename.native().c_str(), GENERIC_READ | (can_write ? GENERIC_WRITE : 0),
+            bool write_back = can_write && !copy_on_write;
+            file = CreateFileW(filename.native().c_str(), GENERIC_READ | (write_back ? GENERIC_WRITE : 0),
                 FILE_SHARE_WRITE|FILE_SHARE_READ, nullptr, OPEN_EXISTING,
                 FILE_ATTRIBUTE_NORMAL, nullptr);
 
@@ -159,12 +165,16 @@ struct MemoryMappedFile::MemoryMappedFilePrivate {
                 Throw("Could not open \"%s\": %s", filename.string(),
                     util::last_error());
 
-            file_mapping = CreateFileMappingW(file, nullptr, can_write ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+            DWORD protect = copy_on_write ? PAGE_WRITECOPY
+                                          : (can_write ? PAGE_READWRITE : PAGE_READONLY);
+            file_mapping = CreateFileMappingW(file, nullptr, protect, 0, 0, nullptr);
             if (file_mapping == nullptr)
                 Throw("CreateFileMapping: Could not map \"%s\" to memory: %s",
                     filename.string(), util::last_error());
 
-            data = (void *) MapViewOfFile(file_mapping, can_write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+            DWORD access = copy_on_write ? FILE_MAP_COPY
+                                         : (can_write ? FILE_MAP_WRITE : FILE_MAP_READ);
+            data = (void *) MapViewOfFile(file_mapping, access, 0, 0, 0);
             if (data == nullptr)
                 Throw("MapViewOfFile: Could not map \"%s\" to memory: %s",
                     filename.string(), util::last_error());
@@ -265,6 +275,23 @@ bool MemoryMappedFile::can_write() const {
     return d->can_write;
 }
 
+void MemoryMappedFile::prefetch(size_t offset, size_t size) const {
+    if (!d->data || offset >= d->size)
+        return;
+    size = std::min(size, d->size - offset);
+
+    #if defined(__LINUX__) || defined(__OSX__)
+        // madvise() requires a page-aligned address
+        size_t page_size = (size_t) sysconf(_SC_PAGESIZE),
+               start     = offset - offset % page_size;
+        if (madvise((uint8_t *) d->data + start, size + (offset - start), MADV_WILLNEED) != 0)
+            Log(Debug, "madvise(): unable to prefetch \"%s\": %s",
+                d->filename.string(), strerror(errno));
+    #else
+        ENOKI_MARK_USED(size);
+    #endif
+}
+
 const fs::path &MemoryMappedFile::filename() const {
     return d->filename;
 }
@@ -276,6 +303,17 @@ ref<MemoryMappedFile> MemoryMappedFile::create_temporary(size_t size) {
     return result;
 }
 
+ref<MemoryMappedFile> MemoryMappedFile::map_private(const fs::path &filename) {
+    ref<MemoryMappedFile> result = new MemoryMappedFile();
+    result->d->filename = filename;
+    result->d->can_write = true;
+    result->d->copy_on_write = true;
+    result->d->map();
+    Log(Trace, "Mapped \"%s\" into memory (copy-on-write, %s)..",
+        filename.filename().string(), util::mem_string(result->d->size));
+    return result;
+}
+
 std::string MemoryMappedFile::to_string() const {
     std::ostringstream oss;
     oss << "MemoryMappedFile[" << std::endl
@@ -0,0 +1,212 @@
+#include <mitsuba/core/numa.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/util.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#if defined(__LINUX__)
+#  if !defined(_GNU_SOURCE)
+#    define _GNU_SOURCE
+#  endif
+#  include <linux/mempolicy.h>
+#  include <pthread.h>
+#  include <sched.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+NAMESPACE_BEGIN(numa)
+
+/// -1: not yet initialized from the environment, 0: disabled, 1: enabled
+static std::atomic<int> numa_mode { -1 };
+
+/// Node that the calling thread was pinned to (-1 if none)
+static thread_local int pinned_node = -1;
+
+namespace {
+    struct Topology {
+        std::vector<std::vector<int>> nodes;  // Processors of every node
+        std::vector<int> node_ids;            // Kernel identifiers of the nodes
+        std::vector<int> cpu_node;            // Processor -> node index
+        int cpu_count = 0;
+
+        Topology() {
+#if defined(__LINUX__)
+            for (int id : parse_list(read_line("/sys/devices/system/node/online"))) {
+                std::vector<int> cpus = parse_list(
+                    read_line(tfm::format("/sys/devices/system/node/node%i/cpulist", id)));
+                if (cpus.empty())
+                    continue; // Memory-only node
+                nodes.push_back(cpus);
+                node_ids.push_back(id);
+            }
+#endif
+            if (nodes.empty()) {
+                std::vector<int> cpus;
+                for (int i = 0; i < util::core_count(); ++i)
+                    cpus.push_back(i);
+                nodes = { cpus };
+                node_ids = { 0 };
+            }
+
+            for (const std::vector<int> &cpus : nodes)
+                for (int cpu : cpus)
+                    cpu_count = std::max(cpu_count, cpu + 1);
+
+            cpu_node.resize(cpu_count, 0);
+            for (size_t i = 0; i < nodes.size(); ++i)
+                for (int cpu : nodes[i])
+                    cpu_node[cpu] = (int) i;
+        }
+
+        static std::string read_line(const std::string &filename) {
+            std::ifstream is(filename);
+            std::string line;
+            std::getline(is, line);
+            return line;
+        }
+
+        /// Parse a list of the form "0-3,8,10-11"
+        static std::vector<int> parse_list(const std::string &str) {
+            std::vector<int> result;
+            for (const std::string &item : string::tokenize(str, ",")) {
+                std::vector<std::string> range = string::tokenize(item, "-");
+                try {
+                    int first = std::stoi(range[0]),
+                        last  = range.size() > 1 ? std::stoi(range[1]) : first;
+                    for (int i = first; i <= last; ++i)
+                        result.push_back(i);
+                } catch (const std::exception &) {
+                    return { };
+                }
+            }
+            return result;
+        }
+    };
+
+    const Topology &topology() {
+        static Topology topology;
+        return topology;
+    }
+} // namespace
+
+bool enabled() {
+    int mode = numa_mode.load(std::memory_order_relaxed);
+    if (unlikely(mode == -1)) {
+        const char *env = std::getenv("MTS_NUMA");
+        mode = (env && std::string(env) == "1") ? 1 : 0;
+        numa_mode.store(mode, std::memory_order_relaxed);
+    }
+    return mode == 1;
+}
+
+void set_enabled(bool enabled) {
+    numa_mode.store(enabled ? 1 : 0, std::memory_order_relaxed);
+}
+
+size_t node_count() {
+    return topology().nodes.size();
+}
+
+std::vector<int> node_cpus(size_t node) {
+    const Topology &topo = topology();
+    if (node >= topo.nodes.size())
+        Throw("numa::node_cpus(): node index %i is out of bounds!", node);
+    return topo.nodes[node];
+}
+
+size_t current_node() {
+#if defined(__LINUX__)
+    const Topology &topo = topology();
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && cpu < topo.cpu_count)
+        return (size_t) topo.cpu_node[cpu];
+#endif
+    return 0;
+}
+
+size_t thread_node() {
+    return pinned_node >= 0 ? (size_t) pinned_node : current_node();
+}
+
+bool pin_thread(int node) {
+    if (node == pinned_node)
+        return true;
+
+#if defined(__LINUX__)
+    const Topology &topo = topology();
+    if (node >= (int) topo.nodes.size())
+        Throw("numa::pin_thread(): node index %i is out of bounds!", node);
+
+    size_t size = CPU_ALLOC_SIZE(topo.cpu_count);
+    cpu_set_t *cpuset = CPU_ALLOC(topo.cpu_count);
+    if (!cpuset)
+        return false;
+    CPU_ZERO_S(size, cpuset);
+
+    for (size_t i = 0; i < topo.nodes.size(); ++i) {
+        if (node != -1 && (int) i != node)
+            continue;
+        for (int cpu : topo.nodes[i])
+            CPU_SET_S(cpu, size, cpuset);
+    }
+
+    int retval = pthread_setaffinity_np(pthread_self(), size, cpuset);
+    CPU_FREE(cpuset);
+    if (retval) {
+        Log(Warn, "numa::pin_thread(): pthread_setaffinity_np(): failed: %s",
+            strerror(retval));
+        return false;
+    }
+
+    pinned_node = node;
+    return true;
+#else
+    return node == -1;
+#endif
+}
+
+bool interleave(const void *ptr, size_t size) {
+#if defined(__LINUX__)
+    const Topology &topo = topology();
+    if (topo.nodes.size() < 2 || !ptr || size == 0)
+        return false;
+
+    /* The kernel expects a page-aligned range. Only the pages that lie
+       entirely inside the region are interleaved: partial pages at either
+       end may be shared with unrelated data, which must not be moved. */
+    uintptr_t page_size = (uintptr_t) sysconf(_SC_PAGESIZE),
+              start     = ((uintptr_t) ptr + page_size - 1) & ~(page_size - 1),
+              end       = ((uintptr_t) ptr + size) & ~(page_size - 1);
+    if (end <= start)
+        return false;
+
+    constexpr size_t Bits = 8 * sizeof(unsigned long);
+    int max_id = *std::max_element(topo.node_ids.begin(), topo.node_ids.end());
+    std::vector<unsigned long> mask(max_id / Bits + 1, 0ul);
+    for (int id : topo.node_ids)
+        mask[id / Bits] |= 1ul << (id % Bits);
+
+    long retval = syscall(SYS_mbind, (void *) start, (unsigned long) (end - start),
+                          (unsigned long) MPOL_INTERLEAVE, mask.data(),
+                          (unsigned long) (max_id + 2), (unsigned) MPOL_MF_MOVE);
+    if (retval != 0) {
+        Log(Debug, "numa::interleave(): mbind() failed: %s", strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    (void) ptr;
+    (void) size;
+    return false;
+#endif
+}
+
+NAMESPACE_END(numa)
+NAMESPACE_END(mitsuba)
@@ -1,7 +1,10 @@
 #include <mitsuba/core/object.h>
+#include <mitsuba/core/util.h>
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <sstream>
+#include <unordered_set>
 #include <vector>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -24,6 +27,12 @@ void Object::traverse(TraversalCallback * /*callback*/) { }
 
 void Object::parameters_changed(const std::vector<std::string> &/*keys*/) { }
 
+MemoryUsage Object::memory_usage() const { return { }; }
+
+bool Object::write_bundle(SceneBundleWriter * /*writer*/, Properties & /*props*/) const {
+    return false;
+}
+
 std::string Object::id() const { return std::string(); }
 
 std::string Object::to_string() const {
@@ -34,6 +43,95 @@ std::string Object::to_string() const {
 
 Object::~Object() { }
 
+namespace {
+/// Traversal callback that collects the memory usage of every visited object
+class MemoryStatisticsCallback : public TraversalCallback {
+public:
+    void visit(const std::string &name, Object *obj, const std::string &child_prefix) {
+        if (!obj || !m_visited.insert(obj).second)
+            return;
+
+        MemoryUsage usage = obj->memory_usage();
+        if (!usage.empty())
+            records.push_back({ name, obj->class_()->name(), std::move(usage) });
+
+        std::string prefix = m_prefix;
+        m_prefix = child_prefix;
+        obj->traverse(this);
+        m_prefix = prefix;
+    }
+
+    void put_object(const std::string &name, Object *obj) override {
+        visit(m_prefix + name, obj, m_prefix + name + ".");
+    }
+
+    std::vector<MemoryRecord> records;
+
+protected:
+    void put_parameter_impl(const std::string &, const std::type_info &,
+                            void *) override { }
+
+private:
+    std::unordered_set<const Object *> m_visited;
+    std::string m_prefix;
+};
+}
+
+std::vector<MemoryRecord> memory_statistics(Object *root) {
+    MemoryStatisticsCallback cb;
+    if (root)
+        cb.visit(root->class_()->name(), root, "");
+
+    std::stable_sort(cb.records.begin(), cb.records.end(),
+                     [](const MemoryRecord &a, const MemoryRecord &b) {
+                         return a.total() > b.total();
+                     });
+    return std::move(cb.records);
+}
+
+std::string memory_report(const std::vector<MemoryRecord> &records, size_t max_objects) {
+    MemoryUsage categories;
+    size_t total = 0;
+    for (const auto &r : records) {
+        for (const auto &kv : r.usage)
+            categories[kv.first] += kv.second;
+        total += r.total();
+    }
+
+    std::ostringstream oss;
+    oss << "Memory usage: " << util::mem_string(total) << " in total" << std::endl;
+
+    oss << "  By category:" << std::endl;
+    std::vector<std::pair<std::string, size_t>> sorted(categories.begin(), categories.end());
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const auto &a, const auto &b) { return a.second > b.second; });
+    for (const auto &kv : sorted)
+        oss << tfm::format("    %-28s %12s", kv.first, util::mem_string(kv.second))
+            << std::endl;
+
+    oss << "  By object:" << std::endl;
+    size_t listed = 0, remainder = 0, remainder_count = 0;
+    for (const auto &r : records) {
+        if (max_objects == 0 || listed < max_objects) {
+            oss << tfm::format("    %-28s %12s  (%s)", r.name,
+                               util::mem_string(r.total()), r.class_name)
+                << std::endl;
+            listed++;
+        } else {
+            remainder += r.total();
+            remainder_count++;
+        }
+    }
+    if (remainder_count > 0)
+        oss << tfm::format("    %-28s %12s", tfm::format("(%i more objects)", remainder_count),
+                           util::mem_string(remainder))
+            << std::endl;
+
+    std::string result = oss.str();
+    result.pop_back(); // strip trailing newline
+    return result;
+}
+
 std::ostream& operator<<(std::ostream &os, const Object *object) {
     os << ((object != nullptr) ? object->to_string() : "nullptr");
     return os;
@@ -41,6 +41,31 @@ MTS_PY_EXPORT(Bitmap) {
         .value("Unpremultiply", Bitmap::AlphaTransform::Unpremultiply,
                 D(Bitmap, AlphaTransform, Unpremultiply));
 
+    py::enum_<Bitmap::EXRCompression>(bitmap, "EXRCompression", D(Bitmap, EXRCompression))
+        .value("None",  Bitmap::EXRCompression::None,  D(Bitmap, EXRCompression, None))
+        .value("RLE",   Bitmap::EXRCompression::RLE,   D(Bitmap, EXRCompression, RLE))
+        .value("ZIPS",  Bitmap::EXRCompression::ZIPS,  D(Bitmap, EXRCompression, ZIPS))
+        .value("ZIP",   Bitmap::EXRCompression::ZIP,   D(Bitmap, EXRCompression, ZIP))
+        .value("PIZ",   Bitmap::EXRCompression::PIZ,   D(Bitmap, EXRCompression, PIZ))
+        .value("PXR24", Bitmap::EXRCompression::PXR24, D(Bitmap, EXRCompression, PXR24))
+        .value("B44",   Bitmap::EXRCompression::B44,   D(Bitmap, EXRCompression, B44))
+        .value("B44A",  Bitmap::EXRCompression::B44A,  D(Bitmap, EXRCompression, B44A))
+        .value("DWAA",  Bitmap::EXRCompression::DWAA,  D(Bitmap, EXRCompression, DWAA))
+        .value("DWAB",  Bitmap::EXRCompression::DWAB,  D(Bitmap, EXRCompression, DWAB));
+
+    py::class_<Bitmap::EXRPart>(bitmap, "EXRPart", D(Bitmap, EXRPart))
+        .def(py::init([](const std::string &name, const std::vector<std::string> &channels,
+                         Bitmap::EXRCompression compression, float compression_level) {
+                return Bitmap::EXRPart{ name, channels, compression, compression_level };
+            }), "name"_a = "", "channels"_a = std::vector<std::string>(),
+            "compression"_a = Bitmap::EXRCompression::PIZ, "compression_level"_a = 45.f)
+        .def_readwrite("name", &Bitmap::EXRPart::name, D(Bitmap, EXRPart, name))
+        .def_readwrite("channels", &Bitmap::EXRPart::channels, D(Bitmap, EXRPart, channels))
+        .def_readwrite("compression", &Bitmap::EXRPart::compression,
+                       D(Bitmap, EXRPart, compression))
+        .def_readwrite("compression_level", &Bitmap::EXRPart::compression_level,
+                       D(Bitmap, EXRPart, compression_level));
+
     bitmap.def(py::init<Bitmap::PixelFormat, Struct::Type, const Vector2u &, size_t>(),
             "pixel_format"_a, "component_format"_a, "size"_a, "channel_count"_a = 0,
             D(Bitmap, Bitmap))
@@ -166,6 +191,16 @@ MTS_PY_EXPORT(Bitmap) {
                 &Bitmap::write_async, py::const_),
             "path"_a, "format"_a = Bitmap::FileFormat::Auto, "quality"_a = -1,
             D(Bitmap, write_async))
+        .def("write_openexr_parts",
+            py::overload_cast<Stream *, const std::vector<Bitmap::EXRPart> &, uint32_t>(
+                &Bitmap::write_openexr_parts, py::const_),
+            "stream"_a, "parts"_a, "tile_size"_a = 0,
+            D(Bitmap, write_openexr_parts), py::call_guard<py::gil_scoped_release>())
+        .def("write_openexr_parts",
+            py::overload_cast<const fs::path &, const std::vector<Bitmap::EXRPart> &, uint32_t>(
+                &Bitmap::write_openexr_parts, py::const_),
+            "path"_a, "parts"_a, "tile_size"_a = 0,
+            D(Bitmap, write_openexr_parts, 2), py::call_guard<py::gil_scoped_release>())
         .def("split", &Bitmap::split, D(Bitmap, split))
         .def_static("detect_file_format", &Bitmap::detect_file_format, D(Bitmap, detect_file_format))
         .def_property_readonly("__array_interface__", [](Bitmap &bitmap) -> py::object {
@@ -205,3 +240,14 @@ MTS_PY_EXPORT(Bitmap) {
             return py::object(result);
         });
 }
+
+MTS_PY_EXPORT(EXRScanlineWriter) {
+    MTS_PY_CLASS(EXRScanlineWriter, Object)
+        .def(py::init<Stream *, const Bitmap *, uint32_t, const std::vector<Bitmap::EXRPart> &>(),
+            "stream"_a, "format"_a, "height"_a,
+            "parts"_a = std::vector<Bitmap::EXRPart>(1), D(EXRScanlineWriter, EXRScanlineWriter))
+        .def("write", &EXRScanlineWriter::write, "strip"_a, D(EXRScanlineWriter, write),
+            py::call_guard<py::gil_scoped_release>())
+        .def_method(EXRScanlineWriter, rows_written)
+        .def_method(EXRScanlineWriter, height);
+}
@@ -142,3 +142,29 @@ MTS_PY_EXPORT(DiscreteDistribution2D) {
         .def("sample", &Warp::sample, "sample"_a, "active"_a = true)
         .def("__repr__", &Warp::to_string);
 }
+
+MTS_PY_EXPORT(Alias2D) {
+    MTS_PY_IMPORT_TYPES()
+    using Warp = Alias2D<Float>;
+    using NumPyArray = py::array_t<ScalarFloat, py::array::c_style | py::array::forcecast>;
+
+    py::class_<Warp>(m, "Alias2D", py::module_local(), D(Alias2D))
+        .def(py::init([](const NumPyArray &data, bool normalize) {
+                 if (data.ndim() != 2)
+                     throw std::domain_error("'data' array has incorrect dimension");
+                 return Warp(
+                     data.data(),
+                     ScalarVector2u((uint32_t) data.shape(1), (uint32_t) data.shape(0)),
+                     normalize);
+             }), "data"_a, "normalize"_a = true, D(Alias2D, Alias2D, 2))
+        .def("sample",
+             vectorize([](const Warp *w, const Point2f &sample, Mask active) {
+                 return w->sample(sample, active);
+             }), "sample"_a, "active"_a = true, D(Alias2D, sample))
+        .def("eval",
+             vectorize([](const Warp *w, const Point2f &pos, Mask active) {
+                 return w->eval(pos, active);
+             }), "pos"_a, "active"_a = true, D(Alias2D, eval))
+        .def("storage_bytes", &Warp::storage_bytes, D(Alias2D, storage_bytes))
+        .def("__repr__", &Warp::to_string);
+}
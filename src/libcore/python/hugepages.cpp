@@ -0,0 +1,44 @@
+#include <mitsuba/core/hugepages.h>
+#include <pybind11/numpy.h>
+#include <mitsuba/python/python.h>
+
+MTS_PY_EXPORT(HugePageBuffer) {
+    using Usage = HugePageBuffer::Usage;
+
+    auto hpb = MTS_PY_CLASS(HugePageBuffer, Object, py::buffer_protocol())
+        .def(py::init<size_t>(), D(HugePageBuffer, HugePageBuffer), "size"_a)
+        .def("size", &HugePageBuffer::size, D(HugePageBuffer, size))
+        .def("backing", py::overload_cast<>(&HugePageBuffer::backing, py::const_),
+            D(HugePageBuffer, backing))
+        .def_static("enabled", &HugePageBuffer::enabled, D(HugePageBuffer, enabled))
+        .def_static("set_enabled", &HugePageBuffer::set_enabled, "enabled"_a,
+            D(HugePageBuffer, set_enabled))
+        .def_static("usage", &HugePageBuffer::usage, D(HugePageBuffer, usage))
+        .def_static("usage_report", &HugePageBuffer::usage_report,
+            D(HugePageBuffer, usage_report))
+        .def_readonly_static("HugePageSize", &HugePageBuffer::HugePageSize)
+        .def_buffer([](HugePageBuffer &b) -> py::buffer_info {
+            return py::buffer_info(
+                b.data(),
+                sizeof(uint8_t),
+                py::format_descriptor<uint8_t>::format(),
+                1,
+                { (size_t) b.size() },
+                { sizeof(uint8_t) }
+            );
+        });
+
+    py::enum_<HugePageBuffer::Backing>(hpb, "Backing", D(HugePageBuffer, Backing))
+        .value("Heap", HugePageBuffer::Backing::Heap, D(HugePageBuffer, Backing, Heap))
+        .value("Transparent", HugePageBuffer::Backing::Transparent,
+            D(HugePageBuffer, Backing, Transparent))
+        .value("HugeTLB", HugePageBuffer::Backing::HugeTLB, D(HugePageBuffer, Backing, HugeTLB))
+        .export_values();
+
+    py::class_<Usage>(hpb, "Usage", D(HugePageBuffer, Usage))
+        .def_readonly("heap", &Usage::heap, D(HugePageBuffer, Usage, heap))
+        .def_readonly("transparent", &Usage::transparent, D(HugePageBuffer, Usage, transparent))
+        .def_readonly("transparent_resident", &Usage::transparent_resident,
+            D(HugePageBuffer, Usage, transparent_resident))
+        .def_readonly("hugetlb", &Usage::hugetlb, D(HugePageBuffer, Usage, hugetlb));
+}
@@ -15,10 +15,13 @@ MTS_PY_DECLARE(Struct);
 MTS_PY_DECLARE(Appender);
 MTS_PY_DECLARE(ArgParser);
 MTS_PY_DECLARE(Bitmap);
+MTS_PY_DECLARE(EXRScanlineWriter);
 MTS_PY_DECLARE(Formatter);
 MTS_PY_DECLARE(FileResolver);
+MTS_PY_DECLARE(HugePageBuffer);
 MTS_PY_DECLARE(Logger);
 MTS_PY_DECLARE(MemoryMappedFile);
+MTS_PY_DECLARE(numa);
 MTS_PY_DECLARE(Stream);
 MTS_PY_DECLARE(DummyStream);
 MTS_PY_DECLARE(FileStream);
@@ -109,10 +112,13 @@ PYBIND11_MODULE(core_ext, m) {
     MTS_PY_IMPORT(rfilter);
     MTS_PY_IMPORT(Stream);
     MTS_PY_IMPORT(Bitmap);
+    MTS_PY_IMPORT(EXRScanlineWriter);
     MTS_PY_IMPORT(Formatter);
     MTS_PY_IMPORT(FileResolver);
+    MTS_PY_IMPORT(HugePageBuffer);
     MTS_PY_IMPORT(Logger);
     MTS_PY_IMPORT(MemoryMappedFile);
+    MTS_PY_IMPORT(numa);
     MTS_PY_IMPORT(DummyStream);
     MTS_PY_IMPORT(FileStream);
     MTS_PY_IMPORT(MemoryStream);
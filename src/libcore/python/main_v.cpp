@@ -12,6 +12,7 @@ MTS_PY_DECLARE(ContinuousDistribution);
 MTS_PY_DECLARE(IrregularContinuousDistribution);
 MTS_PY_DECLARE(Hierarchical2D);
 MTS_PY_DECLARE(Marginal2D);
+MTS_PY_DECLARE(Alias2D);
 MTS_PY_DECLARE(math);
 MTS_PY_DECLARE(qmc);
 MTS_PY_DECLARE(Properties);
@@ -268,6 +269,7 @@ PYBIND11_MODULE(MODULE_NAME, m) {
     MTS_PY_IMPORT(AnimatedTransform);
     MTS_PY_IMPORT(Hierarchical2D);
     MTS_PY_IMPORT(Marginal2D);
+    MTS_PY_IMPORT(Alias2D);
     MTS_PY_IMPORT(vector);
     MTS_PY_IMPORT_SUBMODULE(warp);
     MTS_PY_IMPORT_SUBMODULE(xml);
@@ -20,7 +20,10 @@ MTS_PY_EXPORT(MemoryMappedFile) {
         .def("resize", &MemoryMappedFile::resize, D(MemoryMappedFile, resize))
         .def("filename", &MemoryMappedFile::filename, D(MemoryMappedFile, filename))
         .def("can_write", &MemoryMappedFile::can_write, D(MemoryMappedFile, can_write))
+        .def("prefetch", &MemoryMappedFile::prefetch, "offset"_a = 0,
+            "size"_a = (size_t) -1, D(MemoryMappedFile, prefetch))
         .def_static("create_temporary", &MemoryMappedFile::create_temporary, D(MemoryMappedFile, create_temporary))
+        .def_static("map_private", &MemoryMappedFile::map_private, "filename"_a, D(MemoryMappedFile, map_private))
         .def_buffer([](MemoryMappedFile &m) -> py::buffer_info {
             return py::buffer_info(
                 m.data(),
@@ -0,0 +1,14 @@
+#include <mitsuba/core/numa.h>
+#include <mitsuba/python/python.h>
+
+MTS_PY_EXPORT(numa) {
+    auto numa = m.def_submodule("numa", "NUMA topology queries and thread/memory placement");
+
+    numa.def_method(numa, enabled)
+        .def_method(numa, set_enabled, "enabled"_a)
+        .def_method(numa, node_count)
+        .def_method(numa, node_cpus, "node"_a)
+        .def_method(numa, current_node)
+        .def_method(numa, thread_node)
+        .def_method(numa, pin_thread, "node"_a);
+}
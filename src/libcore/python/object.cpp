@@ -1,5 +1,6 @@
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/plugin.h>
+#include <mitsuba/core/util.h>
 #include <mitsuba/python/python.h>
 
 extern py::object cast_object(Object *o);
@@ -66,7 +67,22 @@ MTS_PY_EXPORT(Object) {
         }, D(Object, expand))
         .def_method(Object, traverse, "cb"_a)
         .def_method(Object, parameters_changed, "keys"_a = py::list())
+        .def_method(Object, memory_usage)
         .def_property_readonly("ptr", [](Object *self) { return (uintptr_t) self; })
         .def("class_", &Object::class_, py::return_value_policy::reference, D(Object, class))
         .def("__repr__", &Object::to_string, D(Object, to_string));
+
+    py::class_<MemoryRecord>(m, "MemoryRecord", D(MemoryRecord))
+        .def_readonly("name", &MemoryRecord::name, D(MemoryRecord, name))
+        .def_readonly("class_name", &MemoryRecord::class_name, D(MemoryRecord, class_name))
+        .def_readonly("usage", &MemoryRecord::usage, D(MemoryRecord, usage))
+        .def_method(MemoryRecord, total)
+        .def("__repr__", [](const MemoryRecord &r) {
+            return tfm::format("MemoryRecord[name=\"%s\", class_name=\"%s\", total=%s]",
+                               r.name, r.class_name, util::mem_string(r.total()));
+        });
+
+    m.def("memory_statistics", &memory_statistics, "root"_a, D(memory_statistics));
+    m.def("memory_report", &memory_report, "records"_a, "max_objects"_a = 20,
+          D(memory_report));
 }
@@ -13,5 +13,8 @@ MTS_PY_EXPORT(rfilter) {
         .def("eval_discretized",
             vectorize(&ReconstructionFilter::eval_discretized),
             D(ReconstructionFilter, eval_discretized), "x"_a, "active"_a = true)
+        .def("sample",
+            vectorize(&ReconstructionFilter::sample),
+            D(ReconstructionFilter, sample), "sample"_a, "active"_a = true)
         ;
 }
@@ -52,6 +52,30 @@ MTS_PY_EXPORT(xml) {
         },
         "string"_a, D(xml, load_string));
 
+    m.def(
+        "write_bundle",
+        [](const std::string &name, const std::string &bundle_name, py::kwargs kwargs) {
+            xml::ParameterList param;
+            if (kwargs) {
+                for (auto [k, v] : kwargs)
+                    param.emplace_back(
+                        (std::string) py::str(k),
+                        (std::string) py::str(v)
+                    );
+            }
+            py::gil_scoped_release release;
+            xml::write_bundle(name, bundle_name, GET_VARIANT(), param);
+        },
+        "path"_a, "bundle_path"_a, D(xml, write_bundle));
+
+    m.def(
+        "load_bundle",
+        [](const std::string &name) {
+            py::gil_scoped_release release;
+            return cast_object(xml::load_bundle(name, GET_VARIANT()));
+        },
+        "path"_a, D(xml, load_bundle));
+
     m.def(
         "load_dict",
         [](const py::dict dict) {
@@ -17,6 +17,12 @@ MTS_VARIANT void ReconstructionFilter<Float, Spectrum>::init_discretization() {
     m_values[MTS_FILTER_RESOLUTION] = 0;
     m_scale_factor = MTS_FILTER_RESOLUTION / m_radius;
     m_border_size = (int) std::ceil(m_radius - .5f - 2.f * math::RayEpsilon<ScalarFloat>);
+
+    // Tabulate the absolute filter values for filter importance sampling
+    std::vector<ScalarFloat> abs_values(MTS_FILTER_RESOLUTION);
+    for (size_t i = 0; i < MTS_FILTER_RESOLUTION; ++i)
+        abs_values[i] = std::abs(m_values[i]);
+    m_distr = DiscreteDistribution<Float>(abs_values.data(), abs_values.size());
 }
 
 std::ostream &operator<<(std::ostream &os, const FilterBoundaryCondition &value) {
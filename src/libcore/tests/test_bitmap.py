@@ -76,6 +76,58 @@ def test_read_write_complex_exr(tmpdir):
     assert str(b3) != str(b1)
 
 
+@pytest.mark.parametrize('tile_size', [0, 16])
+def test_read_write_multipart_exr(tmpdir, tile_size):
+    # Tests writing channel groups to separate (tiled) parts and reading them back
+    b1 = Bitmap(Bitmap.PixelFormat.MultiChannel, Struct.Type.Float32, [37, 21], 7)
+    names = ["R", "G", "B", "A", "albedo.R", "albedo.G", "dd"]
+    for i, name in enumerate(names):
+        b1.struct_()[i].name = name
+    b2 = np.array(b1, copy=False)
+    b2[:] = np.arange(37*21*7).reshape((21, 37, 7))
+    b1.metadata()["str_prop"] = "value"
+
+    parts = [
+        Bitmap.EXRPart("rgba", ["R", "G", "B", "A"], Bitmap.EXRCompression.ZIP),
+        Bitmap.EXRPart("albedo", ["albedo.R", "albedo.G"], Bitmap.EXRCompression.RLE),
+        Bitmap.EXRPart("dd", [], Bitmap.EXRCompression.ZIPS)
+    ]
+    tmp_file = os.path.join(str(tmpdir), "out.exr")
+    b1.write_openexr_parts(tmp_file, parts, tile_size)
+
+    b3 = Bitmap(tmp_file)
+    os.remove(tmp_file)
+    assert b3.metadata()["str_prop"] == "value"
+    # The part names aren't metadata of the image
+    assert not b3.metadata().has_property("name")
+    assert b3.channel_count() == 7
+    assert sorted(f.name for f in b3.struct_()) == sorted(names)
+    b4 = np.array(b3, copy=False)
+    for i, name in enumerate(names):
+        j = [f.name for f in b3.struct_()].index(name)
+        assert np.all(b4[:, :, j] == b2[:, :, i])
+
+    # Channels may only be assigned to a single part
+    with pytest.raises(RuntimeError):
+        b1.write_openexr_parts(tmp_file, [Bitmap.EXRPart("a", ["R"]),
+                                          Bitmap.EXRPart("b", ["R", "G"])])
+    with pytest.raises(RuntimeError):
+        b1.write_openexr_parts(tmp_file, [Bitmap.EXRPart("a", ["X"])])
+
+
+def test_read_write_exr_name_attribute(tmpdir):
+    # Single-part files keep the attributes that describe multi-part files
+    b1 = Bitmap(Bitmap.PixelFormat.RGB, Struct.Type.Float32, [5, 3])
+    np.array(b1, copy=False)[:] = 0.5
+    b1.metadata()["name"] = "single"
+    tmp_file = os.path.join(str(tmpdir), "out.exr")
+    b1.write(tmp_file)
+
+    b2 = Bitmap(tmp_file)
+    os.remove(tmp_file)
+    assert b2.metadata()["name"] == "single"
+
+
 def test_convert_rgb_y(tmpdir):
     # Tests RGBA(float64) -> Y (float32) conversion
     b1 = Bitmap(Bitmap.PixelFormat.RGBA, Struct.Type.Float64, [3, 1])
@@ -244,3 +296,28 @@ def test_accumulate():
     # but (row, column) in arrays.
     b1.accumulate(b2, [5, 3], [3, 1], [1, 5])
     assert np.all(np.array(b1, copy=False) == ref)
+
+
+def test_write_exr_scanlines(tmpdir):
+    # Tests writing an OpenEXR file in strips of rows
+    from mitsuba.core import EXRScanlineWriter, FileStream
+
+    b1 = Bitmap(Bitmap.PixelFormat.RGBA, Struct.Type.Float32, [23, 50])
+    b2 = np.array(b1, copy=False)
+    b2[:] = np.random.uniform(size=b2.shape)
+
+    tmp_file = os.path.join(str(tmpdir), "out.exr")
+    stream = FileStream(tmp_file, FileStream.ETruncReadWrite)
+    writer = EXRScanlineWriter(stream, b1, 50)
+    for y0, y1 in [(0, 7), (7, 32), (32, 50)]:
+        writer.write(Bitmap(b2[y0:y1], Bitmap.PixelFormat.RGBA))
+    assert writer.rows_written() == 50
+
+    # Strips must match the layout of the file and may not exceed its height
+    with pytest.raises(RuntimeError):
+        writer.write(Bitmap(b2[0:1], Bitmap.PixelFormat.RGBA))
+    del writer, stream
+
+    b3 = Bitmap(tmp_file)
+    os.remove(tmp_file)
+    assert np.all(np.array(b3, copy=False) == b2)
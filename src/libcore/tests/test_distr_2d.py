@@ -186,3 +186,51 @@ def test05_discrete_distribution_2d(variant_scalar_rgb):
     assert ac(d.sample([1, 0]), ([2, 0], .3, [1, 0]))
     assert ac(d.sample([0, 6 / 10 - 1e-7]), ([0, 0], .1, [0, 1]))
     assert ac(d.sample([0, 6 / 10 + 1e-7]), ([1, 1], .1, [0, 0]))
+
+
+def test06_alias_2d(variant_scalar_rgb):
+    from mitsuba.core import Alias2D, Hierarchical2D0
+
+    np.random.seed(0)
+    values = np.random.rand(5, 7) * 10
+    values[2, :] = 0
+
+    alias = Alias2D(values)
+    hier = Hierarchical2D0(values)
+
+    # Same density as the hierarchical warp
+    for i in range(100):
+        p = np.random.rand(2)
+        assert ek.allclose(alias.eval(p), hier.eval(p), rtol=1e-5)
+
+    # Sampled densities are consistent with eval()
+    for i in range(100):
+        pos, pdf = alias.sample(np.random.rand(2))
+        assert np.all((np.array(pos) >= 0) & (np.array(pos) <= 1))
+        assert pdf > 0
+        assert ek.allclose(alias.eval(pos), pdf, rtol=1e-4)
+
+    with pytest.raises(RuntimeError):
+        Alias2D(np.zeros((3, 3)))
+
+
+@pytest.mark.parametrize("attempt", list(range(5)))
+def test07_alias_2d_chi2(variant_packet_rgb, attempt):
+    from mitsuba.core import Alias2D, ScalarBoundingBox2f
+    from mitsuba.python.chi2 import ChiSquareTest, PlanarDomain
+
+    np.random.seed(attempt)
+    shape = np.random.randint(2, 8, 2)
+    values = np.ones(shape) if attempt == 4 else np.random.rand(*shape) * 10
+    instance = Alias2D(values)
+
+    chi2 = ChiSquareTest(
+        domain=PlanarDomain(ScalarBoundingBox2f(0, 1)),
+        sample_func=lambda p: instance.sample(p)[0],
+        pdf_func=lambda p: instance.eval(p),
+        sample_dim=2,
+        res=31,
+        sample_count=100000
+    )
+
+    assert chi2.run()
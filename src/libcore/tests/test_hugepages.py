@@ -0,0 +1,61 @@
+import sys
+
+import numpy as np
+import pytest
+
+import mitsuba
+mitsuba.set_variant('scalar_rgb')
+from mitsuba.core import HugePageBuffer
+
+
+@pytest.fixture
+def huge_pages():
+    enabled = HugePageBuffer.enabled()
+    HugePageBuffer.set_enabled(True)
+    yield
+    HugePageBuffer.set_enabled(enabled)
+
+
+def test01_small_buffer(huge_pages):
+    buf = HugePageBuffer(1024)
+    assert buf.size() == 1024
+    assert buf.backing() == HugePageBuffer.Backing.Heap
+
+    data = np.array(buf, copy=False)
+    data[:] = np.arange(1024) % 256
+    assert np.all(np.array(buf, copy=False) == np.arange(1024) % 256)
+
+
+def test02_disabled():
+    enabled = HugePageBuffer.enabled()
+    try:
+        HugePageBuffer.set_enabled(False)
+        buf = HugePageBuffer(2 * HugePageBuffer.HugePageSize)
+        assert buf.backing() == HugePageBuffer.Backing.Heap
+    finally:
+        HugePageBuffer.set_enabled(enabled)
+
+
+@pytest.mark.skipif(not sys.platform.startswith('linux'),
+                    reason='Huge pages are only supported on Linux')
+def test03_large_buffer(huge_pages):
+    size = 3 * HugePageBuffer.HugePageSize + 123
+    before = HugePageBuffer.usage()
+
+    buf = HugePageBuffer(size)
+    assert buf.backing() != HugePageBuffer.Backing.Heap
+
+    # Touch all pages, the buffer must be writable
+    data = np.array(buf, copy=False)
+    data[:] = 1
+    assert np.sum(data) == size
+
+    usage = HugePageBuffer.usage()
+    assert usage.transparent + usage.hugetlb == \
+        before.transparent + before.hugetlb + size
+    assert usage.transparent_resident <= usage.transparent
+    assert 'transparent huge pages' in HugePageBuffer.usage_report()
+
+    del data, buf
+    usage = HugePageBuffer.usage()
+    assert usage.transparent + usage.hugetlb == before.transparent + before.hugetlb
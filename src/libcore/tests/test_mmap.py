@@ -67,3 +67,19 @@ def test04_create_temp():
     assert mmap.can_write()
     del mmap
     assert not os.path.exists(fname)
+
+
+def test05_prefetch(tmpdir):
+    tmp_file = os.path.join(str(tmpdir), "mmap_test")
+    data = np.arange(4096, dtype=np.uint32)
+    data.tofile(tmp_file)
+    mmap = MemoryMappedFile.map_private(tmp_file)
+    # Prefetching is only a hint, arbitrary (even out-of-range) ranges are fine
+    mmap.prefetch()
+    mmap.prefetch(100, 5000)
+    mmap.prefetch(1 << 20)
+    array_view = np.array(mmap, copy=False).view(np.uint32)
+    assert np.all(array_view == data)
+    del array_view
+    del mmap
+    os.remove(tmp_file)
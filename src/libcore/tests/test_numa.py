@@ -0,0 +1,50 @@
+import os
+import sys
+
+import pytest
+
+import mitsuba
+mitsuba.set_variant('scalar_rgb')
+from mitsuba.core import numa, util
+
+
+def test01_topology():
+    node_count = numa.node_count()
+    assert node_count >= 1
+
+    cpus = [cpu for node in range(node_count) for cpu in numa.node_cpus(node)]
+    assert len(cpus) > 0
+    assert len(set(cpus)) == len(cpus)
+    assert numa.current_node() < node_count
+
+    with pytest.raises(RuntimeError):
+        numa.node_cpus(node_count)
+
+
+@pytest.mark.skipif(not sys.platform.startswith('linux'),
+                    reason='Thread affinity is only supported on Linux')
+def test02_pin_thread():
+    # pin_thread(-1) allows all processors, which may differ from the
+    # affinity that the test process was started with
+    affinity = os.sched_getaffinity(0)
+    try:
+        node = numa.node_count() - 1
+        assert numa.pin_thread(node)
+        assert numa.thread_node() == node
+
+        assert numa.pin_thread(-1)
+        assert numa.thread_node() == numa.current_node()
+    finally:
+        numa.pin_thread(-1)
+        os.sched_setaffinity(0, affinity)
+
+
+def test03_enable():
+    enabled = numa.enabled()
+    try:
+        numa.set_enabled(True)
+        assert numa.enabled()
+        numa.set_enabled(False)
+        assert not numa.enabled()
+    finally:
+        numa.set_enabled(enabled)
@@ -359,4 +359,46 @@ def test24_properties_duplicated(variant_scalar_rgb):
                                 <rgb name="reflectance" value="0.44"/>
                             </bsdf>
                         </scene>""")
-    e.match(err_str)
\ No newline at end of file
+    e.match(err_str)
+
+@fresolver_append_path
+def test25_scene_bundle(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import xml, Ray3f
+    from mitsuba.render import Mesh
+
+    scene_xml = str(tmpdir.join('scene.xml'))
+    bundle = str(tmpdir.join('scene.mtsb'))
+    with open(scene_xml, 'w') as f:
+        f.write("""<scene version="2.0.0">
+                       <shape type="obj" id="box">
+                           <string name="filename" value="resources/data/tests/obj/cbox_smallbox.obj"/>
+                           <bsdf type="diffuse">
+                               <rgb name="reflectance" value="0.2, 0.5, 0.8"/>
+                           </bsdf>
+                       </shape>
+                       <shape type="sphere">
+                           <point name="center" x="0" y="0" z="5"/>
+                       </shape>
+                   </scene>""")
+
+    xml.write_bundle(scene_xml, bundle)
+    scene_ref = xml.load_file(scene_xml)
+    scene = xml.load_file(bundle)
+
+    assert len(scene.shapes()) == len(scene_ref.shapes())
+    mesh = [s for s in scene.shapes() if isinstance(s, Mesh)][0]
+    mesh_ref = [s for s in scene_ref.shapes() if isinstance(s, Mesh)][0]
+    assert mesh.vertex_count() == mesh_ref.vertex_count()
+    assert mesh.face_count() == mesh_ref.face_count()
+    assert ek.allclose(mesh.vertex_positions_buffer(), mesh_ref.vertex_positions_buffer())
+    assert ek.allclose(mesh.faces_buffer(), mesh_ref.faces_buffer())
+    assert ek.allclose(scene.bbox().min, scene_ref.bbox().min)
+    assert ek.allclose(scene.bbox().max, scene_ref.bbox().max)
+
+    for d in [[0, 0, 1], [0.1, 0.2, 1], [1, 0, 0]]:
+        ray = Ray3f([0, 0, -10], ek.normalize(d), 0, [])
+        si, si_ref = scene.ray_intersect(ray), scene_ref.ray_intersect(ray)
+        assert si.is_valid() == si_ref.is_valid()
+        if si_ref.is_valid():
+            assert ek.allclose(si.t, si_ref.t)
+            assert ek.allclose(si.n, si_ref.n)
@@ -3,6 +3,7 @@
 #include <mitsuba/core/tls.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/numa.h>
 #include <mitsuba/core/profiler.h>
 #include <tbb/task_scheduler_observer.h>
 #include <condition_variable>
@@ -487,11 +488,18 @@ public:
         observe();
     }
 
-    void on_scheduler_entry(bool) {
+    void on_scheduler_entry(bool is_worker) {
         if (register_external_thread("tbb")) {
             std::unique_lock<std::mutex> lock(m_mutex);
             m_started_counter++;
         }
+
+        /* In NUMA mode, distribute the workers over the nodes in round-robin
+           order. Otherwise, undo the pinning of a previous scheduler. */
+        if (is_worker)
+            numa::pin_thread(numa::enabled()
+                                 ? (int) (m_worker_counter++ % numa::node_count())
+                                 : -1);
     }
 
     void on_scheduler_exit(bool) {
@@ -510,6 +518,7 @@ public:
 private:
     uint32_t m_started_counter{0};
     uint32_t m_stopped_counter{0};
+    std::atomic<uint32_t> m_worker_counter{0};
     std::condition_variable m_cv;
     std::mutex m_mutex;
 };
@@ -1,8 +1,10 @@
 #include <cctype>
 #include <fstream>
+#include <map>
 #include <set>
 #include <unordered_map>
 
+#include <mitsuba/core/bundle.h>
 #include <mitsuba/core/class.h>
 #include <mitsuba/core/config.h>
 #include <mitsuba/core/filesystem.h>
@@ -269,6 +271,11 @@ struct XMLParseContext {
     bool parallelize;
     ColorMode color_mode;
 
+    /* When writing a scene bundle, textures specified using the 'rgb' and
+       'spectrum' tags are turned into separate (uninstantiated) objects */
+    bool bundle = false;
+    std::vector<std::unique_ptr<std::vector<Float>>> bundle_arrays;
+
     XMLParseContext(const std::string &variant) : variant(variant) {
         color_mode = MTS_INVOKE_VARIANT(variant, variant_to_color_mode);
 
@@ -280,6 +287,121 @@ struct XMLParseContext {
     std::string variant;
 };
 
+/// Add an anonymous texture object to the scene graph and reference it from \c props
+static void add_texture_instance(XMLSource &src, XMLParseContext &ctx,
+                                 const pugi::xml_node &node, Properties &props,
+                                 const std::string &name, const Properties &texture_props) {
+    std::string id = tfm::format("_unnamed_%i", ctx.id_counter++);
+    auto &inst = ctx.instances[id];
+    inst.props = texture_props;
+    inst.props.set_id(id);
+    inst.class_ = Class::for_name("Texture", ctx.variant);
+    inst.offset = src.offset;
+    inst.src_id = src.id;
+    inst.location = node.offset_debug();
+    props.set_named_reference(name, id);
+}
+
+/// Construction parameters of a texture representing an RGB value
+static Properties texture_props_from_rgb(const std::string &name,
+                                         Color<float, 3> color,
+                                         bool within_emitter) {
+    Properties props(within_emitter ? "srgb_d65" : "srgb");
+    props.set_color("color", color);
+
+    if (!within_emitter && is_unbounded_spectrum(name))
+        props.set_bool("unbounded", true);
+
+    return props;
+}
+
+/**
+ * \brief Construction parameters of a texture representing a spectrum
+ *
+ * In spectral modes, the returned properties reference the contents of
+ * \c wavelengths and \c values, which must outlive them.
+ */
+static Properties texture_props_from_spectrum(const std::string &name,
+                                              float const_value,
+                                              std::vector<float> &wavelengths,
+                                              std::vector<float> &values,
+                                              bool within_emitter,
+                                              bool is_spectral_mode,
+                                              bool is_monochromatic_mode) {
+    if (wavelengths.empty()) {
+        Properties props("uniform");
+        if (within_emitter && is_spectral_mode) {
+            props.set_plugin_name("d65");
+            props.set_float("scale", const_value);
+        } else {
+            props.set_float("value", const_value);
+        }
+
+        return props;
+    } else {
+        /* Values are scaled so that integrating the spectrum against the CIE curves
+            and converting to sRGB yields (1, 1, 1) for D65. */
+        float unit_conversion = 1.f;
+        if (within_emitter || !is_spectral_mode)
+            unit_conversion = MTS_CIE_Y_NORMALIZATION;
+
+        /* Detect whether wavelengths are regularly sampled and potentially
+            apply the conversion factor. */
+        bool is_regular = true;
+        float interval = 0.f;
+
+        for (size_t n = 0; n < wavelengths.size(); ++n) {
+            values[n] *= unit_conversion;
+
+            if (n <= 0)
+                continue;
+
+            float distance = (wavelengths[n] - wavelengths[n - 1]);
+            if (distance < 0.f)
+                Throw("Wavelengths must be specified in increasing order!");
+            if (n == 1)
+                interval = distance;
+            else if (std::abs(distance - interval) > math::Epsilon<float>)
+                is_regular = false;
+        }
+
+        if (is_spectral_mode) {
+            Properties props;
+            if (is_regular) {
+                props.set_plugin_name("regular");
+                props.set_long("size", wavelengths.size());
+                props.set_float("lambda_min", wavelengths.front());
+                props.set_float("lambda_max", wavelengths.back());
+                props.set_pointer("values", values.data());
+            } else {
+                props.set_plugin_name("irregular");
+                props.set_long("size", wavelengths.size());
+                props.set_pointer("wavelengths", wavelengths.data());
+                props.set_pointer("values", values.data());
+            }
+            return props;
+        } else {
+            // In non-spectral mode, pre-integrate against the CIE matching curves
+            Color3f color = spectrum_to_rgb(
+                wavelengths, values, !(within_emitter || is_unbounded_spectrum(name)));
+
+            Properties props;
+            if (is_monochromatic_mode) {
+                props = Properties("uniform");
+                props.set_float("value", luminance(color));
+            } else {
+                props = Properties(within_emitter ? "srgb_d65" : "srgb");
+                props.set_color("color", color);
+
+                if (!within_emitter && is_unbounded_spectrum(name))
+                    props.set_bool("unbounded", true);
+            }
+
+            return props;
+        }
+    }
+}
+
 /// Helper function to check if attributes are fully specified
 static void check_attributes(XMLSource &src, const pugi::xml_node &node,
                              std::set<std::string> &&attrs, bool expect_all = true) {
@@ -794,9 +916,15 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
 
                     if (!within_spectrum) {
                         std::string name = node.attribute("name").value();
-                        ref<Object> obj = detail::create_texture_from_rgb(
-                            name, color, ctx.variant, within_emitter);
-                        props.set_object(name, obj);
+                        if (ctx.bundle) {
+                            add_texture_instance(
+                                src, ctx, node, props, name,
+                                texture_props_from_rgb(name, color, within_emitter));
+                        } else {
+                            ref<Object> obj = detail::create_texture_from_rgb(
+                                name, color, ctx.variant, within_emitter);
+                            props.set_object(name, obj);
+                        }
                     } else {
                         props.set_color("color", color);
                     }
@@ -851,13 +979,28 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                         }
                     }
 
-                    ref<Object> obj = detail::create_texture_from_spectrum(
-                        name, const_value, wavelengths, values, ctx.variant,
-                        within_emitter,
-                        ctx.color_mode == ColorMode::Spectral,
-                        ctx.color_mode == ColorMode::Monochromatic);
+                    if (ctx.bundle) {
+                        // The texture properties may reference these arrays
+                        auto &w = *ctx.bundle_arrays.emplace_back(
+                            new std::vector<Float>(std::move(wavelengths)));
+                        auto &v = *ctx.bundle_arrays.emplace_back(
+                            new std::vector<Float>(std::move(values)));
+
+                        add_texture_instance(
+                            src, ctx, node, props, name,
+                            texture_props_from_spectrum(
+                                name, const_value, w, v, within_emitter,
+                                ctx.color_mode == ColorMode::Spectral,
+                                ctx.color_mode == ColorMode::Monochromatic));
+                    } else {
+                        ref<Object> obj = detail::create_texture_from_spectrum(
+                            name, const_value, wavelengths, values, ctx.variant,
+                            within_emitter,
+                            ctx.color_mode == ColorMode::Spectral,
+                            ctx.color_mode == ColorMode::Monochromatic);
 
-                    props.set_object(name, obj);
+                        props.set_object(name, obj);
+                    }
                 }
                 break;
 
@@ -1074,14 +1217,9 @@ ref<Object> create_texture_from_rgb(const std::string &name,
                                     Color<float, 3> color,
                                     const std::string &variant,
                                     bool within_emitter) {
-    Properties props(within_emitter ? "srgb_d65" : "srgb");
-    props.set_color("color", color);
-
-    if (!within_emitter && is_unbounded_spectrum(name))
-        props.set_bool("unbounded", true);
-
     return PluginManager::instance()->create_object(
-        props, Class::for_name("Texture", variant));
+        texture_props_from_rgb(name, color, within_emitter),
+        Class::for_name("Texture", variant));
 }
 
 ref<Object> create_texture_from_spectrum(const std::string &name,
@@ -1092,85 +1230,20 @@ ref<Object> create_texture_from_spectrum(const std::string &name,
                                          bool within_emitter,
                                          bool is_spectral_mode,
                                          bool is_monochromatic_mode) {
-    const Class *class_ = Class::for_name("Texture", variant);
+    Properties props = texture_props_from_spectrum(
+        name, const_value, wavelengths, values, within_emitter,
+        is_spectral_mode, is_monochromatic_mode);
 
-    if (wavelengths.empty()) {
-        Properties props("uniform");
-        if (within_emitter && is_spectral_mode) {
-            props.set_plugin_name("d65");
-            props.set_float("scale", const_value);
-        } else {
-            props.set_float("value", const_value);
-        }
+    ref<Object> obj = PluginManager::instance()->create_object(
+        props, Class::for_name("Texture", variant));
 
-        ref<Object> obj = PluginManager::instance()->create_object(props, class_);
+    if (wavelengths.empty()) {
         auto expanded = obj->expand();
         Assert(expanded.size() <= 1);
         if (!expanded.empty())
             obj = expanded[0];
-        return obj;
-    } else {
-        /* Values are scaled so that integrating the spectrum against the CIE curves
-            and converting to sRGB yields (1, 1, 1) for D65. */
-        float unit_conversion = 1.f;
-        if (within_emitter || !is_spectral_mode)
-            unit_conversion = MTS_CIE_Y_NORMALIZATION;
-
-        /* Detect whether wavelengths are regularly sampled and potentially
-            apply the conversion factor. */
-        bool is_regular = true;
-        float interval = 0.f;
-
-        for (size_t n = 0; n < wavelengths.size(); ++n) {
-            values[n] *= unit_conversion;
-
-            if (n <= 0)
-                continue;
-
-            float distance = (wavelengths[n] - wavelengths[n - 1]);
-            if (distance < 0.f)
-                Throw("Wavelengths must be specified in increasing order!");
-            if (n == 1)
-                interval = distance;
-            else if (std::abs(distance - interval) > math::Epsilon<float>)
-                is_regular = false;
-        }
-
-        if (is_spectral_mode) {
-            Properties props;
-            if (is_regular) {
-                props.set_plugin_name("regular");
-                props.set_long("size", wavelengths.size());
-                props.set_float("lambda_min", wavelengths.front());
-                props.set_float("lambda_max", wavelengths.back());
-                props.set_pointer("values", values.data());
-            } else {
-                props.set_plugin_name("irregular");
-                props.set_long("size", wavelengths.size());
-                props.set_pointer("wavelengths", wavelengths.data());
-                props.set_pointer("values", values.data());
-            }
-            return PluginManager::instance()->create_object(props, class_);
-        } else {
-            // In non-spectral mode, pre-integrate against the CIE matching curves
-            Color3f color = spectrum_to_rgb(
-                wavelengths, values, !(within_emitter || is_unbounded_spectrum(name)));
-
-            Properties props;
-            if (is_monochromatic_mode) {
-                props = Properties("uniform");
-                props.set_float("value", luminance(color));
-            } else {
-                props = Properties(within_emitter ? "srgb_d65" : "srgb");
-                props.set_color("color", color);
-
-                if (!within_emitter && is_unbounded_spectrum(name))
-                    props.set_bool("unbounded", true);
-            }
-
-            return PluginManager::instance()->create_object(props, class_);
-        }
     }
+    return obj;
 }
 
 NAMESPACE_END(detail)
@@ -1218,6 +1291,13 @@ ref<Object> load_file(const fs::path &filename_, const std::string &variant,
     if (!fs::exists(filename))
         Throw("\"%s\": file does not exist!", filename);
 
+    if (filename.extension().string() == ".mtsb") {
+        if (!param.empty())
+            Log(Warn, "\"%s\": parameters are ignored when loading a scene bundle!",
+                filename);
+        return load_bundle(filename, variant);
+    }
+
     Log(Info, "Loading XML file \"%s\" ..", filename);
     Log(Info, "Using variant \"%s\"", variant);
 
@@ -1280,5 +1360,116 @@ ref<Object> load_file(const fs::path &filename_, const std::string &variant,
     }
 }
 
+void write_bundle(const fs::path &filename, const fs::path &bundle_filename,
+                  const std::string &variant, ParameterList param) {
+    ScopedPhase sp(ProfilerPhase::InitScene);
+    if (!fs::exists(filename))
+        Throw("\"%s\": file does not exist!", filename);
+
+    Log(Info, "Creating scene bundle from XML file \"%s\" ..", filename);
+
+    pugi::xml_document doc;
+    pugi::xml_parse_result result = doc.load_file(filename.native().c_str(),
+                                                  pugi::parse_default |
+                                                  pugi::parse_comments);
+
+    detail::XMLSource src {
+        filename.string(), doc,
+        [=](ptrdiff_t pos) { return detail::file_offset(filename, pos); }
+    };
+
+    if (!result) // There was a parser / file IO error
+        Throw("Error while loading \"%s\" (at %s): %s", src.id,
+              src.offset(result.offset), result.description());
+
+    // Make a backup copy of the FileResolver, which will be restored after parsing
+    ref<FileResolver> fs_backup = Thread::thread()->file_resolver();
+    ref<FileResolver> resolver = new FileResolver(*fs_backup);
+    Thread::thread()->set_file_resolver(resolver);
+
+    try {
+        pugi::xml_node root = doc.document_element();
+        detail::XMLParseContext ctx(variant);
+        ctx.bundle = true;
+        Properties prop;
+        size_t arg_counter = 0; // Unused
+        auto scene_id = detail::parse_xml(src, ctx, root, Tag::Invalid, prop,
+                                          param, arg_counter, 0).second;
+
+        // Instantiation replaces named references by objects, keep a copy
+        std::map<std::string, Properties> props;
+        for (auto &kv : ctx.instances)
+            props[kv.first] = kv.second.props;
+
+        /* Fully load the scene: this decodes all meshes and textures, and
+           reports any errors before the bundle is written */
+        ref<Object> scene = detail::instantiate_node(ctx, scene_id);
+
+        ref<SceneBundleWriter> writer = new SceneBundleWriter(bundle_filename, variant);
+        for (auto &[id, node_props] : props) {
+            const detail::XMLObject &inst = ctx.instances[id];
+            SceneBundle::Node node;
+            node.id = id;
+            node.alias = inst.alias;
+
+            if (inst.alias.empty()) {
+                node.class_name = inst.class_->name();
+                node.props = node_props;
+                if (inst.object)
+                    node.uses_blobs = inst.object->write_bundle(writer, node.props);
+
+                // Files that are still referenced must be found without the XML context
+                if (node.props.has_property("filename") &&
+                    node.props.type("filename") == Properties::Type::String) {
+                    fs::path path = resolver->resolve(node.props.string("filename"));
+                    node.props.set_string("filename", fs::absolute(path).string(), false);
+                }
+            }
+
+            writer->add_node(node);
+        }
+        writer->close(scene_id);
+
+        Thread::thread()->set_file_resolver(fs_backup.get());
+    } catch(...) {
+        Thread::thread()->set_file_resolver(fs_backup.get());
+        throw;
+    }
+}
+
+ref<Object> load_bundle(const fs::path &filename, const std::string &variant) {
+    ScopedPhase sp(ProfilerPhase::InitScene);
+    Log(Info, "Loading scene bundle \"%s\" ..", filename);
+    Log(Info, "Using variant \"%s\"", variant);
+
+    ref<SceneBundle> bundle = new SceneBundle(filename);
+    if (bundle->variant() != variant)
+        Throw("\"%s\": the scene bundle was created for variant \"%s\" and "
+              "cannot be loaded using variant \"%s\"!", filename,
+              bundle->variant(), variant);
+
+    detail::XMLParseContext ctx(variant);
+    const auto &nodes = bundle->nodes();
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const SceneBundle::Node &node = nodes[i];
+        auto &inst = ctx.instances[node.id];
+        inst.alias = node.alias;
+        inst.src_id = filename.string();
+        inst.location = i;
+        inst.offset = [](ptrdiff_t pos) { return "object " + std::to_string(pos); };
+
+        if (node.alias.empty()) {
+            inst.class_ = Class::for_name(node.class_name, variant);
+            if (!inst.class_)
+                Throw("\"%s\": unknown class \"%s\"!", filename, node.class_name);
+            inst.props = node.props;
+            if (node.uses_blobs)
+                inst.props.set_pointer("bundle", bundle.get());
+        }
+    }
+
+    return detail::instantiate_node(ctx, bundle->root());
+}
+
 NAMESPACE_END(xml)
 NAMESPACE_END(mitsuba)
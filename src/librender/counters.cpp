@@ -0,0 +1,122 @@
+#include <mitsuba/render/counters.h>
+#include <mitsuba/core/logger.h>
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+#if defined(MTS_ENABLE_COUNTERS)
+
+/// Keeps track of the counters of all threads
+struct CounterRegistry {
+    std::mutex mutex;
+    std::vector<std::atomic<uint64_t> *> threads;
+    /// Counts of threads that have already terminated
+    uint64_t retired[int(Counter::CounterCount)] = { };
+};
+
+/* The registry is created on first use by the first counter block, hence its
+   destruction is guaranteed to happen after that of all counter blocks. */
+static CounterRegistry &counter_registry() {
+    static CounterRegistry registry;
+    return registry;
+}
+
+struct CounterBlock {
+    std::atomic<uint64_t> values[int(Counter::CounterCount)];
+
+    CounterBlock() {
+        for (auto &v : values)
+            v.store(0, std::memory_order_relaxed);
+        CounterRegistry &r = counter_registry();
+        std::lock_guard<std::mutex> guard(r.mutex);
+        r.threads.push_back(values);
+    }
+
+    ~CounterBlock() {
+        CounterRegistry &r = counter_registry();
+        std::lock_guard<std::mutex> guard(r.mutex);
+        for (uint32_t i = 0; i < uint32_t(Counter::CounterCount); ++i)
+            r.retired[i] += values[i].load(std::memory_order_relaxed);
+        r.threads.erase(std::remove(r.threads.begin(), r.threads.end(), values),
+                        r.threads.end());
+    }
+};
+
+static thread_local CounterBlock counter_block;
+
+std::atomic<uint64_t> *counter_storage() { return counter_block.values; }
+
+bool ray_counters_enabled() { return true; }
+
+RayCounters ray_counters() {
+    CounterRegistry &r = counter_registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+
+    RayCounters result;
+    for (uint32_t i = 0; i < uint32_t(Counter::CounterCount); ++i) {
+        result.values[i] = r.retired[i];
+        for (std::atomic<uint64_t> *values : r.threads)
+            result.values[i] += values[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void ray_counters_reset() {
+    CounterRegistry &r = counter_registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+
+    for (uint32_t i = 0; i < uint32_t(Counter::CounterCount); ++i) {
+        r.retired[i] = 0;
+        for (std::atomic<uint64_t> *values : r.threads)
+            values[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+#else
+
+bool ray_counters_enabled() { return false; }
+RayCounters ray_counters() { return RayCounters(); }
+void ray_counters_reset() { }
+
+#endif
+
+double RayCounters::nodes_per_ray() const {
+    uint64_t count = rays();
+    return count > 0 ? (*this)[Counter::KDNodeVisit] / (double) count : 0.0;
+}
+
+double RayCounters::primitives_per_ray() const {
+    uint64_t count = rays();
+    return count > 0 ? (*this)[Counter::KDPrimitiveTest] / (double) count : 0.0;
+}
+
+double RayCounters::lane_utilization() const {
+    uint64_t lanes = (*this)[Counter::PacketLanes];
+    return lanes > 0 ? (*this)[Counter::PacketActiveLanes] / (double) lanes : 0.0;
+}
+
+std::string RayCounters::to_string(double seconds) const {
+    std::ostringstream oss;
+    oss << "Ray tracing counters:" << std::endl;
+    for (uint32_t i = 0; i < uint32_t(Counter::CounterCount); ++i) {
+        if (Counter(i) == Counter::PacketLanes || Counter(i) == Counter::PacketActiveLanes)
+            continue;
+        oss << tfm::format("  %-24s%llu", std::string(counter_id[i]) + ":",
+                           (unsigned long long) values[i]) << std::endl;
+    }
+
+    if (seconds > 0.0)
+        oss << tfm::format("  %-24s%.2f M/s", "Rays:", rays() / seconds * 1e-6) << std::endl;
+    oss << tfm::format("  %-24s%.2f", "Nodes/ray:", nodes_per_ray()) << std::endl;
+    oss << tfm::format("  %-24s%.2f", "Primitives/ray:", primitives_per_ray());
+    if ((*this)[Counter::PacketLanes] > 0)
+        oss << std::endl
+            << tfm::format("  %-24s%.1f%%", "SIMD lane utilization:",
+                           lane_utilization() * 100.0);
+    return oss.str();
+}
+
+NAMESPACE_END(mitsuba)
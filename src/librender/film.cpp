@@ -31,6 +31,11 @@ MTS_VARIANT Film<Float, Spectrum>::Film(const Properties &props) : Object() {
        large reconstruction filters. */
     m_high_quality_edges = props.bool_("high_quality_edges", false);
 
+    /* If set to true, camera rays are distributed according to the
+       reconstruction filter and each sample only contributes to a single
+       pixel, which avoids the cost of splatting into the neighborhood. */
+    m_filter_importance_sampling = props.bool_("filter_importance_sampling", false);
+
     // Use the provided reconstruction filter, if any.
     for (auto &[name, obj] : props.objects(false)) {
         auto *rfilter = dynamic_cast<ReconstructionFilter *>(obj.get());
@@ -69,6 +74,7 @@ MTS_VARIANT std::string Film<Float, Spectrum>::to_string() const {
         << "  crop_size = "   << m_crop_size   << "," << std::endl
         << "  crop_offset = " << m_crop_offset << "," << std::endl
         << "  high_quality_edges = " << m_high_quality_edges << "," << std::endl
+        << "  filter_importance_sampling = " << m_filter_importance_sampling << "," << std::endl
         << "  m_filter = " << m_filter << std::endl
         << "]";
     return oss.str();
@@ -79,7 +79,6 @@ MTS_VARIANT void ImageBlock<Float, Spectrum>::put(const ImageBlock *block) {
 MTS_VARIANT typename ImageBlock<Float, Spectrum>::Mask
 ImageBlock<Float, Spectrum>::put(const Point2f &pos_, const Float *value, Mask active) {
     ScopedPhase sp(ProfilerPhase::ImageBlockPut);
-    Assert(m_filter != nullptr);
 
     // Check if all sample values are valid
     if (likely(m_warn_negative || m_warn_invalid)) {
@@ -108,7 +107,8 @@ ImageBlock<Float, Spectrum>::put(const Point2f &pos_, const Float *value, Mask a
         }
     }
 
-    ScalarFloat filter_radius = m_filter->radius();
+    // Without a filter, the sample only contributes to a single pixel
+    ScalarFloat filter_radius = m_filter ? m_filter->radius() : .5f;
     ScalarVector2i size = m_size + 2 * m_border_size;
 
     // Convert to pixel coordinates within the image block
@@ -171,6 +171,10 @@ ImageBlock<Float, Spectrum>::put(const Point2f &pos_, const Float *value, Mask a
     return active;
 }
 
+MTS_VARIANT MemoryUsage ImageBlock<Float, Spectrum>::memory_usage() const {
+    return { { "image blocks", slices(m_data) * sizeof(ScalarFloat) } };
+}
+
 MTS_VARIANT std::string ImageBlock<Float, Spectrum>::to_string() const {
     std::ostringstream oss;
     oss << "ImageBlock[" << std::endl
@@ -1,13 +1,17 @@
+#include <chrono>
+#include <deque>
 #include <thread>
 #include <mutex>
 
 #include <enoki/morton.h>
+#include <mitsuba/core/numa.h>
 #include <mitsuba/core/profiler.h>
 #include <mitsuba/core/progress.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/warp.h>
+#include <mitsuba/render/counters.h>
 #include <mitsuba/render/film.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/sampler.h>
@@ -15,6 +19,7 @@
 #include <mitsuba/render/spiral.h>
 #include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 #include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -34,6 +39,8 @@ MTS_VARIANT SamplingIntegrator<Float, Spectrum>::SamplingIntegrator(const Proper
 
     m_samples_per_pass = (uint32_t) props.size_("samples_per_pass", (size_t) -1);
     m_timeout = props.float_("timeout", -1.f);
+    m_split_blocks = props.bool_("split_blocks", true);
+    m_cost_aov = props.bool_("cost_aov", false);
 
     /// Disable direct visibility of emitters if needed
     m_hide_emitters = props.bool_("hide_emitters", false);
@@ -71,8 +78,32 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
     // Insert default channels and set up the film
     for (size_t i = 0; i < 5; ++i)
         channels.insert(channels.begin() + i, std::string(1, "XYZAW"[i]));
+
+    // Append the per-sample cost channels after the integrator's AOVs
+    size_t cost_channel = 0;
+    if (m_cost_aov) {
+        if constexpr (is_cuda_array_v<Float>) {
+            Log(Warn, "The cost AOV is not supported by GPU variants and will be ignored.");
+        } else {
+            cost_channel = channels.size();
+            channels.push_back("cost.kcycles");
+            if (ray_counters_enabled())
+                channels.push_back("cost.rays");
+            else
+                Log(Warn, "Ray tracing counters are disabled (see the MTS_ENABLE_COUNTERS "
+                          "CMake option), the cost AOV only records cycles.");
+        }
+    }
     film->prepare(channels);
 
+    /* With filter importance sampling, samples are not splatted into
+       neighboring pixels: image blocks need no filter and no border. Sample
+       weights may be negative for filters with negative lobes. */
+    bool fis = film->filter_importance_sampling();
+    const ReconstructionFilter *block_filter = fis ? nullptr : film->reconstruction_filter();
+    bool warn_negative = !has_aovs && !fis;
+
+    ray_counters_reset();
     m_render_timer.reset();
     if constexpr (!is_cuda_array_v<Float>) {
         /// Render on the CPU using a spiral pattern
@@ -97,47 +128,267 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
             m_block_size = block_size;
         }
 
-        Spiral spiral(film, m_block_size, n_passes);
+        /* When the integrator requests synchronized passes, the spiral is
+           traversed once per pass with a barrier in between. Otherwise, all
+           passes are processed by a single parallel loop. */
+        bool sync_passes = synchronize_passes();
+        size_t n_rounds = sync_passes ? n_passes : 1;
+
+        Spiral spiral(film, m_block_size, sync_passes ? 1 : n_passes);
+
+        /* Streaming films write rows to disk as soon as no further samples
+           can reach them. Generate the blocks row by row and keep track of
+           the number of pixels rendered in each row of blocks during the
+           final round, as well as the number of leading complete rows. */
+        bool streaming = film->streaming();
+        int block_rows = (film_size.y() + (int) m_block_size - 1) / (int) m_block_size;
+        std::vector<size_t> row_pixels(streaming ? block_rows : 0, 0);
+        int rows_complete = 0;
+        if (streaming)
+            spiral.set_order(Spiral::Order::Scanline);
+
+        /* Synchronized passes cover the whole image before the next one
+           starts, hence rows can only be written during the final pass */
+        if (streaming && n_rounds > 1)
+            Log(Warn, "The integrator synchronizes its %i passes, the streaming film will "
+                      "hold the entire image until the final pass.", n_rounds);
+
+        auto row_expected_pixels = [&](int row) -> size_t {
+            int height = std::min((int) m_block_size, film_size.y() - row * (int) m_block_size);
+            return (size_t) film_size.x() * (size_t) height * (sync_passes ? 1 : n_passes);
+        };
 
         ThreadEnvironment env;
         ref<ProgressReporter> progress = new ProgressReporter("Rendering");
         std::mutex mutex;
 
+        /* Unit of work handed out to the render threads: either a complete
+           block of the spiral, or an aligned quadrant of one. A quadrant
+           covers a contiguous range of Morton indices of its parent block,
+           which keeps sample generation consistent with the unsplit case. */
+        struct WorkItem {
+            ScalarPoint2i origin;    // Offset of the parent block
+            ScalarVector2i extent;   // Size of the parent block
+            size_t block_id;         // Identifier of the parent block
+            uint32_t morton_begin;   // First Morton index within the parent block
+            uint32_t side;           // Side length of the (unclipped) quadrant
+        };
+
+        /* Queue of pending quadrants. Once fewer work items remain than there
+           are threads, every fetched item is split into four quadrants so
+           that expensive blocks at the end of the frame are shared among the
+           otherwise idle threads. */
+        std::deque<WorkItem> split_queue;
+        const uint32_t min_split_size = 4;
+
+        /* Cost of the blocks of the spiral (in cycle counter ticks) and the
+           number of pixels it was measured over. When a block comes up again
+           in a later pass and cost much more than the average pixel, it is
+           split right away instead of waiting for the end of the pass. */
+        std::vector<double> block_cost(spiral.block_count(), 0.0);
+        std::vector<size_t> block_pixels(spiral.block_count(), 0);
+        double cost_total = 0.0;
+        size_t cost_pixels = 0;
+        const double split_cost_factor = 2.0;
+
         // Total number of blocks to be handled, including multiple passes.
         size_t total_blocks = spiral.block_count() * n_passes,
-               blocks_done = 0;
-
-        tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, total_blocks, 1),
-            [&](const tbb::blocked_range<size_t> &range) {
-                ScopedSetThreadEnvironment set_env(env);
-                ref<Sampler> sampler = sensor->sampler()->clone();
-                ref<ImageBlock> block = new ImageBlock(m_block_size, channels.size(),
-                                                       film->reconstruction_filter(),
-                                                       !has_aovs);
-                scoped_flush_denormals flush_denormals(true);
-                std::unique_ptr<Float[]> aovs(new Float[channels.size()]);
-
-                // For each block
-                for (auto i = range.begin(); i != range.end() && !should_stop(); ++i) {
-                    auto [offset, size, block_id] = spiral.next_block();
-                    Assert(hprod(size) != 0);
-                    block->set_size(size);
-                    block->set_offset(offset);
-
-                    render_block(scene, sensor, sampler, block,
-                                 aovs.get(), samples_per_pass, block_id);
-
-                    film->put(block);
-
-                    /* Critical section: update progress bar */ {
-                        std::lock_guard<std::mutex> lock(mutex);
-                        blocks_done++;
-                        progress->update(blocks_done / (ScalarFloat) total_blocks);
+               round_blocks = total_blocks / n_rounds,
+               blocks_fetched = 0;
+        size_t pixels_done = 0,
+               total_pixels = (size_t) hprod(film_size) * n_passes;
+
+        auto fetch = [&](WorkItem &item) -> bool {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool expensive = false;
+            if (!split_queue.empty()) {
+                item = split_queue.front();
+                split_queue.pop_front();
+            } else if (blocks_fetched < round_blocks) {
+                auto [offset, size, block_id] = spiral.next_block();
+                Assert(hprod(size) != 0);
+                blocks_fetched++;
+                item = WorkItem{ ScalarPoint2i(offset), ScalarVector2i(size), block_id,
+                                 0u, m_block_size };
+
+                size_t index = block_id % spiral.block_count();
+                expensive = block_pixels[index] > 0 &&
+                            block_cost[index] * cost_pixels >
+                                split_cost_factor * cost_total * block_pixels[index];
+            } else {
+                return false;
+            }
+
+            size_t remaining = round_blocks - blocks_fetched + split_queue.size();
+            while (m_split_blocks && (remaining < n_threads || expensive) &&
+                   item.side / 2 >= min_split_size) {
+                expensive = false;
+                uint32_t side = item.side / 2, quadrant_pixels = side * side;
+                for (uint32_t q = 1; q < 4; ++q) {
+                    WorkItem sub = item;
+                    sub.morton_begin += q * quadrant_pixels;
+                    sub.side = side;
+                    ScalarVector2i rel(enoki::morton_decode<ScalarVector2u>(sub.morton_begin));
+                    if (all(rel < item.extent)) {
+                        split_queue.push_back(sub);
+                        remaining++;
                     }
                 }
+                item.side = side;
+            }
+            return true;
+        };
+
+        /* In NUMA mode, each node accumulates its samples into an image of
+           its own, which is allocated (and thus first touched) by one of the
+           node's threads. The images are merged into the film after every
+           round. */
+        size_t numa_nodes = numa::enabled() ? numa::node_count() : 0;
+        if (numa_nodes > 0 && streaming) {
+            Log(Warn, "NUMA mode is not supported with streaming films, disabling "
+                      "the per-node images.");
+            numa_nodes = 0;
+        }
+        std::vector<ref<ImageBlock>> node_blocks(numa_nodes);
+        std::unique_ptr<std::mutex[]> node_mutex(new std::mutex[numa_nodes]);
+
+        auto put_block = [&](const ImageBlock *block) {
+            if (numa_nodes == 0) {
+                film->put(block);
+                return;
+            }
+
+            size_t node = numa::thread_node() % numa_nodes;
+            std::lock_guard<std::mutex> lock(node_mutex[node]);
+            ref<ImageBlock> &target = node_blocks[node];
+            if (!target) {
+                target = new ImageBlock(film_size, channels.size(), block_filter,
+                                        warn_negative);
+                target->set_offset(film->crop_offset());
+                target->clear();
+            }
+            target->put(block);
+        };
+
+        /* Time spent rendering by each thread of the task arena, used to
+           compute idle times. TBB may run several of the slots below on the
+           same thread, hence the time is keyed by the thread index. */
+        size_t n_arena_threads =
+            std::max(n_threads, (size_t) tbb::this_task_arena::max_concurrency());
+        std::vector<double> busy_time(n_arena_threads, 0.0);
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point render_start = Clock::now();
+
+        for (size_t round = 0; round < n_rounds && !should_stop(); ++round) {
+            if (round > 0)
+                spiral.reset();
+            blocks_fetched = 0;
+
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(0, n_threads, 1),
+                [&](const tbb::blocked_range<size_t> &range) {
+                    ScopedSetThreadEnvironment set_env(env);
+                    ref<Sampler> sampler = sensor->sampler()->clone();
+                    ref<ImageBlock> block = new ImageBlock(m_block_size, channels.size(),
+                                                           block_filter, warn_negative);
+                    scoped_flush_denormals flush_denormals(true);
+                    std::unique_ptr<Float[]> aovs(new Float[channels.size()]);
+                    double &thread_busy_time =
+                        busy_time[(size_t) tbb::this_task_arena::current_thread_index()];
+
+                    for (size_t slot = range.begin(); slot != range.end(); ++slot) {
+                        WorkItem item;
+                        while (!should_stop() && fetch(item)) {
+                            Clock::time_point start = Clock::now();
+                            uint64_t start_cycles = cycle_counter();
+
+                            ScalarVector2i rel(
+                                enoki::morton_decode<ScalarVector2u>(item.morton_begin));
+                            ScalarVector2i size = min(ScalarVector2i((int) item.side), item.extent - rel);
+                            block->set_size(size);
+                            block->set_offset(item.origin + rel);
+
+                            // Keep block identifiers unique across synchronized passes
+                            size_t block_id = item.block_id + round * spiral.block_count();
+
+                            render_block(scene, sensor, sampler, block, aovs.get(),
+                                         samples_per_pass, block_id, item.morton_begin,
+                                         item.morton_begin + item.side * item.side,
+                                         cost_channel);
+
+                            put_block(block);
+
+                            double cycles = (double) (cycle_counter() - start_cycles);
+                            thread_busy_time +=
+                                std::chrono::duration<double>(Clock::now() - start).count();
+
+                            int32_t finished_y = -1;
+
+                            /* Critical section: update block costs and progress bar */ {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                size_t index = item.block_id % spiral.block_count();
+                                block_cost[index] += cycles;
+                                block_pixels[index] += (size_t) hprod(size);
+                                cost_total += cycles;
+                                cost_pixels += (size_t) hprod(size);
+
+                                pixels_done += (size_t) hprod(size);
+                                progress->update(pixels_done / (ScalarFloat) total_pixels);
+
+                                if (streaming && round + 1 == n_rounds) {
+                                    int row = (item.origin.y() - film->crop_offset().y()) /
+                                              (int) m_block_size;
+                                    row_pixels[row] += (size_t) hprod(size);
+
+                                    int rows_before = rows_complete;
+                                    while (rows_complete < block_rows &&
+                                           row_pixels[rows_complete] ==
+                                               row_expected_pixels(rows_complete))
+                                        rows_complete++;
+
+                                    if (rows_complete != rows_before)
+                                        finished_y = film->crop_offset().y() +
+                                            std::min(rows_complete * (int) m_block_size,
+                                                     film_size.y());
+                                }
+                            }
+
+                            // Let streaming films write the completed rows
+                            if (finished_y >= 0)
+                                film->rows_finished(finished_y);
+                        }
+                    }
+                }
+            );
+
+            for (ref<ImageBlock> &node_block : node_blocks) {
+                if (node_block) {
+                    film->put(node_block);
+                    node_block->clear();
+                }
+            }
+
+            if (sync_passes && !should_stop())
+                pass_finished(round, n_passes);
+        }
+
+        // Report how much time the render threads spent waiting for work
+        double wall_time = std::chrono::duration<double>(Clock::now() - render_start).count();
+        if (wall_time > 0.0 && !should_stop()) {
+            double idle_total = 0.0, idle_max = 0.0;
+            for (size_t i = 0; i < n_arena_threads; ++i) {
+                double idle = std::max(0.0, wall_time - busy_time[i]);
+                idle_total += idle;
+                idle_max = std::max(idle_max, idle);
+                Log(Debug, "Thread %i: busy %s, idle %s", i,
+                    util::time_string((float) busy_time[i] * 1000.f, true),
+                    util::time_string((float) idle * 1000.f, true));
             }
-        );
+            Log(Info, "Thread idle time: %s on average, %s at most (%.1f%% of total thread time)",
+                util::time_string((float) (idle_total / n_arena_threads) * 1000.f, true),
+                util::time_string((float) idle_max * 1000.f, true),
+                100.0 * idle_total / (wall_time * n_arena_threads));
+        }
     } else {
         Log(Info, "Start rendering...");
 
@@ -154,8 +405,7 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
             idx /= (uint32_t) samples_per_pass;
 
         ref<ImageBlock> block = new ImageBlock(film_size, channels.size(),
-                                               film->reconstruction_filter(),
-                                               !has_aovs);
+                                               block_filter, warn_negative);
         block->clear();
         block->set_offset(sensor->film()->crop_offset());
 
@@ -167,58 +417,79 @@ MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::render(Scene *scene, Senso
 
         for (size_t i = 0; i < n_passes; i++)
             render_sample(scene, sensor, sampler, block, aovs.data(),
-                          pos, diff_scale_factor);
+                          pos, diff_scale_factor, cost_channel);
 
         film->put(block);
     }
 
-    if (!m_stop)
-        Log(Info, "Rendering finished. (took %s)",
-            util::time_string(m_render_timer.value(), true));
+    if (!m_stop) {
+        size_t render_time = m_render_timer.value();
+        Log(Info, "Rendering finished. (took %s)", util::time_string(render_time, true));
+        if (ray_counters_enabled())
+            Log(Info, "%s", ray_counters().to_string(render_time / 1000.0));
+    }
 
     return !m_stop;
 }
 
+MTS_VARIANT bool SamplingIntegrator<Float, Spectrum>::synchronize_passes() const {
+    return false;
+}
+
+MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::pass_finished(size_t /* pass */,
+                                                                    size_t /* pass_count */) { }
+
 MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *scene,
                                                                    const Sensor *sensor,
                                                                    Sampler *sampler,
                                                                    ImageBlock *block,
                                                                    Float *aovs,
                                                                    size_t sample_count_,
-                                                                   size_t block_id) const {
+                                                                   size_t block_id,
+                                                                   uint32_t morton_begin,
+                                                                   uint32_t morton_end,
+                                                                   size_t cost_channel) const {
     block->clear();
     uint32_t pixel_count  = (uint32_t)(m_block_size * m_block_size),
              sample_count = (uint32_t)(sample_count_ == (size_t) -1
                                            ? sampler->sample_count()
                                            : sample_count_);
 
+    if (morton_end == 0 || morton_end > pixel_count)
+        morton_end = pixel_count;
+
+    // Position of the first pixel relative to the parent block
+    ScalarVector2u base = enoki::morton_decode<ScalarVector2u>(morton_begin);
+
     ScalarFloat diff_scale_factor = rsqrt((ScalarFloat) sampler->sample_count());
 
     if constexpr (!is_array_v<Float>) {
-        for (uint32_t i = 0; i < pixel_count && !should_stop(); ++i) {
+        for (uint32_t i = morton_begin; i < morton_end && !should_stop(); ++i) {
             sampler->seed(block_id * pixel_count + i);
 
-            ScalarPoint2u pos = enoki::morton_decode<ScalarPoint2u>(i);
+            ScalarPoint2u pos = enoki::morton_decode<ScalarPoint2u>(i) - base;
             if (any(pos >= block->size()))
                 continue;
 
             pos += block->offset();
             for (uint32_t j = 0; j < sample_count && !should_stop(); ++j) {
                 render_sample(scene, sensor, sampler, block, aovs,
-                              pos, diff_scale_factor);
+                              pos, diff_scale_factor, cost_channel);
             }
         }
     } else if constexpr (is_array_v<Float> && !is_cuda_array_v<Float>) {
         // Ensure that the sample generation is fully deterministic
-        sampler->seed(block_id);
+        sampler->seed(block_id + ((uint64_t) morton_begin << 32));
 
-        for (auto [index, active] : range<UInt32>(pixel_count * sample_count)) {
+        for (auto [index, active] : range<UInt32>((morton_end - morton_begin) * sample_count)) {
             if (should_stop())
                 break;
-            Point2u pos = enoki::morton_decode<Point2u>(index / UInt32(sample_count));
+            Point2u pos = enoki::morton_decode<Point2u>(index / UInt32(sample_count) + morton_begin) -
+                          Vector2u(base);
             active &= !any(pos >= block->size());
             pos += block->offset();
-            render_sample(scene, sensor, sampler, block, aovs, pos, diff_scale_factor, active);
+            render_sample(scene, sensor, sampler, block, aovs, pos, diff_scale_factor,
+                          cost_channel, active);
         }
     } else {
         ENOKI_MARK_USED(scene);
@@ -227,6 +498,8 @@ MTS_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *
         ENOKI_MARK_USED(diff_scale_factor);
         ENOKI_MARK_USED(pixel_count);
         ENOKI_MARK_USED(sample_count);
+        ENOKI_MARK_USED(base);
+        ENOKI_MARK_USED(cost_channel);
         Throw("Not implemented for CUDA arrays.");
     }
 }
@@ -239,8 +512,31 @@ SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
                                                    Float *aovs,
                                                    const Vector2f &pos,
                                                    ScalarFloat diff_scale_factor,
+                                                   size_t cost_channel,
                                                    Mask active) const {
-    Vector2f position_sample = pos + sampler->next_2d(active);
+    const Film *film = sensor->film();
+    Vector2f position_sample;
+    Float sample_weight = 1.f;
+
+    uint64_t cost_cycles = 0, cost_rays = 0;
+    if constexpr (!is_cuda_array_v<Float>) {
+        if (cost_channel != 0) {
+            cost_cycles = cycle_counter();
+            cost_rays = thread_ray_count();
+        }
+    }
+
+    if (film->filter_importance_sampling()) {
+        // Distribute the sample around the pixel center according to the filter
+        const ReconstructionFilter *rfilter = film->reconstruction_filter();
+        Point2f filter_sample = sampler->next_2d(active);
+        auto [dx, wx] = rfilter->sample(filter_sample.x(), active);
+        auto [dy, wy] = rfilter->sample(filter_sample.y(), active);
+        position_sample = pos + .5f + Vector2f(dx, dy);
+        sample_weight = wx * wy;
+    } else {
+        position_sample = pos + sampler->next_2d(active);
+    }
 
     Point2f aperture_sample(.5f);
     if (sensor->needs_aperture_sample())
@@ -253,8 +549,7 @@ SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
     Float wavelength_sample = sampler->next_1d(active);
 
     Vector2f adjusted_position =
-        (position_sample - sensor->film()->crop_offset()) /
-        sensor->film()->crop_size();
+        (position_sample - film->crop_offset()) / film->crop_size();
 
     auto [ray, ray_weight] = sensor->sample_ray_differential(
         time, wavelength_sample, adjusted_position, aperture_sample);
@@ -283,7 +578,33 @@ SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
     aovs[3] = select(result.second, Float(1.f), Float(0.f));
     aovs[4] = 1.f;
 
-    block->put(position_sample, aovs, active);
+    if constexpr (!is_cuda_array_v<Float>) {
+        if (cost_channel != 0) {
+            // The cost of a packet is shared evenly among its active lanes
+            ScalarFloat inv_lanes = 1.f;
+            if constexpr (is_array_v<Float>)
+                inv_lanes = 1.f / (ScalarFloat) std::max(count(active), (size_t) 1);
+
+            // Thousands of cycles, which keeps the values in range of half floats
+            aovs[cost_channel] =
+                (ScalarFloat) (cycle_counter() - cost_cycles) * (1e-3f * inv_lanes);
+            if (ray_counters_enabled())
+                aovs[cost_channel + 1] =
+                    (ScalarFloat) (thread_ray_count() - cost_rays) * inv_lanes;
+        }
+    }
+
+    if (film->filter_importance_sampling()) {
+        // The sample only contributes to the pixel it was generated for
+        size_t channel_count = block->channel_count();
+        if (any(sample_weight != 1.f)) {
+            for (size_t i = 0; i < channel_count; ++i)
+                aovs[i] *= sample_weight;
+        }
+        block->put(pos + .5f, aovs, active);
+    } else {
+        block->put(position_sample, aovs, active);
+    }
 
     sampler->advance();
 }
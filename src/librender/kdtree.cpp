@@ -1,6 +1,9 @@
 #include <mitsuba/render/kdtree.h>
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/thread.h>
+#include <limits>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -26,13 +29,17 @@ MTS_VARIANT ShapeKDTree<Float, Spectrum>::ShapeKDTree(const Properties &props)
         set_max_depth(props.int_("kd_max_depth"));
 
     /* kd-tree construction: Number of bins used by the min-max binning method */
-    if (props.has_property("kd_min_max_bins"))
+    if (props.has_property("kd_min_max_bins")) {
         set_min_max_bins(props.int_("kd_min_max_bins"));
+        m_fixed_bins = true;
+    }
 
     /* kd-tree construction: Enable primitive clipping? Generally leads to a
       significant improvement of the resulting tree. */
-    if (props.has_property("kd_clip"))
+    if (props.has_property("kd_clip")) {
         set_clip_primitives(props.bool_("kd_clip"));
+        m_fixed_clip = true;
+    }
 
     /* kd-tree construction: specify whether or not bad splits can be "retracted". */
     if (props.has_property("kd_retract_bad_splits"))
@@ -41,16 +48,132 @@ MTS_VARIANT ShapeKDTree<Float, Spectrum>::ShapeKDTree(const Properties &props)
     /* kd-tree construction: Specify the number of primitives, at which the
        builder will switch from (approximate) Min-Max binning to the accurate
        O(n log n) SAH-based optimization method. */
-    if (props.has_property("kd_exact_primitive_threshold"))
+    if (props.has_property("kd_exact_primitive_threshold")) {
         set_exact_primitive_threshold(props.int_("kd_exact_primitive_threshold"));
+        m_fixed_exact = true;
+    }
+
+    /* kd-tree construction: Specify the number of primitives, starting at which
+       the O(n log n) method processes nodes in parallel (0 == disabled). */
+    if (props.has_property("kd_parallel_exact_threshold"))
+        set_parallel_exact_threshold(props.int_("kd_parallel_exact_threshold"));
+
+    /* kd-tree construction: Quality preset (fast, balanced, high or auto).
+       The three parameters above override the corresponding preset values. */
+    std::string quality = string::to_lower(props.string("kd_quality", "balanced"));
+    if (quality == "auto")
+        m_quality = KDBuildQuality::Auto;
+    else if (quality == "fast")
+        m_quality = KDBuildQuality::Fast;
+    else if (quality == "balanced")
+        m_quality = KDBuildQuality::Balanced;
+    else if (quality == "high")
+        m_quality = KDBuildQuality::High;
+    else
+        Throw("Invalid kd-tree quality preset \"%s\", must be one of: \"fast\", "
+              "\"balanced\", \"high\", or \"auto\"!", quality);
+
+    /* kd-tree construction: Expected number of ray queries per rendered sample
+       (used by the "auto" quality preset) */
+    m_rays_per_sample = props.float_("kd_rays_per_sample", 4.f);
+
+    /* kd-tree update: Rebuild the tree from scratch once incremental updates
+       have increased its expected query cost by this factor. */
+    if (props.has_property("kd_rebuild_threshold"))
+        m_rebuild_threshold = props.float_("kd_rebuild_threshold");
 
     m_primitive_map.push_back(0);
 }
 
+/**
+ * Parameters of the kd-tree build quality presets
+ *
+ * The timing constants are coarse estimates, not measurements of a particular
+ * machine. \c build_ns follows the work per primitive of each preset (number
+ * of min-max bins, primitive clipping and the share of the O(N log N)
+ * builder), scaled so that the balanced preset builds roughly a million
+ * primitives per second on one core. \c relative_cost is the typical ratio
+ * of the SAH cost of the resulting trees. predict_cost() only uses them to
+ * rank the presets against each other.
+ */
+struct KDBuildPreset {
+    const char *name;
+    uint32_t min_max_bins;
+    bool clip_primitives;
+    uint32_t exact_primitive_threshold;
+    /// Build time per primitive and tree level (nanoseconds, single core)
+    double build_ns;
+    /// Expected query cost relative to the balanced preset
+    double relative_cost;
+};
+
+static const KDBuildPreset kd_build_presets[] = {
+    { "auto",     128, true,  65536,   0.0,  1.0  },
+    { "fast",     32,  false, 16,      10.0, 1.3  },
+    { "balanced", 128, true,  65536,   40.0, 1.0  },
+    { "high",     256, true,  1 << 22, 90.0, 0.93 }
+};
+
+/// Approximate time of a ray query per unit of the surface area heuristic (ns)
+static const double kd_ns_per_cost_unit = 0.5;
+
+MTS_VARIANT std::pair<double, double>
+ShapeKDTree<Float, Spectrum>::predict_cost(KDBuildQuality quality) const {
+    const KDBuildPreset &preset = kd_build_presets[(uint32_t) quality];
+    double prim_count = std::max((double) primitive_count(), 2.0),
+           levels     = std::log2(prim_count),
+           threads    = std::max((double) __global_thread_count, 1.0);
+
+    /* The top levels of the tree are built in parallel, which is less
+       effective for small trees */
+    double build_time =
+        preset.build_ns * 1e-9 * prim_count * levels / std::sqrt(threads);
+
+    /* SAH cost of a well-balanced tree: one traversal step per level,
+       followed by a few intersection tests in the leaf */
+    const SurfaceAreaHeuristic3f &model = cost_model();
+    double sah_cost = model.traversal_cost() * levels +
+                      model.query_cost() * stop_primitives();
+
+    return { build_time, preset.relative_cost * sah_cost * kd_ns_per_cost_unit };
+}
+
+MTS_VARIANT void ShapeKDTree<Float, Spectrum>::apply_build_quality(KDBuildQuality quality) {
+    const KDBuildPreset &preset = kd_build_presets[(uint32_t) quality];
+    if (!m_fixed_bins)
+        set_min_max_bins(preset.min_max_bins);
+    if (!m_fixed_clip)
+        set_clip_primitives(preset.clip_primitives);
+    if (!m_fixed_exact)
+        set_exact_primitive_threshold(
+            std::max(preset.exact_primitive_threshold, stop_primitives() + 1));
+}
+
 MTS_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
     Timer timer;
-    Log(Info, "Building a SAH kd-tree (%i primitives) ..",
-        primitive_count());
+
+    KDBuildQuality quality = m_quality;
+    double rays = m_sample_budget * m_rays_per_sample;
+    if (quality == KDBuildQuality::Auto) {
+        /* Pick the preset minimizing the total time spent building the tree
+           and tracing the expected number of rays */
+        double best_time = std::numeric_limits<double>::infinity();
+        for (KDBuildQuality q : { KDBuildQuality::Fast, KDBuildQuality::Balanced,
+                                  KDBuildQuality::High }) {
+            auto [build_time, ray_cost] = predict_cost(q);
+            double time = build_time + rays * ray_cost * 1e-9;
+            if (time < best_time) {
+                best_time = time;
+                quality = q;
+            }
+        }
+    }
+    apply_build_quality(quality);
+
+    auto [predicted_time, predicted_ray_cost] = predict_cost(quality);
+
+    Log(Info, "Building a SAH kd-tree (%i primitives, %s quality) ..",
+        primitive_count(), kd_build_presets[(uint32_t) quality].name);
 
     Base::build();
 
@@ -59,6 +182,76 @@ MTS_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
                         m_node_count * sizeof(KDNode)),
         util::time_string(timer.value())
     );
+
+    // The predicted ray cost is a scaled SAH cost, compare it to that of the built tree
+    double sah_cost = (double) expected_cost();
+    Log(m_quality == KDBuildQuality::Balanced ? Debug : Info,
+        "kd-tree build time: %s (predicted: %s), SAH cost: %.2f (predicted: %.2f), "
+        "ray cost: %.1f ns (predicted: %.1f ns)%s", util::time_string(timer.value()),
+        util::time_string((float) (predicted_time * 1000.0)),
+        sah_cost, predicted_ray_cost / kd_ns_per_cost_unit,
+        sah_cost * kd_ns_per_cost_unit, predicted_ray_cost,
+        rays > 0 ? tfm::format(", budget: %.3g rays", rays) : std::string());
+}
+
+MTS_VARIANT typename ShapeKDTree<Float, Spectrum>::ScalarFloat
+ShapeKDTree<Float, Spectrum>::update(const std::vector<Shape *> &shapes) {
+    Timer timer;
+    std::vector<std::pair<Index, Index>> ranges;
+    bool full_rebuild = false;
+
+    for (Shape *shape : shapes) {
+        auto it = std::find_if(m_shapes.begin(), m_shapes.end(),
+                               [shape](const ref<Shape> &s) { return s.get() == shape; });
+        if (it == m_shapes.end())
+            continue;
+
+        Size i = Size(it - m_shapes.begin());
+        ranges.emplace_back(m_primitive_map[i], m_primitive_map[i + 1]);
+
+        // The primitive index space changes when primitives are added or removed
+        if (m_primitive_map[i + 1] - m_primitive_map[i] != shape->primitive_count())
+            full_rebuild = true;
+    }
+
+    if (ranges.empty())
+        return 1.f;
+
+    ScalarFloat ratio = 1.f;
+    if (!full_rebuild) {
+        ratio = Base::update(ranges);
+        if (ratio > m_rebuild_threshold) {
+            Log(Info, "kd-tree update: expected cost is %.1f%% higher than after a "
+                "full rebuild, rebuilding ..", (ratio - 1.f) * 100.f);
+            full_rebuild = true;
+        } else {
+            Log(Info, "Updated kd-tree (%i changed shapes, expected cost is %.1f%% "
+                "higher than after a full rebuild, took %s)", ranges.size(),
+                (ratio - 1.f) * 100.f, util::time_string(timer.value()));
+        }
+    }
+
+    if (full_rebuild) {
+        rebuild();
+        ratio = 1.f;
+    }
+
+    return ratio;
+}
+
+MTS_VARIANT void ShapeKDTree<Float, Spectrum>::rebuild() {
+    std::vector<ref<Shape>> shapes;
+    shapes.swap(m_shapes);
+
+    m_nodes.reset();
+    m_indices.reset();
+    m_node_count = m_index_count = 0;
+    m_primitive_map.resize(1);
+    m_bbox.reset();
+
+    for (Shape *shape : shapes)
+        add_shape(shape);
+    build();
 }
 
 MTS_VARIANT void ShapeKDTree<Float, Spectrum>::add_shape(Shape *shape) {
@@ -2,6 +2,7 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/phase.h>
+#include <mitsuba/render/sampler.h>
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/texture.h>
 
@@ -88,6 +89,80 @@ Medium<Float, Spectrum>::eval_tr_and_pdf(const MediumInteraction3f &mi,
     return { tr, pdf };
 }
 
+MTS_VARIANT
+std::pair<typename Medium<Float, Spectrum>::UnpolarizedSpectrum,
+          typename Medium<Float, Spectrum>::UnpolarizedSpectrum>
+Medium<Float, Spectrum>::get_control_extinction(const MediumInteraction3f &mi,
+                                                Mask active) const {
+    return { UnpolarizedSpectrum(0.f), get_combined_extinction(mi, active) };
+}
+
+MTS_VARIANT
+typename Medium<Float, Spectrum>::UnpolarizedSpectrum
+Medium<Float, Spectrum>::eval_tr_residual_ratio(const Ray3f &ray, Sampler *sampler,
+                                                UInt32 channel, Mask active) const {
+    MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+
+    MediumInteraction3f mi;
+    mi.sh_frame    = Frame3f(ray.d);
+    mi.wi          = -ray.d;
+    mi.time        = ray.time;
+    mi.wavelengths = ray.wavelengths;
+    mi.medium      = this;
+
+    auto [aabb_its, mint, maxt] = intersect_aabb(ray);
+    aabb_its &= (enoki::isfinite(mint) || enoki::isfinite(maxt));
+    active &= aabb_its;
+    mint = max(ray.mint, mint);
+    maxt = min(ray.maxt, maxt);
+    active &= mint < maxt;
+
+    auto [control, residual] = get_control_extinction(mi, active);
+    Float m = residual[0];
+    if constexpr (is_rgb_v<Spectrum>) { // Handle RGB rendering
+        masked(m, eq(channel, 1u)) = residual[1];
+        masked(m, eq(channel, 2u)) = residual[2];
+    } else {
+        ENOKI_MARK_USED(channel);
+    }
+
+    // Analytic transmittance of the control extinction
+    UnpolarizedSpectrum tr(1.f);
+    masked(tr, active) = exp(-(maxt - mint) * control);
+    mi.mint = mint;
+
+    // Ratio tracking of the residual extinction
+    Float t = mint;
+    active &= m > 0.f;
+    while (any(active)) {
+        masked(t, active) = t - enoki::log(1.f - sampler->next_1d(active)) / m;
+        active &= t < maxt;
+        if (none(active))
+            break;
+
+        masked(mi.t, active) = t;
+        masked(mi.p, active) = ray(t);
+        auto [sigma_s, sigma_n, sigma_t] = get_scattering_coefficients(mi, active);
+        ENOKI_MARK_USED(sigma_s);
+        ENOKI_MARK_USED(sigma_n);
+        masked(tr, active) *= 1.f - (sigma_t - control) / m;
+        active &= any(neq(tr, 0.f));
+    }
+
+    return tr;
+}
+
+bool use_residual_ratio_tracking(const Properties &props) {
+    std::string tr_mode = props.string("transmittance", "ratio");
+    if (tr_mode == "residual_ratio")
+        return true;
+    else if (tr_mode == "ratio")
+        return false;
+    else
+        Throw("Invalid \"transmittance\" value \"%s\", must be \"ratio\" or "
+              "\"residual_ratio\"!", tr_mode);
+}
+
 MTS_IMPLEMENT_CLASS_VARIANT(Medium, Object, "medium")
 MTS_INSTANTIATE_CLASS(Medium)
 NAMESPACE_END(mitsuba)
@@ -1,4 +1,7 @@
+#include <mitsuba/core/bundle.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/hugepages.h>
+#include <mitsuba/core/numa.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/util.h>
@@ -8,6 +11,7 @@
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/render/records.h>
 #include <mitsuba/render/scene.h>
+#include <enoki/half.h>
 #include <mutex>
 
 #if defined(MTS_ENABLE_EMBREE)
@@ -29,6 +33,12 @@ MTS_VARIANT Mesh<Float, Spectrum>::Mesh(const Properties &props) : Base(props) {
        appearance. Default: ``false`` */
     if (props.bool_("face_normals", false))
         m_disable_vertex_normals = true;
+
+    /* When set to ``true``, vertex normals and texture coordinates are stored
+       in a compact quantized layout (see \ref compact_storage()). Face indices
+       additionally use 16 bits for small meshes if ``compact_faces`` is set. */
+    m_compact_requested = props.bool_("compact_storage", false);
+    m_compact_faces_requested = props.bool_("compact_faces", false);
 }
 
 MTS_VARIANT
@@ -139,6 +149,8 @@ MTS_VARIANT void Mesh<Float, Spectrum>::write_ply(const std::string &filename) c
     const InputFloat* position_ptr = m_vertex_positions_buf.data();
     const InputFloat* normal_ptr   = m_vertex_normals_buf.data();
     const InputFloat* texcoord_ptr = m_vertex_texcoords_buf.data();
+    const uint32_t* normal_oct_ptr    = m_vertex_normals_oct_buf.data();
+    const uint32_t* texcoord_half_ptr = m_vertex_texcoords_half_buf.data();
 
     std::vector<const InputFloat*> vertex_attributes_ptr;
     for (const auto&[name, attribute]: vertex_attributes)
@@ -149,12 +161,18 @@ MTS_VARIANT void Mesh<Float, Spectrum>::write_ply(const std::string &filename) c
         stream->write(position_ptr, 3 * sizeof(InputFloat));
         position_ptr += 3;
         // Write normals
-        if (has_vertex_normals()) {
+        if (m_compact_normals) {
+            InputNormal3f n = decode_normal(normal_oct_ptr[i]);
+            stream->write(n.data(), 3 * sizeof(InputFloat));
+        } else if (has_vertex_normals()) {
             stream->write(normal_ptr, 3 * sizeof(InputFloat));
             normal_ptr += 3;
         }
         // Write texture coordinates
-        if (has_vertex_texcoords()) {
+        if (m_compact_texcoords) {
+            Point<InputFloat, 2> uv = decode_texcoord(texcoord_half_ptr[i]);
+            stream->write(uv.data(), 2 * sizeof(InputFloat));
+        } else if (has_vertex_texcoords()) {
             stream->write(texcoord_ptr, 2 * sizeof(InputFloat));
             texcoord_ptr += 2;
         }
@@ -179,8 +197,13 @@ MTS_VARIANT void Mesh<Float, Spectrum>::write_ply(const std::string &filename) c
         stream->write(&vertex_indices_count, sizeof(uint8_t));
 
         // Write positions
-        stream->write(face_ptr, 3 * sizeof(ScalarIndex));
-        face_ptr += 3;
+        if (m_compact_faces) {
+            auto fi = face_indices((ScalarIndex) i);
+            stream->write(fi.data(), 3 * sizeof(ScalarIndex));
+        } else {
+            stream->write(face_ptr, 3 * sizeof(ScalarIndex));
+            face_ptr += 3;
+        }
 
         for (size_t j = 0; j < face_attributes_ptr.size(); ++j) {
             const auto&[name, attribute] = face_attributes[j];
@@ -246,7 +269,10 @@ MTS_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
                 invalid_counter++;
             }
 
-            store(m_vertex_normals_buf.data() + 3 * i, n);
+            if (m_compact_normals)
+                m_vertex_normals_oct_buf.data()[i] = encode_normal(n);
+            else
+                store(m_vertex_normals_buf.data() + 3 * i, n);
         }
 
         if (invalid_counter > 0)
@@ -282,6 +308,127 @@ MTS_VARIANT void Mesh<Float, Spectrum>::recompute_bbox() {
         m_bbox.expand(vertex_position(i));
 }
 
+MTS_VARIANT uint32_t Mesh<Float, Spectrum>::encode_normal(const InputNormal3f &n_) {
+    InputFloat l1 = abs(n_.x()) + abs(n_.y()) + abs(n_.z());
+    if (unlikely(!(l1 > 0.f)))
+        return encode_normal(InputNormal3f(0.f, 0.f, 1.f));
+
+    InputNormal3f n = n_ / l1;
+    InputFloat x = n.x(), y = n.y();
+
+    // Fold the lower hemisphere over the diagonals of the octahedron
+    if (n.z() < 0.f) {
+        x = (1.f - std::abs(n.y())) * (n.x() >= 0.f ? 1.f : -1.f);
+        y = (1.f - std::abs(n.x())) * (n.y() >= 0.f ? 1.f : -1.f);
+    }
+
+    auto quantize = [](InputFloat v) {
+        return (uint32_t) std::round(clamp(fmadd(v, .5f, .5f), 0.f, 1.f) * 65535.f);
+    };
+
+    return quantize(x) | (quantize(y) << 16);
+}
+
+MTS_VARIANT uint32_t Mesh<Float, Spectrum>::encode_texcoord(const InputVector2f &uv) {
+    return (uint32_t) enoki::half::float32_to_float16(uv.x()) |
+           ((uint32_t) enoki::half::float32_to_float16(uv.y()) << 16);
+}
+
+MTS_VARIANT void Mesh<Float, Spectrum>::compact_storage(bool compact_faces) {
+    if constexpr (is_dynamic_v<Float>) {
+        ENOKI_MARK_USED(compact_faces);
+        Log(Warn, "\"%s\": compact mesh storage is only supported by the CPU "
+                  "variants of the renderer, ignoring.", m_name);
+    } else {
+        size_t bytes_before = m_vertex_count * vertex_data_bytes() +
+                              m_face_count * face_data_bytes();
+
+        if (slices(m_vertex_normals_buf) != 0) {
+            m_vertex_normals_oct_buf = empty<DynamicBuffer<UInt32>>(m_vertex_count);
+            uint32_t *out = m_vertex_normals_oct_buf.data();
+            const InputFloat *in = m_vertex_normals_buf.data();
+            for (ScalarSize i = 0; i < m_vertex_count; ++i)
+                out[i] = encode_normal(load_unaligned<InputNormal3f>(in + 3 * i));
+            m_vertex_normals_buf = FloatStorage();
+            m_compact_normals = true;
+        }
+
+        if (slices(m_vertex_texcoords_buf) != 0) {
+            m_vertex_texcoords_half_buf = empty<DynamicBuffer<UInt32>>(m_vertex_count);
+            uint32_t *out = m_vertex_texcoords_half_buf.data();
+            const InputFloat *in = m_vertex_texcoords_buf.data();
+            for (ScalarSize i = 0; i < m_vertex_count; ++i)
+                out[i] = encode_texcoord(load_unaligned<InputVector2f>(in + 2 * i));
+            m_vertex_texcoords_buf = FloatStorage();
+            m_compact_texcoords = true;
+        }
+
+#if defined(MTS_ENABLE_EMBREE)
+        // Embree requires 32 bit indices
+        if (compact_faces)
+            Log(Debug, "\"%s\": 16 bit face indices are not supported by Embree.", m_name);
+        compact_faces = false;
+#endif
+
+        if (compact_faces && !m_compact_faces && m_vertex_count <= 0x10000u) {
+            size_t index_count = m_face_count * 3;
+            m_faces_short_buf = zero<DynamicBuffer<UInt32>>((index_count + 1) / 2);
+            uint32_t *out = m_faces_short_buf.data();
+            const ScalarIndex *in = m_faces_buf.data();
+            for (size_t k = 0; k < index_count; ++k)
+                out[k >> 1] |= in[k] << ((k & 1) << 4);
+            m_faces_buf = DynamicBuffer<UInt32>();
+            m_compact_faces = true;
+        }
+
+        size_t bytes_after = m_vertex_count * vertex_data_bytes() +
+                             m_face_count * face_data_bytes();
+
+        Log(Debug, "\"%s\": compacted mesh storage (%s -> %s)", m_name,
+            util::mem_string(bytes_before), util::mem_string(bytes_after));
+    }
+}
+
+MTS_VARIANT void Mesh<Float, Spectrum>::interleave_memory() const {
+    if constexpr (!is_dynamic_v<Float>) {
+        auto interleave = [](const auto &buf) {
+            if (slices(buf) != 0)
+                numa::interleave(buf.data(), slices(buf) * sizeof(*buf.data()));
+        };
+
+        interleave(m_vertex_positions_buf);
+        interleave(m_vertex_normals_buf);
+        interleave(m_vertex_texcoords_buf);
+        interleave(m_faces_buf);
+        interleave(m_vertex_normals_oct_buf);
+        interleave(m_vertex_texcoords_half_buf);
+        interleave(m_faces_short_buf);
+    }
+}
+
+MTS_VARIANT void Mesh<Float, Spectrum>::move_to_huge_pages() {
+    if constexpr (!is_dynamic_v<Float>) {
+        auto move = [&](auto &buf) {
+            using Buffer = std::decay_t<decltype(buf)>;
+            using Value = scalar_t<Buffer>;
+            ref<HugePageBuffer> storage =
+                HugePageBuffer::copy_large(buf.data(), slices(buf) * sizeof(Value));
+            if (!storage)
+                return;
+            buf = Buffer::map(storage->data(), slices(buf));
+            m_huge_page_storage.push_back(storage.get());
+        };
+
+        move(m_vertex_positions_buf);
+        move(m_vertex_normals_buf);
+        move(m_vertex_texcoords_buf);
+        move(m_faces_buf);
+        move(m_vertex_normals_oct_buf);
+        move(m_vertex_texcoords_half_buf);
+        move(m_faces_short_buf);
+    }
+}
+
 MTS_VARIANT void Mesh<Float, Spectrum>::build_pmf() {
     std::lock_guard<tbb::spin_mutex> lock(m_mutex);
 
@@ -324,6 +471,8 @@ MTS_VARIANT void Mesh<Float, Spectrum>::build_parameterization() {
         new Mesh(m_name + "_param", m_vertex_count, m_face_count,
                  props, false, false);
     mesh->m_faces_buf = m_faces_buf;
+    mesh->m_faces_short_buf = m_faces_short_buf;
+    mesh->m_compact_faces = m_compact_faces;
 
     ScalarFloat *pos_out = (ScalarFloat *) mesh->m_vertex_positions_buf.data();
     for (size_t i = 0; i < m_vertex_count; ++i) {
@@ -738,6 +887,9 @@ MTS_VARIANT std::string Mesh<Float, Spectrum>::to_string() const {
         << "  face_count = " << m_face_count << "," << std::endl
         << "  faces = [" << util::mem_string(face_data_bytes() * m_face_count) << " of face data]," << std::endl;
 
+    if (has_compact_storage())
+        oss << "  compact_storage = 1," << std::endl;
+
     if (!m_area_pmf.empty())
         oss << "  surface_area = " << m_area_pmf.sum() << "," << std::endl;
 
@@ -762,9 +914,14 @@ MTS_VARIANT std::string Mesh<Float, Spectrum>::to_string() const {
 MTS_VARIANT size_t Mesh<Float, Spectrum>::vertex_data_bytes() const {
     size_t vertex_data_bytes = 3 * sizeof(InputFloat);
 
-    if (has_vertex_normals())
+    if (m_compact_normals)
+        vertex_data_bytes += sizeof(uint32_t);
+    else if (has_vertex_normals())
         vertex_data_bytes += 3 * sizeof(InputFloat);
-    if (has_vertex_texcoords())
+
+    if (m_compact_texcoords)
+        vertex_data_bytes += sizeof(uint32_t);
+    else if (has_vertex_texcoords())
         vertex_data_bytes += 2 * sizeof(InputFloat);
 
     for (const auto&[name, attribute]: m_mesh_attributes)
@@ -775,7 +932,7 @@ MTS_VARIANT size_t Mesh<Float, Spectrum>::vertex_data_bytes() const {
 }
 
 MTS_VARIANT size_t Mesh<Float, Spectrum>::face_data_bytes() const {
-    size_t face_data_bytes = 3 * sizeof(ScalarIndex);
+    size_t face_data_bytes = 3 * (m_compact_faces ? sizeof(uint16_t) : sizeof(ScalarIndex));
 
     for (const auto&[name, attribute]: m_mesh_attributes)
         if (attribute.type == MeshAttributeType::Face)
@@ -784,6 +941,64 @@ MTS_VARIANT size_t Mesh<Float, Spectrum>::face_data_bytes() const {
     return face_data_bytes;
 }
 
+MTS_VARIANT MemoryUsage Mesh<Float, Spectrum>::memory_usage() const {
+    return {
+        { "vertex data", m_vertex_count * vertex_data_bytes() },
+        { "face data", m_face_count * face_data_bytes() },
+        { "sampling tables", (slices(m_area_pmf.pmf()) + slices(m_area_pmf.cdf())) *
+                                 sizeof(ScalarFloat) }
+    };
+}
+
+MTS_VARIANT bool Mesh<Float, Spectrum>::write_bundle(SceneBundleWriter *writer,
+                                                     Properties &props) const {
+    Properties result("bundlemesh");
+    result.set_id(props.id());
+
+    // Keep references to child objects (BSDF, emitter, media, ..)
+    for (const auto &[name, target] : props.named_references())
+        result.set_named_reference(name, target);
+
+    /* Loaders apply 'to_world' to the vertex positions, but the transform
+       is also retained by the Shape base class */
+    for (const char *name : { "to_world", "face_normals" }) {
+        if (props.has_property(name))
+            result.copy_attribute(props, name, name);
+    }
+
+    auto add_buffer = [&](const std::string &name, const auto &buf) {
+        if (slices(buf) == 0)
+            return;
+        // Make GPU-resident data accessible to the host
+        auto host = buf;
+        host = host.managed();
+        if constexpr (is_cuda_array_v<Float>)
+            cuda_sync();
+        result.set_long(name, writer->add_blob(host.data(),
+                                               slices(host) * sizeof(*host.data())));
+    };
+
+    result.set_string("name", m_name);
+    result.set_long("vertex_count", (int64_t) m_vertex_count);
+    result.set_long("face_count", (int64_t) m_face_count);
+
+    add_buffer("positions", m_vertex_positions_buf);
+    add_buffer("normals", m_vertex_normals_buf);
+    add_buffer("texcoords", m_vertex_texcoords_buf);
+    add_buffer("faces", m_faces_buf);
+    add_buffer("normals_oct", m_vertex_normals_oct_buf);
+    add_buffer("texcoords_half", m_vertex_texcoords_half_buf);
+    add_buffer("faces_short", m_faces_short_buf);
+
+    for (const auto &[name, attribute] : m_mesh_attributes) {
+        add_buffer("attribute_" + name, attribute.buf);
+        result.set_long("attribute_" + name + "_size", (int64_t) attribute.size);
+    }
+
+    props = result;
+    return true;
+}
+
 #if defined(MTS_ENABLE_EMBREE)
 MTS_VARIANT RTCGeometry Mesh<Float, Spectrum>::embree_geometry(RTCDevice device) {
     RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
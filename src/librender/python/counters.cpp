@@ -0,0 +1,23 @@
+#include <mitsuba/render/counters.h>
+#include <mitsuba/python/python.h>
+
+MTS_PY_EXPORT(RayCounters) {
+    py::class_<RayCounters>(m, "RayCounters", D(RayCounters))
+        .def_property_readonly("values", [](const RayCounters &c) {
+            py::dict result;
+            for (uint32_t i = 0; i < uint32_t(Counter::CounterCount); ++i)
+                result[counter_id[i]] = c.values[i];
+            return result;
+        }, D(RayCounters, values))
+        .def_method(RayCounters, rays)
+        .def_method(RayCounters, nodes_per_ray)
+        .def_method(RayCounters, primitives_per_ray)
+        .def_method(RayCounters, lane_utilization)
+        .def("to_string", &RayCounters::to_string, "seconds"_a = 0.0,
+             D(RayCounters, to_string))
+        .def("__repr__", [](const RayCounters &c) { return c.to_string(); });
+
+    m.def("ray_counters_enabled", &ray_counters_enabled, D(ray_counters_enabled));
+    m.def("ray_counters", &ray_counters, D(ray_counters));
+    m.def("ray_counters_reset", &ray_counters_reset, D(ray_counters_reset));
+}
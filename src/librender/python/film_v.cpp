@@ -20,6 +20,8 @@ MTS_PY_EXPORT(Film) {
             "offset"_a, "size"_a, "target_offset"_a, "target"_a)
         .def_method(Film, destination_exists, "basename"_a)
         .def_method(Film, bitmap, "raw"_a = false)
+        .def_method(Film, streaming)
+        .def_method(Film, rows_finished, "y"_a)
         .def_method(Film, has_high_quality_edges)
         .def_method(Film, size)
         .def_method(Film, crop_size)
@@ -52,6 +52,14 @@ public:
         PYBIND11_OVERLOAD(std::vector<std::string>, SamplingIntegrator, aov_names, );
     }
 
+    bool synchronize_passes() const override {
+        PYBIND11_OVERLOAD(bool, SamplingIntegrator, synchronize_passes, );
+    }
+
+    void pass_finished(size_t pass, size_t pass_count) override {
+        PYBIND11_OVERLOAD(void, SamplingIntegrator, pass_finished, pass, pass_count);
+    }
+
     std::string to_string() const override {
         PYBIND11_OVERLOAD(std::string, SamplingIntegrator, to_string, );
     }
@@ -0,0 +1,10 @@
+#include <mitsuba/render/kdtree.h>
+#include <mitsuba/python/python.h>
+
+MTS_PY_EXPORT(KDBuildQuality) {
+    py::enum_<KDBuildQuality>(m, "KDBuildQuality", D(KDBuildQuality))
+        .def_value(KDBuildQuality, Auto)
+        .def_value(KDBuildQuality, Fast)
+        .def_value(KDBuildQuality, Balanced)
+        .def_value(KDBuildQuality, High);
+}
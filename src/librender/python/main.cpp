@@ -3,8 +3,11 @@
 MTS_PY_DECLARE(BSDFContext);
 MTS_PY_DECLARE(EmitterExtras);
 MTS_PY_DECLARE(HitComputeFlags);
+MTS_PY_DECLARE(KDBuildQuality);
 MTS_PY_DECLARE(MicrofacetType);
 MTS_PY_DECLARE(PhaseFunctionExtras);
+MTS_PY_DECLARE(RayCounters);
+MTS_PY_DECLARE(SparseGrid);
 MTS_PY_DECLARE(Spiral);
 
 PYBIND11_MODULE(render_ext, m) {
@@ -14,8 +17,11 @@ PYBIND11_MODULE(render_ext, m) {
     MTS_PY_IMPORT(BSDFContext);
     MTS_PY_IMPORT(EmitterExtras);
     MTS_PY_IMPORT(HitComputeFlags);
+    MTS_PY_IMPORT(KDBuildQuality);
     MTS_PY_IMPORT(MicrofacetType);
     MTS_PY_IMPORT(PhaseFunctionExtras);
+    MTS_PY_IMPORT(RayCounters);
+    MTS_PY_IMPORT(SparseGrid);
     MTS_PY_IMPORT(Spiral);
 
     // Change module name back to correct value
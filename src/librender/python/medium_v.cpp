@@ -20,6 +20,12 @@ public:
         PYBIND11_OVERLOAD_PURE(UnpolarizedSpectrum, Medium, get_combined_extinction, mi, active);
     }
 
+    std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>
+    get_control_extinction(const MediumInteraction3f &mi, Mask active = true) const override {
+        using Return = std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>;
+        PYBIND11_OVERLOAD(Return, Medium, get_control_extinction, mi, active);
+    }
+
     std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>
     get_scattering_coefficients(const MediumInteraction3f &mi, Mask active = true) const override {
         using Return = std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>;
@@ -39,9 +45,13 @@ MTS_PY_EXPORT(Medium) {
             .def(py::init<const Properties &>())
             .def("intersect_aabb", vectorize(&Medium::intersect_aabb), "ray"_a)
             .def("get_combined_extinction", vectorize(&Medium::get_combined_extinction), "mi"_a, "active"_a=true)
+            .def("get_control_extinction", vectorize(&Medium::get_control_extinction), "mi"_a, "active"_a=true,
+                D(Medium, get_control_extinction))
             .def("get_scattering_coefficients", vectorize(&Medium::get_scattering_coefficients), "mi"_a, "active"_a=true)
             .def("sample_interaction", vectorize(&Medium::sample_interaction), "ray"_a, "sample"_a, "channel"_a, "active"_a=true)
             .def("eval_tr_and_pdf", vectorize(&Medium::eval_tr_and_pdf), "mi"_a, "si"_a, "active"_a=true)
+            .def("eval_tr_residual_ratio", vectorize(&Medium::eval_tr_residual_ratio),
+                "ray"_a, "sampler"_a, "channel"_a, "active"_a=true, D(Medium, eval_tr_residual_ratio))
             .def_method(Medium, phase_function)
             .def_method(Medium, use_emitter_sampling)
             // .def_method(Medium, is_homogeneous)
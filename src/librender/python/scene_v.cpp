@@ -5,6 +5,7 @@
 #include <mitsuba/render/kdtree.h>
 #include <mitsuba/render/sensor.h>
 #include <mitsuba/python/python.h>
+#include <pybind11/numpy.h>
 
 MTS_PY_EXPORT(ShapeKDTree) {
     MTS_PY_IMPORT_TYPES(ShapeKDTree, Shape, Mesh)
@@ -27,15 +28,35 @@ MTS_PY_EXPORT(ShapeKDTree) {
         .def("__len__", &ShapeKDTree::primitive_count)
         .def("bbox", [] (ShapeKDTree &s) { return s.bbox(); })
         .def_method(ShapeKDTree, build)
-        .def_method(ShapeKDTree, build);
+        .def_method(ShapeKDTree, build_quality)
+        .def("expected_cost", [](const ShapeKDTree &s) { return s.expected_cost(); },
+             D(TShapeKDTree, expected_cost, 2))
+        .def_method(ShapeKDTree, set_build_quality, "quality"_a)
+        .def_method(ShapeKDTree, set_sample_budget, "samples"_a)
+        .def_method(ShapeKDTree, predict_cost, "quality"_a);
 #else
     ENOKI_MARK_USED(m);
 #endif
 }
 
+/// Validate an array passed to the batched ray queries and return its data pointer
+template <typename T>
+T *batch_array(py::array &array, const char *name, size_t count, size_t channels,
+               bool writeable) {
+    if (!array.dtype().is(py::dtype::of<T>()))
+        throw std::runtime_error(tfm::format("'%s' has an incompatible type!", name));
+    if (!(array.flags() & py::array::c_style))
+        throw std::runtime_error(tfm::format("'%s' must be C-contiguous!", name));
+    if ((size_t) array.size() != count * channels)
+        throw std::runtime_error(tfm::format("'%s' has an incompatible size!", name));
+    if (writeable && !array.writeable())
+        throw std::runtime_error(tfm::format("'%s' is not writeable!", name));
+    return (T *) array.data();
+}
+
 MTS_PY_EXPORT(Scene) {
     MTS_PY_IMPORT_TYPES(Scene, Integrator, SamplingIntegrator, MonteCarloIntegrator, Sensor)
-    MTS_PY_CLASS(Scene, Object)
+    auto cls = MTS_PY_CLASS(Scene, Object)
         .def(py::init<const Properties>())
         .def("ray_intersect_preliminary",
              vectorize(&Scene::ray_intersect_preliminary),
@@ -60,6 +81,10 @@ MTS_PY_EXPORT(Scene) {
         .def("pdf_emitter_direction",
             vectorize(&Scene::pdf_emitter_direction),
             "ref"_a, "ds"_a, "active"_a = true)
+        .def("sample_emitter_ray",
+            vectorize(&Scene::sample_emitter_ray),
+            "time"_a, "sample1"_a, "sample2"_a, "sample3"_a, "active"_a = true,
+            D(Scene, sample_emitter_ray))
         // Accessors
         .def_method(Scene, bbox)
         .def("sensors", py::overload_cast<>(&Scene::sensors), D(Scene, sensors))
@@ -88,4 +113,44 @@ MTS_PY_EXPORT(Scene) {
             D(Scene, integrator))
         .def_method(Scene, shapes_grad_enabled)
         .def("__repr__", &Scene::to_string);
+
+    if constexpr (!is_array_v<Float>) {
+        cls.def("ray_intersect_batch",
+            [](const Scene &scene, py::array o, py::array d, py::array t,
+               py::array prim_index, py::array shape_index, py::array prim_uv,
+               std::optional<py::array> mint, std::optional<py::array> maxt) {
+                size_t count = (size_t) o.size() / 3;
+                const ScalarFloat
+                    *o_ptr    = batch_array<ScalarFloat>(o, "o", count, 3, false),
+                    *d_ptr    = batch_array<ScalarFloat>(d, "d", count, 3, false),
+                    *mint_ptr = mint ? batch_array<ScalarFloat>(*mint, "mint", count, 1, false) : nullptr,
+                    *maxt_ptr = maxt ? batch_array<ScalarFloat>(*maxt, "maxt", count, 1, false) : nullptr;
+                ScalarFloat *t_ptr  = batch_array<ScalarFloat>(t, "t", count, 1, true),
+                            *uv_ptr = batch_array<ScalarFloat>(prim_uv, "prim_uv", count, 2, true);
+                uint32_t *prim_ptr  = batch_array<uint32_t>(prim_index, "prim_index", count, 1, true),
+                         *shape_ptr = batch_array<uint32_t>(shape_index, "shape_index", count, 1, true);
+
+                py::gil_scoped_release release;
+                scene.ray_intersect_batch(count, o_ptr, d_ptr, mint_ptr, maxt_ptr,
+                                          t_ptr, prim_ptr, shape_ptr, uv_ptr);
+            },
+            "o"_a, "d"_a, "t"_a, "prim_index"_a, "shape_index"_a, "prim_uv"_a,
+            "mint"_a = py::none(), "maxt"_a = py::none(), D(Scene, ray_intersect_batch))
+        .def("ray_test_batch",
+            [](const Scene &scene, py::array o, py::array d, py::array hit,
+               std::optional<py::array> mint, std::optional<py::array> maxt) {
+                size_t count = (size_t) o.size() / 3;
+                const ScalarFloat
+                    *o_ptr    = batch_array<ScalarFloat>(o, "o", count, 3, false),
+                    *d_ptr    = batch_array<ScalarFloat>(d, "d", count, 3, false),
+                    *mint_ptr = mint ? batch_array<ScalarFloat>(*mint, "mint", count, 1, false) : nullptr,
+                    *maxt_ptr = maxt ? batch_array<ScalarFloat>(*maxt, "maxt", count, 1, false) : nullptr;
+                bool *hit_ptr = batch_array<bool>(hit, "hit", count, 1, true);
+
+                py::gil_scoped_release release;
+                scene.ray_test_batch(count, o_ptr, d_ptr, mint_ptr, maxt_ptr, hit_ptr);
+            },
+            "o"_a, "d"_a, "hit"_a, "mint"_a = py::none(), "maxt"_a = py::none(),
+            D(Scene, ray_test_batch));
+    }
 }
\ No newline at end of file
@@ -65,6 +65,11 @@ MTS_PY_EXPORT(Shape) {
         .def_method(Mesh, has_vertex_texcoords)
         .def_method(Mesh, recompute_vertex_normals)
         .def_method(Mesh, recompute_bbox)
+        .def_method(Mesh, has_compact_storage)
+        .def("compact_storage", &Mesh::compact_storage, "compact_faces"_a = false,
+             D(Mesh, compact_storage))
+        .def_method(Mesh, vertex_data_bytes)
+        .def_method(Mesh, face_data_bytes)
         .def("write_ply", &Mesh::write_ply, "filename"_a,
              "Export mesh as a binary PLY file")
         .def("vertex_positions_buffer",
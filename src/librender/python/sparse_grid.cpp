@@ -0,0 +1,42 @@
+#include <mitsuba/core/stream.h>
+#include <mitsuba/render/sparse_grid.h>
+#include <mitsuba/python/python.h>
+
+MTS_PY_EXPORT(SparseGrid) {
+    using ScalarVector3i = typename SparseGrid::ScalarVector3i;
+    using ScalarBoundingBox3f = typename SparseGrid::ScalarBoundingBox3f;
+    using ScalarPoint3f = typename SparseGrid::ScalarPoint3f;
+
+    MTS_PY_CLASS(SparseGrid, Object)
+        .def(py::init([](py::array_t<float, py::array::c_style | py::array::forcecast> data,
+                         const ScalarBoundingBox3f &bbox) {
+            if (data.ndim() != 3 && data.ndim() != 4)
+                throw py::type_error("Expected an array with shape [z, y, x] or [z, y, x, channels]");
+            ScalarVector3i shape((int32_t) data.shape(2), (int32_t) data.shape(1),
+                                 (int32_t) data.shape(0));
+            uint32_t channel_count = data.ndim() == 4 ? (uint32_t) data.shape(3) : 1;
+            py::gil_scoped_release release;
+            return new SparseGrid(shape, channel_count, data.data(), bbox);
+        }), "data"_a, "bbox"_a = ScalarBoundingBox3f(ScalarPoint3f(0.f), ScalarPoint3f(1.f)),
+            "Create a sparse grid from a dense NumPy array with shape [z, y, x] or "
+            "[z, y, x, channels]")
+        .def(py::init<const fs::path &>(), "filename"_a, D(SparseGrid, SparseGrid, 2),
+            py::call_guard<py::gil_scoped_release>())
+        .def(py::init<Stream *>(), "stream"_a, D(SparseGrid, SparseGrid, 3),
+            py::call_guard<py::gil_scoped_release>())
+        .def("write", py::overload_cast<Stream *>(&SparseGrid::write, py::const_),
+            "stream"_a, D(SparseGrid, write), py::call_guard<py::gil_scoped_release>())
+        .def("write", py::overload_cast<const fs::path &>(&SparseGrid::write, py::const_),
+            "filename"_a, D(SparseGrid, write, 2), py::call_guard<py::gil_scoped_release>())
+        .def_method(SparseGrid, shape)
+        .def_method(SparseGrid, root_shape)
+        .def_method(SparseGrid, channel_count)
+        .def_method(SparseGrid, bbox)
+        .def_method(SparseGrid, mean)
+        .def_method(SparseGrid, max)
+        .def_method(SparseGrid, tile_count)
+        .def_method(SparseGrid, brick_count)
+        .def_method(SparseGrid, size_bytes)
+        .def_method(SparseGrid, voxel, "p"_a, "channel"_a = 0)
+        .def_method(SparseGrid, bounds, "p"_a);
+}
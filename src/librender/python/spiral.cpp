@@ -3,7 +3,7 @@
 
 MTS_PY_EXPORT(Spiral) {
     using Vector2i = typename Spiral::Vector2i;
-    MTS_PY_CLASS(Spiral, Object)
+    auto spiral = MTS_PY_CLASS(Spiral, Object)
         .def(py::init<Vector2i, Vector2i, size_t, size_t>(),
             "size"_a, "offset"_a, "block_size"_a = MTS_BLOCK_SIZE, "passes"_a = 1,
             D(Spiral, Spiral))
@@ -11,5 +11,11 @@ MTS_PY_EXPORT(Spiral) {
         .def_method(Spiral, block_count)
         .def_method(Spiral, reset)
         .def_method(Spiral, set_passes)
+        .def_method(Spiral, order)
+        .def_method(Spiral, set_order, "order"_a)
         .def_method(Spiral, next_block);
+
+    py::enum_<Spiral::Order>(spiral, "Order", D(Spiral, Order))
+        .value("Spiral",   Spiral::Order::Spiral,   D(Spiral, Order, Spiral))
+        .value("Scanline", Spiral::Order::Scanline, D(Spiral, Order, Scanline));
 }
@@ -52,6 +52,9 @@ MTS_PY_EXPORT(Volume) {
         .def("max",
             &Volume::max,
             D(Volume, max))
+        .def("eval_bounds",
+            vectorize(&Volume::eval_bounds),
+            "it"_a, "active"_a = true, D(Volume, eval_bounds))
         .def("bbox",
             &Volume::bbox,
             D(Volume, bbox))
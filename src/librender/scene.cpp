@@ -1,11 +1,19 @@
+#include <mitsuba/core/hugepages.h>
+#include <mitsuba/core/numa.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/counters.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/kdtree.h>
 #include <mitsuba/render/integrator.h>
 #include <enoki/stl.h>
+#include <tbb/parallel_for.h>
+#include <unordered_map>
+
+/// Number of rays processed by each task of the batched ray queries
+#define MTS_RAY_BATCH_GRAIN_SIZE 1024
 
 #if defined(MTS_ENABLE_EMBREE)
 #  include "scene_embree.inl"
@@ -19,6 +27,22 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Assemble ray \c i of a batch stored in flat arrays
+template <typename Ray3f, typename ScalarFloat>
+MTS_INLINE Ray3f batch_ray(size_t i, const ScalarFloat *o, const ScalarFloat *d,
+                           const ScalarFloat *mint, const ScalarFloat *maxt) {
+    using Point3f  = typename Ray3f::Point;
+    using Vector3f = typename Ray3f::Vector;
+
+    Ray3f ray(Point3f(o[3 * i], o[3 * i + 1], o[3 * i + 2]),
+              Vector3f(d[3 * i], d[3 * i + 1], d[3 * i + 2]), 0.f);
+    if (mint)
+        ray.mint = mint[i];
+    if (maxt)
+        ray.maxt = maxt[i];
+    return ray;
+}
+
 MTS_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
     for (auto &kv : props.objects()) {
         m_children.push_back(kv.second.get());
@@ -91,11 +115,27 @@ MTS_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
             create_object<Integrator>(Properties("path"));
     }
 
-    if constexpr (is_cuda_array_v<Float>)
+    if constexpr (is_cuda_array_v<Float>) {
         accel_init_gpu(props);
-    else
+    } else {
+        /* The kd-tree places its own nodes, move and spread the geometry that
+           it references as well */
+        for (Shape *shape : m_shapes) {
+            if (!shape->is_mesh())
+                continue;
+            auto mesh = static_cast<Mesh<Float, Spectrum> *>(shape);
+            if (HugePageBuffer::enabled())
+                mesh->move_to_huge_pages();
+            if (numa::enabled())
+                mesh->interleave_memory();
+        }
+
         accel_init_cpu(props);
 
+        if (HugePageBuffer::enabled())
+            Log(Info, "Large scene buffers: %s", HugePageBuffer::usage_report());
+    }
+
     // Create emitters' shapes (environment luminaires)
     for (Emitter *emitter: m_emitters)
         emitter->set_scene(this);
@@ -113,6 +153,7 @@ MTS_VARIANT Scene<Float, Spectrum>::~Scene() {
 MTS_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::RayIntersect, active);
+    counter_add_lanes(Counter::RayIntersect, active);
 
     if constexpr (is_cuda_array_v<Float>)
         return ray_intersect_gpu(ray, HitComputeFlags::All, active);
@@ -123,6 +164,7 @@ Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, Mask active) const {
 MTS_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, HitComputeFlags flags, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::RayIntersect, active);
+    counter_add_lanes(Counter::RayIntersect, active);
 
     if constexpr (is_cuda_array_v<Float>)
         return ray_intersect_gpu(ray, flags, active);
@@ -132,6 +174,8 @@ Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, HitComputeFlags flags, M
 
 MTS_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
 Scene<Float, Spectrum>::ray_intersect_preliminary(const Ray3f &ray, Mask active) const {
+    counter_add_lanes(Counter::RayIntersect, active);
+
     if constexpr (is_cuda_array_v<Float>)
         return ray_intersect_preliminary_gpu(ray, active);
     else
@@ -154,6 +198,7 @@ Scene<Float, Spectrum>::ray_intersect_naive(const Ray3f &ray, Mask active) const
 MTS_VARIANT typename Scene<Float, Spectrum>::Mask
 Scene<Float, Spectrum>::ray_test(const Ray3f &ray, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::RayTest, active);
+    counter_add_lanes(Counter::RayTest, active);
 
     if constexpr (is_cuda_array_v<Float>)
         return ray_test_gpu(ray, active);
@@ -161,10 +206,75 @@ Scene<Float, Spectrum>::ray_test(const Ray3f &ray, Mask active) const {
         return ray_test_cpu(ray, active);
 }
 
+MTS_VARIANT void Scene<Float, Spectrum>::ray_intersect_batch(
+    size_t count, const ScalarFloat *o, const ScalarFloat *d,
+    const ScalarFloat *mint, const ScalarFloat *maxt, ScalarFloat *t,
+    uint32_t *prim_index, uint32_t *shape_index, ScalarFloat *prim_uv) const {
+    if constexpr (!is_array_v<Float>) {
+        std::unordered_map<const Shape *, uint32_t> shape_ids;
+        for (size_t i = 0; i < m_shapes.size(); ++i)
+            shape_ids[m_shapes[i].get()] = (uint32_t) i;
+
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, count, MTS_RAY_BATCH_GRAIN_SIZE),
+            [&](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    Ray3f ray = batch_ray<Ray3f>(i, o, d, mint, maxt);
+                    PreliminaryIntersection3f pi =
+                        ray_intersect_preliminary_cpu(ray, true);
+
+                    uint32_t shape_id = (uint32_t) -1;
+                    if (pi.is_valid()) {
+                        const Shape *shape = pi.instance ? pi.instance : pi.shape;
+                        auto it = shape_ids.find(shape);
+                        if (it != shape_ids.end())
+                            shape_id = it->second;
+                    }
+
+                    t[i]              = pi.t;
+                    prim_index[i]     = pi.is_valid() ? pi.prim_index : (uint32_t) -1;
+                    shape_index[i]    = shape_id;
+                    prim_uv[2 * i]     = pi.prim_uv.x();
+                    prim_uv[2 * i + 1] = pi.prim_uv.y();
+                }
+
+                // Count the rays of this task at once (the queries above bypass ray_intersect())
+                counter_add(Counter::RayIntersect, (uint64_t) range.size());
+            }
+        );
+    } else {
+        ENOKI_MARK_USED(count); ENOKI_MARK_USED(o); ENOKI_MARK_USED(d);
+        ENOKI_MARK_USED(mint); ENOKI_MARK_USED(maxt); ENOKI_MARK_USED(t);
+        ENOKI_MARK_USED(prim_index); ENOKI_MARK_USED(shape_index);
+        ENOKI_MARK_USED(prim_uv);
+        Throw("ray_intersect_batch(): only supported in scalar variants!");
+    }
+}
+
+MTS_VARIANT void Scene<Float, Spectrum>::ray_test_batch(
+    size_t count, const ScalarFloat *o, const ScalarFloat *d,
+    const ScalarFloat *mint, const ScalarFloat *maxt, bool *hit) const {
+    if constexpr (!is_array_v<Float>) {
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, count, MTS_RAY_BATCH_GRAIN_SIZE),
+            [&](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i)
+                    hit[i] = ray_test_cpu(batch_ray<Ray3f>(i, o, d, mint, maxt), true);
+                counter_add(Counter::RayTest, (uint64_t) range.size());
+            }
+        );
+    } else {
+        ENOKI_MARK_USED(count); ENOKI_MARK_USED(o); ENOKI_MARK_USED(d);
+        ENOKI_MARK_USED(mint); ENOKI_MARK_USED(maxt); ENOKI_MARK_USED(hit);
+        Throw("ray_test_batch(): only supported in scalar variants!");
+    }
+}
+
 MTS_VARIANT std::pair<typename Scene<Float, Spectrum>::DirectionSample3f, Spectrum>
 Scene<Float, Spectrum>::sample_emitter_direction(const Interaction3f &ref, const Point2f &sample_,
                                                  bool test_visibility, Mask active) const {
     MTS_MASKED_FUNCTION(ProfilerPhase::SampleEmitterDirection, active);
+    counter_add_lanes(Counter::EmitterSample, active);
 
     using EmitterPtr = replace_scalar_t<Float, Emitter*>;
 
@@ -230,6 +340,34 @@ Scene<Float, Spectrum>::pdf_emitter_direction(const Interaction3f &ref,
     }
 }
 
+MTS_VARIANT std::pair<typename Scene<Float, Spectrum>::Ray3f, Spectrum>
+Scene<Float, Spectrum>::sample_emitter_ray(Float time, Float sample1, const Point2f &sample2,
+                                           const Point2f &sample3, Mask active) const {
+    MTS_MASKED_FUNCTION(ProfilerPhase::EndpointSampleRay, active);
+    using EmitterPtr = replace_scalar_t<Float, Emitter*>;
+
+    if (unlikely(m_emitters.empty()))
+        return { zero<Ray3f>(), Spectrum(0.f) };
+
+    if (m_emitters.size() == 1) {
+        // Fast path if there is only one emitter
+        return m_emitters[0]->sample_ray(time, sample1, sample2, sample3, active);
+    }
+
+    ScalarFloat emitter_pdf = 1.f / m_emitters.size();
+
+    // Randomly pick an emitter and rescale sample1 to lie in [0,1) again
+    UInt32 index = min(UInt32(sample1 * (ScalarFloat) m_emitters.size()),
+                       (uint32_t) m_emitters.size() - 1);
+    sample1 = (sample1 - index * emitter_pdf) * m_emitters.size();
+
+    EmitterPtr emitter = gather<EmitterPtr>(m_emitters.data(), index, active);
+    auto [ray, weight] = emitter->sample_ray(time, sample1, sample2, sample3, active);
+
+    // Account for the discrete probability of sampling this emitter
+    return { ray, weight * rcp(emitter_pdf) };
+}
+
 MTS_VARIANT void Scene<Float, Spectrum>::traverse(TraversalCallback *callback) {
     for (auto& child : m_children) {
         std::string id = child->id();
@@ -239,24 +377,35 @@ MTS_VARIANT void Scene<Float, Spectrum>::traverse(TraversalCallback *callback) {
     }
 }
 
+MTS_VARIANT MemoryUsage Scene<Float, Spectrum>::memory_usage() const {
+#if !defined(MTS_ENABLE_EMBREE)
+    if constexpr (!is_cuda_array_v<Float>) {
+        if (m_accel)
+            return ((const ShapeKDTree *) m_accel)->memory_usage();
+    }
+#endif
+    return { };
+}
+
 MTS_VARIANT void Scene<Float, Spectrum>::parameters_changed(const std::vector<std::string> &keys) {
     if (m_environment)
         m_environment->set_scene(this); // TODO use parameters_changed({"scene"})
 
-    bool update_accel = false;
+    std::vector<Shape *> changed_shapes;
     for (auto &s : m_shapes) {
-        if (string::contains(keys, s->id()) || string::contains(keys, s->class_()->name())) {
-            update_accel = true;
-            break;
-        }
+        if (string::contains(keys, s->id()) || string::contains(keys, s->class_()->name()))
+            changed_shapes.push_back(s);
     }
 
-    if (update_accel) {
+    if (!changed_shapes.empty()) {
+        m_bbox.reset();
+        for (auto &s : m_shapes)
+            m_bbox.expand(s->bbox());
+
         if constexpr (is_cuda_array_v<Float>)
             accel_parameters_changed_gpu();
-        else {
-            // TODO update Embree BVH or Mitsuba kdtree if necessary
-        }
+        else
+            accel_parameters_changed_cpu(changed_shapes);
     }
 
     // Checks whether any of the shape's parameters require gradient
@@ -38,6 +38,31 @@ MTS_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &/*prop
     Log(Info, "Embree ready. (took %s)", util::time_string(timer.value()));
 }
 
+MTS_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu(const std::vector<Shape *> &shapes) {
+    RTCScene embree_scene = (RTCScene) m_accel;
+
+    /* Geometry IDs match the shape indices. The buffers of a shape may have
+       been reallocated, hence its geometry is recreated before Embree updates
+       the affected parts of its BVH (the scene is marked as dynamic). */
+    for (Shape *shape : shapes) {
+        auto it = std::find_if(m_shapes.begin(), m_shapes.end(),
+                               [shape](const ref<Shape> &s) { return s.get() == shape; });
+        if (it == m_shapes.end())
+            continue;
+
+        unsigned int geom_id = (unsigned int) (it - m_shapes.begin());
+        RTCGeometry geom = shape->embree_geometry(__embree_device);
+        rtcDetachGeometry(embree_scene, geom_id);
+        rtcAttachGeometryByID(embree_scene, geom, geom_id);
+        rtcReleaseGeometry(geom);
+    }
+
+    Timer timer;
+    rtcCommitScene(embree_scene);
+    Log(Debug, "Embree updated. (%i changed shapes, took %s)", shapes.size(),
+        util::time_string(timer.value()));
+}
+
 MTS_VARIANT void Scene<Float, Spectrum>::accel_release_cpu() {
     rtcReleaseScene((RTCScene) m_accel);
 }
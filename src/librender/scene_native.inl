@@ -5,10 +5,22 @@ MTS_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &props)
     kdtree->inc_ref();
     for (Shape *shape : m_shapes)
         kdtree->add_shape(shape);
+
+    // Let the build quality heuristic know how many samples will be rendered
+    double samples = 0.0;
+    for (Sensor *sensor : m_sensors)
+        samples += (double) hprod(sensor->film()->crop_size()) *
+                   (double) sensor->sampler()->sample_count();
+    kdtree->set_sample_budget(samples);
+
     kdtree->build();
     m_accel = kdtree;
 }
 
+MTS_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu(const std::vector<Shape *> &shapes) {
+    ((ShapeKDTree *) m_accel)->update(shapes);
+}
+
 MTS_VARIANT void Scene<Float, Spectrum>::accel_release_cpu() {
     ((ShapeKDTree *) m_accel)->dec_ref();
     m_accel = nullptr;
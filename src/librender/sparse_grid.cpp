@@ -0,0 +1,454 @@
+#include <mitsuba/render/sparse_grid.h>
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/mmap.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/util.h>
+#include <tbb/parallel_for.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Version of the sparse grid file format
+static const uint8_t sparse_grid_version = 1;
+
+/// Number of entries of a 3D array with the given resolution
+static size_t array_size(const SparseGrid::ScalarVector3i &shape) {
+    return (size_t) shape.x() * (size_t) shape.y() * (size_t) shape.z();
+}
+
+SparseGrid::SparseGrid(const ScalarVector3i &shape, uint32_t channel_count,
+                       const float *data, const ScalarBoundingBox3f &bbox)
+    : m_shape(shape), m_channel_count(channel_count), m_bbox(bbox) {
+    size_t row_size = (size_t) shape.x() * shape.y() * channel_count;
+    build([&](int32_t z_begin, int32_t) { return data + z_begin * row_size; });
+}
+
+SparseGrid::SparseGrid(const fs::path &filename) {
+    fs::path path = Thread::thread()->file_resolver()->resolve(filename);
+    ref<FileStream> stream = new FileStream(path);
+
+    char header[3];
+    stream->read(header, 3);
+    if (header[0] == 'S' && header[1] == 'V' && header[2] == 'L') {
+        read(stream);
+    } else if (header[0] == 'V' && header[1] == 'O' && header[2] == 'L') {
+        uint8_t version;
+        int32_t data_type, channel_count;
+        float dims[6];
+        stream->read(version);
+        if (version != 3)
+            Throw("Invalid version, currently only version 3 is supported (found %d)", version);
+        stream->read(data_type);
+        if (data_type != 1)
+            Throw("Wrong type, currently only type == 1 (Float32) data is supported (found type = %d)",
+                  data_type);
+        stream->read_array(m_shape.data(), 3);
+        stream->read(channel_count);
+        stream->read_array(dims, 6);
+        if (any(m_shape < 1) || channel_count < 1)
+            Throw("Invalid volume file \"%s\": dimensions %s (%i channels)",
+                  path.string(), m_shape, channel_count);
+        m_channel_count = (uint32_t) channel_count;
+        m_bbox = ScalarBoundingBox3f(ScalarPoint3f(dims[0], dims[1], dims[2]),
+                                     ScalarPoint3f(dims[3], dims[4], dims[5]));
+
+        /* Map the file instead of reading it, so that the conversion only
+           touches one slab of tiles (and its one-voxel border) at a time */
+        size_t offset = stream->tell(),
+               size   = array_size(m_shape) * (size_t) m_channel_count;
+        stream->close();
+        ref<MemoryMappedFile> mmap = new MemoryMappedFile(path);
+        if (mmap->size() < offset + size * sizeof(float))
+            Throw("Volume file \"%s\" is truncated (expected %u bytes, got %u)",
+                  path.string(), offset + size * sizeof(float), mmap->size());
+
+        const float *data = (const float *) ((const uint8_t *) mmap->data() + offset);
+        size_t row_size = (size_t) m_shape.x() * m_shape.y() * m_channel_count;
+        build([&](int32_t z_begin, int32_t z_end) {
+            // Ask the OS to start reading the next slab in the background
+            int32_t next_end = std::min(z_end + int32_t(BrickRes * TileRes), m_shape.z());
+            if (z_end < next_end)
+                mmap->prefetch(offset + z_end * row_size * sizeof(float),
+                               (next_end - z_end) * row_size * sizeof(float));
+            return data + z_begin * row_size;
+        });
+    } else {
+        Throw("Invalid volume file \"%s\"", path.string());
+    }
+
+    Log(Debug, "Loaded sparse grid from \"%s\": %s", path.string(), to_string());
+}
+
+SparseGrid::SparseGrid(Stream *stream) {
+    char header[3];
+    stream->read(header, 3);
+    if (header[0] != 'S' || header[1] != 'V' || header[2] != 'L')
+        Throw("Invalid sparse grid file!");
+    read(stream);
+}
+
+SparseGrid::~SparseGrid() { }
+
+void SparseGrid::build(const SlabFunction &slab) {
+    if (any(m_shape < 1) || m_channel_count == 0)
+        Throw("SparseGrid: invalid grid dimensions %s (%u channels)", m_shape,
+              m_channel_count);
+
+    const uint32_t span = BrickRes * TileRes, channels = m_channel_count;
+    m_root_shape = (m_shape + ScalarVector3i(span - 1)) / ScalarVector3i(span);
+    size_t root_count = array_size(m_root_shape),
+           slab_count = (size_t) m_root_shape.x() * m_root_shape.y();
+
+    /* Per-tile build results. Local entries of a tile reference bricks by
+       their local index and constants by their local index plus one (zero is
+       reserved for the zero value). Tiles where all bricks are the same
+       constant don't store any entries. */
+    struct TileData {
+        std::vector<uint32_t> entries;
+        std::vector<float> bounds;
+        std::vector<float> bricks;
+        std::vector<float> constants;
+        uint32_t root_entry = ConstantFlag;
+        float min = std::numeric_limits<float>::infinity(),
+              max = -std::numeric_limits<float>::infinity();
+        double sum = 0.0;
+    };
+
+    m_root.resize(root_count);
+    m_root_bounds.resize(2 * root_count);
+    m_tiles.clear();
+    m_tile_bounds.clear();
+    m_bricks.clear();
+    m_constants.assign(channels, 0.f);
+
+    double sum = 0.0;
+    m_max = -std::numeric_limits<float>::infinity();
+
+    std::vector<TileData> tiles(slab_count);
+
+    /* Process one slab of tiles at a time, which only requires the voxels
+       of the slab plus a one-voxel border in z */
+    for (int32_t tz = 0; tz < m_root_shape.z(); ++tz) {
+        int32_t z_begin = std::max(tz * int32_t(span) - 1, 0),
+                z_end   = std::min((tz + 1) * int32_t(span) + 1, m_shape.z());
+        const float *data = slab(z_begin, z_end);
+
+        auto value = [&](const ScalarVector3i &p) {
+            return data + (((size_t) (p.z() - z_begin) * m_shape.y() + p.y()) *
+                           m_shape.x() + p.x()) * channels;
+        };
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, slab_count, 1),
+            [&](const tbb::blocked_range<size_t> &range) {
+                for (size_t t = range.begin(); t != range.end(); ++t) {
+                    TileData &tile = tiles[t];
+                    ScalarVector3i tile_pos(int32_t(t % m_root_shape.x()),
+                                            int32_t(t / m_root_shape.x()), tz);
+
+                    tile.entries.resize(TileSize);
+                    tile.bounds.resize(2 * TileSize);
+
+                    bool tile_constant = true;
+                    const float *tile_value = nullptr;
+
+                    for (uint32_t b = 0; b < TileSize; ++b) {
+                        ScalarVector3i origin =
+                            (tile_pos * int32_t(TileRes) +
+                             ScalarVector3i(int32_t(b % TileRes), int32_t((b / TileRes) % TileRes),
+                                            int32_t(b / (TileRes * TileRes)))) *
+                            int32_t(BrickRes);
+
+                        float &bmin = tile.bounds[2 * b], &bmax = tile.bounds[2 * b + 1];
+                        bmin = std::numeric_limits<float>::infinity();
+                        bmax = -std::numeric_limits<float>::infinity();
+
+                        // Bricks outside of the grid are never accessed
+                        if (any(origin >= m_shape)) {
+                            tile.entries[b] = ConstantFlag;
+                            continue;
+                        }
+
+                        ScalarVector3i end = min(origin + ScalarVector3i(BrickRes), m_shape),
+                                       lo  = max(origin - 1, ScalarVector3i(0)),
+                                       hi  = min(end + 1, m_shape);
+
+                        // Bounds over the region dilated by one voxel
+                        for (int32_t z = lo.z(); z < hi.z(); ++z) {
+                            for (int32_t y = lo.y(); y < hi.y(); ++y) {
+                                const float *v = value(ScalarVector3i(lo.x(), y, z));
+                                for (size_t i = 0; i < (size_t) (hi.x() - lo.x()) * channels; ++i) {
+                                    bmin = std::min(bmin, v[i]);
+                                    bmax = std::max(bmax, v[i]);
+                                }
+                            }
+                        }
+                        tile.min = std::min(tile.min, bmin);
+                        tile.max = std::max(tile.max, bmax);
+
+                        // Check if the brick is constant (and accumulate the mean)
+                        const float *ref_value = value(origin);
+                        bool brick_constant = true;
+                        for (int32_t z = origin.z(); z < end.z(); ++z) {
+                            for (int32_t y = origin.y(); y < end.y(); ++y) {
+                                const float *v = value(ScalarVector3i(origin.x(), y, z));
+                                for (int32_t x = origin.x(); x < end.x(); ++x) {
+                                    for (uint32_t c = 0; c < channels; ++c) {
+                                        brick_constant &= v[c] == ref_value[c];
+                                        tile.sum += (double) v[c];
+                                    }
+                                    v += channels;
+                                }
+                            }
+                        }
+
+                        if (brick_constant) {
+                            bool zero = std::all_of(ref_value, ref_value + channels,
+                                                    [](float v) { return v == 0.f; });
+                            if (zero) {
+                                tile.entries[b] = ConstantFlag;
+                            } else {
+                                tile.entries[b] = ConstantFlag |
+                                    uint32_t(tile.constants.size() / channels + 1);
+                                tile.constants.insert(tile.constants.end(), ref_value,
+                                                      ref_value + channels);
+                            }
+
+                            if (tile_value == nullptr)
+                                tile_value = ref_value;
+                            else
+                                tile_constant &= std::equal(ref_value, ref_value + channels,
+                                                            tile_value);
+                        } else {
+                            tile_constant = false;
+                            tile.entries[b] = uint32_t(tile.bricks.size() / (BrickSize * channels));
+
+                            // Copy the voxels, the parts outside of the grid are set to zero
+                            size_t offset = tile.bricks.size();
+                            tile.bricks.resize(offset + BrickSize * channels, 0.f);
+                            for (int32_t z = origin.z(); z < end.z(); ++z) {
+                                for (int32_t y = origin.y(); y < end.y(); ++y) {
+                                    size_t local = (size_t) (z - origin.z()) * BrickRes + (y - origin.y());
+                                    std::memcpy(tile.bricks.data() + offset + local * BrickRes * channels,
+                                                value(ScalarVector3i(origin.x(), y, z)),
+                                                sizeof(float) * (end.x() - origin.x()) * channels);
+                                }
+                            }
+                        }
+                    }
+
+                    if (tile_constant) {
+                        // Collapse the tile into a single root entry
+                        tile.entries = std::vector<uint32_t>();
+                        tile.bounds = std::vector<float>();
+                        bool zero = std::all_of(tile_value, tile_value + channels,
+                                                [](float v) { return v == 0.f; });
+                        if (zero) {
+                            tile.constants.clear();
+                            tile.root_entry = ConstantFlag;
+                        } else {
+                            tile.constants.assign(tile_value, tile_value + channels);
+                            tile.root_entry = ConstantFlag | 1u;
+                        }
+                        tile.constants.shrink_to_fit();
+                    }
+                }
+            }
+        );
+
+        /* Merge the tiles of the slab and replace local by global indices */
+        for (size_t t = 0; t < slab_count; ++t) {
+            TileData &tile = tiles[t];
+            size_t root_index = tz * slab_count + t;
+            uint32_t brick_offset    = uint32_t(m_bricks.size() / (BrickSize * channels)),
+                     constant_offset = uint32_t(m_constants.size() / channels) - 1;
+
+            auto remap = [&](uint32_t entry) {
+                if (!(entry & ConstantFlag))
+                    return entry + brick_offset;
+                else if (entry == ConstantFlag)
+                    return entry;
+                else
+                    return entry + constant_offset;
+            };
+
+            if (tile.entries.empty()) {
+                m_root[root_index] = remap(tile.root_entry);
+            } else {
+                m_root[root_index] = uint32_t(m_tiles.size() / TileSize);
+                for (uint32_t entry : tile.entries)
+                    m_tiles.push_back(remap(entry));
+                m_tile_bounds.insert(m_tile_bounds.end(), tile.bounds.begin(), tile.bounds.end());
+            }
+
+            m_root_bounds[2 * root_index]     = tile.min;
+            m_root_bounds[2 * root_index + 1] = tile.max;
+            m_bricks.insert(m_bricks.end(), tile.bricks.begin(), tile.bricks.end());
+            m_constants.insert(m_constants.end(), tile.constants.begin(), tile.constants.end());
+
+            sum += tile.sum;
+            m_max = std::max(m_max, tile.max);
+            tile = TileData();
+        }
+    }
+
+    if (m_root.size() > ConstantFlag || m_tiles.size() / TileSize > ConstantFlag ||
+        m_bricks.size() / (BrickSize * channels) > ConstantFlag)
+        Throw("SparseGrid: the grid is too large!");
+
+    m_tiles.shrink_to_fit();
+    m_tile_bounds.shrink_to_fit();
+    m_bricks.shrink_to_fit();
+    m_constants.shrink_to_fit();
+
+    m_mean = sum / (double) (array_size(m_shape) * (size_t) channels);
+}
+
+void SparseGrid::read(Stream *stream) {
+    uint8_t version;
+    stream->read(version);
+    if (version != sparse_grid_version)
+        Throw("Invalid sparse grid version %i (expected %i)", version, sparse_grid_version);
+
+    float dims[6];
+    uint32_t sizes[4];
+    stream->read_array(m_shape.data(), 3);
+    stream->read(m_channel_count);
+    stream->read_array(dims, 6);
+    stream->read(m_mean);
+    stream->read(m_max);
+    stream->read_array(sizes, 4);
+
+    m_bbox = ScalarBoundingBox3f(ScalarPoint3f(dims[0], dims[1], dims[2]),
+                                 ScalarPoint3f(dims[3], dims[4], dims[5]));
+
+    const uint32_t span = BrickRes * TileRes;
+    m_root_shape = (m_shape + ScalarVector3i(span - 1)) / ScalarVector3i(span);
+    size_t root_count = array_size(m_root_shape);
+
+    m_root.resize(root_count);
+    m_root_bounds.resize(2 * root_count);
+    m_tiles.resize(sizes[0] * (size_t) TileSize);
+    m_tile_bounds.resize(2 * sizes[0] * (size_t) TileSize);
+    m_bricks.resize(sizes[1] * (size_t) BrickSize * m_channel_count);
+    m_constants.resize(sizes[2] * (size_t) m_channel_count);
+    if (sizes[3] != root_count)
+        Throw("SparseGrid: root array size mismatch (%u vs %u)", sizes[3], root_count);
+    if (sizes[2] == 0)
+        Throw("SparseGrid: the table of constants is empty!");
+
+    stream->read_array(m_root.data(), m_root.size());
+    stream->read_array(m_root_bounds.data(), m_root_bounds.size());
+    stream->read_array(m_tiles.data(), m_tiles.size());
+    stream->read_array(m_tile_bounds.data(), m_tile_bounds.size());
+    stream->read_array(m_bricks.data(), m_bricks.size());
+    stream->read_array(m_constants.data(), m_constants.size());
+
+    // Lookups don't check indices, so reject corrupt files here
+    for (uint32_t entry : m_root) {
+        if (entry & ConstantFlag ? (entry & ~ConstantFlag) >= sizes[2] : entry >= sizes[0])
+            Throw("SparseGrid: invalid root entry 0x%08x (%u tiles, %u constants)",
+                  entry, sizes[0], sizes[2]);
+    }
+    for (uint32_t entry : m_tiles) {
+        if (entry & ConstantFlag ? (entry & ~ConstantFlag) >= sizes[2] : entry >= sizes[1])
+            Throw("SparseGrid: invalid tile entry 0x%08x (%u bricks, %u constants)",
+                  entry, sizes[1], sizes[2]);
+    }
+}
+
+void SparseGrid::write(Stream *stream) const {
+    float dims[6] = { m_bbox.min.x(), m_bbox.min.y(), m_bbox.min.z(),
+                      m_bbox.max.x(), m_bbox.max.y(), m_bbox.max.z() };
+    uint32_t sizes[4] = { (uint32_t) tile_count(), (uint32_t) brick_count(),
+                          (uint32_t) (m_constants.size() / m_channel_count),
+                          (uint32_t) m_root.size() };
+
+    stream->write("SVL", 3);
+    stream->write(sparse_grid_version);
+    stream->write_array(m_shape.data(), 3);
+    stream->write(m_channel_count);
+    stream->write_array(dims, 6);
+    stream->write(m_mean);
+    stream->write(m_max);
+    stream->write_array(sizes, 4);
+    stream->write_array(m_root.data(), m_root.size());
+    stream->write_array(m_root_bounds.data(), m_root_bounds.size());
+    stream->write_array(m_tiles.data(), m_tiles.size());
+    stream->write_array(m_tile_bounds.data(), m_tile_bounds.size());
+    stream->write_array(m_bricks.data(), m_bricks.size());
+    stream->write_array(m_constants.data(), m_constants.size());
+}
+
+void SparseGrid::write(const fs::path &filename) const {
+    ref<FileStream> stream = new FileStream(filename, FileStream::ETruncReadWrite);
+    write(stream);
+}
+
+float SparseGrid::voxel(const ScalarVector3i &p, uint32_t channel) const {
+    if (any(p < 0 || p >= m_shape) || channel >= m_channel_count)
+        Throw("SparseGrid::voxel(): out of bounds!");
+
+    ScalarVector3i tile  = p / int32_t(BrickRes * TileRes),
+                   brick = (p / int32_t(BrickRes)) % int32_t(TileRes),
+                   local = p % int32_t(BrickRes);
+
+    uint32_t entry = m_root[(tile.z() * m_root_shape.y() + tile.y()) * m_root_shape.x() + tile.x()];
+    if (!(entry & ConstantFlag))
+        entry = m_tiles[entry * (size_t) TileSize +
+                        (brick.z() * TileRes + brick.y()) * TileRes + brick.x()];
+
+    if (entry & ConstantFlag)
+        return m_constants[(entry & ~ConstantFlag) * (size_t) m_channel_count + channel];
+    else
+        return m_bricks[(entry * (size_t) BrickSize +
+                         (local.z() * BrickRes + local.y()) * BrickRes + local.x()) *
+                        m_channel_count + channel];
+}
+
+std::pair<float, float> SparseGrid::bounds(const ScalarVector3i &p) const {
+    if (any(p < 0 || p >= m_shape))
+        Throw("SparseGrid::bounds(): out of bounds!");
+
+    ScalarVector3i tile  = p / int32_t(BrickRes * TileRes),
+                   brick = (p / int32_t(BrickRes)) % int32_t(TileRes);
+
+    size_t root_index = (tile.z() * m_root_shape.y() + tile.y()) * m_root_shape.x() + tile.x();
+    uint32_t entry = m_root[root_index];
+    if (entry & ConstantFlag)
+        return { m_root_bounds[2 * root_index], m_root_bounds[2 * root_index + 1] };
+
+    size_t tile_index = entry * (size_t) TileSize +
+                        (brick.z() * TileRes + brick.y()) * TileRes + brick.x();
+    return { m_tile_bounds[2 * tile_index], m_tile_bounds[2 * tile_index + 1] };
+}
+
+size_t SparseGrid::size_bytes() const {
+    return (m_root.size() + m_tiles.size()) * sizeof(uint32_t) +
+           (m_bricks.size() + m_constants.size() + m_root_bounds.size() +
+            m_tile_bounds.size()) * sizeof(float);
+}
+
+std::string SparseGrid::to_string() const {
+    size_t dense_size =
+        array_size(m_shape) * (size_t) m_channel_count * sizeof(float);
+    std::ostringstream oss;
+    oss << "SparseGrid[" << std::endl
+        << "  shape = " << m_shape << "," << std::endl
+        << "  channels = " << m_channel_count << "," << std::endl
+        << "  tiles = " << tile_count() << " of " << m_root.size() << "," << std::endl
+        << "  bricks = " << brick_count() << "," << std::endl
+        << "  constants = " << m_constants.size() / m_channel_count << "," << std::endl
+        << "  mean = " << m_mean << "," << std::endl
+        << "  max = " << m_max << "," << std::endl
+        << "  size = " << util::mem_string(size_bytes()) << " (dense: "
+        << util::mem_string(dense_size) << ")" << std::endl
+        << "]";
+    return oss.str();
+}
+
+MTS_IMPLEMENT_CLASS(SparseGrid, Object)
+NAMESPACE_END(mitsuba)
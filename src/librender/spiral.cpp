@@ -8,7 +8,7 @@ NAMESPACE_BEGIN(mitsuba)
 Spiral::Spiral(Vector2i size, Vector2i offset, size_t block_size, size_t passes)
     : m_block_size(block_size),
       m_size(size), m_offset(offset),
-      m_remaining_passes(passes) {
+      m_remaining_passes(passes), m_order(Order::Spiral) {
 
     m_blocks = Vector2i(ceil(Vector2f(m_size) / m_block_size));
     m_block_count = hprod(m_blocks);
@@ -28,6 +28,31 @@ std::tuple<Spiral::Vector2i, Spiral::Vector2i, size_t> Spiral::next_block() {
     // Reimplementation of the spiraling block generator by Adam Arbree.
     std::lock_guard<tbb::spin_mutex> lock(m_mutex);
 
+    if (m_order == Order::Scanline) {
+        /* Traverse the rows of blocks from top to bottom, generating all
+           passes of a row before moving on to the next one */
+        size_t row_blocks = (size_t) m_blocks.x() * m_remaining_passes;
+        if (m_block_counter == m_block_count * m_remaining_passes)
+            return { Vector2i(0), Vector2i(0), (size_t) -1 };
+
+        size_t row   = m_block_counter / row_blocks,
+               index = m_block_counter % row_blocks,
+               pass  = index / m_blocks.x(),
+               col   = index % m_blocks.x();
+
+        // Calculate a unique identifer per block
+        size_t block_id = row * m_blocks.x() + col + pass * m_block_count;
+
+        Vector2i offset(Vector2i((int) col, (int) row) * (int) m_block_size);
+        Vector2i size = min((int) m_block_size, m_size - offset);
+        offset += m_offset;
+
+        Assert(all(size > 0));
+
+        ++m_block_counter;
+        return { offset, size, block_id };
+    }
+
     if (m_block_count == m_block_counter) {
         if (m_remaining_passes > 1) {
             --m_remaining_passes;
@@ -148,6 +148,132 @@ def test06_render_timeout(variants_cpu_rgb, int_name):
     assert ek.allclose(timeout, effective, atol=0.5)
 
 
+def test07_cost_aov(variants_cpu_rgb):
+    integrator = make_integrator('path', """<boolean name="cost_aov" value="true"/>""")
+    scene = SCENES['teapot']['factory'](spp=4)
+    sensor = scene.sensors()[0]
+    assert integrator.render(scene, sensor)
+
+    bitmap = sensor.film().bitmap(raw=False)
+    names = [bitmap.struct_()[i].name for i in range(len(bitmap.struct_()))]
+    expected = ['R', 'G', 'B', 'A', 'cost.kcycles']
+    if mitsuba.render.ray_counters_enabled():
+        expected.append('cost.rays')
+    assert names == expected
+
+    values = np.array(bitmap, copy=False)
+    assert np.all(values[..., 4] > 0)
+    if mitsuba.render.ray_counters_enabled():
+        # Every sample traces at least its camera ray
+        assert np.all(values[..., 5] >= 1 - 1e-3)
+
+
+def test08_numa_mode(variant_scalar_rgb):
+    from mitsuba.core import numa
+
+    def render():
+        scene = SCENES['teapot']['factory'](spp=4)
+        sensor = scene.sensors()[0]
+        assert make_integrator('path').render(scene, sensor)
+        return np.array(sensor.film().bitmap(raw=True), copy=True)
+
+    reference = render()
+    enabled = numa.enabled()
+    try:
+        # Scene data is placed at load time, images are accumulated per node
+        numa.set_enabled(True)
+        image = render()
+    finally:
+        numa.set_enabled(enabled)
+
+    assert np.allclose(image, reference, rtol=1e-4, atol=1e-6)
+
+
+@pytest.mark.parametrize('split_blocks', [False, True])
+@pytest.mark.parametrize('samples_per_pass', [1, 3])
+def test09_split_blocks(variant_scalar_rgb, split_blocks, samples_per_pass):
+    from mitsuba.core.xml import load_string
+
+    # With filter importance sampling and a box filter, every sample only
+    # contributes a unit weight to the pixel it was generated for
+    scene = load_string("""<scene version="2.0.0">
+        <sensor type="perspective">
+            <film type="hdrfilm">
+                <integer name="width" value="37"/>
+                <integer name="height" value="29"/>
+                <boolean name="filter_importance_sampling" value="true"/>
+                <rfilter type="box"/>
+            </film>
+            <sampler type="independent">
+                <integer name="sample_count" value="3"/>
+            </sampler>
+        </sensor>
+    </scene>""")
+    sensor = scene.sensors()[0]
+
+    integrator = make_integrator('depth', """
+        <integer name="block_size" value="16"/>
+        <integer name="samples_per_pass" value="{}"/>
+        <boolean name="split_blocks" value="{}"/>""".format(
+            samples_per_pass, 'true' if split_blocks else 'false'))
+    assert integrator.render(scene, sensor)
+
+    # Each pixel received all of its samples exactly once
+    weights = np.array(sensor.film().bitmap(raw=True), copy=False)[..., 4]
+    assert weights.shape == (29, 37)
+    assert np.allclose(weights, 3)
+
+
+def test10_streaming(variant_scalar_rgb, tmpdir):
+    from mitsuba.core import Bitmap, Struct
+    from mitsuba.core.xml import load_string
+
+    # The depth of a tilted plane varies smoothly, so both renders agree up to
+    # the jitter of the samples within the wide Gaussian footprint
+    def render(streaming):
+        scene = load_string("""<scene version="2.0.0">
+            <sensor type="perspective">
+                <film type="hdrfilm">
+                    <integer name="width" value="41"/>
+                    <integer name="height" value="37"/>
+                    <string name="component_format" value="float32"/>
+                    <boolean name="streaming" value="%s"/>
+                    <rfilter type="gaussian"/>
+                </film>
+                <sampler type="independent">
+                    <integer name="sample_count" value="32"/>
+                </sampler>
+            </sensor>
+            <shape type="rectangle">
+                <transform name="to_world">
+                    <scale value="20"/>
+                    <rotate x="1" angle="30"/>
+                    <translate z="5"/>
+                </transform>
+            </shape>
+        </scene>""" % streaming)
+        sensor = scene.sensors()[0]
+        film = sensor.film()
+        assert film.streaming() == (streaming == 'true')
+
+        filename = str(tmpdir.join('streaming_%s.exr' % streaming))
+        film.set_destination_file(filename)
+        integrator = make_integrator('depth', """
+            <integer name="block_size" value="8"/>
+            <integer name="samples_per_pass" value="8"/>
+            <boolean name="split_blocks" value="true"/>""")
+        assert integrator.render(scene, sensor)
+        film.develop()
+
+        return np.array(Bitmap(filename).convert(Bitmap.PixelFormat.RGBA, Struct.Type.Float32,
+                                                 srgb_gamma=False))
+
+    regular, streamed = render('false'), render('true')
+    assert regular.shape == streamed.shape == (37, 41, 4)
+    assert np.all(regular[..., 0] > 0) and np.allclose(regular[..., 3], 1)
+    assert np.allclose(regular, streamed, rtol=2e-2, atol=1e-4)
+
+
 def make_reference_renders():
     mitsuba.set_variant('scalar_rgb')
     from mitsuba.core import Bitmap, Struct
@@ -131,3 +131,157 @@ def test03_depth_packet_stairs(variant_packet_rgb):
     # TODO: spot-check (here, we only check consistency)
     assert ek.all(res_shadow == res.is_valid())
     compare_results(res_naive, res, atol=1e-6)
+
+
+@fresolver_append_path
+def test04_update_after_deformation(variant_scalar_rgb):
+    from mitsuba.core import Ray3f
+    from mitsuba.core.xml import load_string
+    from mitsuba.python.util import traverse
+
+    if mitsuba.core.MTS_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    scene = load_string("""
+        <scene version="2.0.0">
+            <shape type="ply" id="bunny">
+                <string name="filename" value="resources/data/common/meshes/bunny_lowres.ply"/>
+            </shape>
+        </scene>
+    """)
+
+    params = traverse(scene)
+    key = 'bunny.vertex_positions_buf'
+    positions = params[key]
+
+    # Stretch and shift the upper half of the mesh
+    b = scene.bbox()
+    center = b.center()
+    for i in range(len(positions) // 3):
+        if positions[3 * i + 1] > center[1]:
+            positions[3 * i + 1] += 0.5 * (positions[3 * i + 1] - center[1])
+            positions[3 * i + 2] += 0.1 * b.extents()[2]
+    params[key] = positions
+    params.update()
+
+    b = scene.bbox()
+    n = 50
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            o = [b.min[0] * (1 - x * inv_n) + b.max[0] * x * inv_n,
+                 b.min[1] * (1 - y * inv_n) + b.max[1] * y * inv_n,
+                 b.min[2] - 1]
+            r = Ray3f(o, [0, 0, 1], 0.5, [])
+            r.mint = 0
+            r.maxt = 100
+
+            res_naive  = scene.ray_intersect_naive(r)
+            res        = scene.ray_intersect(r)
+            res_shadow = scene.ray_test(r)
+            assert ek.all(res_shadow == res_naive.is_valid())
+            compare_results(res_naive, res)
+
+
+@fresolver_append_path
+@pytest.mark.parametrize('quality', ['fast', 'balanced', 'high', 'auto'])
+def test05_build_quality(variant_scalar_rgb, quality):
+    from mitsuba.core import Ray3f
+    from mitsuba.core.xml import load_string
+    if mitsuba.core.MTS_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    scene = load_string("""
+        <scene version="2.0.0">
+            <string name="kd_quality" value="%s"/>
+            <shape type="ply">
+                <string name="filename" value="resources/data/common/meshes/bunny_lowres.ply"/>
+            </shape>
+        </scene>
+    """ % quality)
+    b = scene.bbox()
+
+    n = 30
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            o = [b.min[0] * (1 - x * inv_n) + b.max[0] * x * inv_n,
+                 b.min[1] * (1 - y * inv_n) + b.max[1] * y * inv_n,
+                 b.min[2] - 1]
+            r = Ray3f(o, [0, 0, 1], 0.5, [])
+            r.mint = 0
+            r.maxt = 100
+
+            res_naive  = scene.ray_intersect_naive(r)
+            res        = scene.ray_intersect(r)
+            res_shadow = scene.ray_test(r)
+            assert ek.all(res_shadow == res_naive.is_valid())
+            compare_results(res_naive, res)
+
+
+@fresolver_append_path
+def test06_parallel_nlogn(variant_scalar_rgb):
+    from mitsuba.core import Ray3f
+    from mitsuba.core.xml import load_string
+
+    if mitsuba.core.MTS_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    # Use the O(n log n) builder everywhere and process most of its nodes in parallel
+    scene_str = """
+        <scene version="2.0.0">
+            <integer name="kd_exact_primitive_threshold" value="100000"/>
+            <integer name="kd_parallel_exact_threshold" value="%i"/>
+            <shape type="ply">
+                <string name="filename" value="resources/data/common/meshes/bunny_lowres.ply"/>
+            </shape>
+        </scene>
+    """
+    scene = load_string(scene_str % 64)
+    scene_serial = load_string(scene_str % 0)
+    b = scene.bbox()
+
+    n = 30
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            o = [b.min[0] * (1 - x * inv_n) + b.max[0] * x * inv_n,
+                 b.min[1] * (1 - y * inv_n) + b.max[1] * y * inv_n,
+                 b.min[2] - 1]
+            r = Ray3f(o, [0, 0, 1], 0.5, [])
+            r.mint = 0
+            r.maxt = 100
+
+            res_serial = scene_serial.ray_intersect(r)
+            res        = scene.ray_intersect(r)
+            assert ek.all(scene.ray_test(r) == res_serial.is_valid())
+            compare_results(res_serial, res)
+
+
+@fresolver_append_path
+def test07_build_quality_presets(variant_scalar_rgb):
+    from mitsuba.core import Properties
+    from mitsuba.core.xml import load_string
+    from mitsuba.render import ShapeKDTree, KDBuildQuality
+
+    if mitsuba.core.MTS_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    mesh = load_string("""
+        <shape version="2.0.0" type="ply">
+            <string name="filename" value="resources/data/common/meshes/bunny_lowres.ply"/>
+        </shape>
+    """)
+
+    def build(quality):
+        kdtree = ShapeKDTree(Properties())
+        kdtree.add_shape(mesh)
+        kdtree.set_build_quality(quality)
+        kdtree.build()
+        return kdtree.expected_cost()
+
+    # Builds are deterministic, and the 'fast' preset produces a tree with
+    # a SAH cost at least as high as the 'high' preset
+    fast_cost, high_cost = build(KDBuildQuality.Fast), build(KDBuildQuality.High)
+    assert build(KDBuildQuality.Fast) == fast_cost
+    assert fast_cost >= high_cost * (1 - 1e-4)
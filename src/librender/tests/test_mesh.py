@@ -648,3 +648,32 @@ def test16_differentiable_surface_interaction_params_backward(variant_gpu_autodi
     assert ek.allclose(ek.gradient(params[vertex_texcoords_key]),
                        [0, 2, 0, 0, 0, 0, 0, -2], atol=1e-5)
 
+
+
+def test17_compact_storage(variant_scalar_rgb):
+    from mitsuba.core import Ray3f, Vector3f
+    from mitsuba.render import Mesh
+
+    m = Mesh("MyMesh", 4, 2, has_vertex_normals=True, has_vertex_texcoords=True)
+    m.vertex_positions_buffer()[:] = [0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0]
+    m.vertex_texcoords_buffer()[:] = [0, 0, 1, 0, 1, 1, 0, 1]
+    m.faces_buffer()[:] = [0, 1, 2, 0, 2, 3]
+    m.parameters_changed()
+    m.vertex_normals_buffer()[:] = [0, 0, 1, 0.6, 0, 0.8, 0, -0.6, 0.8, 0, 0, -1]
+
+    ray = Ray3f(Vector3f(0.3, 0.6, -1.0), Vector3f(0.0, 0.0, 1.0), 0, [])
+    si_ref = m.ray_intersect_triangle(1, ray).compute_surface_interaction(ray)
+
+    vertex_bytes, face_bytes = m.vertex_data_bytes(), m.face_data_bytes()
+    assert not m.has_compact_storage()
+    m.compact_storage(compact_faces=True)
+    assert m.has_compact_storage()
+    assert m.has_vertex_normals() and m.has_vertex_texcoords()
+    assert m.vertex_data_bytes() == vertex_bytes - 12
+    assert m.face_data_bytes() == face_bytes // 2
+
+    si = m.ray_intersect_triangle(1, ray).compute_surface_interaction(ray)
+    assert ek.allclose(si.t, si_ref.t)
+    assert ek.allclose(si.p, si_ref.p)
+    assert ek.allclose(si.uv, si_ref.uv, atol=1e-3)
+    assert ek.allclose(si.sh_frame.n, si_ref.sh_frame.n, atol=1e-4)
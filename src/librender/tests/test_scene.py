@@ -102,3 +102,151 @@ def test03_shapes_parameters_grad_enabled(variant_gpu_autodiff_rgb):
     params.set_dirty(shape_param_key)
     params.update()
     assert scene.shapes_grad_enabled() == True
+
+
+@fresolver_append_path
+def test04_memory_statistics(variant_scalar_rgb):
+    from mitsuba.core import memory_statistics, memory_report
+    from mitsuba.core.xml import load_string
+
+    scene = load_string("""
+        <scene version="2.0.0">
+            <shape type="obj" id="box">
+                <string name="filename" value="resources/data/tests/obj/cbox_smallbox.obj"/>
+            </shape>
+            <sensor type="perspective">
+                <film type="hdrfilm">
+                    <integer name="width" value="16"/>
+                    <integer name="height" value="8"/>
+                </film>
+            </sensor>
+        </scene>
+    """)
+
+    records = memory_statistics(scene)
+    names = [r.name for r in records]
+    assert 'box' in names
+
+    # Records are sorted by decreasing size
+    totals = [r.total() for r in records]
+    assert totals == sorted(totals, reverse=True)
+
+    mesh = scene.shapes()[0]
+    box = records[names.index('box')]
+    assert box.class_name == 'OBJMesh'
+    assert box.usage['vertex data'] == mesh.vertex_count() * mesh.vertex_data_bytes()
+    assert box.usage['face data'] == mesh.face_count() * mesh.face_data_bytes()
+    assert box.total() == sum(box.usage.values())
+
+    # Each object only reports its own allocations
+    assert mesh.memory_usage() == box.usage
+
+    report = memory_report(records)
+    assert 'Memory usage' in report and 'box' in report
+
+
+@fresolver_append_path
+def test05_ray_intersect_batch(variant_scalar_rgb):
+    import numpy as np
+    from mitsuba.core import Ray3f
+    from mitsuba.core.xml import load_string
+
+    scene = load_string("""
+        <scene version="2.0.0">
+            <shape type="obj">
+                <string name="filename" value="resources/data/tests/obj/cbox_smallbox.obj"/>
+            </shape>
+            <shape type="sphere">
+                <point name="center" x="0" y="0" z="5"/>
+            </shape>
+        </scene>
+    """)
+
+    count = 1000
+    rng = np.random.RandomState(0)
+    o = np.zeros((count, 3), dtype=np.float32)
+    o[:, 2] = -5
+    d = rng.normal(size=(count, 3)).astype(np.float32)
+    d[:, 2] = np.abs(d[:, 2]) * 4
+    d /= np.linalg.norm(d, axis=1)[:, None]
+    maxt = np.full(count, 100, dtype=np.float32)
+    maxt[::10] = 1e-3
+
+    t = np.empty(count, dtype=np.float32)
+    prim_index = np.empty(count, dtype=np.uint32)
+    shape_index = np.empty(count, dtype=np.uint32)
+    prim_uv = np.empty((count, 2), dtype=np.float32)
+    hit = np.empty(count, dtype=np.bool_)
+
+    scene.ray_intersect_batch(o, d, t, prim_index, shape_index, prim_uv, maxt=maxt)
+    scene.ray_test_batch(o, d, hit, maxt=maxt)
+
+    assert np.any(hit) and not np.all(hit)
+    assert np.all(np.isfinite(t) == hit)
+
+    for i in range(count):
+        ray = Ray3f(o[i], d[i], 0, [])
+        ray.maxt = maxt[i]
+        pi = scene.ray_intersect_preliminary(ray)
+        assert pi.is_valid() == hit[i]
+        if hit[i]:
+            assert ek.allclose(pi.t, t[i])
+            assert shape_index[i] in (0, 1)
+            if shape_index[i] == 0:
+                # Triangle hit: primitive index and barycentrics must match
+                assert pi.prim_index == prim_index[i]
+                assert ek.allclose(pi.prim_uv, prim_uv[i])
+        else:
+            assert prim_index[i] == 0xFFFFFFFF and shape_index[i] == 0xFFFFFFFF
+
+    # Output arrays are validated rather than silently copied
+    with pytest.raises(RuntimeError):
+        scene.ray_intersect_batch(o, d, t.astype(np.float64), prim_index,
+                                  shape_index, prim_uv)
+
+
+def test06_ray_counters(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+    from mitsuba.core import Ray3f
+    from mitsuba.render import ray_counters, ray_counters_enabled, ray_counters_reset
+
+    scene = load_string("""<scene version="2.0.0">
+        <shape type="sphere"/>
+    </scene>""")
+
+    ray_counters_reset()
+    for i in range(10):
+        scene.ray_intersect(Ray3f([0, 0, -5], [0, 0, 1], 0, []))
+    for i in range(5):
+        scene.ray_test(Ray3f([0, 0, -5], [0, 1, 0], 0, []))
+
+    counters = ray_counters()
+    if ray_counters_enabled():
+        assert counters.values['Closest-hit rays'] == 10
+        assert counters.values['Shadow rays'] == 5
+        assert counters.rays() == 15
+        assert counters.nodes_per_ray() >= 1
+    else:
+        assert counters.rays() == 0
+
+    # Rays traced through the batch interface are counted as well
+    import numpy as np
+    count = 1000
+    o = np.tile(np.array([0, 0, -5], dtype=np.float32), (count, 1))
+    d = np.tile(np.array([0, 0, 1], dtype=np.float32), (count, 1))
+    ray_counters_reset()
+    scene.ray_intersect_batch(o, d, np.empty(count, dtype=np.float32),
+                              np.empty(count, dtype=np.uint32),
+                              np.empty(count, dtype=np.uint32),
+                              np.empty((count, 2), dtype=np.float32))
+    scene.ray_test_batch(o, d, np.empty(count, dtype=np.bool_))
+
+    counters = ray_counters()
+    if ray_counters_enabled():
+        assert counters.values['Closest-hit rays'] == count
+        assert counters.values['Shadow rays'] == count
+    else:
+        assert counters.rays() == 0
+
+    ray_counters_reset()
+    assert ray_counters().rays() == 0
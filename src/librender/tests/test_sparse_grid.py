@@ -0,0 +1,132 @@
+import numpy as np
+import pytest
+
+import mitsuba
+
+from mitsuba.python.test.util import tmpfile
+
+
+def sparse_data(shape=(40, 70, 20), channels=1, seed=0):
+    """Mostly empty grid with a dense blob, a constant region, and noise"""
+    rng = np.random.RandomState(seed)
+    data = np.zeros(shape + (channels,), dtype=np.float32)
+    data[4:13, 10:30, 3:17] = rng.uniform(size=(9, 20, 14, channels))
+    data[24:40, 64:70, :] = 0.5
+    data[30, 5, 7] = 2.0
+    return data
+
+
+def test01_sparse_grid_lookup(variant_scalar_rgb):
+    from mitsuba.render import SparseGrid
+
+    data = sparse_data()
+    grid = SparseGrid(data)
+
+    assert list(grid.shape()) == [20, 70, 40]
+    assert grid.channel_count() == 1
+    assert grid.max() == 2.0
+    assert np.isclose(grid.mean(), data.mean())
+
+    # Empty and constant bricks are elided
+    assert grid.brick_count() < np.prod([(s + 7) // 8 for s in data.shape[:3]])
+    assert grid.size_bytes() < data.nbytes
+
+    for z, y, x in [(0, 0, 0), (5, 12, 4), (12, 29, 16), (30, 5, 7),
+                    (39, 69, 19), (25, 66, 10), (13, 30, 17)]:
+        assert grid.voxel([x, y, z]) == data[z, y, x, 0]
+
+        # Bounds cover the trilinear footprint of the voxel
+        lo, hi = grid.bounds([x, y, z])
+        region = data[max(z - 1, 0):z + 2, max(y - 1, 0):y + 2, max(x - 1, 0):x + 2]
+        assert lo <= region.min() and hi >= region.max()
+
+
+def test02_sparse_grid_io(variant_scalar_rgb, tmpfile):
+    from mitsuba.render import SparseGrid
+    from mitsuba.python.volume import write_dense_volume, convert_to_sparse
+
+    data = sparse_data(channels=3)
+    write_dense_volume(tmpfile, data)
+    grid = convert_to_sparse(tmpfile, tmpfile + '.svol')
+    grid2 = SparseGrid(tmpfile + '.svol')
+
+    assert list(grid2.shape()) == list(grid.shape())
+    assert grid2.channel_count() == 3
+    assert grid2.brick_count() == grid.brick_count()
+    for z, y, x in [(5, 12, 4), (30, 5, 7), (25, 66, 10)]:
+        for c in range(3):
+            assert grid2.voxel([x, y, z], c) == data[z, y, x, c]
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+@pytest.mark.parametrize('wrap_mode', ['clamp', 'repeat', 'mirror'])
+def test03_sparse_volume_eval(variant_scalar_rgb, tmpfile, filter_type, wrap_mode):
+    from mitsuba.core.xml import load_string
+    from mitsuba.render import Interaction3f
+    from mitsuba.python.volume import write_dense_volume
+
+    data = sparse_data()
+    write_dense_volume(tmpfile, data)
+
+    volume_str = """<volume type="%s" version="2.0.0">
+        <string name="filename" value="%s"/>
+        <string name="filter_type" value="%s"/>
+        <string name="wrap_mode" value="%s"/>
+    </volume>"""
+    dense = load_string(volume_str % ('gridvolume', tmpfile, filter_type, wrap_mode))
+    sparse = load_string(volume_str % ('sparsegridvolume', tmpfile, filter_type, wrap_mode))
+
+    assert sparse.max() == dense.max()
+    assert list(sparse.resolution()) == list(dense.resolution())
+
+    rng = np.random.RandomState(1)
+    it = Interaction3f()
+    for i in range(500):
+        it.p = rng.uniform(-0.1, 1.1, size=3)
+        v = sparse.eval_1(it)
+        assert np.isclose(v, dense.eval_1(it), atol=1e-6)
+
+        lo, hi = sparse.eval_bounds(it)
+        assert lo - 1e-6 <= v <= hi + 1e-6
+
+
+def test04_sparse_grid_slabs(variant_scalar_rgb, tmpfile):
+    from mitsuba.render import SparseGrid
+    from mitsuba.python.volume import write_dense_volume
+
+    # Several slabs of tiles, with features straddling the slab boundaries
+    data = np.zeros((150, 20, 10, 1), dtype=np.float32)
+    data[60:70, 2:9, 1:5] = np.random.RandomState(3).uniform(size=(10, 7, 4, 1))
+    data[128, 10, 5] = 3.0
+    write_dense_volume(tmpfile, data)
+
+    grid = SparseGrid(tmpfile)
+    reference = SparseGrid(data)
+    assert grid.brick_count() == reference.brick_count()
+    assert grid.max() == 3.0
+    assert np.isclose(grid.mean(), data.mean())
+
+    for z, y, x in [(63, 4, 2), (64, 4, 2), (69, 8, 4), (127, 10, 5), (128, 10, 5)]:
+        assert grid.voxel([x, y, z]) == data[z, y, x, 0]
+        assert grid.bounds([x, y, z]) == reference.bounds([x, y, z])
+        region = data[z - 1:z + 2, y - 1:y + 2, x - 1:x + 2]
+        lo, hi = grid.bounds([x, y, z])
+        assert lo <= region.min() and hi >= region.max()
+
+
+def test05_sparse_grid_corrupt(variant_scalar_rgb, tmpfile):
+    from mitsuba.render import SparseGrid
+
+    SparseGrid(sparse_data()).write(tmpfile)
+    with open(tmpfile, 'rb') as f:
+        contents = bytearray(f.read())
+
+    # Make the first root entry reference a tile that doesn't exist
+    header_size = 3 + 1 + 12 + 4 + 24 + 8 + 4 + 16
+    contents[header_size:header_size + 4] = np.uint32(0x7fffffff).tobytes()
+    with open(tmpfile, 'wb') as f:
+        f.write(contents)
+
+    with pytest.raises(Exception, match='invalid root entry'):
+        SparseGrid(tmpfile)
+
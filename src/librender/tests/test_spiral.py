@@ -82,3 +82,28 @@ def test03_normal_film(variant_scalar_rgb):
     # Resetting and re-querying the blocks should yield the exact same results.
     s.reset()
     check_first_blocks(extract_blocks(s), expected, n_total=110)
+
+
+def test04_scanline_order(variant_scalar_rgb):
+    from mitsuba.render import Spiral
+
+    f = make_film(100, 70)
+    s = Spiral(f.size(), f.crop_offset(), 32, 2)
+    s.set_order(Spiral.Order.Scanline)
+    assert s.order() == Spiral.Order.Scanline
+
+    blocks = extract_blocks(s)
+    assert len(blocks) == 2 * s.block_count()
+
+    # Both passes of a row are generated before the next row
+    w = 32
+    for row in range(3):
+        for p in range(2):
+            for col in range(4):
+                (bo, bs, bi) = blocks[row * 8 + p * 4 + col]
+                assert ek.all(bo == [col * w, row * w])
+                assert ek.all(bs == [min(w, 100 - col * w), min(w, 70 - row * w)])
+                assert bi == row * 4 + col + p * s.block_count()
+
+    # Block identifiers are unique
+    assert len(set(b[2] for b in blocks)) == len(blocks)
@@ -114,6 +114,11 @@ Volume<Float, Spectrum>::eval_gradient(const Interaction3f & /*it*/, Mask /*acti
 MTS_VARIANT typename Volume<Float, Spectrum>::ScalarFloat
 Volume<Float, Spectrum>::max() const { NotImplementedError("max"); }
 
+MTS_VARIANT std::pair<Float, Float>
+Volume<Float, Spectrum>::eval_bounds(const Interaction3f & /*it*/, Mask /*active*/) const {
+    return { Float(0.f), Float(max()) };
+}
+
 MTS_VARIANT typename Volume<Float, Spectrum>::ScalarVector3i
 Volume<Float, Spectrum>::resolution() const {
     return ScalarVector3i(1, 1, 1);
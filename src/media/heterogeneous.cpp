@@ -28,6 +28,13 @@ public:
 
         m_max_density = m_scale * m_sigmat->max();
         m_aabb        = m_sigmat->bbox();
+
+        /* Control extinction for residual ratio tracking, as a fraction of
+           the majorant. The default minimizes the residual majorant for
+           extinction values within [0, majorant]. */
+        m_control_density = m_max_density * props.float_("control_fraction", 0.5f);
+        if (m_control_density < 0.f || m_control_density > m_max_density)
+            Throw("\"control_fraction\" must be in [0, 1]!");
     }
 
     UnpolarizedSpectrum
@@ -38,6 +45,15 @@ public:
         return m_max_density;
     }
 
+    std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>
+    get_control_extinction(const MediumInteraction3f & /* mi */,
+                           Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        // Extinction values lie within [0, m_max_density]
+        return { m_control_density,
+                 std::max(m_max_density - m_control_density, m_control_density) };
+    }
+
     std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>
     get_scattering_coefficients(const MediumInteraction3f &mi,
                                 Mask active) const override {
@@ -77,6 +93,7 @@ private:
 
     ScalarBoundingBox3f m_aabb;
     ScalarFloat m_max_density;
+    ScalarFloat m_control_density;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(HeterogeneousMedium, Medium)
@@ -38,6 +38,14 @@ public:
         return eval_sigmat(mi);
     }
 
+    std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>
+    get_control_extinction(const MediumInteraction3f &mi,
+                           Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        // The extinction is constant: there is no residual to track
+        return { eval_sigmat(mi), UnpolarizedSpectrum(0.f) };
+    }
+
     std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>
     get_scattering_coefficients(const MediumInteraction3f &mi,
                                 Mask active) const override {
@@ -0,0 +1,68 @@
+import numpy as np
+import pytest
+
+import mitsuba
+
+from mitsuba.python.test.util import tmpfile
+
+
+def make_sampler():
+    from mitsuba.core.xml import load_string
+    return load_string("""<sampler version="2.0.0" type="independent">
+            <integer name="sample_count" value="1"/>
+        </sampler>""")
+
+
+def test01_homogeneous_exact(variant_scalar_rgb):
+    from mitsuba.core import Ray3f
+    from mitsuba.core.xml import load_string
+
+    medium = load_string("""<medium version="2.0.0" type="homogeneous">
+            <rgb name="sigma_t" value="0.5, 1.0, 2.0"/>
+        </medium>""")
+
+    # The control extinction matches exactly: no collisions are sampled
+    ray = Ray3f([0, 0, 0], [0, 0, 1], 0, [])
+    ray.maxt = 1.5
+    tr = medium.eval_tr_residual_ratio(ray, make_sampler(), 0)
+    assert np.allclose(tr, np.exp(-1.5 * np.array([0.5, 1.0, 2.0])))
+
+
+@pytest.mark.parametrize('control_fraction', [0.0, 0.5, 0.8, 1.0])
+def test02_heterogeneous_unbiased(variant_scalar_rgb, tmpfile, control_fraction):
+    from mitsuba.core import Ray3f
+    from mitsuba.core.xml import load_string
+    from mitsuba.python.volume import write_dense_volume
+
+    write_dense_volume(tmpfile, np.full((4, 4, 4), 0.6))
+    medium = load_string("""<medium version="2.0.0" type="heterogeneous">
+            <volume type="gridvolume" name="sigma_t">
+                <string name="filename" value="%s"/>
+            </volume>
+            <float name="scale" value="2"/>
+            <float name="control_fraction" value="%f"/>
+        </medium>""" % (tmpfile, control_fraction))
+
+    control, residual = medium.get_control_extinction(mitsuba.render.MediumInteraction3f())
+    assert np.allclose(control, 1.2 * control_fraction)
+    assert np.allclose(residual, 1.2 * max(control_fraction, 1 - control_fraction))
+
+    # The ray enters the unit cube at t=1 and leaves it at t=2
+    ray = Ray3f([0.5, 0.5, -1], [0, 0, 1], 0, [])
+    sampler = make_sampler()
+    tr = np.mean([medium.eval_tr_residual_ratio(ray, sampler, 0)[0]
+                  for i in range(10000)])
+    assert np.isclose(tr, np.exp(-1.2), atol=2e-2)
+
+
+def test03_invalid_mode(variant_scalar_rgb):
+    from mitsuba.core.xml import load_string
+
+    for integrator in ['volpath', 'volpathmis']:
+        load_string("""<integrator version="2.0.0" type="%s">
+                <string name="transmittance" value="residual_ratio"/>
+            </integrator>""" % integrator)
+        with pytest.raises(Exception):
+            load_string("""<integrator version="2.0.0" type="%s">
+                    <string name="transmittance" value="delta"/>
+                </integrator>""" % integrator)
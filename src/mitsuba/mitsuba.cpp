@@ -3,8 +3,10 @@
 #include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/hugepages.h>
 #include <mitsuba/core/jit.h>
 #include <mitsuba/core/logger.h>
+#include <mitsuba/core/numa.h>
 #include <mitsuba/core/profiler.h>
 #include <mitsuba/core/thread.h>
 #include <mitsuba/core/util.h>
@@ -53,6 +55,14 @@ Options:
     -t <count>, --threads <count>
         Render with the specified number of threads.
 
+    --numa
+        Pin the render threads to NUMA nodes, interleave the scene
+        data across nodes, and accumulate the image per node.
+
+    --huge-pages
+        Back large scene buffers (kd-tree, meshes, textures, volumes)
+        by huge pages to reduce TLB misses during rendering.
+
     -D <key>=<value>, --define <key>=<value>
         Define a constant that can referenced as "$key"
         within the scene description.
@@ -93,6 +103,8 @@ bool render(Object *scene_, size_t sensor_i, filesystem::path filename) {
     if (!integrator)
         Throw("No integrator specified for scene: %s", scene);
 
+    Log(Info, "Scene loaded. %s", memory_report(memory_statistics(scene), 10));
+
     /* critical section */ {
         std::lock_guard<std::mutex> guard(develop_callback_mutex);
         develop_callback = [&]() { film->develop(); };
@@ -102,6 +114,7 @@ bool render(Object *scene_, size_t sensor_i, filesystem::path filename) {
         std::lock_guard<std::mutex> guard(develop_callback_mutex);
         develop_callback = nullptr;
     }
+    Log(Info, "Rendering finished. %s", memory_report(memory_statistics(scene), 10));
     if (success)
         film->develop();
     else
@@ -134,6 +147,8 @@ int main(int argc, char *argv[]) {
     ArgParser parser;
     using StringVec    = std::vector<std::string>;
     auto arg_threads   = parser.add(StringVec{ "-t", "--threads" }, true);
+    auto arg_numa      = parser.add(StringVec{ "--numa" }, false);
+    auto arg_hugepages = parser.add(StringVec{ "--huge-pages" }, false);
     auto arg_verbose   = parser.add(StringVec{ "-v", "--verbose" }, false);
     auto arg_define    = parser.add(StringVec{ "-D", "--define" }, true);
     auto arg_sensor_i  = parser.add(StringVec{ "-s", "--sensor" }, true);
@@ -189,6 +204,13 @@ int main(int argc, char *argv[]) {
 
         size_t sensor_i  = (*arg_sensor_i ? arg_sensor_i->as_int() : 0);
 
+        // Workers are pinned to NUMA nodes when they join the task scheduler
+        if (*arg_numa)
+            numa::set_enabled(true);
+
+        if (*arg_hugepages)
+            HugePageBuffer::set_enabled(true);
+
         // Initialize Intel Thread Building Blocks with the requested number of threads
         if (*arg_threads)
             __global_thread_count = arg_threads->as_int();
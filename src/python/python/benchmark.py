@@ -0,0 +1,212 @@
+"""
+Micro-benchmarks of Mitsuba's core data structures.
+
+The module can be run as a script, e.g.
+
+    python -m mitsuba.python.benchmark scene.xml --threads 1 2 4 8
+
+which prints the scaling curve of the kd-tree construction for the shapes of
+the given scene, or
+
+    python -m mitsuba.python.benchmark scene.xml --numa
+
+which compares the render time of the scene with and without the NUMA mode
+(see ``mitsuba.core.numa``).
+"""
+
+import time
+
+import mitsuba
+
+
+def _thread_counts(max_threads=None):
+    """Powers of two up to (and including) the number of cores"""
+    from mitsuba.core import util
+    max_threads = max_threads if max_threads is not None else util.core_count()
+    counts, count = [], 1
+    while count < max_threads:
+        counts.append(count)
+        count *= 2
+    counts.append(max_threads)
+    return counts
+
+
+def kdtree_build_time(shapes, properties={}, repeats=3):
+    """
+    Return the smallest wall-clock time (in seconds) needed to build a kd-tree
+    over ``shapes`` using the current number of threads.
+
+    Parameter ``properties`` (``dict``):
+        kd-tree parameters (e.g. ``kd_quality``) passed to the ``ShapeKDTree``
+        constructor.
+
+    Parameter ``repeats`` (``int``):
+        Number of builds, the fastest one is reported.
+    """
+    from mitsuba.core import Properties
+    from mitsuba.render import ShapeKDTree
+
+    props = Properties()
+    for key, value in properties.items():
+        props[key] = value
+
+    best = float('inf')
+    for i in range(repeats):
+        kdtree = ShapeKDTree(props)
+        for shape in shapes:
+            kdtree.add_shape(shape)
+        start = time.perf_counter()
+        kdtree.build()
+        best = min(best, time.perf_counter() - start)
+        del kdtree
+    return best
+
+
+def kdtree_scaling(shapes, thread_counts=None, properties={}, repeats=3):
+    """
+    Measure the kd-tree construction time of ``shapes`` for a sequence of
+    thread counts.
+
+    The builder is run twice per thread count: once with the default
+    configuration, and once with the parallel O(n log n) builder disabled
+    (``kd_parallel_exact_threshold=0``), which shows the contribution of the
+    latter.
+
+    Returns a list of tuples ``(threads, time, time_serial_nlogn)``.
+    """
+    from mitsuba.core import set_thread_count
+
+    if thread_counts is None:
+        thread_counts = _thread_counts()
+
+    serial_props = dict(properties)
+    serial_props['kd_parallel_exact_threshold'] = 0
+
+    result = []
+    try:
+        for threads in thread_counts:
+            set_thread_count(threads)
+            result.append((
+                threads,
+                kdtree_build_time(shapes, properties, repeats),
+                kdtree_build_time(shapes, serial_props, repeats)
+            ))
+    finally:
+        set_thread_count(-1)
+    return result
+
+
+def format_scaling(results):
+    """Turn the output of :py:func:`kdtree_scaling` into a table"""
+    lines = ['%8s %12s %9s %11s %12s %9s' % ('Threads', 'Time [ms]',
+             'Speedup', 'Efficiency', 'Serial [ms]', 'Speedup')]
+    base, base_serial = results[0][1], results[0][2]
+    for threads, t, t_serial in results:
+        lines.append('%8i %12.2f %8.2fx %10.1f%% %12.2f %8.2fx' % (
+            threads, t * 1000, base / t, 100 * base / (t * threads),
+            t_serial * 1000, base_serial / t_serial))
+    return '\n'.join(lines)
+
+
+def render_time(filename, numa_mode=False, repeats=3):
+    """
+    Return the smallest wall-clock time (in seconds) needed to render the
+    scene file ``filename`` with its own integrator and first sensor.
+
+    Parameter ``numa_mode`` (``bool``):
+        Enable the NUMA mode while loading and rendering the scene. The task
+        scheduler is recreated so that its workers are pinned accordingly,
+        and the scene is reloaded for every render since its data is placed
+        at load time.
+
+    Parameter ``repeats`` (``int``):
+        Number of renders, the fastest one is reported.
+    """
+    from mitsuba.core import numa, set_thread_count
+    from mitsuba.core.xml import load_file
+
+    enabled = numa.enabled()
+    best = float('inf')
+    try:
+        numa.set_enabled(numa_mode)
+        set_thread_count(-1)
+        for i in range(repeats):
+            scene = load_file(filename)
+            sensor = scene.sensors()[0]
+            start = time.perf_counter()
+            scene.integrator().render(scene, sensor)
+            best = min(best, time.perf_counter() - start)
+            del scene, sensor
+    finally:
+        numa.set_enabled(enabled)
+        set_thread_count(-1)
+    return best
+
+
+def numa_comparison(filename, repeats=3):
+    """
+    Measure the render time of the scene file ``filename`` without and with
+    the NUMA mode.
+
+    Returns a list of tuples ``(numa_mode, time)``.
+    """
+    return [(mode, render_time(filename, mode, repeats)) for mode in [False, True]]
+
+
+def format_numa(results):
+    """Turn the output of :py:func:`numa_comparison` into a table"""
+    from mitsuba.core import numa
+
+    lines = ['NUMA nodes: %i' % numa.node_count(),
+             '%8s %12s %9s' % ('Mode', 'Time [ms]', 'Speedup')]
+    base = results[0][1]
+    for mode, t in results:
+        lines.append('%8s %12.2f %8.2fx' % ('numa' if mode else 'default',
+                                            t * 1000, base / t))
+    return '\n'.join(lines)
+
+
+def main(args=None):
+    import argparse
+
+    parser = argparse.ArgumentParser(
+        prog='python -m mitsuba.python.benchmark',
+        description='Measure the scaling of the kd-tree construction, or '
+        'compare render times with and without the NUMA mode.')
+    parser.add_argument('scene', help='Scene file (XML) providing the shapes')
+    parser.add_argument('-m', '--variant', default='scalar_rgb',
+                        help='Mitsuba variant (default: scalar_rgb)')
+    parser.add_argument('-t', '--threads', type=int, nargs='+',
+                        help='Thread counts (default: powers of two up to '
+                        'the number of cores)')
+    parser.add_argument('-q', '--quality', default='balanced',
+                        help='kd-tree quality preset (default: balanced)')
+    parser.add_argument('-r', '--repeats', type=int, default=3,
+                        help='Builds or renders per configuration (default: 3)')
+    parser.add_argument('--numa', action='store_true',
+                        help='Compare render times with and without the NUMA mode')
+    args = parser.parse_args(args)
+
+    mitsuba.set_variant(args.variant)
+    from mitsuba.core import Thread, LogLevel
+    from mitsuba.core.xml import load_file
+
+    Thread.thread().logger().set_log_level(LogLevel.Warn)
+
+    if args.numa:
+        print('Rendering (%s)' % args.scene)
+        print(format_numa(numa_comparison(args.scene, args.repeats)))
+        return
+
+    scene = load_file(args.scene)
+    shapes = scene.shapes()
+
+    results = kdtree_scaling(shapes, args.threads,
+                             {'kd_quality': args.quality}, args.repeats)
+    print('kd-tree construction (%i shapes, %s quality)' %
+          (len(shapes), args.quality))
+    print(format_scaling(results))
+
+
+if __name__ == '__main__':
+    main()
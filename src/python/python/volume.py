@@ -0,0 +1,71 @@
+"""
+Utilities for Mitsuba's volume file formats.
+
+Dense binary volume files (``.vol``) can be converted into sparse grids
+(see ``mitsuba.render.SparseGrid``) from the command line:
+
+    python -m mitsuba.python.volume input.vol output.svol
+"""
+
+import numpy as np
+
+import mitsuba
+
+
+def write_dense_volume(filename, data, bbox=([0, 0, 0], [1, 1, 1])):
+    """
+    Write a dense Mitsuba binary volume file (version 3, float32 values).
+
+    Parameter ``data`` (``numpy.ndarray``):
+        Voxel values with shape ``[z, y, x]`` or ``[z, y, x, channels]``
+
+    Parameter ``bbox`` (``tuple``):
+        Minimum and maximum corner of the volume's bounding box
+    """
+    data = np.asarray(data, dtype=np.float32)
+    if data.ndim == 3:
+        data = data[..., np.newaxis]
+    if data.ndim != 4:
+        raise ValueError('Expected an array with shape [z, y, x] or [z, y, x, channels]')
+
+    with open(filename, 'wb') as f:
+        f.write(b'VOL')
+        f.write(np.uint8(3).tobytes())
+        f.write(np.int32(1).tobytes())
+        f.write(np.array([data.shape[2], data.shape[1], data.shape[0],
+                          data.shape[3]], dtype=np.int32).tobytes())
+        f.write(np.array(list(bbox[0]) + list(bbox[1]), dtype=np.float32).tobytes())
+        f.write(np.ascontiguousarray(data).tobytes())
+
+
+def convert_to_sparse(src, dst):
+    """
+    Convert the dense volume file ``src`` into the sparse grid file ``dst``
+    and return the resulting ``mitsuba.render.SparseGrid``.
+    """
+    from mitsuba.render import SparseGrid
+
+    grid = SparseGrid(src)
+    grid.write(dst)
+    return grid
+
+
+def main(args=None):
+    import argparse
+
+    parser = argparse.ArgumentParser(
+        prog='python -m mitsuba.python.volume',
+        description='Convert a dense volume (.vol) into a sparse grid.')
+    parser.add_argument('input', help='Dense volume file')
+    parser.add_argument('output', help='Sparse grid file')
+    parser.add_argument('-m', '--variant', default='scalar_rgb',
+                        help='Mitsuba variant (default: scalar_rgb)')
+    args = parser.parse_args(args)
+
+    mitsuba.set_variant(args.variant)
+    grid = convert_to_sparse(args.input, args.output)
+    print(grid)
+
+
+if __name__ == '__main__':
+    main()
@@ -134,3 +134,28 @@ def test09_resampler_filter_only(variant_scalar_rgb):
     assert ek.allclose(b[0], (G(0) * a[0] + G(1) * (a[1] + a[2])) / (G(0) + 2*G(1)))
     assert ek.allclose(b[1], (G(0) * a[1] + G(1) * (a[0] + a[2])) / (G(0) + 2*G(1)))
     assert ek.allclose(b[2], (G(0) * a[2] + G(1) * (a[0] + a[1])) / (G(0) + 2*G(1)))
+
+
+@pytest.mark.parametrize('filter_type', ['box', 'gaussian', 'mitchell', 'lanczos'])
+def test10_sample(variant_scalar_rgb, filter_type):
+    from mitsuba.core.xml import load_string
+    import numpy as np
+
+    f = load_string("<rfilter version='2.0.0' type='%s'/>" % filter_type)
+    r = f.radius()
+
+    n = 10000
+    samples = [f.sample((i + 0.5) / n) for i in range(n)]
+    x = np.array([s[0] for s in samples])
+    w = np.array([s[1] for s in samples])
+
+    assert np.all(np.abs(x) <= r)
+    assert np.all(np.abs(w) == 1)
+    signs = np.array([1.0 if f.eval_discretized(v) >= 0 else -1.0 for v in x])
+    assert np.mean(w != signs) < 1e-3 # (may differ exactly at bin boundaries)
+
+    # The expected sample weight is the ratio of the signed and absolute filter integrals
+    t = np.linspace(-r, r, 20001)
+    values = np.array([f.eval_discretized(v) for v in t])
+    ratio = np.sum(values) / np.sum(np.abs(values))
+    assert np.allclose(np.mean(w), ratio, atol=1e-2)
@@ -0,0 +1,117 @@
+#include <mitsuba/render/mesh.h>
+#include <mitsuba/core/bundle.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/* Internal plugin: triangle mesh stored in a scene bundle (see SceneBundle).
+
+   Meshes replace their construction parameters by a reference to this plugin
+   when written to a bundle (Mesh::write_bundle()). The vertex, face and
+   attribute buffers then directly reference the memory-mapped bundle file in
+   the CPU variants of the renderer, and are copied to the GPU otherwise. */
+
+template <typename Float, typename Spectrum>
+class BundleMesh final : public Mesh<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Mesh, m_name, m_bbox, m_vertex_count, m_face_count,
+                    m_vertex_positions_buf, m_vertex_normals_buf, m_vertex_texcoords_buf,
+                    m_faces_buf, m_vertex_normals_oct_buf, m_vertex_texcoords_half_buf,
+                    m_faces_short_buf, m_compact_normals, m_compact_texcoords,
+                    m_compact_faces, m_mesh_attributes, set_children)
+    MTS_IMPORT_TYPES()
+
+    using typename Base::ScalarSize;
+    using typename Base::InputFloat;
+    using typename Base::InputPoint3f;
+    using typename Base::FloatStorage;
+
+    BundleMesh(const Properties &props) : Base(props) {
+        m_bundle = (const SceneBundle *) props.pointer("bundle");
+        m_name = props.string("name");
+        m_vertex_count = (ScalarSize) props.long_("vertex_count");
+        m_face_count = (ScalarSize) props.long_("face_count");
+
+        Timer timer;
+        m_vertex_positions_buf = map_buffer<FloatStorage>(props, "positions", m_vertex_count * 3);
+        if (props.has_property("normals"))
+            m_vertex_normals_buf = map_buffer<FloatStorage>(props, "normals", m_vertex_count * 3);
+        if (props.has_property("texcoords"))
+            m_vertex_texcoords_buf = map_buffer<FloatStorage>(props, "texcoords", m_vertex_count * 2);
+        if (props.has_property("faces"))
+            m_faces_buf = map_buffer<DynamicBuffer<UInt32>>(props, "faces", m_face_count * 3);
+
+        if (props.has_property("normals_oct")) {
+            m_vertex_normals_oct_buf =
+                map_buffer<DynamicBuffer<UInt32>>(props, "normals_oct", m_vertex_count);
+            m_compact_normals = true;
+        }
+        if (props.has_property("texcoords_half")) {
+            m_vertex_texcoords_half_buf =
+                map_buffer<DynamicBuffer<UInt32>>(props, "texcoords_half", m_vertex_count);
+            m_compact_texcoords = true;
+        }
+        if (props.has_property("faces_short")) {
+            m_faces_short_buf = map_buffer<DynamicBuffer<UInt32>>(props, "faces_short");
+            m_compact_faces = true;
+        }
+
+        /* Attributes are stored after conversion (e.g. to spectral model
+           coefficients), hence they are not registered via add_attribute() */
+        for (const std::string &key : props.property_names()) {
+            if (!string::starts_with(key, "attribute_") || !props.has_property(key + "_size"))
+                continue;
+            std::string name = key.substr(10);
+            size_t size = (size_t) props.long_(key + "_size");
+            auto type = string::starts_with(name, "vertex_") ? Base::MeshAttributeType::Vertex
+                                                             : Base::MeshAttributeType::Face;
+            m_mesh_attributes.insert({ name, { size, type, map_buffer<FloatStorage>(props, key) } });
+        }
+
+        // Compute the bounding box from the mapped data (also valid in GPU mode)
+        const InputFloat *position = (const InputFloat *) m_bundle->blob(props.long_("positions"));
+        for (ScalarSize i = 0; i < m_vertex_count; ++i)
+            m_bbox.expand(ScalarPoint3f(load_unaligned<InputPoint3f>(position + 3 * i)));
+
+        Log(Debug, "\"%s\": mapped %i faces, %i vertices from scene bundle (took %s)",
+            m_name, m_face_count, m_vertex_count, util::time_string(timer.value()));
+
+        set_children();
+    }
+
+    MTS_DECLARE_CLASS()
+
+private:
+    /**
+     * Reference a data block of the bundle as a buffer. The data is mapped
+     * without copying in the CPU variants and uploaded in the GPU variants.
+     * When \c expected is nonzero, the block must contain exactly this many
+     * entries.
+     */
+    template <typename Buffer>
+    Buffer map_buffer(const Properties &props, const std::string &name, size_t expected = 0) {
+        using Value = scalar_t<Buffer>;
+
+        size_t index = (size_t) props.long_(name),
+               size  = m_bundle->blob_size(index);
+        if (size % sizeof(Value) != 0 || (expected != 0 && size != expected * sizeof(Value)))
+            Throw("\"%s\": data block \"%s\" of the scene bundle has an unexpected size!",
+                  m_name, name);
+
+        if constexpr (is_cuda_array_v<Float>)
+            return Buffer::copy(m_bundle->blob(index), size / sizeof(Value));
+        else
+            return Buffer::map(m_bundle->blob(index), size / sizeof(Value));
+    }
+
+private:
+    /// Keeps the memory-mapped bundle alive
+    ref<const SceneBundle> m_bundle;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(BundleMesh, Mesh)
+MTS_EXPORT_PLUGIN(BundleMesh, "Scene bundle mesh")
+NAMESPACE_END(mitsuba)
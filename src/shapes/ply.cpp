@@ -33,6 +33,15 @@ PLY (Stanford Triangle Format) mesh loader (:monosp:`ply`)
    - |transform|
    - Specifies an optional linear object-to-world transformation.
      (Default: none, i.e. object space = world space)
+ * - compact_storage
+   - |bool|
+   - Store vertex normals (octahedral encoding, 32 bit) and texture coordinates
+     (half precision) in a compact quantized layout to reduce memory usage. Only
+     supported by the CPU variants. (Default: |false|)
+ * - compact_faces
+   - |bool|
+   - When ``compact_storage`` is enabled, additionally store the face indices of
+     meshes with at most 65536 vertices using 16 bits. (Default: |false|)
 
 .. subfigstart::
 .. subfigure:: ../../resources/data/docs/images/render/shape_ply_bunny.jpg
@@ -69,7 +78,8 @@ public:
     MTS_IMPORT_BASE(Mesh, m_name, m_bbox, m_to_world, m_vertex_count, m_face_count,
                     m_vertex_positions_buf, m_vertex_normals_buf, m_vertex_texcoords_buf,
                     m_faces_buf, add_attribute, m_disable_vertex_normals, has_vertex_normals,
-                    has_vertex_texcoords, recompute_vertex_normals, set_children)
+                    has_vertex_texcoords, recompute_vertex_normals, compact_storage, m_compact_requested,
+                    m_compact_faces_requested, set_children)
     MTS_IMPORT_TYPES()
 
     using typename Base::ScalarSize;
@@ -383,6 +393,9 @@ public:
                 util::time_string(timer2.value()));
         }
 
+        if (m_compact_requested)
+            compact_storage(m_compact_faces_requested);
+
         set_children();
     }
 
@@ -1,5 +1,7 @@
 #include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/bundle.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/hugepages.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
@@ -8,6 +10,7 @@
 #include <mitsuba/render/texture.h>
 #include <mitsuba/render/srgb.h>
 #include <mutex>
+#include <tbb/parallel_reduce.h>
 #include <tbb/spin_mutex.h>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -52,6 +55,13 @@ Bitmap texture (:monosp:`bitmap`)
      spectral upsampling) be disabled? You will want to enable this when working
      with bitmaps storing normal maps that use a linear encoding. (Default: false)
 
+ * - filter_coefficients
+   - |bool|
+   - In :monosp:`spectral` modes, interpolate the coefficients of the spectral upsampling
+     model rather than the spectra of the individual pixels. This only evaluates the model
+     once per lookup, but is only accurate when neighboring pixels have similar colors
+     (e.g. for smooth or high resolution textures). (Default: false)
+
  * - to_uv
    - |transform|
    - Specifies an optional 3x3 transformation matrix that will be applied to UV
@@ -92,11 +102,6 @@ public:
     BitmapTexture(const Properties &props) : Texture(props) {
         m_transform = props.transform("to_uv", ScalarTransform4f()).extract();
 
-        FileResolver* fs = Thread::thread()->file_resolver();
-        fs::path file_path = fs->resolve(props.string("filename"));
-        m_name = file_path.filename().string();
-        Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
-
         std::string filter_type = props.string("filter_type", "bilinear");
         if (filter_type == "nearest")
             m_filter_type = FilterType::Nearest;
@@ -117,6 +122,59 @@ public:
             Throw("Invalid wrap mode \"%s\", must be one of: \"repeat\", "
                   "\"mirror\", or \"clamp\"!", wrap_mode);
 
+        /* Should Mitsuba disable transformations to the stored color data?
+           (e.g. sRGB to linear, spectral upsampling, etc.) */
+        m_raw = props.bool_("raw", false);
+
+        m_filter_coefficients = props.bool_("filter_coefficients", false);
+
+        if (props.has_property("bundle_data"))
+            load_bundle(props);
+        else
+            load_file(props);
+    }
+
+    /**
+     * Recursively expand into an implementation specialized to the
+     * actual loaded image.
+     */
+    std::vector<ref<Object>> expand() const override {
+        Properties props;
+        props.set_id(this->id());
+        return { ref<Object>(expand_1()) };
+    }
+
+    /// Store the converted texture data in a scene bundle
+    bool write_bundle(SceneBundleWriter *writer, Properties &props) const override {
+        Properties result("bitmap");
+        result.set_id(props.id());
+        for (const char *name : { "filter_type", "wrap_mode", "raw", "filter_coefficients",
+                                  "to_uv" }) {
+            if (props.has_property(name))
+                result.copy_attribute(props, name, name);
+        }
+
+        result.set_string("name", m_name);
+        result.set_long("bundle_data", writer->add_blob(m_bitmap->data(), m_bitmap->buffer_size()));
+        result.set_long("bundle_width", (int64_t) m_bitmap->width());
+        result.set_long("bundle_height", (int64_t) m_bitmap->height());
+        result.set_long("bundle_channels", (int64_t) m_bitmap->channel_count());
+        result.set_float("bundle_mean", m_mean);
+
+        props = result;
+        return true;
+    }
+
+    MTS_DECLARE_CLASS()
+
+protected:
+    /// Load, decode and convert the bitmap referenced by the 'filename' parameter
+    void load_file(const Properties &props) {
+        FileResolver* fs = Thread::thread()->file_resolver();
+        fs::path file_path = fs->resolve(props.string("filename"));
+        m_name = file_path.filename().string();
+        Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
+
         m_bitmap = new Bitmap(file_path);
 
         /* Convert to linear RGB float bitmap, will be converted
@@ -140,9 +198,6 @@ public:
                       "format (Y[A], RGB[A], XYZ[A] are supported).");
         }
 
-        /* Should Mitsuba disable transformations to the stored color data?
-           (e.g. sRGB to linear, spectral upsampling, etc.) */
-        m_raw = props.bool_("raw", false);
         if (m_raw) {
             /* Don't undo gamma correction in the conversion below.
                This is needed, e.g., for normal maps. */
@@ -167,15 +222,27 @@ public:
         double mean = 0.0;
         if (m_bitmap->channel_count() == 3) {
             if (is_spectral_v<Spectrum> && !m_raw) {
-                for (size_t i = 0; i < pixel_count; ++i) {
-                    ScalarColor3f value = load_unaligned<ScalarColor3f>(ptr);
-                    if (!all(value >= 0 && value <= 1))
-                        bad = true;
-                    value = srgb_model_fetch(value);
-                    mean += (double) srgb_model_mean(value);
-                    store_unaligned(ptr, value);
-                    ptr += 3;
-                }
+                // Convert to model coefficients (in parallel, this is costly for large textures)
+                using Stats = std::pair<double, bool>;
+                std::tie(mean, bad) = tbb::parallel_reduce(
+                    tbb::blocked_range<size_t>(0, pixel_count, 4096), Stats(0.0, false),
+                    [&](const tbb::blocked_range<size_t> &range, Stats stats) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            ScalarColor3f value = load_unaligned<ScalarColor3f>(ptr + 3 * i);
+                            if (!all(value >= 0 && value <= 1))
+                                stats.second = true;
+                            value = srgb_model_fetch(value);
+                            stats.first += (double) srgb_model_mean(value);
+                            if (m_filter_coefficients)
+                                value = srgb_model_finite(value);
+                            store_unaligned(ptr + 3 * i, value);
+                        }
+                        return stats;
+                    },
+                    [](Stats s1, const Stats &s2) {
+                        return Stats(s1.first + s2.first, s1.second || s2.second);
+                    }
+                );
             } else {
                 for (size_t i = 0; i < pixel_count; ++i) {
                     ScalarColor3f value = load_unaligned<ScalarColor3f>(ptr);
@@ -205,19 +272,27 @@ public:
         m_mean = ScalarFloat(mean / pixel_count);
     }
 
-    /**
-     * Recursively expand into an implementation specialized to the
-     * actual loaded image.
-     */
-    std::vector<ref<Object>> expand() const override {
-        Properties props;
-        props.set_id(this->id());
-        return { ref<Object>(expand_1()) };
+    /// Reference already converted texture data stored in a scene bundle
+    void load_bundle(const Properties &props) {
+        m_bundle = (const SceneBundle *) props.pointer("bundle");
+        m_name = props.string("name");
+        m_mean = props.float_("bundle_mean");
+
+        size_t index = (size_t) props.long_("bundle_data"),
+               channels = (size_t) props.long_("bundle_channels");
+        ScalarVector2u size((uint32_t) props.long_("bundle_width"),
+                            (uint32_t) props.long_("bundle_height"));
+
+        if ((channels != 1 && channels != 3) ||
+            m_bundle->blob_size(index) != hprod(size) * channels * sizeof(ScalarFloat))
+            Throw("BitmapTexture: invalid texture data for \"%s\" in scene bundle!", m_name);
+
+        // The bitmap does not take ownership of the mapped data
+        m_bitmap = new Bitmap(channels == 1 ? Bitmap::PixelFormat::Y : Bitmap::PixelFormat::RGB,
+                              struct_type_v<ScalarFloat>, size, channels,
+                              (uint8_t *) m_bundle->blob(index));
     }
 
-    MTS_DECLARE_CLASS()
-
-protected:
     Object* expand_1() const {
         return m_bitmap->channel_count() == 1 ? expand_2<1>() : expand_2<3>();
     }
@@ -229,14 +304,17 @@ protected:
     template <uint32_t Channels, bool Raw> Object* expand_3() const {
         Properties props;
         return new BitmapTextureImpl<Float, Spectrum, Channels, Raw>(
-            props, m_bitmap, m_name, m_transform, m_mean, m_filter_type, m_wrap_mode);
+            props, m_bitmap, m_name, m_transform, m_mean, m_filter_type, m_wrap_mode,
+            m_filter_coefficients, m_bundle.get());
     }
 
 protected:
     ref<Bitmap> m_bitmap;
+    ref<const SceneBundle> m_bundle;
     std::string m_name;
     ScalarTransform3f m_transform;
     bool m_raw;
+    bool m_filter_coefficients;
     ScalarFloat m_mean;
     FilterType m_filter_type;
     WrapMode m_wrap_mode;
@@ -253,15 +331,35 @@ public:
                       const ScalarTransform3f &transform,
                       ScalarFloat mean,
                       FilterType filter_type,
-                      WrapMode wrap_mode)
+                      WrapMode wrap_mode,
+                      bool filter_coefficients,
+                      const Object *storage = nullptr)
         : Texture(props),
           m_resolution(ScalarVector2i(bitmap->size())),
           m_inv_resolution_x((int) bitmap->width()),
           m_inv_resolution_y((int) bitmap->height()),
           m_name(name), m_transform(transform), m_mean(mean),
-          m_filter_type(filter_type), m_wrap_mode(wrap_mode){
-        m_data = DynamicBuffer<Float>::copy(bitmap->data(),
-            hprod(m_resolution) * Channels);
+          m_filter_type(filter_type), m_wrap_mode(wrap_mode),
+          m_filter_coefficients(filter_coefficients) {
+        size_t size = hprod(m_resolution) * Channels;
+        if constexpr (!is_cuda_array_v<Float>) {
+            /* Reference memory-mapped data (e.g. of a scene bundle)
+               without copying, while keeping the storage alive */
+            if (storage) {
+                m_data = DynamicBuffer<Float>::map(bitmap->data(), size);
+                m_storage = storage;
+                return;
+            }
+
+            // Large textures are accessed randomly: back them by huge pages if enabled
+            if (ref<HugePageBuffer> buffer =
+                    HugePageBuffer::copy_large(bitmap->data(), size * sizeof(ScalarFloat))) {
+                m_data = DynamicBuffer<Float>::map((ScalarFloat *) buffer->data(), size);
+                m_storage = buffer.get();
+                return;
+            }
+        }
+        m_data = DynamicBuffer<Float>::copy(bitmap->data(), size);
     }
 
     UnpolarizedSpectrum eval(const SurfaceInteraction3f &si, Mask active) const override {
@@ -437,6 +535,15 @@ public:
 
             // Bilinear interpolation
             if constexpr (is_spectral_v<Spectrum> && !Raw && Channels == 3) {
+                if (m_filter_coefficients) {
+                    // Interpolate the coefficients and evaluate the model only once
+                    StorageType v0 = fmadd(w0.x(), v00, w1.x() * v10),
+                                v1 = fmadd(w0.x(), v01, w1.x() * v11);
+
+                    return srgb_model_eval<UnpolarizedSpectrum>(fmadd(w0.y(), v0, w1.y() * v1),
+                                                                si.wavelengths);
+                }
+
                 // Evaluate spectral upsampling model from stored coefficients
                 UnpolarizedSpectrum c00, c10, c01, c11, c0, c1;
 
@@ -579,6 +686,13 @@ public:
 
     bool is_spatially_varying() const override { return true; }
 
+    MemoryUsage memory_usage() const override {
+        MemoryUsage usage = { { "textures", slices(m_data) * sizeof(ScalarFloat) } };
+        if (m_distr2d)
+            usage["sampling tables"] = m_distr2d->storage_bytes();
+        return usage;
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "BitmapTextureImpl[" << std::endl
@@ -654,6 +768,7 @@ protected:
 
 protected:
     DynamicBuffer<Float> m_data;
+    ref<const Object> m_storage;
     ScalarVector2i m_resolution;
     enoki::divisor<int32_t> m_inv_resolution_x;
     enoki::divisor<int32_t> m_inv_resolution_y;
@@ -662,6 +777,7 @@ protected:
     ScalarFloat m_mean;
     FilterType m_filter_type;
     WrapMode m_wrap_mode;
+    bool m_filter_coefficients;
 
     // Optional: distribution for importance sampling
     mutable tbb::spin_mutex m_mutex;
@@ -1,5 +1,6 @@
 #include <enoki/stl.h>
 
+#include <mitsuba/core/hugepages.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
@@ -7,6 +8,7 @@
 #include <mitsuba/render/srgb.h>
 #include <mitsuba/render/texture.h>
 #include <mitsuba/render/volume_texture.h>
+#include <tbb/parallel_reduce.h>
 
 #include "volume_data.h"
 
@@ -32,6 +34,28 @@ class GridVolumeImpl;
  * operation makes sense after the file has been mapped into memory:
  *     data[((zpos*yres + ypos)*xres + xpos)*channels + chan]}
  *     where (xpos, ypos, zpos, chan) denotes the lookup location.
+ *
+ * In spectral modes, the \c filter_coefficients parameter causes trilinear
+ * lookups to interpolate the coefficients of the spectral upsampling model
+ * instead of evaluating the model at all eight surrounding voxels. This is
+ * considerably faster, but only accurate when neighboring voxels have
+ * similar colors.
+ *
+ * In CPU variants, the voxel data is memory-mapped (copy-on-write) rather
+ * than read into a separate buffer, unless \c mmap is set to \c false or
+ * the data must be converted (spectral upsampling). Pages are then only
+ * loaded from disk when they are first accessed during rendering. As the
+ * voxel data of <tt>.vol</tt> files is only 16-byte aligned, packet variants
+ * still copy it when their packets require a stronger alignment (e.g. AVX).
+ * Scalar variants only load individual values and always map it. Loading
+ * still scans the file once to compute its mean and maximum value, which is
+ * skipped when \c max_value is specified (the mean is then only computed
+ * when it is printed). The \c prefetch parameter asks
+ * the operating system to start reading the file in the background, which
+ * overlaps I/O with the remainder of scene loading. When huge pages are
+ * enabled (see \ref HugePageBuffer), \c mmap defaults to \c false and large
+ * grids are instead copied into memory backed by huge pages, which reduces
+ * TLB misses of random lookups.
  */
 template <typename Float, typename Spectrum>
 class GridVolume final : public Volume<Float, Spectrum> {
@@ -61,35 +85,92 @@ public:
                   "\"mirror\", or \"clamp\"!", wrap_mode);
 
 
-        auto [metadata, raw_data] = read_binary_volume_data<Float>(props.string("filename"));
-        m_metadata                = metadata;
         m_raw                     = props.bool_("raw", false);
-        ScalarUInt32 size         = hprod(m_metadata.shape);
+        bool filter_coefficients  = props.bool_("filter_coefficients", false);
+        bool convert = is_spectral_v<Spectrum> && !m_raw;
+
+        ref<MemoryMappedFile> mmap;
+        const float *ptr;
+        std::tie(m_metadata, mmap, ptr) =
+            map_binary_volume_data(props.string("filename"), false);
+        if (props.bool_("prefetch", false))
+            mmap->prefetch();
+
+        ScalarUInt32 size = hprod(m_metadata.shape);
         // Apply spectral conversion if necessary
-        if (is_spectral_v<Spectrum> && m_metadata.channel_count == 3 && !m_raw) {
-            ScalarFloat *ptr = raw_data.get();
+        if (m_metadata.channel_count == 3 && convert) {
             auto scaled_data = std::unique_ptr<ScalarFloat[]>(new ScalarFloat[size * 4]);
             ScalarFloat *scaled_data_ptr = scaled_data.get();
-            double mean = 0.0;
-            ScalarFloat max = 0.0;
-            for (ScalarUInt32 i = 0; i < size; ++i) {
-                ScalarColor3f rgb = load_unaligned<ScalarColor3f>(ptr);
-                // TODO: Make this scaling optional if the RGB values are between 0 and 1
-                ScalarFloat scale = hmax(rgb) * 2.f;
-                ScalarColor3f rgb_norm = rgb / std::max((ScalarFloat) 1e-8, scale);
-                ScalarVector3f coeff = srgb_model_fetch(rgb_norm);
-                mean += (double) (srgb_model_mean(coeff) * scale);
-                max = std::max(max, scale);
-                store_unaligned(scaled_data_ptr, concat(coeff, scale));
-                ptr += 3;
-                scaled_data_ptr += 4;
-            }
-            m_metadata.mean = mean;
-            m_metadata.max = max;
-            m_data = DynamicBuffer<Float>::copy(scaled_data.get(), size * 4);
+
+            // Convert to model coefficients (in parallel, this is costly for large grids)
+            using Stats = std::pair<double, ScalarFloat>;
+            Stats result = tbb::parallel_reduce(
+                tbb::blocked_range<ScalarUInt32>(0, size, 4096), Stats(0.0, 0.f),
+                [&](const tbb::blocked_range<ScalarUInt32> &range, Stats stats) {
+                    for (ScalarUInt32 i = range.begin(); i != range.end(); ++i) {
+                        ScalarColor3f rgb(ptr[3 * i], ptr[3 * i + 1], ptr[3 * i + 2]);
+                        // TODO: Make this scaling optional if the RGB values are between 0 and 1
+                        ScalarFloat scale = hmax(rgb) * 2.f;
+                        ScalarColor3f rgb_norm = rgb / std::max((ScalarFloat) 1e-8, scale);
+                        ScalarVector3f coeff = srgb_model_fetch(rgb_norm);
+                        stats.first += (double) (srgb_model_mean(coeff) * scale);
+                        stats.second = std::max(stats.second, scale);
+                        if (filter_coefficients)
+                            coeff = srgb_model_finite(coeff);
+                        store_unaligned(scaled_data_ptr + 4 * i, concat(coeff, scale));
+                    }
+                    return stats;
+                },
+                [](Stats s1, const Stats &s2) {
+                    return Stats(s1.first + s2.first, std::max(s1.second, s2.second));
+                }
+            );
+            m_metadata.mean = result.first;
+            m_metadata.max = result.second;
+            set_data(scaled_data.get(), size * 4);
         } else {
-            m_data = DynamicBuffer<Float>::copy(raw_data.get(), size * m_metadata.channel_count);
+            size_t count = size * m_metadata.channel_count;
+
+            /* The statistics pass touches every page of the file, it is only
+               needed when the maximum isn't specified explicitly */
+            if (!props.has_property("max_value"))
+                std::tie(m_metadata.mean, m_metadata.max) = volume_data_stats(ptr, count);
+
+            bool mapped = false;
+            if constexpr (!is_cuda_array_v<Float> && std::is_same_v<ScalarFloat, float>) {
+                /* Packet variants load packets with aligned instructions (which
+                   may extend past the last value), which is only safe if the data
+                   starts at a packet boundary. File mappings are page-aligned, so
+                   the data following the 48-byte header never is for packets wider
+                   than 16 bytes. The copy below is padded to whole packets. */
+                bool aligned = true;
+                if constexpr (is_array_v<Float>) {
+                    using Packet = typename DynamicBuffer<Float>::Packet;
+                    aligned = (uintptr_t) ptr % alignof(Packet) == 0;
+                }
+                if (!aligned && props.bool_("mmap", false))
+                    Log(Debug, "Volume data of \"%s\" is not aligned to packets, copying it",
+                        m_metadata.filename);
+                if (aligned && props.bool_("mmap", !HugePageBuffer::enabled())) {
+                    // Reference the mapped file, which is kept alive by 'm_storage'
+                    m_data = DynamicBuffer<Float>::map((ScalarFloat *) ptr, count);
+                    m_storage = mmap;
+                    mapped = true;
+                }
+            }
+            if (!mapped) {
+                std::unique_ptr<ScalarFloat[]> values(new ScalarFloat[count]);
+                double sum = 0.0;
+                for (size_t i = 0; i < count; ++i) {
+                    values[i] = (ScalarFloat) ptr[i];
+                    sum += (double) ptr[i];
+                }
+                // The copy touches every value anyway, so the mean comes for free
+                m_metadata.mean = sum / (double) count;
+                set_data(values.get(), count);
+            }
         }
+        props.mark_queried("mmap");
 
         // Mark values which are only used in the implementation class as queried
         props.mark_queried("use_grid_bbox");
@@ -105,12 +186,12 @@ public:
         ref<Object> result;
         switch (m_metadata.channel_count) {
             case 1:
-                result = m_raw ? (Object *) new Impl<1, true>(m_props, m_metadata, m_data, m_filter_type, m_wrap_mode)
-                               : (Object *) new Impl<1, false>(m_props, m_metadata, m_data, m_filter_type, m_wrap_mode);
+                result = m_raw ? (Object *) new Impl<1, true>(m_props, m_metadata, m_data, m_filter_type, m_wrap_mode, m_storage.get())
+                               : (Object *) new Impl<1, false>(m_props, m_metadata, m_data, m_filter_type, m_wrap_mode, m_storage.get());
                 break;
             case 3:
-                result = m_raw ? (Object *) new Impl<3, true>(m_props, m_metadata, m_data, m_filter_type, m_wrap_mode)
-                               : (Object *) new Impl<3, false>(m_props, m_metadata, m_data, m_filter_type, m_wrap_mode);
+                result = m_raw ? (Object *) new Impl<3, true>(m_props, m_metadata, m_data, m_filter_type, m_wrap_mode, m_storage.get())
+                               : (Object *) new Impl<3, false>(m_props, m_metadata, m_data, m_filter_type, m_wrap_mode, m_storage.get());
                 break;
             default:
                 Throw("Unsupported channel count: %d (expected 1 or 3)", m_metadata.channel_count);
@@ -120,8 +201,23 @@ public:
 
     MTS_DECLARE_CLASS()
 protected:
+    /// Copy voxel data into \ref m_data, using huge pages for large grids if enabled
+    void set_data(const ScalarFloat *values, size_t count) {
+        if constexpr (!is_cuda_array_v<Float>) {
+            if (ref<HugePageBuffer> buffer =
+                    HugePageBuffer::copy_large(values, count * sizeof(ScalarFloat))) {
+                m_data = DynamicBuffer<Float>::map((ScalarFloat *) buffer->data(), count);
+                m_storage = buffer.get();
+                return;
+            }
+        }
+        m_data = DynamicBuffer<Float>::copy(values, count);
+    }
+
     bool m_raw;
     DynamicBuffer<Float> m_data;
+    /// Keeps the memory-mapped volume file or huge page buffer referenced by \ref m_data alive
+    ref<const Object> m_storage;
     VolumeMetadata m_metadata;
     Properties m_props;
     FilterType m_filter_type;
@@ -137,9 +233,11 @@ public:
     GridVolumeImpl(const Properties &props, const VolumeMetadata &meta,
                const DynamicBuffer<Float> &data,
                FilterType filter_type,
-               WrapMode wrap_mode)
+               WrapMode wrap_mode,
+               const Object *storage = nullptr)
         : Base(props),
             m_data(data),
+            m_storage(storage),
             m_metadata(meta),
             m_inv_resolution_x((int) m_metadata.shape.x()),
             m_inv_resolution_y((int) m_metadata.shape.y()),
@@ -148,6 +246,12 @@ public:
 
 
 
+        if constexpr (!is_cuda_array_v<Float>) {
+            // Reference the mapped file or huge page buffer instead of a copy
+            if (storage)
+                m_data = DynamicBuffer<Float>::map((ScalarFloat *) data.data(), slices(data));
+        }
+
         m_size     = hprod(m_metadata.shape);
         if (props.bool_("use_grid_bbox", false)) {
             m_world_to_local = m_metadata.transform * m_world_to_local;
@@ -158,6 +262,8 @@ public:
             m_fixed_max    = true;
             m_metadata.max = props.float_("max_value");
         }
+
+        m_filter_coefficients = props.bool_("filter_coefficients", false);
     }
 
     UnpolarizedSpectrum eval(const Interaction3f &it, Mask active) const override {
@@ -300,6 +406,21 @@ public:
                  d011 = gather<StorageType>(m_data, index[6], active),
                  d111 = gather<StorageType>(m_data, index[7], active);
 
+            if constexpr (uses_srgb_model) {
+                if (m_filter_coefficients) {
+                    // Interpolate the coefficients and evaluate the model only once
+                    StorageType d00 = fmadd(w0.x(), d000, w1.x() * d100),
+                                d01 = fmadd(w0.x(), d001, w1.x() * d101),
+                                d10 = fmadd(w0.x(), d010, w1.x() * d110),
+                                d11 = fmadd(w0.x(), d011, w1.x() * d111);
+                    StorageType d0  = fmadd(w0.y(), d00, w1.y() * d10),
+                                d1  = fmadd(w0.y(), d01, w1.y() * d11);
+                    StorageType d   = fmadd(w0.z(), d0, w1.z() * d1);
+
+                    return d.w() * srgb_model_eval<UnpolarizedSpectrum>(head<3>(d), wavelengths);
+                }
+            }
+
             ResultType v000, v001, v010, v011, v100, v101, v110, v111;
             Float scale = 1.f;
             if constexpr (uses_srgb_model) {
@@ -382,12 +503,17 @@ public:
             m_size = (ScalarUInt32) new_size;
         }
 
-        auto sum = hsum(hsum(detach(m_data)));
-        m_metadata.mean = (double) enoki::slice(sum, 0) / (double) (m_size * 3);
-        if (!m_fixed_max) {
-            auto maximum = hmax(hmax(m_data));
-            m_metadata.max = slice(maximum, 0);
-        }
+        auto [data_mean, data_max] = data_stats();
+        m_metadata.mean = data_mean;
+        if (!m_fixed_max)
+            m_metadata.max = data_max;
+    }
+
+    MemoryUsage memory_usage() const override {
+        // Mapped data is only read from disk on demand, so report it separately
+        bool mapped = dynamic_cast<const MemoryMappedFile *>(m_storage.get()) != nullptr;
+        return { { mapped ? "grid volumes (mapped)" : "grid volumes",
+                   slices(m_data) * sizeof(ScalarFloat) } };
     }
 
     std::string to_string() const override {
@@ -395,7 +521,7 @@ public:
         oss << "GridVolume[" << std::endl
             << "  world_to_local = " << m_world_to_local << "," << std::endl
             << "  dimensions = " << m_metadata.shape << "," << std::endl
-            << "  mean = " << m_metadata.mean << "," << std::endl
+            << "  mean = " << mean() << "," << std::endl
             << "  max = " << m_metadata.max << "," << std::endl
             << "  channels = " << m_metadata.channel_count << std::endl
             << "]";
@@ -404,7 +530,28 @@ public:
 
     MTS_DECLARE_CLASS()
 protected:
+    /// Mean voxel value, computed on demand if loading skipped the statistics pass
+    double mean() const {
+        if (!std::isnan(m_metadata.mean))
+            return m_metadata.mean;
+        return data_stats().first;
+    }
+
+    /// Mean and maximum voxel value
+    std::pair<double, ScalarFloat> data_stats() const {
+        if constexpr (!is_array_v<Float> && std::is_same_v<ScalarFloat, float>) {
+            // Data mapped by scalar variants isn't necessarily aligned to packets
+            return volume_data_stats(m_data.data(), slices(m_data));
+        } else {
+            auto sum = hsum(hsum(detach(m_data)));
+            auto maximum = hmax(hmax(m_data));
+            return { (double) enoki::slice(sum, 0) / (double) slices(m_data),
+                     (ScalarFloat) slice(maximum, 0) };
+        }
+    }
+
     DynamicBuffer<Float> m_data;
+    ref<const Object> m_storage;
     bool m_fixed_max = false;
     VolumeMetadata m_metadata;
     enoki::divisor<int32_t> m_inv_resolution_x, m_inv_resolution_y, m_inv_resolution_z;
@@ -412,6 +559,7 @@ protected:
     ScalarUInt32 m_size;
     FilterType m_filter_type;
     WrapMode m_wrap_mode;
+    bool m_filter_coefficients;
 };
 
 MTS_IMPLEMENT_CLASS_VARIANT(GridVolume, Volume)
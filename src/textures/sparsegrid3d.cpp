@@ -0,0 +1,427 @@
+#include <enoki/stl.h>
+
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/render/sparse_grid.h>
+#include <mitsuba/render/srgb.h>
+#include <mitsuba/render/texture.h>
+#include <mitsuba/render/volume_texture.h>
+#include <tbb/parallel_reduce.h>
+#include <limits>
+
+#include "volume_data.h"
+
+NAMESPACE_BEGIN(mitsuba)
+
+enum class FilterType { Nearest, Trilinear };
+enum class WrapMode { Repeat, Mirror, Clamp };
+
+/**
+ * Interpolated 3D grid texture of scalar or color values, which is stored
+ * sparsely in bricks of 8x8x8 voxels (see \ref SparseGrid).
+ *
+ * Regions of the grid where all voxels have the same value (e.g. empty space)
+ * don't consume any memory besides a single entry in a tile or the root array
+ * of the hierarchy. The plugin supports the same parameters as \c gridvolume.
+ *
+ * The \c filename parameter accepts sparse grid files (written by
+ * \c SparseGrid.write() or \c mitsuba.python.volume), as well as dense Mitsuba
+ * binary volume files, which are converted at loading time.
+ *
+ * The hierarchy also stores the range of values in each tile and brick, which
+ * \ref eval_bounds() returns. This is groundwork for local majorants: the
+ * \c heterogeneous medium currently still tracks against the global maximum.
+ */
+template <typename Float, typename Spectrum>
+class SparseGridVolume final : public Volume<Float, Spectrum> {
+public:
+    MTS_IMPORT_BASE(Volume, update_bbox, m_world_to_local)
+    MTS_IMPORT_TYPES()
+
+    static constexpr uint32_t BrickRes     = SparseGrid::BrickRes;
+    static constexpr uint32_t TileRes      = SparseGrid::TileRes;
+    static constexpr uint32_t BrickSize    = SparseGrid::BrickSize;
+    static constexpr uint32_t TileSize     = SparseGrid::TileSize;
+    static constexpr uint32_t ConstantFlag = SparseGrid::ConstantFlag;
+
+    SparseGridVolume(const Properties &props) : Base(props) {
+        std::string filter_type = props.string("filter_type", "trilinear");
+        if (filter_type == "nearest")
+            m_filter_type = FilterType::Nearest;
+        else if (filter_type == "trilinear")
+            m_filter_type = FilterType::Trilinear;
+        else
+            Throw("Invalid filter type \"%s\", must be one of: \"nearest\" or "
+                  "\"trilinear\"!", filter_type);
+
+        std::string wrap_mode = props.string("wrap_mode", "clamp");
+        if (wrap_mode == "repeat")
+            m_wrap_mode = WrapMode::Repeat;
+        else if (wrap_mode == "mirror")
+            m_wrap_mode = WrapMode::Mirror;
+        else if (wrap_mode == "clamp")
+            m_wrap_mode = WrapMode::Clamp;
+        else
+            Throw("Invalid wrap mode \"%s\", must be one of: \"repeat\", "
+                  "\"mirror\", or \"clamp\"!", wrap_mode);
+
+        ref<SparseGrid> grid = new SparseGrid(props.string("filename"));
+        m_shape         = grid->shape();
+        m_root_shape    = grid->root_shape();
+        m_channel_count = grid->channel_count();
+        m_inv_resolution_x = enoki::divisor<int32_t>(m_shape.x());
+        m_inv_resolution_y = enoki::divisor<int32_t>(m_shape.y());
+        m_inv_resolution_z = enoki::divisor<int32_t>(m_shape.z());
+
+        if (m_channel_count != 1 && m_channel_count != 3)
+            Throw("Unsupported channel count: %d (expected 1 or 3)", m_channel_count);
+
+        m_raw  = props.bool_("raw", false);
+        m_srgb = is_spectral_v<Spectrum> && m_channel_count == 3 && !m_raw;
+        m_mean = grid->mean();
+        m_max  = grid->max();
+
+        if (props.bool_("use_grid_bbox", false)) {
+            m_world_to_local = detail::bbox_transform(grid->bbox()) * m_world_to_local;
+            update_bbox();
+        }
+
+        std::vector<float> bricks      = grid->bricks(),
+                           constants   = grid->constants(),
+                           root_bounds = grid->root_bounds(),
+                           tile_bounds = grid->tile_bounds();
+
+        if (m_srgb) {
+            /* Convert to model coefficients. Only the stored values need to be
+               converted, which is much cheaper than converting a dense grid. */
+            ScalarFloat max_brick = to_srgb_coefficients(bricks),
+                        max_const = to_srgb_coefficients(constants);
+            m_max = std::max(max_brick, max_const);
+
+            /* Spectra are bounded by the scale factor (twice the largest
+               RGB component) */
+            for (size_t i = 0; i < root_bounds.size(); i += 2)
+                root_bounds[i] = 0.f, root_bounds[i + 1] *= 2.f;
+            for (size_t i = 0; i < tile_bounds.size(); i += 2)
+                tile_bounds[i] = 0.f, tile_bounds[i + 1] *= 2.f;
+        }
+
+        if (m_wrap_mode != WrapMode::Clamp)
+            widen_border_bounds(grid->root(), root_bounds, tile_bounds);
+
+        if (props.has_property("max_value"))
+            m_max = props.float_("max_value");
+
+        m_root        = DynamicBuffer<UInt32>::copy(grid->root().data(), grid->root().size());
+        m_tiles       = DynamicBuffer<UInt32>::copy(grid->tiles().data(), grid->tiles().size());
+        m_bricks      = DynamicBuffer<Float>::copy(bricks.data(), bricks.size());
+        m_constants   = DynamicBuffer<Float>::copy(constants.data(), constants.size());
+        m_root_bounds = DynamicBuffer<Float>::copy(root_bounds.data(), root_bounds.size());
+        m_tile_bounds = DynamicBuffer<Float>::copy(tile_bounds.data(), tile_bounds.size());
+    }
+
+    UnpolarizedSpectrum eval(const Interaction3f &it, Mask active) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        Point3f p = m_world_to_local * it.p;
+        UnpolarizedSpectrum result;
+
+        if (m_channel_count == 1) {
+            result = interpolate<Array<Float, 1>>(
+                p, [](const Array<Float, 1> &v) { return v.x(); }, active);
+        } else if constexpr (is_spectral_v<Spectrum>) {
+            if (!m_srgb)
+                Throw("The SparseGridVolume texture %s was queried for a spectrum, but texture "
+                      "conversion into spectra was explicitly disabled! (raw=true)",
+                      to_string());
+
+            result = interpolate<Array<Float, 4>>(
+                p,
+                [&](const Array<Float, 4> &v) {
+                    return v.w() * srgb_model_eval<UnpolarizedSpectrum>(head<3>(v), it.wavelengths);
+                },
+                active);
+        } else {
+            Color3f color = interpolate<Array<Float, 3>>(
+                p, [](const Array<Float, 3> &v) { return Color3f(v); }, active);
+
+            if constexpr (is_monochromatic_v<Spectrum>)
+                result = luminance(color);
+            else
+                result = color;
+        }
+
+        return select(active, result, zero<UnpolarizedSpectrum>());
+    }
+
+    Float eval_1(const Interaction3f &it, Mask active = true) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_srgb)
+            Throw("eval_1(): The SparseGridVolume texture %s was queried for a scalar value, but "
+                  "texture conversion into spectra was requested! (raw=false)",
+                  to_string());
+
+        Point3f p = m_world_to_local * it.p;
+        Float result;
+        if (m_channel_count == 1)
+            result = interpolate<Array<Float, 1>>(
+                p, [](const Array<Float, 1> &v) { return v.x(); }, active);
+        else
+            result = luminance(interpolate<Array<Float, 3>>(
+                p, [](const Array<Float, 3> &v) { return Color3f(v); }, active));
+
+        return select(active, result, 0.f);
+    }
+
+    Vector3f eval_3(const Interaction3f &it, Mask active = true) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channel_count != 3)
+            Throw("eval_3(): The SparseGridVolume texture %s was queried for a 3D vector, but it "
+                  "has only a single channel!", to_string());
+        if (m_srgb)
+            Throw("eval_3(): The SparseGridVolume texture %s was queried for a 3D vector, but "
+                  "texture conversion into spectra was requested! (raw=false)",
+                  to_string());
+
+        Point3f p = m_world_to_local * it.p;
+        Vector3f result = interpolate<Array<Float, 3>>(
+            p, [](const Array<Float, 3> &v) { return Vector3f(v); }, active);
+        return select(active, result, zero<Vector3f>());
+    }
+
+    std::pair<Float, Float> eval_bounds(const Interaction3f &it,
+                                        Mask active = true) const override {
+        MTS_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        Point3f p = m_world_to_local * it.p;
+        Vector3i p_i = wrap(floor2int<Vector3i>(p * m_shape));
+
+        auto [root_index, brick_index] = hierarchy_index(p_i);
+        UInt32 entry = gather<UInt32>(m_root, root_index, active);
+        Mask is_tile = eq(entry & ConstantFlag, 0u);
+
+        Array<Float, 2> bounds = gather<Array<Float, 2>>(m_root_bounds, root_index,
+                                                         active && !is_tile);
+        masked(bounds, is_tile) =
+            gather<Array<Float, 2>>(m_tile_bounds, entry * TileSize + brick_index,
+                                    active && is_tile);
+
+        return { bounds.x(), bounds.y() };
+    }
+
+    ScalarFloat max() const override { return m_max; }
+    ScalarVector3i resolution() const override { return m_shape; };
+
+    MemoryUsage memory_usage() const override {
+        return { { "sparse grid volumes",
+                   (slices(m_root) + slices(m_tiles)) * sizeof(ScalarUInt32) +
+                   (slices(m_bricks) + slices(m_constants) + slices(m_root_bounds) +
+                    slices(m_tile_bounds)) * sizeof(ScalarFloat) } };
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "SparseGridVolume[" << std::endl
+            << "  world_to_local = " << m_world_to_local << "," << std::endl
+            << "  dimensions = " << m_shape << "," << std::endl
+            << "  bricks = " << slices(m_bricks) / (BrickSize * (m_srgb ? 4 : m_channel_count)) << "," << std::endl
+            << "  mean = " << m_mean << "," << std::endl
+            << "  max = " << m_max << "," << std::endl
+            << "  channels = " << m_channel_count << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MTS_DECLARE_CLASS()
+protected:
+    template <typename T> T wrap(const T &value) const {
+        if (m_wrap_mode == WrapMode::Clamp) {
+            return clamp(value, 0, m_shape - 1);
+        } else {
+            T div = T(m_inv_resolution_x(value.x()),
+                      m_inv_resolution_y(value.y()),
+                      m_inv_resolution_z(value.z())),
+              mod = value - div * m_shape;
+
+            masked(mod, mod < 0) += T(m_shape);
+
+            if (m_wrap_mode == WrapMode::Mirror)
+                mod = select(eq(div & 1, 0) ^ (value < 0), mod, m_shape - 1 - mod);
+
+            return mod;
+        }
+    }
+
+    /// Return the index of the root entry and of the brick within its tile
+    std::pair<Int32, UInt32> hierarchy_index(const Vector3i &p) const {
+        Vector3i tile  = p >> 6,
+                 brick = (p >> 3) & 7;
+
+        Int32 root_index = fmadd(fmadd(tile.z(), m_root_shape.y(), tile.y()),
+                                 m_root_shape.x(), tile.x());
+        UInt32 brick_index = UInt32(fmadd(fmadd(brick.z(), (int32_t) TileRes, brick.y()),
+                                          (int32_t) TileRes, brick.x()));
+        return { root_index, brick_index };
+    }
+
+    /// Look up the value of a voxel by traversing the hierarchy
+    template <typename StorageType>
+    MTS_INLINE StorageType fetch(const Vector3i &p, Mask active) const {
+        auto [root_index, brick_index] = hierarchy_index(p);
+        Vector3i local = p & 7;
+
+        UInt32 entry = gather<UInt32>(m_root, root_index, active);
+        Mask is_tile = eq(entry & ConstantFlag, 0u);
+        masked(entry, is_tile) =
+            gather<UInt32>(m_tiles, entry * TileSize + brick_index, active && is_tile);
+
+        Mask is_constant = neq(entry & ConstantFlag, 0u);
+        UInt32 voxel_index =
+            entry * BrickSize +
+            UInt32(fmadd(fmadd(local.z(), (int32_t) BrickRes, local.y()), (int32_t) BrickRes,
+                         local.x()));
+
+        StorageType value = gather<StorageType>(m_constants, entry & ~ConstantFlag,
+                                                active && is_constant);
+        masked(value, !is_constant) =
+            gather<StorageType>(m_bricks, voxel_index, active && !is_constant);
+        return value;
+    }
+
+    /**
+     * Taking a 3D point in [0, 1)^3, estimates the grid's value at that point
+     * (using trilinear interpolation if requested). \c func converts the
+     * stored values before they are interpolated.
+     */
+    template <typename StorageType, typename Func>
+    MTS_INLINE auto interpolate(Point3f p, const Func &func, Mask active) const {
+        using ResultType = std::decay_t<decltype(func(std::declval<StorageType>()))>;
+
+        if constexpr (!is_array_v<Mask>)
+            active = true;
+
+        if (m_filter_type == FilterType::Trilinear) {
+            // Scale to volume resolution and apply shift
+            p = fmadd(p, m_shape, -.5f);
+
+            Vector3i p_i = floor2int<Vector3i>(p);
+
+            // Interpolation weights
+            Point3f w1 = p - Point3f(p_i),
+                    w0 = 1.f - w1;
+
+            // Neighboring voxels may reside in different bricks
+            ResultType v[8];
+            for (int32_t k = 0; k < 8; ++k)
+                v[k] = func(fetch<StorageType>(
+                    wrap(p_i + Vector3i(k & 1, (k >> 1) & 1, k >> 2)), active));
+
+            ResultType v00 = fmadd(w0.x(), v[0], w1.x() * v[1]),
+                       v10 = fmadd(w0.x(), v[2], w1.x() * v[3]),
+                       v01 = fmadd(w0.x(), v[4], w1.x() * v[5]),
+                       v11 = fmadd(w0.x(), v[6], w1.x() * v[7]);
+            ResultType v0  = fmadd(w0.y(), v00, w1.y() * v10),
+                       v1  = fmadd(w0.y(), v01, w1.y() * v11);
+            return ResultType(fmadd(w0.z(), v0, w1.z() * v1));
+        } else {
+            // Scale to volume resolution, no shift
+            Vector3i p_i = wrap(floor2int<Vector3i>(p * m_shape));
+            return ResultType(func(fetch<StorageType>(p_i, active)));
+        }
+    }
+
+    /// Convert RGB values to spectral model coefficients and a scale factor, returns the maximum scale
+    static ScalarFloat to_srgb_coefficients(std::vector<float> &values) {
+        size_t count = values.size() / 3;
+        std::vector<float> result(count * 4);
+
+        ScalarFloat max = tbb::parallel_reduce(
+            tbb::blocked_range<size_t>(0, count, 4096), 0.f,
+            [&](const tbb::blocked_range<size_t> &range, ScalarFloat max) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    ScalarColor3f rgb = load_unaligned<ScalarColor3f>(values.data() + 3 * i);
+                    ScalarFloat scale = hmax(rgb) * 2.f;
+                    ScalarColor3f rgb_norm = rgb / std::max((ScalarFloat) 1e-8, scale);
+                    ScalarVector3f coeff = srgb_model_fetch(rgb_norm);
+                    store_unaligned(result.data() + 4 * i, concat(coeff, scale));
+                    max = std::max(max, scale);
+                }
+                return max;
+            },
+            [](ScalarFloat a, ScalarFloat b) { return std::max(a, b); }
+        );
+
+        values.swap(result);
+        return max;
+    }
+
+    /**
+     * The bounds of the hierarchy only account for neighbors within the grid.
+     * With periodic wrap modes, lookups near the boundary also access voxels
+     * on the opposite side, hence the bounds of border regions are widened to
+     * the global range.
+     */
+    void widen_border_bounds(const std::vector<uint32_t> &root,
+                             std::vector<float> &root_bounds,
+                             std::vector<float> &tile_bounds) const {
+        ScalarFloat global_min = std::numeric_limits<ScalarFloat>::infinity(),
+                    global_max = -std::numeric_limits<ScalarFloat>::infinity();
+        for (size_t i = 0; i < root_bounds.size(); i += 2) {
+            global_min = std::min(global_min, root_bounds[i]);
+            global_max = std::max(global_max, root_bounds[i + 1]);
+        }
+
+        auto widen = [&](float *bounds) {
+            bounds[0] = std::min(bounds[0], global_min);
+            bounds[1] = std::max(bounds[1], global_max);
+        };
+
+        ScalarVector3i last_tile  = m_root_shape - 1,
+                       last_brick = (m_shape - 1) / int32_t(BrickRes);
+
+        for (size_t t = 0; t < root.size(); ++t) {
+            ScalarVector3i tile(
+                int32_t(t % m_root_shape.x()),
+                int32_t((t / m_root_shape.x()) % m_root_shape.y()),
+                int32_t(t / ((size_t) m_root_shape.x() * m_root_shape.y())));
+            if (none(eq(tile, 0) || eq(tile, last_tile)))
+                continue;
+
+            widen(root_bounds.data() + 2 * t);
+            if (root[t] & ConstantFlag)
+                continue;
+
+            for (uint32_t b = 0; b < TileSize; ++b) {
+                ScalarVector3i brick =
+                    tile * int32_t(TileRes) +
+                    ScalarVector3i(int32_t(b % TileRes), int32_t((b / TileRes) % TileRes),
+                                   int32_t(b / (TileRes * TileRes)));
+                if (any(eq(brick, 0) || eq(brick, last_brick)))
+                    widen(tile_bounds.data() + 2 * ((size_t) root[t] * TileSize + b));
+            }
+        }
+    }
+
+protected:
+    DynamicBuffer<UInt32> m_root, m_tiles;
+    DynamicBuffer<Float> m_bricks, m_constants;
+    DynamicBuffer<Float> m_root_bounds, m_tile_bounds;
+
+    ScalarVector3i m_shape, m_root_shape;
+    enoki::divisor<int32_t> m_inv_resolution_x, m_inv_resolution_y, m_inv_resolution_z;
+    uint32_t m_channel_count;
+    bool m_raw, m_srgb;
+    double m_mean;
+    ScalarFloat m_max;
+
+    FilterType m_filter_type;
+    WrapMode m_wrap_mode;
+};
+
+MTS_IMPLEMENT_CLASS_VARIANT(SparseGridVolume, Volume)
+MTS_EXPORT_PLUGIN(SparseGridVolume, "Sparse grid volume texture")
+NAMESPACE_END(mitsuba)
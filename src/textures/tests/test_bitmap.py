@@ -59,4 +59,104 @@ def test02_eval_grad(variant_scalar_rgb):
             fv = bitmap.eval_1(si)
             gradient_finite_difference = Vector2f((fu - f)/delta, (fv - f)/delta)
             gradient_analytic = bitmap.eval_1_grad(si)
-            assert ek.allclose(0, ek.abs(gradient_finite_difference/gradient_analytic - 1.0), atol = 1e04)
\ No newline at end of file
+            assert ek.allclose(0, ek.abs(gradient_finite_difference/gradient_analytic - 1.0), atol = 1e04)
+
+@fresolver_append_path
+def test03_filter_coefficients(variant_scalar_spectral):
+    # At texel centers, filtering in coefficient space must match the default
+    from mitsuba.render import SurfaceInteraction3f
+    from mitsuba.core.xml import load_string
+    import enoki as ek
+
+    bitmaps = [load_string("""
+        <texture type="bitmap" version="2.0.0">
+            <string name="filename" value="resources/data/common/textures/noise_8x8.png"/>
+            <boolean name="filter_coefficients" value="%s"/>
+        </texture>""" % v).expand()[0] for v in ['false', 'true']]
+
+    si = SurfaceInteraction3f()
+    si.wavelengths = [400, 500, 600, 700]
+    for i in range(8):
+        for j in range(8):
+            si.uv = [(i + .5) / 8, (j + .5) / 8]
+            assert ek.allclose(bitmaps[0].eval(si), bitmaps[1].eval(si), atol=1e-4)
+
+
+def test05_filter_coefficients_reference(variant_scalar_spectral, tmpdir):
+    # Between texel centers, filtering in coefficient space interpolates the
+    # model coefficients and evaluates the spectral model once
+    from mitsuba.core import Bitmap, Struct
+    from mitsuba.core.xml import load_string
+    from mitsuba.render import SurfaceInteraction3f, srgb_model_fetch, srgb_model_eval
+    import numpy as np
+
+    res = 8
+    rng = np.random.RandomState(0)
+    rgb = rng.uniform(0.05, 0.95, size=(res, res, 3))
+    rgb[2, 3] = [0, 0, 0]    # Black and white texels have infinite coefficients
+    rgb[5, 5] = [1, 1, 1]
+    bitmap = Bitmap(Bitmap.PixelFormat.RGB, Struct.Type.Float32, [res, res])
+    np.array(bitmap, copy=False)[:] = rgb
+    filename = str(tmpdir.join('texture.exr'))
+    bitmap.write(filename)
+
+    texture = load_string("""
+        <texture type="bitmap" version="2.0.0">
+            <string name="filename" value="%s"/>
+            <boolean name="filter_coefficients" value="true"/>
+        </texture>""" % filename).expand()[0]
+
+    # Coefficients as stored by the texture, clamped to finite values
+    coeff = np.array([[srgb_model_fetch(rgb[y, x]) for x in range(res)] for y in range(res)])
+    coeff[..., 2] = np.clip(coeff[..., 2], -100, 100)
+
+    si = SurfaceInteraction3f()
+    wavelengths = [400, 500, 600, 700]
+    si.wavelengths = wavelengths
+    for uv in rng.uniform(0, 1, size=(50, 2)):
+        si.uv = uv
+        p = uv * res - .5
+        i = np.floor(p).astype(int)
+        w = p - i
+        c = 0
+        for dx, dy in [(0, 0), (1, 0), (0, 1), (1, 1)]:
+            x, y = (i[0] + dx) % res, (i[1] + dy) % res    # Repeat wrap mode
+            c = c + coeff[y, x] * (w[0] if dx else 1 - w[0]) * (w[1] if dy else 1 - w[1])
+        ref = np.array(srgb_model_eval(c, wavelengths))
+        assert np.allclose(np.array(texture.eval(si)), ref, rtol=1e-4, atol=1e-4)
+
+
+@fresolver_append_path
+def test04_scene_bundle(variant_scalar_rgb, tmpdir):
+    # Bitmap textures loaded from a scene bundle reference the stored data,
+    # which must evaluate exactly like the texture decoded from the file
+    from mitsuba.core import xml
+    from mitsuba.render import BSDFContext, SurfaceInteraction3f
+    import numpy as np
+
+    scene_xml = str(tmpdir.join('scene.xml'))
+    bundle = str(tmpdir.join('scene.mtsb'))
+    with open(scene_xml, 'w') as f:
+        f.write("""<scene version="2.0.0">
+                       <shape type="rectangle">
+                           <bsdf type="diffuse">
+                               <texture type="bitmap" name="reflectance">
+                                   <string name="filename"
+                                           value="resources/data/common/textures/carrot.png"/>
+                                   <string name="wrap_mode" value="mirror"/>
+                               </texture>
+                           </bsdf>
+                       </shape>
+                   </scene>""")
+
+    xml.write_bundle(scene_xml, bundle)
+    bsdfs = [xml.load_file(f).shapes()[0].bsdf() for f in [scene_xml, bundle]]
+
+    si = SurfaceInteraction3f()
+    si.wi = [0, 0, 1]
+    rng = np.random.RandomState(0)
+    for uv in rng.uniform(-0.5, 1.5, size=(50, 2)):
+        si.uv = uv
+        values = [np.array(b.eval(BSDFContext(), si, [0, 0, 1])) for b in bsdfs]
+        assert np.all(values[0] >= 0) and np.any(values[0] > 0)
+        assert np.array_equal(values[0], values[1])
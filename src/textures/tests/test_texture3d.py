@@ -416,3 +416,108 @@
 #             side *= 2
 #         ref = load_ref(side, values)
 #         check_equivalence(t3d, ref, values)
+
+
+def test01_grid_filter_coefficients(variant_scalar_spectral, tmpdir):
+    # Filtering in coefficient space interpolates the model coefficients and
+    # the scale of the RGB values, and evaluates the spectral model once
+    import numpy as np
+    from mitsuba.core.xml import load_string
+    from mitsuba.render import Interaction3f, srgb_model_fetch, srgb_model_eval
+    from mitsuba.python.volume import write_dense_volume
+
+    res = 4
+    rng = np.random.RandomState(0)
+    rgb = rng.uniform(0.05, 2, size=(res, res, res, 3))
+    rgb[1, 2, 1] = 0
+    filename = str(tmpdir.join('grid.vol'))
+    write_dense_volume(filename, rgb)
+
+    volume = load_string("""<volume type="gridvolume" version="2.0.0">
+            <string name="filename" value="%s"/>
+            <boolean name="filter_coefficients" value="true"/>
+        </volume>""" % filename)
+
+    # Coefficients and scale factors as stored by the volume
+    scale = np.max(rgb, axis=3) * 2
+    coeff = np.zeros(rgb.shape)
+    for z, y, x in np.ndindex(res, res, res):
+        coeff[z, y, x] = srgb_model_fetch(rgb[z, y, x] / max(1e-8, scale[z, y, x]))
+    coeff[..., 2] = np.clip(coeff[..., 2], -100, 100)
+
+    it = Interaction3f()
+    wavelengths = [400, 500, 600, 700]
+    it.wavelengths = wavelengths
+    for p in rng.uniform(.5 / res, 1 - .5 / res, size=(30, 3)):
+        it.p = p
+        q = p * res - .5
+        i = np.floor(q).astype(int)
+        w = q - i
+        c, f = 0, 0
+        for dx, dy, dz in np.ndindex(2, 2, 2):
+            weight = (w[0] if dx else 1 - w[0]) * (w[1] if dy else 1 - w[1]) * \
+                     (w[2] if dz else 1 - w[2])
+            index = (i[2] + dz, i[1] + dy, i[0] + dx)
+            c = c + weight * coeff[index]
+            f = f + weight * scale[index]
+        ref = f * np.array(srgb_model_eval(c, wavelengths))
+        assert np.allclose(np.array(volume.eval(it)), ref, rtol=1e-4, atol=1e-4)
+
+
+def grid_data(channels, seed=0):
+    import numpy as np
+    rng = np.random.RandomState(seed)
+    return rng.uniform(size=(12, 10, 8, channels)).astype(np.float32)
+
+
+def test02_grid_volume_mmap(variant_scalar_rgb, tmpdir):
+    # Scalar variants map the voxel data of the file instead of copying it
+    import numpy as np
+    from mitsuba.core.xml import load_string
+    from mitsuba.render import Interaction3f
+    from mitsuba.python.volume import write_dense_volume
+
+    data = grid_data(channels=3)
+    filename = str(tmpdir.join('grid.vol'))
+    write_dense_volume(filename, data)
+
+    volume_str = """<volume type="gridvolume" version="2.0.0">
+        <string name="filename" value="%s"/>
+        <boolean name="raw" value="true"/>
+        <boolean name="mmap" value="%s"/>
+        <boolean name="prefetch" value="true"/>
+    </volume>"""
+    mapped = load_string(volume_str % (filename, 'true'))
+    copied = load_string(volume_str % (filename, 'false'))
+    assert mapped.memory_usage() == {'grid volumes (mapped)': data.nbytes}
+    assert copied.memory_usage() == {'grid volumes': data.nbytes}
+    assert mapped.max() == copied.max() == data.max()
+
+    rng = np.random.RandomState(2)
+    it = Interaction3f()
+    for i in range(100):
+        it.p = rng.uniform(0, 1, size=3)
+        assert np.allclose(mapped.eval_3(it), copied.eval_3(it))
+
+
+def test03_grid_volume_max_value(variant_scalar_rgb, tmpdir):
+    import re
+    import numpy as np
+    from mitsuba.core.xml import load_string
+    from mitsuba.python.volume import write_dense_volume
+
+    data = grid_data(channels=1)
+    filename = str(tmpdir.join('grid.vol'))
+    write_dense_volume(filename, data)
+
+    # The statistics pass is skipped, but the mean is still reported
+    for mmap in ['true', 'false']:
+        volume = load_string("""<volume type="gridvolume" version="2.0.0">
+                <string name="filename" value="%s"/>
+                <boolean name="raw" value="true"/>
+                <boolean name="mmap" value="%s"/>
+                <float name="max_value" value="4"/>
+            </volume>""" % (filename, mmap))
+        assert volume.max() == 4
+        mean = float(re.search(r'mean = ([^,]*),', str(volume)).group(1))
+        assert np.isclose(mean, data.mean(), rtol=1e-4)
@@ -2,10 +2,12 @@
 
 #include <fstream>
 #include <sstream>
+#include <tbb/parallel_reduce.h>
 
 /// @file Helper functions for volume data handling.
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/math.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/thread.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/render/volume_texture.h>
@@ -101,4 +103,105 @@ read_binary_volume_data(const std::string &filename) {
     return { meta, std::move(raw_data) };
 }
 
+/// Computes the mean and maximum of \c count voxel values (in parallel)
+inline std::pair<double, float> volume_data_stats(const float *data, size_t count) {
+    using Stats = std::pair<double, float>;
+    Stats stats = tbb::parallel_reduce(
+        tbb::blocked_range<size_t>(0, count, 1 << 16),
+        Stats(0.0, -math::Infinity<float>),
+        [&](const tbb::blocked_range<size_t> &range, Stats stats) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                stats.first += (double) data[i];
+                stats.second = std::max(stats.second, data[i]);
+            }
+            return stats;
+        },
+        [](Stats s1, const Stats &s2) {
+            return Stats(s1.first + s2.first, std::max(s1.second, s2.second));
+        }
+    );
+    stats.first /= double(count);
+    return stats;
+}
+
+/**
+ * \brief Map a Mitsuba binary volume file into memory (copy-on-write)
+ *
+ * Returns the metadata, the mapping, and a pointer to the (float32) voxel
+ * values within the mapping. Pages of the file are only read when they are
+ * accessed for the first time. The mean and maximum value are only computed
+ * (touching all pages) when \c compute_stats is set, otherwise \c mean and
+ * \c max are set to NaN. The voxel values are only 16-byte aligned.
+ */
+inline std::tuple<VolumeMetadata, ref<MemoryMappedFile>, const float *>
+map_binary_volume_data(const std::string &filename, bool compute_stats = true) {
+    using ScalarFloat = float;
+    using ScalarPoint3f = Point<float, 3>;
+    using ScalarBoundingBox3f = BoundingBox<ScalarPoint3f>;
+
+    VolumeMetadata meta;
+    auto fs       = Thread::thread()->file_resolver();
+    meta.filename = fs->resolve(filename).string();
+    ref<MemoryMappedFile> mmap = MemoryMappedFile::map_private(meta.filename);
+
+    // Header: 'VOL', version, type, shape, channel count, and bounding box (48 bytes)
+    const size_t header_size = 48;
+    const uint8_t *ptr = (const uint8_t *) mmap->data();
+    auto read = [&](auto &value, size_t offset) {
+        std::memcpy(&value, ptr + offset, sizeof(value));
+    };
+
+    if (mmap->size() < header_size || ptr[0] != 'V' || ptr[1] != 'O' || ptr[2] != 'L')
+        Throw("Invalid volume file %s", filename);
+    meta.version = ptr[3];
+    if (meta.version != 3)
+        Throw("Invalid version, currently only version 3 is supported (found %d)", meta.version);
+
+    read(meta.data_type, 4);
+    if (meta.data_type != 1)
+        Throw("Wrong type, currently only type == 1 (Float32) data is supported (found type = %d)",
+              meta.data_type);
+
+    int32_t shape[3], channel_count;
+    float dims[6];
+    read(shape, 8);
+    read(channel_count, 20);
+    read(dims, 24);
+
+    meta.shape = Vector<int32_t, 3>(shape[0], shape[1], shape[2]);
+    size_t size = hprod(meta.shape);
+    if (size < 8)
+        Throw("Invalid grid dimensions: %d x %d x %d < 8 (must have at "
+              "least one value at each corner)",
+              meta.shape.x(), meta.shape.y(), meta.shape.z());
+    meta.channel_count = (size_t) channel_count;
+
+    size_t value_count = size * meta.channel_count;
+    if (mmap->size() < header_size + value_count * sizeof(float))
+        Throw("Volume file %s is truncated (expected %s of data, found %s)", filename,
+              util::mem_string(header_size + value_count * sizeof(float)),
+              util::mem_string(mmap->size()));
+
+    meta.bbox      = ScalarBoundingBox3f(ScalarPoint3f(dims[0], dims[1], dims[2]),
+                                         ScalarPoint3f(dims[3], dims[4], dims[5]));
+    meta.transform = detail::bbox_transform(meta.bbox);
+
+    /* The mapping is page-aligned, so the data following the 48-byte header
+       is only guaranteed to be 16-byte aligned. Callers that need a stronger
+       alignment (e.g. for packets) must copy it. */
+    const float *data = (const float *) (ptr + header_size);
+
+    if (compute_stats) {
+        std::tie(meta.mean, meta.max) = volume_data_stats(data, value_count);
+    } else {
+        meta.mean = std::numeric_limits<double>::quiet_NaN();
+        meta.max  = std::numeric_limits<ScalarFloat>::quiet_NaN();
+    }
+
+    Log(Debug, "Mapped grid volume data from file %s: dimensions %s, mean value %f, max value %f",
+        filename, meta.shape, meta.mean, meta.max);
+
+    return { meta, mmap, data };
+}
+
 NAMESPACE_END(mitsuba)